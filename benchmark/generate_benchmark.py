@@ -0,0 +1,136 @@
+import os
+import sys
+import argparse
+import subprocess
+
+import yaml
+from jinja2 import Environment, FileSystemLoader
+
+REPOSITORY_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, REPOSITORY_ROOT)
+
+from yaml_parser import Parser, ALLOWED_TYPES  # noqa: E402
+
+MANY_FRAMES_COUNT = 32
+MULTI_DEVICE_FRAMES_COUNT = 4
+MULTI_DEVICE_MAX_DEVICES = 16
+
+
+def status_fields():
+    """Fields of a typical status frame, every numeric field has health checks"""
+    return [
+        {'name': 'status', 'type': 'uint8_t', 'default': "0", 'health_checks': [
+            {'type': 'exact', 'value': 0, 'result': 'OK'},
+            {'type': 'range', 'min': 1, 'max': 200, 'result': 'WARNING'},
+            {'type': 'range', 'min': 200, 'max': 256, 'result': 'CRITICAL'}]},
+        {'name': 'temperature', 'type': 'float', 'default': "25.0", 'health_checks': [
+            {'type': 'range', 'min': -40, 'max': 85, 'result': 'OK'},
+            {'type': 'range', 'min': 85, 'max': 125, 'result': 'WARNING'}]},
+        {'name': 'counter', 'type': 'uint32_t', 'default': "0"},
+        {'name': 'voltage', 'type': 'int16_t', 'default': "12", 'health_checks': [
+            {'type': 'range', 'min': 10, 'max': 15, 'result': 'OK'},
+            {'type': 'range', 'min': 0, 'max': 10, 'result': 'WARNING'},
+            {'type': 'exact', 'value': -1, 'result': 'CRITICAL'}]},
+        {'name': 'enabled', 'type': 'bool', 'default': "true"},
+    ]
+
+
+def bit_packed_fields():
+    """Status frame fields squeezed into bit widths and scaled fixed-point values"""
+    fields = status_fields()
+    fields[0]['bits'] = 8
+    fields[1].update({'bits': 12, 'scale': 0.1, 'offset': -40})
+    fields[2]['bits'] = 20
+    fields[3]['bits'] = 6
+    fields[4]['bits'] = 1
+    return fields
+
+
+def wide_fields():
+    """One field of every allowed type, numeric fields have health checks"""
+    fields = []
+    for field_type in ALLOWED_TYPES:
+        field = {'name': f"{field_type.replace('_t', '')}_field", 'type': field_type}
+        if field_type == 'enum':
+            field['values'] = ["IDLE", "RUNNING", "FAULT"]
+        elif field_type != 'bool':
+            field['health_checks'] = [
+                {'type': 'range', 'min': 0, 'max': 100, 'result': 'OK'},
+                {'type': 'range', 'min': 100, 'max': 120, 'result': 'WARNING'},
+                {'type': 'exact', 'value': 127, 'result': 'CRITICAL'}]
+        fields.append(field)
+    return fields
+
+
+def synthetic_protocols():
+    """Synthetic protocols covering many frames, wide frames and multi-device subsystems"""
+    return {
+        'bench_many_frames': {'protocol': {
+            'subsystem': 'bench_many_frames',
+            'subsystem_id': 1,
+            'frames': [{'name': f"frame_{i}", 'frame_id': i + 1, 'fields': status_fields()}
+                       for i in range(MANY_FRAMES_COUNT)]}},
+        'bench_wide': {'protocol': {
+            'subsystem': 'bench_wide',
+            'subsystem_id': 2,
+            'frames': [{'name': 'all_types', 'frame_id': 1, 'fields': wide_fields()}]}},
+        'bench_multi_device': {'protocol': {
+            'subsystem': 'bench_multi_device',
+            'subsystem_id': 3,
+            'multiple_devices': True,
+            'max_devices': MULTI_DEVICE_MAX_DEVICES,
+            'frames': [{'name': f"device_frame_{i}", 'frame_id': i + 1, 'timeout_ms': 100, 'fields': status_fields()}
+                       for i in range(MULTI_DEVICE_FRAMES_COUNT)]}},
+        'bench_bit_packed': {'protocol': {
+            'subsystem': 'bench_bit_packed',
+            'subsystem_id': 4,
+            'frames': [{'name': 'packed_status', 'frame_id': 1, 'fields': bit_packed_fields()}]}},
+    }
+
+
+def save_protocols(protocols, path):
+    os.makedirs(path, exist_ok=True)
+    for file in os.listdir(path):
+        os.remove(os.path.join(path, file))
+
+    for name, protocol in protocols.items():
+        with open(os.path.join(path, f"{name}_protocol.yaml"), 'w') as f:
+            yaml.safe_dump(protocol, f, sort_keys=False)
+
+
+def generate_library(protocols_path, output_path, templates_path, layout):
+    # Compiler rewrites only changed files, so unchanged sources of the library aren't rebuilt
+    subprocess.run([sys.executable, os.path.join(REPOSITORY_ROOT, 'proto_compiler.py'),
+                    '-s', protocols_path, '-o', output_path, '-t', templates_path, '-l', layout],
+                   cwd=REPOSITORY_ROOT, check=True)
+
+
+def generate_benchmark_source(protocols_path, output_file):
+    parser = Parser()
+    for file in sorted(os.listdir(protocols_path)):
+        parser.load_from_yaml(os.path.join(protocols_path, file))
+
+    jinja_env = Environment(loader=FileSystemLoader(os.path.dirname(os.path.abspath(__file__))))
+    template = jinja_env.get_template('benchmark_template.c.jinja2')
+
+    with open(output_file, 'w') as f:
+        f.write(template.render(protocols=parser.get_protocols().values()))
+
+
+if __name__ == '__main__':
+    argument_parser = argparse.ArgumentParser(description='Generate benchmark of code generated from synthetic protocols')
+    argument_parser.add_help = True
+
+    argument_parser.add_argument('-o', '--output', type=str, help='Path to the output directory', required=True)
+    argument_parser.add_argument('-t', '--templates', type=str, help='Path to the templates directory',
+                                 default=os.path.join(REPOSITORY_ROOT, 'templates'), required=False)
+    argument_parser.add_argument('-l', '--layout', type=str, choices=['switch', 'tables'], default='switch',
+                                 help='Layout of generated instance code', required=False)
+
+    args = argument_parser.parse_args()
+    output = os.path.abspath(args.output)
+
+    save_protocols(synthetic_protocols(), os.path.join(output, 'protocols'))
+    generate_library(os.path.join(output, 'protocols'), os.path.join(output, 'ksrp'), os.path.abspath(args.templates),
+                     args.layout)
+    generate_benchmark_source(os.path.join(output, 'protocols'), os.path.join(output, 'benchmark.c'))
@@ -0,0 +1,66 @@
+import re
+import json
+import argparse
+import subprocess
+
+CODE_SYMBOL_TYPES = 'tT'
+DATA_SYMBOL_TYPES = 'rRdDbB'
+
+
+def run_benchmark(benchmark, iterations):
+    command = [benchmark] + ([str(iterations)] if iterations else [])
+    return json.loads(subprocess.run(command, check=True, capture_output=True, text=True).stdout)
+
+
+def load_symbols(nm, library):
+    """Return list of (name, type, size) of all sized symbols in the library"""
+    output = subprocess.run([nm, '--print-size', library], check=True, capture_output=True, text=True).stdout
+    symbols = []
+    for line in output.splitlines():
+        columns = line.split()
+        if len(columns) == 4:
+            symbols.append((columns[3], columns[2], int(columns[1], 16)))
+    return symbols
+
+
+def measure_size(symbols, identifier, name):
+    """Sum sizes of symbols named after given subsystem or frame, i.e. KSRP_Pack_<Identifier> or ksrp_<name>_lut"""
+    pattern = re.compile(rf"(_{identifier}(_|$)|^ksrp_{name}_)")
+    size = {'code': 0, 'data': 0}
+    for symbol_name, symbol_type, symbol_size in symbols:
+        if pattern.search(symbol_name):
+            if symbol_type in CODE_SYMBOL_TYPES:
+                size['code'] += symbol_size
+            elif symbol_type in DATA_SYMBOL_TYPES:
+                size['data'] += symbol_size
+    return size
+
+
+if __name__ == '__main__':
+    argument_parser = argparse.ArgumentParser(description='Run benchmark and measure size of generated code')
+    argument_parser.add_help = True
+
+    argument_parser.add_argument('--benchmark', type=str, help='Path to the benchmark executable', required=True)
+    argument_parser.add_argument('--library', type=str, help='Path to the generated library', required=True)
+    argument_parser.add_argument('--nm', type=str, help='Path to the nm tool', default='nm', required=False)
+    argument_parser.add_argument('-i', '--iterations', type=int, help='Iterations of every benchmark', required=False)
+    argument_parser.add_argument('-o', '--output', type=str, help='Path to the output json file', required=True)
+
+    args = argument_parser.parse_args()
+
+    results = run_benchmark(args.benchmark, args.iterations)
+    symbols = load_symbols(args.nm, args.library)
+
+    for frame in results['frames']:
+        frame['size_bytes'] = measure_size(symbols, f"{frame['subsystem']}_{frame['frame']}",
+                                           f"{frame['subsystem_name']}_{frame['frame_name']}")
+    subsystems = dict.fromkeys((frame['subsystem'], frame['subsystem_name']) for frame in results['frames'])
+    results['subsystems'] = [{'subsystem': subsystem, 'size_bytes': measure_size(symbols, subsystem, name)}
+                             for subsystem, name in subsystems]
+
+    with open(args.output, 'w') as f:
+        json.dump(results, f, indent=2)
+
+    for result in results['results']:
+        frame = f"{result['subsystem']}_{result['frame']}"
+        print(f"{result['benchmark']:<20} {frame:<40} {result['ns_per_op']:>10.3f} ns/op")
@@ -0,0 +1,169 @@
+# Generates KSRP library from protocol definitions at build time.
+#
+# include(<generator>/cmake/KsrpGenerate.cmake)
+# ksrp_generate_protocol(<name>
+#     SOURCE <protocol source directory>
+#     [OUTPUT_DIRECTORY <directory>]  # defaults to ${CMAKE_CURRENT_BINARY_DIR}/<name>
+#     [LAYOUT switch|tables]          # instance code layout, see --layout of proto_compiler.py
+#     [JOBS <count>]                  # protocols rendered in parallel
+#     [HOST]                          # build host-side components, requires threads
+#     [UNITY_BUILD]                   # compile sources of every target as single unity file
+#     [LTO])                          # enable link time optimization when supported
+#
+# Defines targets:
+# - <name>_generate - runs compiler when yaml file, template, compiler or library source changes
+# - <name>_core - library sources (frames, rings, batches, ...)
+# - <name>_<subsystem> - protocol and instance of every subsystem, only subsystems with changed
+#   definition are recompiled as compiler rewrites only files whose content changed
+# - <name> - protocol utils (dispatch, registry, fleet store with HOST), links all of the above, link your
+#   targets with this one
+#
+# Adding or removing yaml file is picked up by reconfigure, which build runs automatically.
+
+cmake_minimum_required(VERSION 3.20)
+
+find_package(Python3 REQUIRED COMPONENTS Interpreter)
+
+set(KSRP_GENERATOR_DIR "${CMAKE_CURRENT_LIST_DIR}/.." CACHE INTERNAL "")
+
+function(ksrp_generate_protocol name)
+    cmake_parse_arguments(PARSE_ARGV 1 ARG "HOST;UNITY_BUILD;LTO" "SOURCE;OUTPUT_DIRECTORY;LAYOUT;JOBS" "")
+
+    if(NOT ARG_SOURCE)
+        message(FATAL_ERROR "ksrp_generate_protocol: SOURCE is required")
+    endif()
+    get_filename_component(source "${ARG_SOURCE}" ABSOLUTE)
+    if(ARG_OUTPUT_DIRECTORY)
+        get_filename_component(output "${ARG_OUTPUT_DIRECTORY}" ABSOLUTE BASE_DIR "${CMAKE_CURRENT_BINARY_DIR}")
+    else()
+        set(output "${CMAKE_CURRENT_BINARY_DIR}/${name}")
+    endif()
+    if(NOT ARG_LAYOUT)
+        set(ARG_LAYOUT switch)
+    endif()
+    set(compiler_args -s "${source}" -o "${output}" -l ${ARG_LAYOUT})
+    if(ARG_JOBS)
+        list(APPEND compiler_args -j ${ARG_JOBS})
+    endif()
+
+    # Inputs, reconfigure when yaml file is added or removed
+    file(GLOB protocol_files CONFIGURE_DEPENDS "${source}/*")
+    file(GLOB_RECURSE template_files CONFIGURE_DEPENDS "${KSRP_GENERATOR_DIR}/templates/*")
+    file(GLOB_RECURSE library_files CONFIGURE_DEPENDS "${KSRP_GENERATOR_DIR}/library_source/*")
+    set(compiler_files "${KSRP_GENERATOR_DIR}/proto_compiler.py" "${KSRP_GENERATOR_DIR}/yaml_parser.py")
+
+    # Outputs of every subsystem are known only after parsing protocol definitions
+    execute_process(
+        COMMAND ${Python3_EXECUTABLE} proto_compiler.py ${compiler_args} --list-outputs
+        WORKING_DIRECTORY "${KSRP_GENERATOR_DIR}"
+        OUTPUT_VARIABLE outputs_json
+        RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "ksrp_generate_protocol: listing outputs of ${source} failed")
+    endif()
+
+    set(generated_files)
+    foreach(group library common)
+        string(JSON count LENGTH "${outputs_json}" ${group})
+        set(${group}_outputs)
+        if(count GREATER 0)
+            math(EXPR last "${count} - 1")
+            foreach(index RANGE ${last})
+                string(JSON file GET "${outputs_json}" ${group} ${index})
+                list(APPEND ${group}_outputs "${output}/${file}")
+            endforeach()
+        endif()
+        list(APPEND generated_files ${${group}_outputs})
+    endforeach()
+
+    set(subsystems)
+    string(JSON count LENGTH "${outputs_json}" subsystems)
+    if(count GREATER 0)
+        math(EXPR last "${count} - 1")
+        foreach(index RANGE ${last})
+            string(JSON subsystem MEMBER "${outputs_json}" subsystems ${index})
+            string(JSON files_count LENGTH "${outputs_json}" subsystems ${subsystem})
+            math(EXPR files_last "${files_count} - 1")
+            set(${subsystem}_outputs)
+            foreach(file_index RANGE ${files_last})
+                string(JSON file GET "${outputs_json}" subsystems ${subsystem} ${file_index})
+                list(APPEND ${subsystem}_outputs "${output}/${file}")
+            endforeach()
+            list(APPEND subsystems ${subsystem})
+            list(APPEND generated_files ${${subsystem}_outputs})
+        endforeach()
+    endif()
+
+    # Rewritten only when its content changes, so the compiler runs again when yaml file is removed or options
+    # change
+    set(configuration "${CMAKE_CURRENT_BINARY_DIR}/${name}.ksrp_configuration")
+    string(REPLACE ";" "\n" configuration_content "${compiler_args};${protocol_files}")
+    file(CONFIGURE OUTPUT "${configuration}" CONTENT "${configuration_content}" @ONLY)
+
+    # Generated files are byproducts of stamp, so unchanged ones keep their timestamps and don't trigger
+    # recompilation
+    set(stamp "${CMAKE_CURRENT_BINARY_DIR}/${name}.ksrp_stamp")
+    add_custom_command(
+        OUTPUT "${stamp}"
+        BYPRODUCTS ${generated_files}
+        COMMAND ${Python3_EXECUTABLE} proto_compiler.py ${compiler_args}
+        COMMAND ${CMAKE_COMMAND} -E touch "${stamp}"
+        DEPENDS "${configuration}" ${protocol_files} ${template_files} ${library_files} ${compiler_files}
+        WORKING_DIRECTORY "${KSRP_GENERATOR_DIR}"
+        COMMENT "Generating KSRP protocol ${name}"
+        VERBATIM)
+    add_custom_target(${name}_generate DEPENDS "${stamp}")
+
+    set(targets ${name}_core ${name})
+
+    set(core_sources ${library_outputs})
+    list(FILTER core_sources INCLUDE REGEX "/src/.*\\.c$")
+    if(NOT ARG_HOST)
+        list(FILTER core_sources EXCLUDE REGEX "/src/host/")
+    endif()
+    add_library(${name}_core ${core_sources})
+    target_include_directories(${name}_core PUBLIC "${output}/include")
+    if(ARG_HOST)
+        find_package(Threads REQUIRED)
+        target_link_libraries(${name}_core PUBLIC Threads::Threads)
+        # Host sources define feature test macros, which have to precede all includes
+        set(host_sources ${core_sources} ${common_outputs})
+        list(FILTER host_sources INCLUDE REGEX "/src/host/.*\\.c$")
+        set_source_files_properties(${host_sources} PROPERTIES SKIP_UNITY_BUILD_INCLUSION ON)
+    endif()
+
+    set(subsystem_targets)
+    foreach(subsystem ${subsystems})
+        set(subsystem_sources ${${subsystem}_outputs})
+        list(FILTER subsystem_sources INCLUDE REGEX "\\.c$")
+        add_library(${name}_${subsystem} ${subsystem_sources})
+        target_link_libraries(${name}_${subsystem} PUBLIC ${name}_core)
+        list(APPEND subsystem_targets ${name}_${subsystem})
+    endforeach()
+    list(APPEND targets ${subsystem_targets})
+
+    set(utils_sources ${common_outputs})
+    list(FILTER utils_sources INCLUDE REGEX "\\.c$")
+    if(NOT ARG_HOST)
+        list(FILTER utils_sources EXCLUDE REGEX "/src/host/")
+    endif()
+    add_library(${name} ${utils_sources})
+    target_link_libraries(${name} PUBLIC ${subsystem_targets} ${name}_core)
+
+    foreach(target ${targets})
+        add_dependencies(${target} ${name}_generate)
+        if(ARG_UNITY_BUILD)
+            set_target_properties(${target} PROPERTIES UNITY_BUILD ON)
+        endif()
+    endforeach()
+
+    if(ARG_LTO)
+        include(CheckIPOSupported)
+        check_ipo_supported(RESULT lto_supported OUTPUT lto_output LANGUAGES C)
+        if(lto_supported)
+            set_target_properties(${targets} PROPERTIES INTERPROCEDURAL_OPTIMIZATION ON)
+        else()
+            message(WARNING "ksrp_generate_protocol: LTO is not supported, ${lto_output}")
+        endif()
+    endif()
+endfunction()
\ No newline at end of file
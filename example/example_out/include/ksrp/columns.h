@@ -0,0 +1,22 @@
+#ifndef KALMAN_PROTOCOL_STATUS_REPORT_COLUMNS_H_
+#define KALMAN_PROTOCOL_STATUS_REPORT_COLUMNS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+// Number of frames held by generated KSRP_<Subsystem>_<Frame>_Columns, has to be defined the same for the whole build
+#ifndef KSRP_COLUMNS_CAPACITY
+#define KSRP_COLUMNS_CAPACITY 1024
+#endif // KSRP_COLUMNS_CAPACITY
+
+// Alignment of every column, wide enough for any SIMD register and a cache line
+#define KSRP_COLUMN_ALIGNMENT 64
+
+#define _column_ __attribute__((aligned(KSRP_COLUMN_ALIGNMENT)))
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // KALMAN_PROTOCOL_STATUS_REPORT_COLUMNS_H_
\ No newline at end of file
@@ -0,0 +1,24 @@
+/**
+ * @file protocols.hpp
+ * @brief C++ descriptors of all subsystems
+ */
+
+#ifndef KALMAN_STATUS_REPORT_CPP_PROTOCOLS_HPP_
+#define KALMAN_STATUS_REPORT_CPP_PROTOCOLS_HPP_
+
+// Include user libraries
+#include "ksrp/cpp/ksrp.hpp"
+#include "ksrp/cpp/subsystems/wheels.hpp"
+
+namespace ksrp {
+
+/// @brief Descriptors of all frames of all subsystems sent in a single raw data frame
+using Frames = type_list<
+    wheels::WheelsStatus>;
+
+/// @brief Descriptors of all frames of all subsystems sent in segments
+using SegmentedFrames = type_list<>;
+
+} // namespace ksrp
+
+#endif // KALMAN_STATUS_REPORT_CPP_PROTOCOLS_HPP_
\ No newline at end of file
@@ -0,0 +1,147 @@
+/**
+ * @file wheels.hpp
+ * @brief C++ descriptors of wheels subsystem frames and fields
+ */
+
+#ifndef KALMAN_STATUS_REPORT_CPP_WHEELS_HPP_
+#define KALMAN_STATUS_REPORT_CPP_WHEELS_HPP_
+
+// Include standard libraries
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Include user libraries
+#include "ksrp/cpp/ksrp.hpp"
+#include "ksrp/protocols/subsystems/wheels_protocol.h"
+
+namespace ksrp::wheels {
+
+struct WheelsStatus;
+
+/**
+ * @brief Descriptors of WheelsStatus frame fields
+ */
+namespace wheels_status {
+
+struct DeviceId {
+    using frame = ::ksrp::wheels::WheelsStatus;
+    using storage_type = uint8_t;
+    using value_type = uint8_t;
+    static constexpr uint32_t id = KSRP_WHEELS_WHEELS_STATUS_DEVICE_ID_FIELD_ID;
+    static constexpr std::size_t offset = 0;
+    static constexpr std::string_view name = "device_id";
+    static constexpr bool has_health_checks = false;
+};
+
+struct DriverStatus {
+    using frame = ::ksrp::wheels::WheelsStatus;
+    using storage_type = uint8_t;
+    using value_type = uint8_t;
+    static constexpr uint32_t id = KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_FIELD_ID;
+    static constexpr std::size_t offset = 1;
+    static constexpr std::string_view name = "driver_status";
+    static constexpr bool has_health_checks = true;
+
+    static KSRP_HealthCheckResult health_check(const KSRP_Wheels_WheelsStatus_Frame& frame) {
+        return KSRP_HealthCheckResult_Wheels_WheelsStatus_DriverStatus(&frame);
+    }
+};
+
+struct Temperature {
+    using frame = ::ksrp::wheels::WheelsStatus;
+    using storage_type = float;
+    using value_type = float;
+    static constexpr uint32_t id = KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_FIELD_ID;
+    static constexpr std::size_t offset = 2;
+    static constexpr std::string_view name = "temperature";
+    static constexpr bool has_health_checks = true;
+
+    static KSRP_HealthCheckResult health_check(const KSRP_Wheels_WheelsStatus_Frame& frame) {
+        return KSRP_HealthCheckResult_Wheels_WheelsStatus_Temperature(&frame);
+    }
+};
+
+struct AlgorithmType {
+    using frame = ::ksrp::wheels::WheelsStatus;
+    using storage_type = uint8_t;
+    using value_type = KSRP_Wheels_WheelsStatus_AlgorithmType;
+    static constexpr uint32_t id = KSRP_WHEELS_WHEELS_STATUS_ALGORITHM_TYPE_FIELD_ID;
+    static constexpr std::size_t offset = 6;
+    static constexpr std::string_view name = "algorithm_type";
+    static constexpr bool has_health_checks = false;
+};
+
+struct AlgorithmType2 {
+    using frame = ::ksrp::wheels::WheelsStatus;
+    using storage_type = uint8_t;
+    using value_type = KSRP_Wheels_WheelsStatus_AlgorithmType2;
+    static constexpr uint32_t id = KSRP_WHEELS_WHEELS_STATUS_ALGORITHM_TYPE2_FIELD_ID;
+    static constexpr std::size_t offset = 7;
+    static constexpr std::string_view name = "algorithm_type2";
+    static constexpr bool has_health_checks = false;
+};
+
+struct Testbool {
+    using frame = ::ksrp::wheels::WheelsStatus;
+    using storage_type = uint8_t;
+    using value_type = bool;
+    static constexpr uint32_t id = KSRP_WHEELS_WHEELS_STATUS_TESTBOOL_FIELD_ID;
+    static constexpr std::size_t offset = 8;
+    static constexpr std::string_view name = "testbool";
+    static constexpr bool has_health_checks = false;
+};
+
+} // namespace wheels_status
+
+/**
+ * @brief Descriptor of WheelsStatus frame
+ */
+struct WheelsStatus {
+    using frame_type = KSRP_Wheels_WheelsStatus_Frame;
+    using fields = type_list<
+        wheels_status::DeviceId,
+        wheels_status::DriverStatus,
+        wheels_status::Temperature,
+        wheels_status::AlgorithmType,
+        wheels_status::AlgorithmType2,
+        wheels_status::Testbool>;
+    static constexpr uint8_t subsystem_id = KSRP_WHEELS_SUBSYSTEM_ID;
+    static constexpr uint8_t frame_id = KSRP_WHEELS_WHEELS_STATUS_FRAME_ID;
+    static constexpr KSRP_TypeID type_id = KSRP_WHEELS_WHEELS_STATUS_TYPE_ID;
+    static constexpr std::size_t size = KSRP_WHEELS_WHEELS_STATUS_FRAME_SIZE;
+    static constexpr std::size_t wire_size = KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE;
+    static constexpr std::string_view name = "wheels_status";
+
+    static KSRP_Status init(frame_type& frame) {
+        return KSRP_Init_Wheels_WheelsStatus_Frame(&frame);
+    }
+
+    static KSRP_Status pack(const frame_type& frame, KSRP_RawData_Frame& raw_data) {
+        return KSRP_Pack_Wheels_WheelsStatus(&frame, &raw_data);
+    }
+
+    static KSRP_Status unpack(const KSRP_RawData_Frame& raw_data, frame_type& frame) {
+        return KSRP_Unpack_Wheels_WheelsStatus(&raw_data, &frame);
+    }
+};
+
+/// @brief Descriptors of all frames of wheels subsystem sent in a single raw data frame
+using Frames = type_list<
+    WheelsStatus>;
+
+/// @brief Descriptors of all frames of wheels subsystem sent in segments
+using SegmentedFrames = type_list<>;
+
+} // namespace ksrp::wheels
+
+namespace ksrp {
+
+template <>
+struct descriptor_of<KSRP_Wheels_WheelsStatus_Frame> {
+    using type = wheels::WheelsStatus;
+};
+
+} // namespace ksrp
+
+#endif // KALMAN_STATUS_REPORT_CPP_WHEELS_HPP_
\ No newline at end of file
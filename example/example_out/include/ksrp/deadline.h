@@ -0,0 +1,95 @@
+#ifndef KALMAN_PROTOCOL_STATUS_REPORT_DEADLINE_H_
+#define KALMAN_PROTOCOL_STATUS_REPORT_DEADLINE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ksrp/common.h"
+
+#define KSRP_DEADLINE_NONE 0xFFFF
+
+/**
+ * @brief Deadline of a single timed entry, nodes are stored in an array and linked into queues by index
+ */
+typedef struct {
+    uint32_t deadline_ms;
+    uint16_t prev;
+    uint16_t next;
+    bool armed;
+} KSRP_DeadlineNode;
+
+/**
+ * @brief Queue of deadlines sharing the same timeout
+ *
+ * Every scheduled entry gets deadline now + timeout, so appending to the tail keeps the queue sorted by deadline.
+ * Rescheduling an entry moves it to the tail in constant time and expired entries are always at the head, so checking
+ * for expired deadlines costs O(expired) instead of O(entries).
+ */
+typedef struct {
+    KSRP_DeadlineNode* nodes;
+    uint32_t timeout_ms;
+    uint16_t head;
+    uint16_t tail;
+} KSRP_DeadlineQueue;
+
+/**
+ * @brief Disarm all deadline nodes
+ *
+ * @param nodes The nodes to initialize
+ * @param count The number of nodes
+ */
+_nonnull_
+void KSRP_DeadlineNodes_Init(KSRP_DeadlineNode* nodes, uint16_t count);
+
+/**
+ * @brief Initialize an empty deadline queue
+ *
+ * @param queue The queue to initialize
+ * @param nodes Nodes linked by the queue, may be shared by several queues as long as each node is scheduled in
+ * one queue only
+ * @param timeout_ms Timeout of all entries in the queue (in ms)
+ */
+_nonnull_
+void KSRP_DeadlineQueue_Init(KSRP_DeadlineQueue* queue, KSRP_DeadlineNode* nodes, uint32_t timeout_ms);
+
+/**
+ * @brief Schedule (or reschedule) a node to expire after the timeout of the queue
+ *
+ * @param queue The queue to schedule in
+ * @param index The index of the node
+ * @param now_ms Current time (in ms)
+ */
+_nonnull_
+void KSRP_DeadlineQueue_Schedule(KSRP_DeadlineQueue* queue, uint16_t index, uint32_t now_ms);
+
+/**
+ * @brief Schedule (or reschedule) a node to expire after the timeout since its last update, node is inserted in
+ * deadline order, so nodes may be scheduled in any order. Costs O(scheduled nodes), used when restoring state
+ *
+ * @param queue The queue to schedule in
+ * @param index The index of the node
+ * @param updated_ms Time of the last update of the entry (in ms)
+ */
+_nonnull_
+void KSRP_DeadlineQueue_Insert(KSRP_DeadlineQueue* queue, uint16_t index, uint32_t updated_ms);
+
+/**
+ * @brief Remove the earliest node from the queue if its deadline has passed, removed node stays disarmed until it is
+ * scheduled again
+ *
+ * @param queue The queue to check
+ * @param now_ms Current time (in ms)
+ * @return uint16_t The index of the expired node, KSRP_DEADLINE_NONE if no deadline has passed
+ */
+_nonnull_
+uint16_t KSRP_DeadlineQueue_PopExpired(KSRP_DeadlineQueue* queue, uint32_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // KALMAN_PROTOCOL_STATUS_REPORT_DEADLINE_H_
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef KALMAN_PROTOCOL_STATUS_REPORT_DELTA_H_
+#define KALMAN_PROTOCOL_STATUS_REPORT_DELTA_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ksrp/common.h"
+#include "ksrp/frames.h"
+
+// Delta is a raw data frame with reserved type ID carrying only changed fields of a frame. It is followed by type ID
+// of the encoded frame, little-endian bitmask of changed fields (bit number is field ID) and little-endian values of
+// the changed fields in field ID order:
+// | 0xFF | 0x01 | subsystem_id | frame_id | mask ... | field values ... |
+#define KSRP_DELTA_SUBSYSTEM_ID 0xFF
+#define KSRP_DELTA_FRAME_ID 0x01
+#define KSRP_DELTA_TYPE_ID KSRP_MAKE_TYPE_ID(KSRP_DELTA_SUBSYSTEM_ID, KSRP_DELTA_FRAME_ID)
+#define KSRP_DELTA_HEADER_BYTES (2 * KSRP_ID_BYTES)
+#define KSRP_DELTA_MASK_BYTES(fields_count) (((fields_count) + 7) / 8)
+
+/**
+ * @brief Initialize an empty delta of a frame type, without mask and field values
+ *
+ * @param delta The raw data frame to initialize as delta
+ * @param type_id The type ID of the encoded frame
+ */
+_nonnull_
+void KSRP_Delta_Init(KSRP_RawData_Frame* delta, KSRP_TypeID type_id);
+
+/**
+ * @brief Check if a raw data frame is a delta
+ *
+ * @param frame The frame to check
+ * @return true if the frame is a delta
+ */
+_nonnull_
+bool KSRP_Delta_IsDelta(const KSRP_RawData_Frame* frame);
+
+/**
+ * @brief Get the type ID of the frame encoded in a delta
+ *
+ * @param delta The delta to read
+ * @return KSRP_TypeID The type ID of the encoded frame, KSRP_ILLEGAL_TYPE_ID if the frame is not a delta
+ */
+_nonnull_
+KSRP_TypeID KSRP_Delta_GetTypeID(const KSRP_RawData_Frame* delta);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // KALMAN_PROTOCOL_STATUS_REPORT_DELTA_H_
\ No newline at end of file
@@ -0,0 +1,147 @@
+#ifndef KALMAN_PROTOCOL_STATUS_REPORT_ENDIANNESS_H_
+#define KALMAN_PROTOCOL_STATUS_REPORT_ENDIANNESS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include <string.h>
+
+// Frames are sent in little-endian byte order. On little-endian targets packed frame structures match the wire
+// layout and are copied at once, elsewhere fields are converted with the helpers below.
+#ifndef KSRP_LITTLE_ENDIAN
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define KSRP_LITTLE_ENDIAN 1
+#else
+#define KSRP_LITTLE_ENDIAN 0
+#endif
+#endif // KSRP_LITTLE_ENDIAN
+
+static inline uint16_t KSRP_LoadLE16(const uint8_t* bytes) {
+    return (uint16_t)((uint16_t)bytes[0] | ((uint16_t)bytes[1] << 8));
+}
+
+static inline uint32_t KSRP_LoadLE32(const uint8_t* bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static inline uint64_t KSRP_LoadLE64(const uint8_t* bytes) {
+    return (uint64_t)KSRP_LoadLE32(bytes) | ((uint64_t)KSRP_LoadLE32(bytes + 4) << 32);
+}
+
+static inline float KSRP_LoadLEFloat(const uint8_t* bytes) {
+    uint32_t bits = KSRP_LoadLE32(bytes);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline double KSRP_LoadLEDouble(const uint8_t* bytes) {
+    uint64_t bits = KSRP_LoadLE64(bytes);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline void KSRP_StoreLE16(uint8_t* bytes, uint16_t value) {
+    bytes[0] = (uint8_t)value;
+    bytes[1] = (uint8_t)(value >> 8);
+}
+
+static inline void KSRP_StoreLE32(uint8_t* bytes, uint32_t value) {
+    bytes[0] = (uint8_t)value;
+    bytes[1] = (uint8_t)(value >> 8);
+    bytes[2] = (uint8_t)(value >> 16);
+    bytes[3] = (uint8_t)(value >> 24);
+}
+
+static inline void KSRP_StoreLE64(uint8_t* bytes, uint64_t value) {
+    KSRP_StoreLE32(bytes, (uint32_t)value);
+    KSRP_StoreLE32(bytes + 4, (uint32_t)(value >> 32));
+}
+
+static inline void KSRP_StoreLEFloat(uint8_t* bytes, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    KSRP_StoreLE32(bytes, bits);
+}
+
+static inline void KSRP_StoreLEDouble(uint8_t* bytes, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    KSRP_StoreLE64(bytes, bits);
+}
+
+static inline uint32_t KSRP_FloatToBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static inline float KSRP_BitsToFloat(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline uint64_t KSRP_DoubleToBits(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static inline double KSRP_BitsToDouble(uint64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Frames with bit-packed fields are serialized with bit granularity, every field starts right after the previous one
+// and its least significant bit goes first (bit 0 of byte 0 is the first bit of the frame). With constant offset and
+// width the helpers below unroll into a few shifts and masks.
+static inline uint64_t KSRP_LoadBits(const uint8_t* bytes, uint16_t bit_offset, uint8_t bits) {
+    bytes += bit_offset / 8;
+    const uint8_t shift = bit_offset % 8;
+    uint64_t value = (uint64_t)(bytes[0] >> shift);
+    for (uint8_t loaded = (uint8_t)(8 - shift), i = 1; loaded < bits; loaded += 8, i++) {
+        value |= (uint64_t)bytes[i] << loaded;
+    }
+    return bits < 64 ? value & (((uint64_t)1 << bits) - 1) : value;
+}
+
+// Bits of the destination have to be cleared before storing
+static inline void KSRP_StoreBits(uint8_t* bytes, uint16_t bit_offset, uint8_t bits, uint64_t value) {
+    value = bits < 64 ? value & (((uint64_t)1 << bits) - 1) : value;
+    bytes += bit_offset / 8;
+    const uint8_t shift = bit_offset % 8;
+    bytes[0] |= (uint8_t)(value << shift);
+    for (uint8_t stored = (uint8_t)(8 - shift), i = 1; stored < bits; stored += 8, i++) {
+        bytes[i] |= (uint8_t)(value >> stored);
+    }
+}
+
+static inline int64_t KSRP_SignExtend(uint64_t value, uint8_t bits) {
+    const uint64_t sign = (uint64_t)1 << (bits - 1);
+    return (int64_t)((value ^ sign) - sign);
+}
+
+// Scaled fields carry round((value - offset) / scale), saturated to the range of the field
+static inline uint64_t KSRP_EncodeScaled(double value, double scale, double offset, uint8_t bits) {
+    const double max = (double)(((uint64_t)1 << bits) - 1);
+    const double scaled = (value - offset) * (1.0 / scale);
+    if (!(scaled > 0.0)) {
+        return 0;
+    }
+    return scaled >= max ? (uint64_t)max : (uint64_t)(scaled + 0.5);
+}
+
+static inline double KSRP_DecodeScaled(uint64_t value, double scale, double offset) {
+    return (double)value * scale + offset;
+}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // KALMAN_PROTOCOL_STATUS_REPORT_ENDIANNESS_H_
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef KALMAN_PROTOCOL_STATUS_REPORT_HEALTH_BATCH_H_
+#define KALMAN_PROTOCOL_STATUS_REPORT_HEALTH_BATCH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+
+#include "ksrp/common.h"
+
+/**
+ * @brief Health checks of a field compiled into steps evaluated on whole columns of values
+ *
+ * Result of a value starts as KSRP_RESULT_UNKNOWN. Bounds are sorted and every bound not greater than the value sets
+ * its result, so the last one of them wins. Points are applied after bounds, value equal to a point gets its result.
+ */
+#define KSRP_HEALTH_CHECK_STEPS(name, type)                                                                           \
+    typedef struct {                                                                                                  \
+        const type* bounds;                                                                                           \
+        const uint8_t* bound_results;                                                                                 \
+        uint32_t bounds_count;                                                                                        \
+        const type* points;                                                                                           \
+        const uint8_t* point_results;                                                                                 \
+        uint32_t points_count;                                                                                        \
+    } KSRP_HealthCheckSteps_##name;                                                                                   \
+                                                                                                                      \
+    _nonnull_                                                                                                         \
+    void KSRP_HealthCheckBatch_##name(const type* values, uint32_t count, const KSRP_HealthCheckSteps_##name* steps, \
+                                      KSRP_HealthCheckResult* results);
+
+// Evaluate health checks of count values into results, vectorized with SSE2 or AVX2 when the target supports them
+KSRP_HEALTH_CHECK_STEPS(Uint16, uint16_t)
+KSRP_HEALTH_CHECK_STEPS(Int16, int16_t)
+KSRP_HEALTH_CHECK_STEPS(Uint32, uint32_t)
+KSRP_HEALTH_CHECK_STEPS(Int32, int32_t)
+KSRP_HEALTH_CHECK_STEPS(Uint64, uint64_t)
+KSRP_HEALTH_CHECK_STEPS(Int64, int64_t)
+KSRP_HEALTH_CHECK_STEPS(Float, float)
+KSRP_HEALTH_CHECK_STEPS(Double, double)
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // KALMAN_PROTOCOL_STATUS_REPORT_HEALTH_BATCH_H_
\ No newline at end of file
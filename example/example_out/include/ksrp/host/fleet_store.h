@@ -0,0 +1,141 @@
+/**
+ * @file fleet_store.h
+ * @brief Host-side state of all subsystems of a fleet of vehicles, stored in dense per-frame arrays
+ */
+#ifndef KALMAN_STATUS_REPORT_FLEET_STORE_H_
+#define KALMAN_STATUS_REPORT_FLEET_STORE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+// Include standard libraries
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Include user libraries
+#include "ksrp/frames.h"
+#include "ksrp/common.h"
+#include "ksrp/batch.h"
+#include "ksrp/delta.h"
+#include "ksrp/segments.h"
+#include "ksrp/host/fleet.h"
+#include "ksrp/protocols/protocol_common.h"
+#include "ksrp/protocols/subsystems/wheels_protocol.h"
+
+/**
+ * @brief State of all frames of all vehicles, every frame type has its own arrays indexed by
+ * vehicle * devices of the subsystem + device ID
+ *
+ * Only frame data, time of the last update and cached health of frames with health checks are stored, so memory per
+ * vehicle is KSRP_FLEET_STORE_BYTES_PER_VEHICLE. All arrays are in a single arena.
+ */
+typedef struct {
+    uint32_t vehicles;
+    void* arena;
+
+    KSRP_Wheels_WheelsStatus_Frame* wheels_wheels_status;
+    uint32_t* wheels_wheels_status_updated_ms;
+    uint8_t* wheels_wheels_status_health;
+} KSRP_FleetStore;
+
+/// @brief Memory of a single vehicle in the store (in bytes), without padding of arrays to cache lines
+#define KSRP_FLEET_STORE_BYTES_PER_VEHICLE (0 \
+    + KSRP_WHEELS_MAX_DEVICES * (sizeof(KSRP_Wheels_WheelsStatus_Frame) + sizeof(uint32_t) + sizeof(uint8_t)) \
+)
+
+/**
+ * @brief Allocate the store and initialize frames of all vehicles to their defaults
+ *
+ * @param store The store to initialize
+ * @param vehicles Number of vehicles
+ * @param now_ms Current time (in ms), frames are stale when not updated for their timeout since then
+ * @return KSRP_Status KSRP_STATUS_OK if successful, KSRP_STATUS_ERROR if memory couldn't be allocated
+ */
+_nonnull_
+KSRP_Status KSRP_FleetStore_Init(KSRP_FleetStore* store, uint32_t vehicles, uint32_t now_ms);
+
+/**
+ * @brief Free memory of the store
+ *
+ * @param store The store to free
+ */
+_nonnull_
+void KSRP_FleetStore_Free(KSRP_FleetStore* store);
+
+/**
+ * @brief Unpack a received frame into the store, deltas patch the stored frame and batches are split into
+ * sub-frames
+ *
+ * @param store The store to update
+ * @param vehicle The vehicle that sent the frame
+ * @param frame The raw data frame, delta or batch
+ * @param timestamp_ms Time of the reception (in ms)
+ * @return KSRP_Status KSRP_STATUS_OK if the frame was stored, KSRP_STATUS_ERROR if the vehicle is out of range,
+ * KSRP_STATUS_INVALID_FRAME_TYPE if the type ID is unknown or segmented, KSRP_STATUS_INVALID_DEVICE_ID if device
+ * ID is out of range, otherwise status of the unpacking, for batches status of the first failed sub-frame
+ */
+_nonnull_
+KSRP_Status KSRP_FleetStore_Update(KSRP_FleetStore* store, uint32_t vehicle, const KSRP_RawData_Frame* frame,
+                                   uint32_t timestamp_ms);
+
+/**
+ * @brief Unpack a reassembled segmented frame into the store
+ *
+ * @param store The store to update
+ * @param vehicle The vehicle that sent the frame
+ * @param payload The payload completed by KSRP_Reassembler_Push
+ * @param timestamp_ms Time of the reception (in ms)
+ * @return KSRP_Status KSRP_STATUS_OK if the frame was stored, KSRP_STATUS_ERROR if the vehicle is out of range,
+ * KSRP_STATUS_INVALID_FRAME_TYPE if the type ID is not a segmented frame, otherwise status of the unpacking
+ */
+_nonnull_
+KSRP_Status KSRP_FleetStore_UpdateSegmented(KSRP_FleetStore* store, uint32_t vehicle,
+                                            const KSRP_SegmentedPayload* payload, uint32_t timestamp_ms);
+
+/**
+ * @brief Update the store with received frames of many vehicles, vehicles are split into shards updated in
+ * parallel and frames of every vehicle are applied in the given order
+ *
+ * @param store The store to update
+ * @param frames The received frames
+ * @param count Number of frames
+ * @param threads Number of threads, 0 for the number of online processors
+ * @param stats Counters of applied and failed frames, may be NULL
+ */
+void KSRP_FleetStore_UpdateBatch(KSRP_FleetStore* store, const KSRP_FleetFrame* frames, size_t count, uint32_t threads,
+                                 KSRP_FleetUpdateStats* stats);
+
+/**
+ * @brief Find frames not updated for their timeout in all vehicles, every sweep reports frames until they are
+ * updated
+ *
+ * @param store The store to sweep
+ * @param now_ms Current time (in ms)
+ * @param callback Called for every stale frame from worker threads, may be NULL
+ * @param context The context passed to the callback
+ * @param threads Number of threads, 0 for the number of online processors
+ * @param stats Counters of the sweep, only stale frames are counted, may be NULL
+ */
+void KSRP_FleetStore_SweepStale(KSRP_FleetStore* store, uint32_t now_ms, KSRP_FleetStaleCallback callback,
+                                void* context, uint32_t threads, KSRP_FleetSweepStats* stats);
+
+/**
+ * @brief Evaluate health checks of frames of all vehicles and cache worst result of every frame
+ *
+ * @param store The store to sweep
+ * @param callback Called from worker threads when worst result of a frame changed since the previous sweep, may be
+ * NULL
+ * @param context The context passed to the callback
+ * @param threads Number of threads, 0 for the number of online processors
+ * @param stats Counters of the sweep, stale frames aren't counted, may be NULL
+ */
+void KSRP_FleetStore_SweepHealth(KSRP_FleetStore* store, KSRP_FleetHealthCallback callback, void* context,
+                                 uint32_t threads, KSRP_FleetSweepStats* stats);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // KALMAN_STATUS_REPORT_FLEET_STORE_H_
\ No newline at end of file
@@ -0,0 +1,170 @@
+#ifndef KALMAN_PROTOCOL_STATUS_REPORT_HOST_RECORDING_H_
+#define KALMAN_PROTOCOL_STATUS_REPORT_HOST_RECORDING_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "ksrp/common.h"
+#include "ksrp/frames.h"
+#include "ksrp/host/pipeline.h"
+
+// Recording file layout, all integers are little-endian:
+//  - header of KSRP_RECORDING_HEADER_SIZE bytes: magic, version, record size, protocol hash, records count,
+//    offset of the index, flags and number of indexed types
+//  - records of KSRP_RECORDING_RECORD_SIZE bytes: timestamp (8), type ID (2), length (1), reserved (5) and raw
+//    data of the frame including its ID bytes
+//  - index written on close: table of indexed types sorted by type ID (type ID (2), reserved (2), records count (4),
+//    first entry (8)) followed by 32-bit record numbers grouped by type, in recording order
+// Deltas are indexed under the type ID of the frame they patch, so a query returns everything needed to rebuild
+// the frame. File that wasn't closed has zero index offset, its records are still readable and queries scan them.
+#define KSRP_RECORDING_MAGIC "KSRPREC1"
+#define KSRP_RECORDING_VERSION 1
+#define KSRP_RECORDING_HEADER_SIZE 64
+#define KSRP_RECORDING_RECORD_SIZE (16 + KSRP_RAW_DATA_FRAME_BUFFER_SIZE)
+#define KSRP_RECORDING_INDEX_TYPE_SIZE 16
+#define KSRP_RECORDING_MAX_RECORDS UINT32_MAX
+
+// All records are in non-decreasing timestamp order, so time ranges are looked up with binary search
+#define KSRP_RECORDING_FLAG_SORTED 0x01
+
+/**
+ * @brief Append-only writer of a recording file
+ */
+typedef struct {
+    FILE* file;
+    uint64_t protocol_hash;
+    uint64_t records_count;
+    uint64_t last_timestamp;
+    bool sorted;
+    KSRP_TypeID* type_ids; // Indexed type of every record, used to build the index on close
+    uint64_t type_ids_capacity;
+} KSRP_RecordingWriter;
+
+/**
+ * @brief Create a recording file, existing file is truncated
+ *
+ * @param writer The writer to initialize
+ * @param path The path of the file
+ * @param protocol_hash Hash of protocol definitions the frames follow, i.e. KSRP_PROTOCOL_HASH
+ * @return KSRP_Status KSRP_STATUS_OK if successful, KSRP_STATUS_ERROR if the file couldn't be created
+ */
+_nonnull_
+KSRP_Status KSRP_RecordingWriter_Open(KSRP_RecordingWriter* writer, const char* path, uint64_t protocol_hash);
+
+/**
+ * @brief Append a frame to the recording
+ *
+ * @param writer The writer to append to
+ * @param timestamp The time the frame was received, unit is up to the user
+ * @param frame The frame to append
+ * @return KSRP_Status KSRP_STATUS_OK if successful, KSRP_STATUS_INVALID_DATA_SIZE if the frame is too long or
+ * too short to have type ID, KSRP_STATUS_ERROR if the record couldn't be written
+ */
+_nonnull_
+KSRP_Status KSRP_RecordingWriter_Append(KSRP_RecordingWriter* writer, uint64_t timestamp,
+                                        const KSRP_RawData_Frame* frame);
+
+/**
+ * @brief Write the type index, finalize the header and close the file
+ *
+ * @param writer The writer to close
+ * @return KSRP_Status KSRP_STATUS_OK if successful, KSRP_STATUS_ERROR if the index couldn't be written, records
+ * stay readable without the index
+ */
+_nonnull_
+KSRP_Status KSRP_RecordingWriter_Close(KSRP_RecordingWriter* writer);
+
+/**
+ * @brief Memory-mapped recording file
+ */
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    uint64_t protocol_hash;
+    uint64_t records_count;
+    uint32_t flags;
+    uint32_t types_count;
+    const uint8_t* types;   // Index table of types, NULL if the recording wasn't closed
+    const uint8_t* entries; // Record numbers grouped by type
+} KSRP_RecordingReader;
+
+/**
+ * @brief Iterator over records of a single type in a time range
+ */
+typedef struct {
+    const KSRP_RecordingReader* reader;
+    KSRP_TypeID type_id;
+    uint64_t from;
+    uint64_t to;
+    uint64_t position;
+    uint64_t end;
+    bool indexed; // Position runs over index entries of the type, otherwise over all records
+} KSRP_RecordingCursor;
+
+/**
+ * @brief Map a recording file into memory
+ *
+ * @param reader The reader to initialize
+ * @param path The path of the file
+ * @return KSRP_Status KSRP_STATUS_OK if successful, KSRP_STATUS_INVALID_DATA_SIZE if the file is not a valid
+ * recording, KSRP_STATUS_ERROR if the file couldn't be mapped
+ */
+_nonnull_
+KSRP_Status KSRP_RecordingReader_Open(KSRP_RecordingReader* reader, const char* path);
+
+/**
+ * @brief Unmap the recording file
+ *
+ * @param reader The reader to close
+ */
+_nonnull_
+void KSRP_RecordingReader_Close(KSRP_RecordingReader* reader);
+
+/**
+ * @brief Read a single record
+ *
+ * @param reader The reader to read from
+ * @param record Number of the record, lower than records_count
+ * @param frame The frame read from the record
+ * @return KSRP_Status KSRP_STATUS_OK if successful, KSRP_STATUS_INVALID_DATA_SIZE if the record doesn't exist
+ */
+_nonnull_
+KSRP_Status KSRP_RecordingReader_Get(const KSRP_RecordingReader* reader, uint64_t record, KSRP_TimedFrame* frame);
+
+/**
+ * @brief Start iterating records of a single type with timestamp in range [from, to)
+ *
+ * Records are found through the type index without scanning the other types, in sorted recordings the start of the
+ * range is found with binary search.
+ *
+ * @param reader The reader to query
+ * @param type_id The type ID of the frames, deltas are returned together with frames they patch
+ * @param from The first timestamp of the range
+ * @param to The timestamp after the range, UINT64_MAX for no limit
+ * @param cursor The cursor to initialize
+ */
+_nonnull_
+void KSRP_RecordingReader_Query(const KSRP_RecordingReader* reader, KSRP_TypeID type_id, uint64_t from, uint64_t to,
+                                KSRP_RecordingCursor* cursor);
+
+/**
+ * @brief Read the next record matching the query
+ *
+ * @param cursor The cursor to advance
+ * @param frame The frame read from the record
+ * @return KSRP_Status KSRP_STATUS_OK if a record was read, KSRP_STATUS_ERROR if there are no more records
+ */
+_nonnull_
+KSRP_Status KSRP_RecordingCursor_Next(KSRP_RecordingCursor* cursor, KSRP_TimedFrame* frame);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // KALMAN_PROTOCOL_STATUS_REPORT_HOST_RECORDING_H_
\ No newline at end of file
@@ -0,0 +1,72 @@
+#ifndef KALMAN_PROTOCOL_STATUS_REPORT_HOST_SOCKETCAN_H_
+#define KALMAN_PROTOCOL_STATUS_REPORT_HOST_SOCKETCAN_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ksrp/common.h"
+#include "ksrp/frames.h"
+#include "ksrp/transport.h"
+
+// Every raw data frame is a single CAN frame with 29-bit identifier carrying base ID of the bus, length of the
+// payload and type ID, payload is the raw data after the ID bytes:
+// | base_id (7 bits) | payload length (6 bits) | subsystem_id (8 bits) | frame_id (8 bits) |
+// Payloads up to 8 bytes are sent as classic CAN frames, larger ones as CAN FD frames padded to the nearest valid
+// length. Frames are sent and received in batches of at most KSRP_SOCKETCAN_BATCH_FRAMES with a single system call.
+#define KSRP_SOCKETCAN_MAX_BASE_ID 0x7F
+#define KSRP_SOCKETCAN_MAKE_CAN_ID(base_id, payload_length, type_id) \
+    (((uint32_t)(base_id) << 22) | ((uint32_t)(payload_length) << 16) | (uint32_t)(type_id))
+
+#ifndef KSRP_SOCKETCAN_BATCH_FRAMES
+#define KSRP_SOCKETCAN_BATCH_FRAMES 64
+#endif // KSRP_SOCKETCAN_BATCH_FRAMES
+
+/**
+ * @brief Non-blocking raw CAN socket (i.e. can0 or vcan0) receiving only frames with its base ID
+ */
+typedef struct {
+    int socket;
+    uint8_t base_id;
+    uint32_t dropped;
+} KSRP_SocketCan;
+
+/**
+ * @brief Open a CAN FD socket on an interface and initialize a transport sending and receiving with it
+ *
+ * @param can The socket to open, has to outlive the transport
+ * @param transport The transport to initialize
+ * @param interface Name of the CAN interface, the interface has to support CAN FD for payloads above 8 bytes
+ * @param base_id Base ID of the bus, at most KSRP_SOCKETCAN_MAX_BASE_ID
+ * @return KSRP_Status KSRP_STATUS_OK if opened, KSRP_STATUS_ERROR if the base ID is too large, the interface doesn't
+ * exist or the socket couldn't be opened
+ */
+_nonnull_
+KSRP_Status KSRP_SocketCan_Open(KSRP_SocketCan* can, KSRP_Transport* transport, const char* interface,
+                                uint8_t base_id);
+
+/**
+ * @brief Close the socket, the transport can't be used afterwards
+ *
+ * @param can The socket to close
+ */
+_nonnull_
+void KSRP_SocketCan_Close(KSRP_SocketCan* can);
+
+/**
+ * @brief Get the number of received CAN frames dropped because their length didn't match their identifier
+ *
+ * @param can The socket to read
+ * @return uint32_t Number of dropped CAN frames
+ */
+_nonnull_
+uint32_t KSRP_SocketCan_GetDropped(const KSRP_SocketCan* can);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // KALMAN_PROTOCOL_STATUS_REPORT_HOST_SOCKETCAN_H_
\ No newline at end of file
@@ -0,0 +1,79 @@
+#ifndef KALMAN_PROTOCOL_STATUS_REPORT_HOST_UDP_H_
+#define KALMAN_PROTOCOL_STATUS_REPORT_HOST_UDP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/socket.h>
+
+#include "ksrp/common.h"
+#include "ksrp/frames.h"
+#include "ksrp/transport.h"
+
+// Every raw data frame is a single datagram with the raw data including ID bytes, datagrams are sent and received
+// in batches of at most KSRP_UDP_BATCH_FRAMES with a single system call
+#ifndef KSRP_UDP_BATCH_FRAMES
+#define KSRP_UDP_BATCH_FRAMES 64
+#endif // KSRP_UDP_BATCH_FRAMES
+
+/**
+ * @brief Non-blocking UDP socket bridging raw data frames between hosts, i.e. from a CAN gateway to ground station
+ */
+typedef struct {
+    int socket;
+    struct sockaddr_storage peer;
+    socklen_t peer_length;
+    bool has_peer;
+    bool learn_peer; // Peer is the sender of the most recently received datagram, set when opened without peer_host
+    uint32_t dropped;
+} KSRP_Udp;
+
+/**
+ * @brief Open a UDP socket and initialize a transport sending and receiving with it
+ *
+ * @param udp The socket to open, has to outlive the transport
+ * @param transport The transport to initialize
+ * @param bind_host Local address to bind to, NULL for any address
+ * @param bind_port Local port to bind to, "0" for any port
+ * @param peer_host Address frames are sent to, NULL to send to the sender of the most recently received datagram
+ * @param peer_port Port frames are sent to, ignored when peer_host is NULL
+ * @return KSRP_Status KSRP_STATUS_OK if opened, KSRP_STATUS_ERROR if an address couldn't be resolved or the socket
+ * couldn't be opened
+ */
+KSRP_Status KSRP_Udp_Open(KSRP_Udp* udp, KSRP_Transport* transport, const char* bind_host, const char* bind_port,
+                          const char* peer_host, const char* peer_port);
+
+/**
+ * @brief Close the socket, the transport can't be used afterwards
+ *
+ * @param udp The socket to close
+ */
+_nonnull_
+void KSRP_Udp_Close(KSRP_Udp* udp);
+
+/**
+ * @brief Get the local port the socket is bound to, useful when opened with port "0"
+ *
+ * @param udp The socket to read
+ * @return uint16_t The local port, 0 if it can't be read
+ */
+_nonnull_
+uint16_t KSRP_Udp_GetPort(const KSRP_Udp* udp);
+
+/**
+ * @brief Get the number of received datagrams dropped because they weren't a valid raw data frame
+ *
+ * @param udp The socket to read
+ * @return uint32_t Number of dropped datagrams
+ */
+_nonnull_
+uint32_t KSRP_Udp_GetDropped(const KSRP_Udp* udp);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // KALMAN_PROTOCOL_STATUS_REPORT_HOST_UDP_H_
\ No newline at end of file
@@ -15,23 +15,44 @@ extern "C" {
 // Include user libraries
 #include "ksrp/frames.h"
 #include "ksrp/common.h"
+#include "ksrp/ring.h"
+#include "ksrp/deadline.h"
+#include "ksrp/snapshot.h"
 #include "ksrp/protocols/subsystems/wheels_protocol.h"
 
 /**
  * @brief Instance structure for the wheels subsystem
+ *
+ * Frames and update times are stored per device, indexed by device ID
  */
 typedef struct {
-    KSRP_Wheels_WheelsStatus_Frame wheels_status_instance;
+    KSRP_Wheels_WheelsStatus_Frame wheels_status_instance[KSRP_WHEELS_MAX_DEVICES];
     
-    uint32_t wheels_status_ms_since_last_update;
+    uint32_t wheels_status_last_update_ms[KSRP_WHEELS_MAX_DEVICES];
+    uint32_t now_ms;
     
     KSRP_FrameUpdateCallback wheels_status_callback;
+    
+    uint64_t wheels_status_changed_fields[KSRP_WHEELS_MAX_DEVICES];
+    uint16_t wheels_status_deltas_since_keyframe[KSRP_WHEELS_MAX_DEVICES];
+    
+    KSRP_HealthCheckResult wheels_status_driver_status_health[KSRP_WHEELS_MAX_DEVICES];
+    KSRP_HealthCheckResult wheels_status_temperature_health[KSRP_WHEELS_MAX_DEVICES];
+    KSRP_HealthTransitionCallback wheels_status_health_callback;
+    
+    KSRP_FrameStaleCallback wheels_status_stale_callback;
+    KSRP_DeadlineNode deadline_nodes[1 * KSRP_WHEELS_MAX_DEVICES];
+    KSRP_DeadlineQueue deadline_queues[1];
+
+    KSRP_RawData_Frame rx_queue_frames[KSRP_WHEELS_RX_QUEUE_CAPACITY];
+    KSRP_Ring rx_queue;
 
     KSRP_Status (*send_frame_callback)(KSRP_RawData_Frame* frame);
 } KSRP_Wheels_Instance;
 
 /**
- * @brief Initialize all frames in the instance
+ * @brief Initialize all frames in the instance, deadlines of frames with timeout start at initialization, so frames
+ * never received are reported stale too
  *
  * @param instance The instance to initialize
  * @return KSRP_Status The status of the initialization, KSRP_STATUS_OK if successful
@@ -46,7 +67,8 @@ KSRP_Status KSRP_Init_Wheels_Instance(KSRP_Wheels_Instance* instance);
  * @param frame_id The ID of the frame to update
  * @param frame The new frame data
  * @param frame_size The size of the new frame data
- * @return KSRP_Status The status of the update, KSRP_STATUS_OK if successful
+ * @return KSRP_Status The status of the update, KSRP_STATUS_OK if successful, KSRP_STATUS_INVALID_DEVICE_ID if
+ * device_id of the frame is not lower than KSRP_WHEELS_MAX_DEVICES
  */
 _nonnull_
 KSRP_Status KSRP_UpdateFrame_Wheels_Instance(
@@ -58,6 +80,7 @@ KSRP_Status KSRP_UpdateFrame_Wheels_Instance(
  * @brief Update a field in a frame in the instance
  *
  * @param instance The instance to update
+ * @param device_id The ID of the device which frame is updated
  * @param frame_id The ID of the frame to update
  * @param field_id The ID of the field to update
  * @param value The new field data
@@ -67,11 +90,54 @@ KSRP_Status KSRP_UpdateFrame_Wheels_Instance(
 _nonnull_
 KSRP_Status KSRP_UpdateFrameField_Wheels_Instance(
     KSRP_Wheels_Instance* instance,
+    uint8_t device_id,
     KSRP_Wheels_FrameID frame_id, uint32_t field_id,
     void* value, size_t value_size);
 
 /**
- * @brief Update the time since last update for all frames in the instance
+ * @brief Patch a frame in the instance with a delta, patched frame is applied as with
+ * KSRP_UpdateFrame_Wheels_Instance
+ *
+ * @param instance The instance to update
+ * @param raw_data The delta to apply
+ * @return KSRP_Status The status of the update, KSRP_STATUS_OK if successful
+ */
+_nonnull_
+KSRP_Status KSRP_ApplyDelta_Wheels_Instance(
+    KSRP_Wheels_Instance* instance,
+    const KSRP_RawData_Frame* raw_data);
+
+/**
+ * @brief Queue a received raw data frame for the instance in constant time, frame is applied later by
+ * KSRP_Drain_Wheels_Instance. Safe to call from a single interrupt (producer) while
+ * main loop (consumer) drains the queue, without critical sections
+ *
+ * @param instance The instance to queue the frame for
+ * @param frame The raw data frame, delta or batch to queue
+ * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if successful, KSRP_STATUS_ERROR if the queue is
+ * full and the frame was dropped
+ */
+_nonnull_
+KSRP_Status KSRP_Enqueue_Wheels_Instance(
+    KSRP_Wheels_Instance* instance,
+    const KSRP_RawData_Frame* frame);
+
+/**
+ * @brief Apply frames queued with KSRP_Enqueue_Wheels_Instance to the instance,
+ * frames queued during draining are left for the next call
+ *
+ * @param instance The instance to drain
+ * @param max_frames Maximum number of frames to apply, 0 to apply all queued frames
+ * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if all frames were applied, otherwise status of
+ * the first failed one, remaining frames are still applied
+ */
+_nonnull_
+KSRP_Status KSRP_Drain_Wheels_Instance(
+    KSRP_Wheels_Instance* instance,
+    uint32_t max_frames);
+
+/**
+ * @brief Advance the clock of the instance, stale callbacks of frames which timeout expired are called
  *
  * @param instance The instance to update
  * @param ms_since_last_update Time delta since last update (in ms)
@@ -86,12 +152,14 @@ KSRP_Status KSRP_UpdateTime_Wheels_Instance(
  * @brief Get the time since last update for a frame in the instance
  *
  * @param instance The instance to get the time from
+ * @param device_id The ID of the device to get the time from
  * @param frame_id The ID of the frame to get the time from
  * @return uint32_t The time since the last update (in ms)
  */
 _nonnull_
 uint32_t KSRP_Wheels_Instance_GetTimeSinceLastUpdate(
     KSRP_Wheels_Instance* instance,
+    uint8_t device_id,
     KSRP_Wheels_FrameID frame_id);
 
 /**
@@ -114,7 +182,7 @@ KSRP_Status KSRP_Wheels_Instance_SetSendFrameCallback(
  * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if successful
  */
 _nonnull_
-KSRP_Statu KSRP_Wheels_Instance_SendPing(
+KSRP_Status KSRP_Wheels_Instance_SendPing(
     KSRP_Wheels_Instance* instance);
 
 /**
@@ -131,6 +199,99 @@ KSRP_Status KSRP_Wheels_Instance_SetCallback(
     KSRP_Wheels_FrameID frame_id,
     KSRP_FrameUpdateCallback callback);
 
+/**
+ * @brief Set the stale callback for a frame in the instance, callback is called once when frame isn't updated for its
+ * timeout, frame is watched again after next update
+ *
+ * @param instance The instance to set the callback for
+ * @param frame_id The ID of the frame to set the callback for
+ * @param callback The callback function to set
+ * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if successful, KSRP_STATUS_INVALID_FRAME_TYPE if
+ * frame has no timeout
+ */
+_nonnull_
+KSRP_Status KSRP_Wheels_Instance_SetStaleCallback(
+    KSRP_Wheels_Instance* instance,
+    KSRP_Wheels_FrameID frame_id,
+    KSRP_FrameStaleCallback callback);
+
+/**
+ * @brief Set the health transition callback for a frame in the instance, callback is called only when cached health
+ * check result of a field in the frame changes
+ *
+ * @param instance The instance to set the callback for
+ * @param frame_id The ID of the frame to set the callback for
+ * @param callback The callback function to set
+ * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if successful, KSRP_STATUS_INVALID_FRAME_TYPE if
+ * frame has no health checks
+ */
+_nonnull_
+KSRP_Status KSRP_Wheels_Instance_SetHealthCallback(
+    KSRP_Wheels_Instance* instance,
+    KSRP_Wheels_FrameID frame_id,
+    KSRP_HealthTransitionCallback callback);
+
+/**
+ * @brief Get the cached health check result of a field in the instance, result is updated with every frame update
+ *
+ * @param instance The instance to get the result from
+ * @param device_id The ID of the device to get the result from
+ * @param frame_id The ID of the frame to get the result from
+ * @param field_id The ID of the field to get the result from
+ * @return KSRP_HealthCheckResult The cached result, KSRP_RESULT_UNKNOWN if field has no health checks
+ */
+_nonnull_
+KSRP_HealthCheckResult KSRP_Wheels_Instance_GetHealth(
+    KSRP_Wheels_Instance* instance,
+    uint8_t device_id,
+    KSRP_Wheels_FrameID frame_id, uint32_t field_id);
+
+/// @brief Size of the state of wheels instance in a snapshot section (in bytes): every frame in its
+/// wire layout, time since its last update and its cached health check results
+#define KSRP_WHEELS_SNAPSHOT_STATE_SIZE (KSRP_WHEELS_MAX_DEVICES * (0 \
+    + KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE + sizeof(uint32_t) + 2 \
+))
+
+/// @brief Size of snapshot image of a single wheels instance (in bytes)
+#define KSRP_WHEELS_SNAPSHOT_SIZE \
+    (KSRP_SNAPSHOT_HEADER_BYTES + KSRP_SNAPSHOT_SECTION_HEADER_BYTES + KSRP_WHEELS_SNAPSHOT_STATE_SIZE)
+
+/**
+ * @brief Append state of the instance to a snapshot image as a single section, callbacks, queued frames and transmit
+ * state aren't stored
+ *
+ * @param instance The instance to snapshot
+ * @param index Index of the registry the instance belongs to, 0 for standalone instance
+ * @param writer The writer of the image
+ * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if successful, KSRP_STATUS_INVALID_DATA_SIZE if
+ * the state doesn't fit into the image
+ */
+_nonnull_
+KSRP_Status KSRP_Snapshot_Wheels_Instance(
+    const KSRP_Wheels_Instance* instance,
+    uint32_t index,
+    KSRP_SnapshotWriter* writer);
+
+/**
+ * @brief Restore state of the instance from a snapshot section, frames aren't initialized to their defaults and no
+ * callbacks are called
+ *
+ * Frames, times since their last update (relative to the current time of the instance) and cached health check
+ * results are restored. Callbacks of the instance are kept and frames queued for it are dropped, so the instance may
+ * be zeroed memory. Frames older than their timeout are reported stale again by the next time update.
+ *
+ * @param instance The instance to restore
+ * @param section The section read by KSRP_SnapshotReader_Next
+ * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if successful. On failure the instance is left
+ * untouched: KSRP_STATUS_INVALID_FRAME_TYPE if the section belongs to another subsystem, KSRP_STATUS_ERROR if it was
+ * written with different definition, KSRP_STATUS_INVALID_DATA_SIZE if it has wrong size, otherwise status of the
+ * first frame which couldn't be unpacked
+ */
+_nonnull_
+KSRP_Status KSRP_Restore_Wheels_Instance(
+    KSRP_Wheels_Instance* instance,
+    const KSRP_SnapshotSection* section);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
@@ -19,6 +19,9 @@ typedef enum {
     KSRP_WHEELS_SUBSYSTEM_ID = 1,
 } KSRP_SubsystemID;
 
+// Size of the largest frame sent in segments, KSRP_SEGMENTED_MAX_SIZE has to be at least that large to receive it
+#define KSRP_SEGMENTED_MAX_WIRE_SIZE 0
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
@@ -0,0 +1,9 @@
+#ifndef KALMAN_STATUS_REPORT_PROTOCOL_HASH_H_
+#define KALMAN_STATUS_REPORT_PROTOCOL_HASH_H_
+
+// Kept apart from other headers, as it changes with every edit of protocol definitions and would rebuild all of them
+
+/// @brief Hash of all protocol definitions, stored in recordings to detect frames of different definitions
+#define KSRP_PROTOCOL_HASH 0x97EA15EEC50DCF60ULL
+
+#endif // KALMAN_STATUS_REPORT_PROTOCOL_HASH_H_
\ No newline at end of file
@@ -0,0 +1,164 @@
+/**
+ * @file protocol_registry.h
+ * @brief Registry laying out instances of all subsystems in a single arena
+ */
+#ifndef KALMAN_STATUS_REPORT_REGISTRY_H_
+#define KALMAN_STATUS_REPORT_REGISTRY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+// Include standard libraries
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Include user libraries
+#include "ksrp/frames.h"
+#include "ksrp/common.h"
+#include "ksrp/snapshot.h"
+#include "ksrp/protocols/protocol_common.h"
+#include "ksrp/instances/wheels_instance.h"
+
+/**
+ * @brief Instances of all subsystems of a single vehicle, laid out contiguously
+ *
+ * Registry of a fleet is an array of registries, so instances of all vehicles form a single block that operations
+ * below iterate linearly.
+ */
+typedef struct {
+    KSRP_Wheels_Instance wheels;
+} KSRP_Registry;
+
+/**
+ * @brief Initialize instances of all subsystems in the registries
+ *
+ * @param registries The registries to initialize
+ * @param count Number of registries
+ * @return KSRP_Status KSRP_STATUS_OK if all instances were initialized, otherwise status of the first failed one
+ */
+_nonnull_
+KSRP_Status KSRP_Registry_Init(KSRP_Registry* registries, uint32_t count);
+
+/**
+ * @brief Look up the instance of a subsystem in constant time
+ *
+ * @param registry The registry to look up in
+ * @param subsystem_id The ID of the subsystem
+ * @return void* The instance of the subsystem, NULL if the subsystem is unknown
+ */
+_nonnull_
+void* KSRP_Registry_GetInstance(KSRP_Registry* registry, uint32_t subsystem_id);
+
+/**
+ * @brief Look up the instance of the subsystem a type ID belongs to in constant time
+ *
+ * @param registry The registry to look up in
+ * @param type_id The type ID of a frame
+ * @return void* The instance of the subsystem, NULL if the subsystem is unknown
+ */
+_nonnull_
+void* KSRP_Registry_GetInstanceByTypeID(KSRP_Registry* registry, KSRP_TypeID type_id);
+
+/**
+ * @brief Pass a received frame to the instance of its subsystem, deltas go to the subsystem of the frame they patch
+ * and batches are split into sub-frames. Subsystems with rx_queue_capacity queue the frame until
+ * KSRP_Registry_Drain, other subsystems apply it immediately
+ *
+ * @param registry The registry of the vehicle that sent the frame
+ * @param frame The raw data frame, delta or batch
+ * @return KSRP_Status KSRP_STATUS_OK if the frame was queued or applied, KSRP_STATUS_INVALID_FRAME_TYPE if the
+ * subsystem is unknown, otherwise status of the queue or the update, for batches status of the first failed sub-frame
+ */
+_nonnull_
+KSRP_Status KSRP_Registry_Receive(KSRP_Registry* registry, const KSRP_RawData_Frame* frame);
+
+/**
+ * @brief Advance the clock of all instances in the registries, stale callbacks of frames which timeout expired are
+ * called
+ *
+ * @param registries The registries to update
+ * @param count Number of registries
+ * @param ms_since_last_update Time delta since last update (in ms)
+ * @return KSRP_Status KSRP_STATUS_OK if all instances were updated, otherwise status of the first failed one,
+ * remaining instances are still updated
+ */
+_nonnull_
+KSRP_Status KSRP_Registry_Tick(KSRP_Registry* registries, uint32_t count, uint32_t ms_since_last_update);
+
+/**
+ * @brief Apply all frames queued for instances with rx_queue_capacity in the registries
+ *
+ * @param registries The registries to drain
+ * @param count Number of registries
+ * @return KSRP_Status KSRP_STATUS_OK if all frames were applied, otherwise status of the first failed one,
+ * remaining frames are still applied
+ */
+_nonnull_
+KSRP_Status KSRP_Registry_Drain(KSRP_Registry* registries, uint32_t count);
+
+/**
+ * @brief Send frames changed since the last flush of all instances with deferred_transmit in the registries
+ *
+ * @param registries The registries to flush
+ * @param count Number of registries
+ * @return KSRP_Status KSRP_STATUS_OK if all instances were flushed, otherwise status of the first failed one,
+ * remaining instances are still flushed
+ */
+_nonnull_
+KSRP_Status KSRP_Registry_Flush(KSRP_Registry* registries, uint32_t count);
+
+/**
+ * @brief Set the send frame callback of all instances in the registries
+ *
+ * @param registries The registries to update
+ * @param count Number of registries
+ * @param send_frame_callback The callback sending frames of all instances
+ * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if successful
+ */
+_nonnull_
+KSRP_Status KSRP_Registry_SetSendFrameCallback(KSRP_Registry* registries, uint32_t count,
+                                               KSRP_Status (*send_frame_callback)(KSRP_RawData_Frame* frame));
+
+/// @brief Size of snapshot image of count registries (in bytes)
+#define KSRP_REGISTRY_SNAPSHOT_SIZE(count) (KSRP_SNAPSHOT_HEADER_BYTES + (size_t)(count) * (0 \
+    + KSRP_SNAPSHOT_SECTION_HEADER_BYTES + KSRP_WHEELS_SNAPSHOT_STATE_SIZE \
+))
+
+/**
+ * @brief Write state of all instances in the registries into a snapshot image, every instance is stored in its own
+ * section tagged with the index of its registry
+ *
+ * @param registries The registries to snapshot
+ * @param count Number of registries
+ * @param buffer The buffer to write the image into, KSRP_REGISTRY_SNAPSHOT_SIZE(count) bytes are enough
+ * @param capacity Size of the buffer
+ * @param length Size of the written image
+ * @return KSRP_Status KSRP_STATUS_OK if successful, KSRP_STATUS_INVALID_DATA_SIZE if the image doesn't fit into the
+ * buffer
+ */
+_nonnull_
+KSRP_Status KSRP_Registry_Snapshot(const KSRP_Registry* registries, uint32_t count, uint8_t* buffer, size_t capacity,
+                                   size_t* length);
+
+/**
+ * @brief Restore instances in the registries from a snapshot image without initializing frames to their defaults,
+ * see restore of single instances. Instances without a section in the image are left untouched
+ *
+ * @param registries The registries to restore
+ * @param count Number of registries
+ * @param buffer The image written by KSRP_Registry_Snapshot
+ * @param length Size of the image
+ * @return KSRP_Status KSRP_STATUS_OK if all sections were restored, status of the image header if it's invalid,
+ * otherwise status of the first section which couldn't be restored (KSRP_STATUS_INVALID_FRAME_TYPE for unknown
+ * subsystem or registry index out of range), remaining sections are still restored
+ */
+_nonnull_
+KSRP_Status KSRP_Registry_Restore(KSRP_Registry* registries, uint32_t count, const uint8_t* buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // KALMAN_STATUS_REPORT_REGISTRY_H_
\ No newline at end of file
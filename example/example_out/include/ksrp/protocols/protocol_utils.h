@@ -16,7 +16,12 @@ extern "C" {
 // Include user libraries
 #include "ksrp/frames.h"
 #include "ksrp/common.h"
+#include "ksrp/batch.h"
+#include "ksrp/delta.h"
+#include "ksrp/segments.h"
+#include "ksrp/transport.h"
 #include "ksrp/protocols/subsystems/wheels_protocol.h"
+#include "ksrp/instances/wheels_instance.h"
 
 /**
  * @brief Verify the type ID of a frame
@@ -26,6 +31,137 @@ extern "C" {
  */
 KSRP_TypeID KSRP_VerifyTypeID(const KSRP_RawData_Frame* frame);
 
+/////////////////////////////////////////////////////////////////////////////////
+/// Frame Dispatch
+/////////////////////////////////////////////////////////////////////////////////
+/**
+ * @brief Handler unpacking a raw data frame of one type into its registered instance
+ */
+typedef KSRP_Status (*KSRP_DispatchHandler)(const KSRP_RawData_Frame* raw_data);
+
+/**
+ * @brief Register the wheels instance that received frames are dispatched into
+ *
+ * @param instance The instance to dispatch into, NULL to stop dispatching wheels frames
+ * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if successful
+ */
+KSRP_Status KSRP_Dispatch_Register_Wheels_Instance(
+    KSRP_Wheels_Instance* instance);
+
+/**
+ * @brief Look up the handler for a type ID in the dispatch table
+ *
+ * @param type_id The type ID to look up
+ * @return KSRP_DispatchHandler The handler for the type ID, NULL if the type ID is unknown
+ */
+KSRP_DispatchHandler KSRP_Dispatch_GetHandler(KSRP_TypeID type_id);
+
+/**
+ * @brief Unpack a raw data frame and update the registered instance of its subsystem, deltas are applied to the
+ * current frame of the instance
+ *
+ * Lookup is done in constant time through tables indexed by subsystem ID and frame ID bytes.
+ *
+ * @param frame The raw data frame to dispatch
+ * @return KSRP_Status KSRP_STATUS_OK if the frame was dispatched, KSRP_STATUS_INVALID_FRAME_TYPE if the type ID
+ * is unknown, KSRP_STATUS_ERROR if no instance is registered for the subsystem
+ */
+_nonnull_
+KSRP_Status KSRP_Dispatch(const KSRP_RawData_Frame* frame);
+
+/**
+ * @brief Dispatch every sub-frame of a batch, frames that are not batches are dispatched directly
+ *
+ * @param frame The batch or raw data frame to dispatch
+ * @return KSRP_Status KSRP_STATUS_OK if all sub-frames were dispatched, otherwise status of the first failed one,
+ * remaining sub-frames are still dispatched
+ */
+_nonnull_
+KSRP_Status KSRP_DispatchBatch(const KSRP_RawData_Frame* frame);
+
+/**
+ * @brief Unpack a reassembled segmented frame in place and update the registered instance of its subsystem
+ *
+ * @param payload The payload completed by KSRP_Reassembler_Push
+ * @return KSRP_Status KSRP_STATUS_OK if the frame was dispatched, KSRP_STATUS_INVALID_FRAME_TYPE if the type ID
+ * is not a segmented frame, KSRP_STATUS_ERROR if no instance is registered for the subsystem
+ */
+_nonnull_
+KSRP_Status KSRP_DispatchSegmented(const KSRP_SegmentedPayload* payload);
+
+/**
+ * @brief Add a segment to the reassembler and dispatch the frame once all its segments are received, frames that
+ * are not segments are dispatched with KSRP_DispatchBatch
+ *
+ * @param reassembler The reassembler collecting segments
+ * @param frame The segment or raw data frame to dispatch
+ * @param now_ms Current time (in ms), used to evict incomplete frames
+ * @return KSRP_Status KSRP_STATUS_OK if the segment was added or the frame was dispatched, otherwise status of the
+ * reassembly or the dispatch
+ */
+_nonnull_
+KSRP_Status KSRP_DispatchSegment(KSRP_Reassembler* reassembler, const KSRP_RawData_Frame* frame, uint32_t now_ms);
+
+/**
+ * @brief Receive every frame already available on the transport and dispatch it with KSRP_DispatchSegment
+ *
+ * Frames are received in batches of KSRP_TRANSPORT_RX_CAPACITY, all received frames are dispatched even when some
+ * of them fail.
+ *
+ * @param transport The transport to receive from
+ * @param reassembler The reassembler collecting segments
+ * @param now_ms Current time (in ms), used to evict incomplete frames
+ * @param received Number of received frames
+ * @return KSRP_Status KSRP_STATUS_OK if all received frames were dispatched, KSRP_STATUS_ERROR on failure of the
+ * transport, otherwise status of the first failed dispatch
+ */
+_nonnull_
+KSRP_Status KSRP_DispatchTransport(KSRP_Transport* transport, KSRP_Reassembler* reassembler, uint32_t now_ms,
+                                   uint32_t* received);
+
+/////////////////////////////////////////////////////////////////////////////////
+/// Frame Decoding
+/////////////////////////////////////////////////////////////////////////////////
+/**
+ * @brief Frame of any subsystem unpacked by KSRP_Decode, deltas and batches are kept as raw data frames. Segmented
+ * frames are received only through KSRP_DispatchSegment, so they aren't part of it
+ */
+typedef struct {
+    KSRP_TypeID type_id;
+    KSRP_HealthCheckResult health;
+    uint64_t failing_fields;
+    union {
+        KSRP_RawData_Frame raw;
+        KSRP_Wheels_WheelsStatus_Frame wheels_wheels_status;
+    } frame;
+} KSRP_DecodedFrame;
+
+/**
+ * @brief Unpack a raw data frame and evaluate all its health checks without touching any instance
+ *
+ * Decoding doesn't depend on any state, so frames can be decoded concurrently (i.e. on worker threads of
+ * KSRP_Pipeline_Run) and applied later in order with KSRP_DispatchDecoded. Deltas depend on the current frame of
+ * the instance, so deltas and batches are only copied.
+ *
+ * @param frame The raw data frame to decode
+ * @param decoded The decoded frame, health is KSRP_RESULT_UNKNOWN for frames without health checks
+ * @return KSRP_Status KSRP_STATUS_OK if the frame was decoded, KSRP_STATUS_INVALID_FRAME_TYPE if the type ID is
+ * unknown, otherwise status of the unpacking
+ */
+_nonnull_
+KSRP_Status KSRP_Decode(const KSRP_RawData_Frame* frame, KSRP_DecodedFrame* decoded);
+
+/**
+ * @brief Update the registered instance of the subsystem with a decoded frame, deltas and batches are dispatched
+ * with KSRP_DispatchBatch
+ *
+ * @param decoded The frame decoded with KSRP_Decode
+ * @return KSRP_Status KSRP_STATUS_OK if the frame was dispatched, KSRP_STATUS_INVALID_FRAME_TYPE if the type ID
+ * is unknown, KSRP_STATUS_ERROR if no instance is registered for the subsystem
+ */
+_nonnull_
+KSRP_Status KSRP_DispatchDecoded(const KSRP_DecodedFrame* decoded);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
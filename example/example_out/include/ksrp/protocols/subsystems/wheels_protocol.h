@@ -17,6 +17,11 @@ extern "C" {
 // Include user libraries
 #include "ksrp/frames.h"
 #include "ksrp/common.h"
+#include "ksrp/delta.h"
+#include "ksrp/segments.h"
+#include "ksrp/descriptor.h"
+#include "ksrp/columns.h"
+#include "ksrp/health_batch.h"
 #include "ksrp/protocols/protocol_common.h"
 
 // Enum for all frame IDs in given subsystem
@@ -25,6 +30,18 @@ typedef enum {
     KSRP_WHEELS_WHEELS_STATUS_FRAME_ID = 12,
 } KSRP_Wheels_FrameID;
 
+/// @brief Hash of wheels definition, snapshots of its instance are restored only with the same definition
+#define KSRP_WHEELS_DEFINITION_HASH 0xE237AFD3037D7F26ULL
+
+/// @brief Number of devices tracked by wheels instance, device IDs must be lower than that
+#define KSRP_WHEELS_MAX_DEVICES 4
+
+/// @brief Number of deltas sent between two full frames of wheels subsystem
+#define KSRP_WHEELS_KEYFRAME_INTERVAL 16
+
+/// @brief Number of received frames that can wait in wheels instance queue, power of two
+#define KSRP_WHEELS_RX_QUEUE_CAPACITY 16
+
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// WheelsStatus Frame
@@ -34,24 +51,20 @@ typedef enum {
  */
 
 /**
- * @brief Health check value mappings for results in WheelsStatus frame
+ * @brief Health check value mappings for results of driver_status in WheelsStatus frame
  */
-typedef enum {
-    KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_HEALTH_CHECK_OK_1 = 0,
-    KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_HEALTH_CHECK_CRITICAL_2 = 255,
-} KSRP_Wheels_WheelsStatus_DriverStatus_HealthCheck;
+#define KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_HEALTH_CHECK_OK_1 (0)
+#define KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_HEALTH_CHECK_CRITICAL_2 (255)
 
 /**
- * @brief Health check value mappings for results in WheelsStatus frame
+ * @brief Health check value mappings for results of temperature in WheelsStatus frame
  */
-typedef enum {       
-    KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_OK_1_MIN = 0,
-    KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_OK_1_MAX = 100,       
-    KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_WARNING_2_MIN = 100,
-    KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_WARNING_2_MAX = 200,       
-    KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_CRITICAL_3_MIN = 200,
-    KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_CRITICAL_3_MAX = 300,
-} KSRP_Wheels_WheelsStatus_Temperature_HealthCheck;
+#define KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_OK_1_MIN (0)
+#define KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_OK_1_MAX (100)
+#define KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_WARNING_2_MIN (100)
+#define KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_WARNING_2_MAX (200)
+#define KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_CRITICAL_3_MIN (200)
+#define KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_CRITICAL_3_MAX (300)
 
 
 /**
@@ -106,6 +119,20 @@ typedef struct _packed_ {
     KSRP_Wheels_WheelsStatus_Testbool_TypeDef testbool;
 } KSRP_Wheels_WheelsStatus_Frame;
 
+/**
+ * @brief Columns of up to KSRP_COLUMNS_CAPACITY WheelsStatus frames, every field is stored in its
+ * own contiguous array aligned to KSRP_COLUMN_ALIGNMENT, too large for stack so allocate it statically or on heap
+ */
+typedef struct {
+    uint32_t count;
+    _column_ uint8_t device_id[KSRP_COLUMNS_CAPACITY];
+    _column_ uint8_t driver_status[KSRP_COLUMNS_CAPACITY];
+    _column_ float temperature[KSRP_COLUMNS_CAPACITY];
+    _column_ KSRP_Wheels_WheelsStatus_AlgorithmType_TypeDef algorithm_type[KSRP_COLUMNS_CAPACITY];
+    _column_ KSRP_Wheels_WheelsStatus_AlgorithmType2_TypeDef algorithm_type2[KSRP_COLUMNS_CAPACITY];
+    _column_ KSRP_Wheels_WheelsStatus_Testbool_TypeDef testbool[KSRP_COLUMNS_CAPACITY];
+} KSRP_Wheels_WheelsStatus_Columns;
+
 /// @brief Type ID for WheelsStatus frame
 #define KSRP_WHEELS_WHEELS_STATUS_TYPE_ID ( \
     KSRP_MAKE_TYPE_ID(KSRP_WHEELS_SUBSYSTEM_ID, \
@@ -130,6 +157,12 @@ bool KSRP_IsRawDataInstanceof_Wheels_WheelsStatus(const KSRP_RawData_Frame* raw_
 /// @brief Size of WheelsStatus frame
 #define KSRP_WHEELS_WHEELS_STATUS_FRAME_SIZE sizeof(KSRP_Wheels_WheelsStatus_Frame)
 
+/// @brief Size of serialized WheelsStatus frame without type ID
+#define KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE 9
+
+/// @brief Time without update after which WheelsStatus frame is reported as stale (in ms)
+#define KSRP_WHEELS_WHEELS_STATUS_TIMEOUT_MS 100
+
 /**
  * @brief Enum with field IDs for WheelsStatus frame
  */
@@ -142,6 +175,11 @@ typedef enum {
     KSRP_WHEELS_WHEELS_STATUS_TESTBOOL_FIELD_ID,
 } KSRP_Wheels_WheelsStatus_FieldID;
 
+/// @brief Number of fields in WheelsStatus frame
+#define KSRP_WHEELS_WHEELS_STATUS_FIELDS_COUNT 6
+/// @brief Size of changed fields mask in delta of WheelsStatus frame
+#define KSRP_WHEELS_WHEELS_STATUS_DELTA_MASK_BYTES KSRP_DELTA_MASK_BYTES(KSRP_WHEELS_WHEELS_STATUS_FIELDS_COUNT)
+
 /////////////////////////////////////////////////////////////////////////////////
 /// WheelsStatus Frame Construction
 /////////////////////////////////////////////////////////////////////////////////
@@ -164,6 +202,18 @@ KSRP_Status KSRP_Init_Wheels_WheelsStatus_Frame(KSRP_Wheels_WheelsStatus_Frame*
 _nonnull_
 KSRP_Status KSRP_Unpack_Wheels_WheelsStatus(const KSRP_RawData_Frame* raw_data, KSRP_Wheels_WheelsStatus_Frame* frame);
 
+/**
+ * @brief Deserialize raw data frames of WHEELS_STATUS frame directly into columns
+ *
+ * @param raw_data The raw data frames to unpack
+ * @param count The number of raw data frames, at most KSRP_COLUMNS_CAPACITY
+ * @param columns The columns to unpack into, left untouched if any of the raw data frames is invalid
+ * @return KSRP_Status KSRP_STATUS_OK if all frames were unpacked successfully
+ */
+_nonnull_
+KSRP_Status KSRP_UnpackBatch_Wheels_WheelsStatus(const KSRP_RawData_Frame* raw_data, uint32_t count,
+    KSRP_Wheels_WheelsStatus_Columns* columns);
+
 /**
  * @brief Serialize a WHEELS_STATUS frame into a raw data frame
  *
@@ -174,6 +224,41 @@ KSRP_Status KSRP_Unpack_Wheels_WheelsStatus(const KSRP_RawData_Frame* raw_data,
 _nonnull_
 KSRP_Status KSRP_Pack_Wheels_WheelsStatus(const KSRP_Wheels_WheelsStatus_Frame* frame, KSRP_RawData_Frame* raw_data);
 
+/**
+ * @brief Serialize changed fields of a WHEELS_STATUS frame into a delta
+ *
+ * Device ID is always encoded, so receiver can find the frame to patch
+ *
+ * @param frame The frame to pack
+ * @param changed_fields Bitmask of fields to pack, bit number is field ID
+ * @param raw_data The raw data frame to pack into
+ * @return KSRP_Status KSRP_STATUS_OK if the delta was packed successfully, KSRP_STATUS_INVALID_DATA_SIZE if changed
+ * fields don't fit into raw data frame
+ */
+_nonnull_
+KSRP_Status KSRP_PackDelta_Wheels_WheelsStatus(const KSRP_Wheels_WheelsStatus_Frame* frame, uint64_t changed_fields,
+    KSRP_RawData_Frame* raw_data);
+
+/**
+ * @brief Patch a WHEELS_STATUS frame in place with fields encoded in a delta
+ *
+ * @param raw_data The delta to apply
+ * @param frame The frame to patch, left untouched if the delta is invalid
+ * @return KSRP_Status KSRP_STATUS_OK if the delta was applied successfully
+ */
+_nonnull_
+KSRP_Status KSRP_ApplyDelta_Wheels_WheelsStatus(const KSRP_RawData_Frame* raw_data, KSRP_Wheels_WheelsStatus_Frame* frame);
+
+/**
+ * @brief Get the device ID encoded in a delta of WHEELS_STATUS frame
+ *
+ * @param raw_data The delta to read
+ * @param device_id The device ID read from the delta
+ * @return KSRP_Status KSRP_STATUS_OK if the device ID was read successfully
+ */
+_nonnull_
+KSRP_Status KSRP_GetDeltaDeviceID_Wheels_WheelsStatus(const KSRP_RawData_Frame* raw_data, uint8_t* device_id);
+
 /**
  * @brief Compare two WHEELS_STATUS frames
  *
@@ -311,6 +396,25 @@ bool KSRP_Get_Wheels_WheelsStatus_Testbool(const KSRP_Wheels_WheelsStatus_Frame*
 _nonnull_
 KSRP_HealthCheckResult KSRP_HealthCheckResult_Wheels_WheelsStatus_DriverStatus(const KSRP_Wheels_WheelsStatus_Frame* frame);
 
+/**
+ * @brief Perform health check on a value of driver_status in WHEELS_STATUS frame
+ *
+ * @param value The value to check
+ * @return KSRP_HealthCheckResult The result of the health check
+ */
+KSRP_HealthCheckResult KSRP_HealthCheckResultOfValue_Wheels_WheelsStatus_DriverStatus(uint8_t value);
+
+/**
+ * @brief Perform health check on a column of driver_status values in WHEELS_STATUS frame
+ *
+ * @param values The values to check, e.g. driver_status column of KSRP_Wheels_WheelsStatus_Columns
+ * @param count The number of values
+ * @param results The results of the health checks, one for every value
+ */
+_nonnull_
+void KSRP_HealthCheckResultBatch_Wheels_WheelsStatus_DriverStatus(const uint8_t* values,
+    uint32_t count, KSRP_HealthCheckResult* results);
+
 /**
  * @brief Perform health check on temperature in WHEELS_STATUS frame
  *
@@ -320,6 +424,25 @@ KSRP_HealthCheckResult KSRP_HealthCheckResult_Wheels_WheelsStatus_DriverStatus(c
 _nonnull_
 KSRP_HealthCheckResult KSRP_HealthCheckResult_Wheels_WheelsStatus_Temperature(const KSRP_Wheels_WheelsStatus_Frame* frame);
 
+/**
+ * @brief Perform health check on a value of temperature in WHEELS_STATUS frame
+ *
+ * @param value The value to check
+ * @return KSRP_HealthCheckResult The result of the health check
+ */
+KSRP_HealthCheckResult KSRP_HealthCheckResultOfValue_Wheels_WheelsStatus_Temperature(float value);
+
+/**
+ * @brief Perform health check on a column of temperature values in WHEELS_STATUS frame
+ *
+ * @param values The values to check, e.g. temperature column of KSRP_Wheels_WheelsStatus_Columns
+ * @param count The number of values
+ * @param results The results of the health checks, one for every value
+ */
+_nonnull_
+void KSRP_HealthCheckResultBatch_Wheels_WheelsStatus_Temperature(const float* values,
+    uint32_t count, KSRP_HealthCheckResult* results);
+
 /**
  * @brief Get the troubleshooting description for the health check on driver_status in WHEELS_STATUS frame
  *
@@ -355,6 +478,19 @@ const char* KSRP_HealthCheckDescription_Wheels_WheelsStatus_DriverStatus(const K
  */
 _nonnull_
 const char* KSRP_HealthCheckDescription_Wheels_WheelsStatus_Temperature(const KSRP_Wheels_WheelsStatus_Frame* frame);
+
+
+/**
+ * @brief Perform all health checks of WHEELS_STATUS frame in a single pass
+ *
+ * @param frame The frame to check
+ * @param failing_fields Bitmask of fields which result is not KSRP_RESULT_OK, bit number is field ID
+ * @return KSRP_HealthCheckResult The worst result of all checked fields, ordered from best: OK, UNKNOWN, WARNING,
+ * CRITICAL
+ */
+_nonnull_
+KSRP_HealthCheckResult KSRP_HealthCheck_Wheels_WheelsStatus_All(const KSRP_Wheels_WheelsStatus_Frame* frame, uint64_t* failing_fields);
+
 /**
  * @}
  */
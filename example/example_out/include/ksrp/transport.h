@@ -0,0 +1,165 @@
+#ifndef KALMAN_PROTOCOL_STATUS_REPORT_TRANSPORT_H_
+#define KALMAN_PROTOCOL_STATUS_REPORT_TRANSPORT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ksrp/common.h"
+#include "ksrp/frames.h"
+#include "ksrp/ring.h"
+
+// Frames queued by KSRP_Transport_Queue before they are sent in a single vectored send
+#ifndef KSRP_TRANSPORT_TX_CAPACITY
+#define KSRP_TRANSPORT_TX_CAPACITY 32
+#endif // KSRP_TRANSPORT_TX_CAPACITY
+
+// Frames received by a single call of the generated KSRP_DispatchTransport
+#ifndef KSRP_TRANSPORT_RX_CAPACITY
+#define KSRP_TRANSPORT_RX_CAPACITY 32
+#endif // KSRP_TRANSPORT_RX_CAPACITY
+
+/**
+ * @brief Operations of a transport backend, every raw data frame is sent as a single datagram or bus frame
+ */
+typedef struct {
+    /**
+     * @brief Send frames in order, stop at the first frame the backend can't accept now
+     *
+     * @return KSRP_STATUS_OK if all frames were sent, KSRP_STATUS_BUSY if only sent frames were, KSRP_STATUS_ERROR
+     * on failure of the backend
+     */
+    KSRP_Status (*send)(void* backend, const KSRP_RawData_Frame* frames, uint32_t count, uint32_t* sent);
+
+    /**
+     * @brief Receive frames already available without blocking
+     *
+     * @return KSRP_STATUS_OK also when no frame was available, KSRP_STATUS_ERROR on failure of the backend
+     */
+    KSRP_Status (*receive)(void* backend, KSRP_RawData_Frame* frames, uint32_t capacity, uint32_t* received);
+
+    /**
+     * @brief Wait until frames can be received, NULL for backends without a way to tell
+     *
+     * @return KSRP_STATUS_OK if frames can be received, KSRP_STATUS_BUSY on timeout, KSRP_STATUS_ERROR on failure
+     */
+    KSRP_Status (*wait)(void* backend, uint32_t timeout_ms);
+} KSRP_TransportOps;
+
+/**
+ * @brief Transport backend with a queue of frames waiting to be sent
+ */
+typedef struct {
+    const KSRP_TransportOps* ops;
+    void* backend;
+    KSRP_RawData_Frame queue[KSRP_TRANSPORT_TX_CAPACITY];
+    uint32_t queued;
+} KSRP_Transport;
+
+/**
+ * @brief Initialize a transport with empty queue
+ *
+ * @param transport The transport to initialize
+ * @param ops Operations of the backend, has to outlive the transport
+ * @param backend State of the backend passed to the operations, has to outlive the transport
+ */
+_nonnull_
+void KSRP_Transport_Init(KSRP_Transport* transport, const KSRP_TransportOps* ops, void* backend);
+
+/**
+ * @brief Send frames directly in a single vectored send, bypassing the queue
+ *
+ * @param transport The transport to send with
+ * @param frames The frames to send
+ * @param count Number of frames to send
+ * @param sent Number of frames that were sent, the rest should be sent again later
+ * @return KSRP_Status KSRP_STATUS_OK if all frames were sent, KSRP_STATUS_BUSY if the backend accepted only some of
+ * them, KSRP_STATUS_ERROR on failure of the backend
+ */
+_nonnull_
+KSRP_Status KSRP_Transport_Send(KSRP_Transport* transport, const KSRP_RawData_Frame* frames, uint32_t count,
+                                uint32_t* sent);
+
+/**
+ * @brief Queue a frame to be sent by the next KSRP_Transport_Flush, flush first if the queue is full
+ *
+ * Meant to be called from the send frame callback of instances, so every frame sent during a periodic call goes
+ * out in a single vectored send.
+ *
+ * @param transport The transport to queue to
+ * @param frame The frame to queue, it is copied
+ * @return KSRP_Status KSRP_STATUS_OK if the frame was queued, KSRP_STATUS_INVALID_DATA_SIZE if the frame is too
+ * large, KSRP_STATUS_BUSY if the queue is full and the backend doesn't accept more frames, KSRP_STATUS_ERROR on
+ * failure of the backend
+ */
+_nonnull_
+KSRP_Status KSRP_Transport_Queue(KSRP_Transport* transport, const KSRP_RawData_Frame* frame);
+
+/**
+ * @brief Send queued frames in a single vectored send, frames the backend didn't accept stay queued
+ *
+ * @param transport The transport to flush
+ * @return KSRP_Status KSRP_STATUS_OK if the queue is empty, KSRP_STATUS_BUSY if some frames stay queued,
+ * KSRP_STATUS_ERROR on failure of the backend
+ */
+_nonnull_
+KSRP_Status KSRP_Transport_Flush(KSRP_Transport* transport);
+
+/**
+ * @brief Get the number of frames waiting in the queue
+ *
+ * @param transport The transport to read
+ * @return uint32_t Number of queued frames
+ */
+_nonnull_
+uint32_t KSRP_Transport_GetQueued(const KSRP_Transport* transport);
+
+/**
+ * @brief Receive frames already available without blocking
+ *
+ * @param transport The transport to receive from
+ * @param frames Storage of received frames
+ * @param capacity Number of frames that fit the storage
+ * @param received Number of received frames
+ * @return KSRP_Status KSRP_STATUS_OK also when no frame was available, KSRP_STATUS_ERROR on failure of the backend
+ */
+_nonnull_
+KSRP_Status KSRP_Transport_Receive(KSRP_Transport* transport, KSRP_RawData_Frame* frames, uint32_t capacity,
+                                   uint32_t* received);
+
+/**
+ * @brief Wait until frames can be received
+ *
+ * @param transport The transport to wait for
+ * @param timeout_ms Longest time to wait (in ms)
+ * @return KSRP_Status KSRP_STATUS_OK if frames can be received, KSRP_STATUS_BUSY on timeout or when the backend
+ * has no way to tell, KSRP_STATUS_ERROR on failure of the backend
+ */
+_nonnull_
+KSRP_Status KSRP_Transport_Wait(KSRP_Transport* transport, uint32_t timeout_ms);
+
+/**
+ * @brief Open an in-memory transport, frames sent with it are received from it in the same order
+ *
+ * Backpressure is applied when the ring is full, so no frame is dropped. Sending and receiving may happen on two
+ * different threads, each of them only from one. Waiting doesn't block, it only checks if the ring is empty.
+ *
+ * @param transport The transport to initialize
+ * @param ring The ring holding frames in flight, has to outlive the transport
+ * @param frames Storage of the ring, has to outlive the transport
+ * @param capacity Number of frames that fit the storage, power of two
+ * @return KSRP_Status KSRP_STATUS_OK if opened, KSRP_STATUS_INVALID_DATA_SIZE if capacity isn't a power of two
+ */
+_nonnull_
+KSRP_Status KSRP_Loopback_Open(KSRP_Transport* transport, KSRP_Ring* ring, KSRP_RawData_Frame* frames,
+                               uint32_t capacity);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // KALMAN_PROTOCOL_STATUS_REPORT_TRANSPORT_H_
\ No newline at end of file
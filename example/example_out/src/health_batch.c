@@ -0,0 +1,297 @@
+#include "ksrp/health_batch.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Portable evaluation, also used for values left after vectorized blocks
+#define KSRP_HEALTH_CHECK_BATCH_SCALAR(name, type)                                                                    \
+    static void ksrp_health_check_batch_scalar_##name(const type* values, uint32_t count,                             \
+                                                      const KSRP_HealthCheckSteps_##name* steps,                      \
+                                                      KSRP_HealthCheckResult* results) {                              \
+        for (uint32_t i = 0; i < count; i++) {                                                                        \
+            const type value = values[i];                                                                             \
+            uint8_t result = KSRP_RESULT_UNKNOWN;                                                                     \
+            /* Bounds are sorted, so no bound after the first greater one matches, NaN matches none */                \
+            for (uint32_t step = 0; step < steps->bounds_count && value >= steps->bounds[step]; step++) {             \
+                result = steps->bound_results[step];                                                                  \
+            }                                                                                                         \
+            for (uint32_t step = 0; step < steps->points_count; step++) {                                             \
+                if (value == steps->points[step]) {                                                                   \
+                    result = steps->point_results[step];                                                              \
+                }                                                                                                     \
+            }                                                                                                         \
+            results[i] = (KSRP_HealthCheckResult)result;                                                              \
+        }                                                                                                             \
+    }
+
+KSRP_HEALTH_CHECK_BATCH_SCALAR(Uint16, uint16_t)
+KSRP_HEALTH_CHECK_BATCH_SCALAR(Int16, int16_t)
+KSRP_HEALTH_CHECK_BATCH_SCALAR(Uint32, uint32_t)
+KSRP_HEALTH_CHECK_BATCH_SCALAR(Int32, int32_t)
+KSRP_HEALTH_CHECK_BATCH_SCALAR(Uint64, uint64_t)
+KSRP_HEALTH_CHECK_BATCH_SCALAR(Int64, int64_t)
+KSRP_HEALTH_CHECK_BATCH_SCALAR(Float, float)
+KSRP_HEALTH_CHECK_BATCH_SCALAR(Double, double)
+
+#if defined(__SSE2__)
+// Vector lanes of results are stored directly into the results column
+_Static_assert(sizeof(KSRP_HealthCheckResult) == sizeof(int32_t), "KSRP_HealthCheckResult has to be 32-bit");
+
+static inline __m128i ksrp_select_128(__m128i mask, __m128i selected, __m128i other) {
+    return _mm_or_si128(_mm_and_si128(mask, selected), _mm_andnot_si128(mask, other));
+}
+
+// Signed comparison of unsigned lanes after flipping their sign bits
+static inline __m128i ksrp_unsigned_ge_epi32(__m128i value, uint32_t bound) {
+    const __m128i sign = _mm_set1_epi32(INT32_MIN);
+    const __m128i below = _mm_cmpgt_epi32(_mm_set1_epi32((int32_t)(bound ^ 0x80000000u)), _mm_xor_si128(value, sign));
+    return _mm_xor_si128(below, _mm_set1_epi32(-1));
+}
+
+// Two masks of 64-bit lanes narrowed to four 32-bit lanes
+static inline __m128i ksrp_narrow_masks_pd(__m128d low, __m128d high) {
+    return _mm_castps_si128(_mm_shuffle_ps(_mm_castpd_ps(low), _mm_castpd_ps(high), _MM_SHUFFLE(2, 0, 2, 0)));
+}
+#endif // __SSE2__
+
+#if defined(__AVX2__)
+static inline __m256i ksrp_select_256(__m256i mask, __m256i selected, __m256i other) {
+    return _mm256_blendv_epi8(other, selected, mask);
+}
+#endif // __AVX2__
+
+_nonnull_
+void KSRP_HealthCheckBatch_Uint16(const uint16_t* values, uint32_t count, const KSRP_HealthCheckSteps_Uint16* steps,
+                                  KSRP_HealthCheckResult* results) {
+    uint32_t i = 0;
+#if defined(__SSE2__)
+    const __m128i sign = _mm_set1_epi16(INT16_MIN);
+    for (; i + 8 <= count; i += 8) {
+        const __m128i value = _mm_xor_si128(_mm_loadu_si128((const __m128i*)&values[i]), sign);
+        __m128i result = _mm_set1_epi16(KSRP_RESULT_UNKNOWN);
+        for (uint32_t step = 0; step < steps->bounds_count; step++) {
+            const __m128i bound = _mm_set1_epi16((int16_t)(steps->bounds[step] ^ 0x8000u));
+            const __m128i mask = _mm_xor_si128(_mm_cmpgt_epi16(bound, value), _mm_set1_epi16(-1));
+            if (_mm_movemask_epi8(mask) == 0) {
+                break;
+            }
+            result = ksrp_select_128(mask, _mm_set1_epi16(steps->bound_results[step]), result);
+        }
+        for (uint32_t step = 0; step < steps->points_count; step++) {
+            const __m128i point = _mm_set1_epi16((int16_t)(steps->points[step] ^ 0x8000u));
+            result = ksrp_select_128(_mm_cmpeq_epi16(value, point), _mm_set1_epi16(steps->point_results[step]), result);
+        }
+        _mm_storeu_si128((__m128i*)&results[i], _mm_unpacklo_epi16(result, _mm_setzero_si128()));
+        _mm_storeu_si128((__m128i*)&results[i + 4], _mm_unpackhi_epi16(result, _mm_setzero_si128()));
+    }
+#endif // __SSE2__
+    ksrp_health_check_batch_scalar_Uint16(&values[i], count - i, steps, &results[i]);
+}
+
+_nonnull_
+void KSRP_HealthCheckBatch_Int16(const int16_t* values, uint32_t count, const KSRP_HealthCheckSteps_Int16* steps,
+                                 KSRP_HealthCheckResult* results) {
+    uint32_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 8 <= count; i += 8) {
+        const __m128i value = _mm_loadu_si128((const __m128i*)&values[i]);
+        __m128i result = _mm_set1_epi16(KSRP_RESULT_UNKNOWN);
+        for (uint32_t step = 0; step < steps->bounds_count; step++) {
+            const __m128i bound = _mm_set1_epi16(steps->bounds[step]);
+            const __m128i mask = _mm_xor_si128(_mm_cmpgt_epi16(bound, value), _mm_set1_epi16(-1));
+            if (_mm_movemask_epi8(mask) == 0) {
+                break;
+            }
+            result = ksrp_select_128(mask, _mm_set1_epi16(steps->bound_results[step]), result);
+        }
+        for (uint32_t step = 0; step < steps->points_count; step++) {
+            const __m128i point = _mm_set1_epi16(steps->points[step]);
+            result = ksrp_select_128(_mm_cmpeq_epi16(value, point), _mm_set1_epi16(steps->point_results[step]), result);
+        }
+        _mm_storeu_si128((__m128i*)&results[i], _mm_unpacklo_epi16(result, _mm_setzero_si128()));
+        _mm_storeu_si128((__m128i*)&results[i + 4], _mm_unpackhi_epi16(result, _mm_setzero_si128()));
+    }
+#endif // __SSE2__
+    ksrp_health_check_batch_scalar_Int16(&values[i], count - i, steps, &results[i]);
+}
+
+_nonnull_
+void KSRP_HealthCheckBatch_Uint32(const uint32_t* values, uint32_t count, const KSRP_HealthCheckSteps_Uint32* steps,
+                                  KSRP_HealthCheckResult* results) {
+    uint32_t i = 0;
+#if defined(__AVX2__)
+    const __m256i sign = _mm256_set1_epi32(INT32_MIN);
+    for (; i + 8 <= count; i += 8) {
+        const __m256i value = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)&values[i]), sign);
+        __m256i result = _mm256_set1_epi32(KSRP_RESULT_UNKNOWN);
+        for (uint32_t step = 0; step < steps->bounds_count; step++) {
+            const __m256i bound = _mm256_set1_epi32((int32_t)(steps->bounds[step] ^ 0x80000000u));
+            const __m256i mask = _mm256_xor_si256(_mm256_cmpgt_epi32(bound, value), _mm256_set1_epi32(-1));
+            if (_mm256_movemask_epi8(mask) == 0) {
+                break;
+            }
+            result = ksrp_select_256(mask, _mm256_set1_epi32(steps->bound_results[step]), result);
+        }
+        for (uint32_t step = 0; step < steps->points_count; step++) {
+            const __m256i point = _mm256_set1_epi32((int32_t)(steps->points[step] ^ 0x80000000u));
+            result = ksrp_select_256(_mm256_cmpeq_epi32(value, point), _mm256_set1_epi32(steps->point_results[step]),
+                                     result);
+        }
+        _mm256_storeu_si256((__m256i*)&results[i], result);
+    }
+#endif // __AVX2__
+#if defined(__SSE2__)
+    for (; i + 4 <= count; i += 4) {
+        const __m128i value = _mm_loadu_si128((const __m128i*)&values[i]);
+        __m128i result = _mm_set1_epi32(KSRP_RESULT_UNKNOWN);
+        for (uint32_t step = 0; step < steps->bounds_count; step++) {
+            const __m128i mask = ksrp_unsigned_ge_epi32(value, steps->bounds[step]);
+            if (_mm_movemask_epi8(mask) == 0) {
+                break;
+            }
+            result = ksrp_select_128(mask, _mm_set1_epi32(steps->bound_results[step]), result);
+        }
+        for (uint32_t step = 0; step < steps->points_count; step++) {
+            const __m128i point = _mm_set1_epi32((int32_t)steps->points[step]);
+            result = ksrp_select_128(_mm_cmpeq_epi32(value, point), _mm_set1_epi32(steps->point_results[step]), result);
+        }
+        _mm_storeu_si128((__m128i*)&results[i], result);
+    }
+#endif // __SSE2__
+    ksrp_health_check_batch_scalar_Uint32(&values[i], count - i, steps, &results[i]);
+}
+
+_nonnull_
+void KSRP_HealthCheckBatch_Int32(const int32_t* values, uint32_t count, const KSRP_HealthCheckSteps_Int32* steps,
+                                 KSRP_HealthCheckResult* results) {
+    uint32_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 8 <= count; i += 8) {
+        const __m256i value = _mm256_loadu_si256((const __m256i*)&values[i]);
+        __m256i result = _mm256_set1_epi32(KSRP_RESULT_UNKNOWN);
+        for (uint32_t step = 0; step < steps->bounds_count; step++) {
+            const __m256i bound = _mm256_set1_epi32(steps->bounds[step]);
+            const __m256i mask = _mm256_xor_si256(_mm256_cmpgt_epi32(bound, value), _mm256_set1_epi32(-1));
+            if (_mm256_movemask_epi8(mask) == 0) {
+                break;
+            }
+            result = ksrp_select_256(mask, _mm256_set1_epi32(steps->bound_results[step]), result);
+        }
+        for (uint32_t step = 0; step < steps->points_count; step++) {
+            const __m256i point = _mm256_set1_epi32(steps->points[step]);
+            result = ksrp_select_256(_mm256_cmpeq_epi32(value, point), _mm256_set1_epi32(steps->point_results[step]),
+                                     result);
+        }
+        _mm256_storeu_si256((__m256i*)&results[i], result);
+    }
+#endif // __AVX2__
+#if defined(__SSE2__)
+    for (; i + 4 <= count; i += 4) {
+        const __m128i value = _mm_loadu_si128((const __m128i*)&values[i]);
+        __m128i result = _mm_set1_epi32(KSRP_RESULT_UNKNOWN);
+        for (uint32_t step = 0; step < steps->bounds_count; step++) {
+            const __m128i bound = _mm_set1_epi32(steps->bounds[step]);
+            const __m128i mask = _mm_xor_si128(_mm_cmpgt_epi32(bound, value), _mm_set1_epi32(-1));
+            if (_mm_movemask_epi8(mask) == 0) {
+                break;
+            }
+            result = ksrp_select_128(mask, _mm_set1_epi32(steps->bound_results[step]), result);
+        }
+        for (uint32_t step = 0; step < steps->points_count; step++) {
+            const __m128i point = _mm_set1_epi32(steps->points[step]);
+            result = ksrp_select_128(_mm_cmpeq_epi32(value, point), _mm_set1_epi32(steps->point_results[step]), result);
+        }
+        _mm_storeu_si128((__m128i*)&results[i], result);
+    }
+#endif // __SSE2__
+    ksrp_health_check_batch_scalar_Int32(&values[i], count - i, steps, &results[i]);
+}
+
+// 64-bit integer comparisons need SSE4.2 and are rarely checked against ranges, so they stay scalar
+_nonnull_
+void KSRP_HealthCheckBatch_Uint64(const uint64_t* values, uint32_t count, const KSRP_HealthCheckSteps_Uint64* steps,
+                                  KSRP_HealthCheckResult* results) {
+    ksrp_health_check_batch_scalar_Uint64(values, count, steps, results);
+}
+
+_nonnull_
+void KSRP_HealthCheckBatch_Int64(const int64_t* values, uint32_t count, const KSRP_HealthCheckSteps_Int64* steps,
+                                 KSRP_HealthCheckResult* results) {
+    ksrp_health_check_batch_scalar_Int64(values, count, steps, results);
+}
+
+_nonnull_
+void KSRP_HealthCheckBatch_Float(const float* values, uint32_t count, const KSRP_HealthCheckSteps_Float* steps,
+                                 KSRP_HealthCheckResult* results) {
+    uint32_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 8 <= count; i += 8) {
+        const __m256 value = _mm256_loadu_ps(&values[i]);
+        __m256i result = _mm256_set1_epi32(KSRP_RESULT_UNKNOWN);
+        for (uint32_t step = 0; step < steps->bounds_count; step++) {
+            // Ordered comparisons are false for NaN, same as in scalar evaluation
+            const __m256 mask = _mm256_cmp_ps(value, _mm256_set1_ps(steps->bounds[step]), _CMP_GE_OQ);
+            if (_mm256_movemask_ps(mask) == 0) {
+                break;
+            }
+            result = ksrp_select_256(_mm256_castps_si256(mask), _mm256_set1_epi32(steps->bound_results[step]), result);
+        }
+        for (uint32_t step = 0; step < steps->points_count; step++) {
+            const __m256 mask = _mm256_cmp_ps(value, _mm256_set1_ps(steps->points[step]), _CMP_EQ_OQ);
+            result = ksrp_select_256(_mm256_castps_si256(mask), _mm256_set1_epi32(steps->point_results[step]), result);
+        }
+        _mm256_storeu_si256((__m256i*)&results[i], result);
+    }
+#endif // __AVX2__
+#if defined(__SSE2__)
+    for (; i + 4 <= count; i += 4) {
+        const __m128 value = _mm_loadu_ps(&values[i]);
+        __m128i result = _mm_set1_epi32(KSRP_RESULT_UNKNOWN);
+        for (uint32_t step = 0; step < steps->bounds_count; step++) {
+            const __m128 mask = _mm_cmpge_ps(value, _mm_set1_ps(steps->bounds[step]));
+            if (_mm_movemask_ps(mask) == 0) {
+                break;
+            }
+            result = ksrp_select_128(_mm_castps_si128(mask), _mm_set1_epi32(steps->bound_results[step]), result);
+        }
+        for (uint32_t step = 0; step < steps->points_count; step++) {
+            const __m128 mask = _mm_cmpeq_ps(value, _mm_set1_ps(steps->points[step]));
+            result = ksrp_select_128(_mm_castps_si128(mask), _mm_set1_epi32(steps->point_results[step]), result);
+        }
+        _mm_storeu_si128((__m128i*)&results[i], result);
+    }
+#endif // __SSE2__
+    ksrp_health_check_batch_scalar_Float(&values[i], count - i, steps, &results[i]);
+}
+
+_nonnull_
+void KSRP_HealthCheckBatch_Double(const double* values, uint32_t count, const KSRP_HealthCheckSteps_Double* steps,
+                                  KSRP_HealthCheckResult* results) {
+    uint32_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= count; i += 4) {
+        const __m128d low = _mm_loadu_pd(&values[i]);
+        const __m128d high = _mm_loadu_pd(&values[i + 2]);
+        __m128i result = _mm_set1_epi32(KSRP_RESULT_UNKNOWN);
+        for (uint32_t step = 0; step < steps->bounds_count; step++) {
+            const __m128d bound = _mm_set1_pd(steps->bounds[step]);
+            const __m128i mask = ksrp_narrow_masks_pd(_mm_cmpge_pd(low, bound), _mm_cmpge_pd(high, bound));
+            if (_mm_movemask_epi8(mask) == 0) {
+                break;
+            }
+            result = ksrp_select_128(mask, _mm_set1_epi32(steps->bound_results[step]), result);
+        }
+        for (uint32_t step = 0; step < steps->points_count; step++) {
+            const __m128d point = _mm_set1_pd(steps->points[step]);
+            const __m128i mask = ksrp_narrow_masks_pd(_mm_cmpeq_pd(low, point), _mm_cmpeq_pd(high, point));
+            result = ksrp_select_128(mask, _mm_set1_epi32(steps->point_results[step]), result);
+        }
+        _mm_storeu_si128((__m128i*)&results[i], result);
+    }
+#endif // __SSE2__
+    ksrp_health_check_batch_scalar_Double(&values[i], count - i, steps, &results[i]);
+}
\ No newline at end of file
@@ -0,0 +1,404 @@
+/**
+ * @file fleet_store.c
+ * @brief Host-side state of all subsystems of a fleet of vehicles, stored in dense per-frame arrays
+ */
+
+// Include standard libraries
+#include <stdlib.h>
+
+// Include user libraries
+#include "ksrp/host/fleet_store.h"
+
+// Counters accumulated by shards, see KSRP_FLEET_COUNTERS
+enum {
+    KSRP_FLEET_COUNTER_APPLIED = 0,
+    KSRP_FLEET_COUNTER_FAILED = 1,
+    KSRP_FLEET_COUNTER_STALE = 0,
+    KSRP_FLEET_COUNTER_WARNING = 1,
+    KSRP_FLEET_COUNTER_CRITICAL = 2,
+    KSRP_FLEET_COUNTER_TRANSITIONS = 3,
+};
+
+/**
+ * @brief Allocate the store and initialize frames of all vehicles to their defaults
+ *
+ * @param store The store to initialize
+ * @param vehicles Number of vehicles
+ * @param now_ms Current time (in ms), frames are stale when not updated for their timeout since then
+ * @return KSRP_Status KSRP_STATUS_OK if successful, KSRP_STATUS_ERROR if memory couldn't be allocated
+ */
+_nonnull_
+KSRP_Status KSRP_FleetStore_Init(KSRP_FleetStore* store, uint32_t vehicles, uint32_t now_ms) {
+    size_t arena_size = 0;
+    size_t wheels_wheels_status_offset = KSRP_Fleet_Reserve(&arena_size,
+        (size_t)vehicles * KSRP_WHEELS_MAX_DEVICES * sizeof(KSRP_Wheels_WheelsStatus_Frame));
+    size_t wheels_wheels_status_updated_ms_offset = KSRP_Fleet_Reserve(&arena_size,
+        (size_t)vehicles * KSRP_WHEELS_MAX_DEVICES * sizeof(uint32_t));
+    size_t wheels_wheels_status_health_offset = KSRP_Fleet_Reserve(&arena_size,
+        (size_t)vehicles * KSRP_WHEELS_MAX_DEVICES * sizeof(uint8_t));
+
+    uint8_t* arena = KSRP_Fleet_AllocateArena(arena_size);
+    if (arena == NULL) {
+        return KSRP_STATUS_ERROR;
+    }
+
+    store->vehicles = vehicles;
+    store->arena = arena;
+
+    store->wheels_wheels_status = (KSRP_Wheels_WheelsStatus_Frame*)(arena + wheels_wheels_status_offset);
+    store->wheels_wheels_status_updated_ms = (uint32_t*)(arena + wheels_wheels_status_updated_ms_offset);
+    store->wheels_wheels_status_health = arena + wheels_wheels_status_health_offset;
+    for (size_t slot = 0; slot < (size_t)vehicles * KSRP_WHEELS_MAX_DEVICES; slot++) {
+        KSRP_Init_Wheels_WheelsStatus_Frame(&store->wheels_wheels_status[slot]);
+        store->wheels_wheels_status[slot].device_id = (uint8_t)(slot % KSRP_WHEELS_MAX_DEVICES);
+        store->wheels_wheels_status_updated_ms[slot] = now_ms;
+        store->wheels_wheels_status_health[slot] = KSRP_RESULT_UNKNOWN;
+    }
+
+    return KSRP_STATUS_OK;
+}
+
+/**
+ * @brief Free memory of the store
+ *
+ * @param store The store to free
+ */
+_nonnull_
+void KSRP_FleetStore_Free(KSRP_FleetStore* store) {
+    free(store->arena);
+    store->arena = NULL;
+    store->vehicles = 0;
+}
+
+/**
+ * @brief Patch a stored frame with a delta
+ *
+ * @param store The store to update
+ * @param vehicle The vehicle that sent the delta
+ * @param delta The delta to apply
+ * @param timestamp_ms Time of the reception (in ms)
+ * @return KSRP_Status The status of the update, KSRP_STATUS_OK if successful
+ */
+static KSRP_Status KSRP_FleetStore_ApplyDelta(KSRP_FleetStore* store, uint32_t vehicle, const KSRP_RawData_Frame* delta,
+                                              uint32_t timestamp_ms) {
+    KSRP_Status status;
+    size_t slot;
+
+    switch (KSRP_Delta_GetTypeID(delta)) {
+        case KSRP_WHEELS_WHEELS_STATUS_TYPE_ID: {
+            uint8_t device_id;
+            status = KSRP_GetDeltaDeviceID_Wheels_WheelsStatus(delta, &device_id);
+            if (status != KSRP_STATUS_OK) {
+                return status;
+            }
+            if (device_id >= KSRP_WHEELS_MAX_DEVICES) {
+                return KSRP_STATUS_INVALID_DEVICE_ID;
+            }
+            slot = (size_t)vehicle * KSRP_WHEELS_MAX_DEVICES + device_id;
+            status = KSRP_ApplyDelta_Wheels_WheelsStatus(delta, &store->wheels_wheels_status[slot]);
+            if (status == KSRP_STATUS_OK) {
+                store->wheels_wheels_status_updated_ms[slot] = timestamp_ms;
+            }
+            return status;
+        }
+        default:
+            return KSRP_STATUS_INVALID_FRAME_TYPE;
+    }
+}
+
+/**
+ * @brief Unpack a raw data frame or delta into the store
+ *
+ * @param store The store to update
+ * @param vehicle The vehicle that sent the frame
+ * @param frame The raw data frame or delta
+ * @param timestamp_ms Time of the reception (in ms)
+ * @return KSRP_Status The status of the update, KSRP_STATUS_OK if successful
+ */
+static KSRP_Status KSRP_FleetStore_UpdateFrame(KSRP_FleetStore* store, uint32_t vehicle,
+                                               const KSRP_RawData_Frame* frame, uint32_t timestamp_ms) {
+    if (frame->length < KSRP_ID_BYTES) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    if (KSRP_Delta_IsDelta(frame)) {
+        return KSRP_FleetStore_ApplyDelta(store, vehicle, frame, timestamp_ms);
+    }
+
+    switch (KSRP_RawData_Frame_GetTypeID(frame)) {
+        case KSRP_WHEELS_WHEELS_STATUS_TYPE_ID: {
+            KSRP_Wheels_WheelsStatus_Frame unpacked;
+            KSRP_Status status = KSRP_Unpack_Wheels_WheelsStatus(frame, &unpacked);
+            if (status != KSRP_STATUS_OK) {
+                return status;
+            }
+            if (unpacked.device_id >= KSRP_WHEELS_MAX_DEVICES) {
+                return KSRP_STATUS_INVALID_DEVICE_ID;
+            }
+            size_t slot = (size_t)vehicle * KSRP_WHEELS_MAX_DEVICES + unpacked.device_id;
+            store->wheels_wheels_status[slot] = unpacked;
+            store->wheels_wheels_status_updated_ms[slot] = timestamp_ms;
+            return KSRP_STATUS_OK;
+        }
+        default:
+            return KSRP_STATUS_INVALID_FRAME_TYPE;
+    }
+}
+
+/**
+ * @brief Unpack a received frame into the store, deltas patch the stored frame and batches are split into
+ * sub-frames
+ *
+ * @param store The store to update
+ * @param vehicle The vehicle that sent the frame
+ * @param frame The raw data frame, delta or batch
+ * @param timestamp_ms Time of the reception (in ms)
+ * @return KSRP_Status KSRP_STATUS_OK if the frame was stored, KSRP_STATUS_ERROR if the vehicle is out of range,
+ * KSRP_STATUS_INVALID_FRAME_TYPE if the type ID is unknown or segmented, KSRP_STATUS_INVALID_DEVICE_ID if device
+ * ID is out of range, otherwise status of the unpacking, for batches status of the first failed sub-frame
+ */
+_nonnull_
+KSRP_Status KSRP_FleetStore_Update(KSRP_FleetStore* store, uint32_t vehicle, const KSRP_RawData_Frame* frame,
+                                   uint32_t timestamp_ms) {
+    if (vehicle >= store->vehicles) {
+        return KSRP_STATUS_ERROR;
+    }
+
+    if (!KSRP_Batch_IsBatch(frame)) {
+        return KSRP_FleetStore_UpdateFrame(store, vehicle, frame, timestamp_ms);
+    }
+
+    KSRP_Status result = KSRP_STATUS_OK;
+    KSRP_BatchReader reader;
+    KSRP_RawData_Frame sub_frame;
+    KSRP_Status status;
+
+    KSRP_BatchReader_Init(&reader, frame);
+    while ((status = KSRP_BatchReader_Next(&reader, &sub_frame)) != KSRP_STATUS_ERROR) {
+        if (status == KSRP_STATUS_OK) {
+            status = KSRP_FleetStore_UpdateFrame(store, vehicle, &sub_frame, timestamp_ms);
+        }
+
+        if (status != KSRP_STATUS_OK && result == KSRP_STATUS_OK) {
+            result = status;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Unpack a reassembled segmented frame into the store
+ *
+ * @param store The store to update
+ * @param vehicle The vehicle that sent the frame
+ * @param payload The payload completed by KSRP_Reassembler_Push
+ * @param timestamp_ms Time of the reception (in ms)
+ * @return KSRP_Status KSRP_STATUS_OK if the frame was stored, KSRP_STATUS_ERROR if the vehicle is out of range,
+ * KSRP_STATUS_INVALID_FRAME_TYPE if the type ID is not a segmented frame, otherwise status of the unpacking
+ */
+_nonnull_
+KSRP_Status KSRP_FleetStore_UpdateSegmented(KSRP_FleetStore* store, uint32_t vehicle,
+                                            const KSRP_SegmentedPayload* payload, uint32_t timestamp_ms) {
+    if (vehicle >= store->vehicles) {
+        return KSRP_STATUS_ERROR;
+    }
+    // No frame is segmented
+    (void)payload;
+    (void)timestamp_ms;
+
+    return KSRP_STATUS_INVALID_FRAME_TYPE;
+}
+
+typedef struct {
+    KSRP_FleetStore* store;
+    const KSRP_FleetFrame* frames;
+    const size_t* order;   // Indices of frames grouped by shard, frames of every shard keep the given order
+    const size_t* buckets; // Start of frames of every shard in order, one more entry marks the end of the last one
+    uint32_t shard_vehicles;
+} KSRP_FleetStoreUpdateWork;
+
+static void KSRP_FleetStore_UpdateShard(uint32_t first_vehicle, uint32_t end_vehicle, void* context,
+                                        uint64_t counters[KSRP_FLEET_COUNTERS]) {
+    const KSRP_FleetStoreUpdateWork* work = (const KSRP_FleetStoreUpdateWork*)context;
+
+    // Calling thread may work on several shards at once, when a thread couldn't be created
+    size_t begin = work->buckets[first_vehicle / work->shard_vehicles];
+    size_t end = work->buckets[(end_vehicle + work->shard_vehicles - 1) / work->shard_vehicles];
+
+    for (size_t i = begin; i < end; i++) {
+        const KSRP_FleetFrame* frame = &work->frames[work->order[i]];
+        KSRP_Status status = KSRP_FleetStore_Update(work->store, frame->vehicle, &frame->frame, frame->timestamp_ms);
+        counters[status == KSRP_STATUS_OK ? KSRP_FLEET_COUNTER_APPLIED : KSRP_FLEET_COUNTER_FAILED]++;
+    }
+}
+
+/**
+ * @brief Update the store with received frames of many vehicles, vehicles are split into shards updated in
+ * parallel and frames of every vehicle are applied in the given order
+ *
+ * @param store The store to update
+ * @param frames The received frames
+ * @param count Number of frames
+ * @param threads Number of threads, 0 for the number of online processors
+ * @param stats Counters of applied and failed frames, may be NULL
+ */
+void KSRP_FleetStore_UpdateBatch(KSRP_FleetStore* store, const KSRP_FleetFrame* frames, size_t count, uint32_t threads,
+                                 KSRP_FleetUpdateStats* stats) {
+    uint64_t counters[KSRP_FLEET_COUNTERS] = {0};
+
+    threads = KSRP_Fleet_ResolveThreads(threads);
+    uint32_t shard_vehicles = KSRP_Fleet_ShardVehicles(store->vehicles, threads);
+    uint32_t shards_count = shard_vehicles > 0 ? (store->vehicles + shard_vehicles - 1) / shard_vehicles : 0;
+    size_t* buckets = calloc((size_t)shards_count + 1, sizeof(size_t));
+    size_t* order = malloc((count > 0 ? count : 1) * sizeof(size_t));
+
+    if (shards_count == 0 || buckets == NULL || order == NULL) {
+        // No vehicles or no memory for buckets, calling thread applies all frames
+        for (size_t i = 0; i < count; i++) {
+            KSRP_Status status = KSRP_FleetStore_Update(store, frames[i].vehicle, &frames[i].frame,
+                                                        frames[i].timestamp_ms);
+            counters[status == KSRP_STATUS_OK ? KSRP_FLEET_COUNTER_APPLIED : KSRP_FLEET_COUNTER_FAILED]++;
+        }
+    } else {
+        // Frames are bucketed by shard with stable counting sort, so every shard walks only its own frames
+        for (size_t i = 0; i < count; i++) {
+            if (frames[i].vehicle < store->vehicles) {
+                buckets[frames[i].vehicle / shard_vehicles + 1]++;
+            }
+        }
+        for (uint32_t shard = 0; shard < shards_count; shard++) {
+            buckets[shard + 1] += buckets[shard];
+        }
+
+        uint64_t unknown = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (frames[i].vehicle < store->vehicles) {
+                order[buckets[frames[i].vehicle / shard_vehicles]++] = i;
+            } else {
+                unknown++;
+            }
+        }
+        // Scatter moved start of every bucket to its end, shift them back
+        for (uint32_t shard = shards_count; shard > 0; shard--) {
+            buckets[shard] = buckets[shard - 1];
+        }
+        buckets[0] = 0;
+
+        KSRP_FleetStoreUpdateWork work = {store, frames, order, buckets, shard_vehicles};
+        KSRP_Fleet_RunSharded(store->vehicles, threads, KSRP_FleetStore_UpdateShard, &work, counters);
+        counters[KSRP_FLEET_COUNTER_FAILED] += unknown;
+    }
+
+    free(order);
+    free(buckets);
+
+    if (stats != NULL) {
+        stats->applied = counters[KSRP_FLEET_COUNTER_APPLIED];
+        stats->failed = counters[KSRP_FLEET_COUNTER_FAILED];
+    }
+}
+
+typedef struct {
+    KSRP_FleetStore* store;
+    uint32_t now_ms;
+    KSRP_FleetStaleCallback stale_callback;
+    KSRP_FleetHealthCallback health_callback;
+    void* context;
+} KSRP_FleetStoreSweepWork;
+
+static void KSRP_FleetStore_SweepStaleShard(uint32_t first_vehicle, uint32_t end_vehicle, void* context,
+                                            uint64_t counters[KSRP_FLEET_COUNTERS]) {
+    const KSRP_FleetStoreSweepWork* work = (const KSRP_FleetStoreSweepWork*)context;
+    KSRP_FleetStore* store = work->store;
+
+    for (uint32_t vehicle = first_vehicle; vehicle < end_vehicle; vehicle++) {
+        for (uint32_t device_id = 0; device_id < KSRP_WHEELS_MAX_DEVICES; device_id++) {
+            size_t slot = (size_t)vehicle * KSRP_WHEELS_MAX_DEVICES + device_id;
+            uint32_t age_ms = work->now_ms - store->wheels_wheels_status_updated_ms[slot];
+            if (age_ms >= KSRP_WHEELS_WHEELS_STATUS_TIMEOUT_MS) {
+                counters[KSRP_FLEET_COUNTER_STALE]++;
+                if (work->stale_callback != NULL) {
+                    work->stale_callback(vehicle, KSRP_WHEELS_WHEELS_STATUS_TYPE_ID,
+                                         (uint8_t)device_id, age_ms, work->context);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Find frames not updated for their timeout in all vehicles, every sweep reports frames until they are
+ * updated
+ *
+ * @param store The store to sweep
+ * @param now_ms Current time (in ms)
+ * @param callback Called for every stale frame from worker threads, may be NULL
+ * @param context The context passed to the callback
+ * @param threads Number of threads, 0 for the number of online processors
+ * @param stats Counters of the sweep, only stale frames are counted, may be NULL
+ */
+void KSRP_FleetStore_SweepStale(KSRP_FleetStore* store, uint32_t now_ms, KSRP_FleetStaleCallback callback,
+                                void* context, uint32_t threads, KSRP_FleetSweepStats* stats) {
+    KSRP_FleetStoreSweepWork work = {store, now_ms, callback, NULL, context};
+    uint64_t counters[KSRP_FLEET_COUNTERS];
+
+    KSRP_Fleet_RunSharded(store->vehicles, threads, KSRP_FleetStore_SweepStaleShard, &work, counters);
+
+    if (stats != NULL) {
+        *stats = (KSRP_FleetSweepStats){.stale = counters[KSRP_FLEET_COUNTER_STALE]};
+    }
+}
+
+static void KSRP_FleetStore_SweepHealthShard(uint32_t first_vehicle, uint32_t end_vehicle, void* context,
+                                             uint64_t counters[KSRP_FLEET_COUNTERS]) {
+    const KSRP_FleetStoreSweepWork* work = (const KSRP_FleetStoreSweepWork*)context;
+    KSRP_FleetStore* store = work->store;
+    uint64_t failing_fields;
+
+    for (uint32_t vehicle = first_vehicle; vehicle < end_vehicle; vehicle++) {
+        for (uint32_t device_id = 0; device_id < KSRP_WHEELS_MAX_DEVICES; device_id++) {
+            size_t slot = (size_t)vehicle * KSRP_WHEELS_MAX_DEVICES + device_id;
+            KSRP_HealthCheckResult result = KSRP_HealthCheck_Wheels_WheelsStatus_All(&store->wheels_wheels_status[slot],
+                                                                                   &failing_fields);
+            KSRP_HealthCheckResult previous = (KSRP_HealthCheckResult)store->wheels_wheels_status_health[slot];
+
+            counters[KSRP_FLEET_COUNTER_WARNING] += result == KSRP_RESULT_WARNING;
+            counters[KSRP_FLEET_COUNTER_CRITICAL] += result == KSRP_RESULT_CRITICAL;
+            if (result != previous) {
+                store->wheels_wheels_status_health[slot] = (uint8_t)result;
+                counters[KSRP_FLEET_COUNTER_TRANSITIONS]++;
+                if (work->health_callback != NULL) {
+                    work->health_callback(vehicle, KSRP_WHEELS_WHEELS_STATUS_TYPE_ID,
+                                          (uint8_t)device_id, previous, result, failing_fields, work->context);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Evaluate health checks of frames of all vehicles and cache worst result of every frame
+ *
+ * @param store The store to sweep
+ * @param callback Called from worker threads when worst result of a frame changed since the previous sweep, may be
+ * NULL
+ * @param context The context passed to the callback
+ * @param threads Number of threads, 0 for the number of online processors
+ * @param stats Counters of the sweep, stale frames aren't counted, may be NULL
+ */
+void KSRP_FleetStore_SweepHealth(KSRP_FleetStore* store, KSRP_FleetHealthCallback callback, void* context,
+                                 uint32_t threads, KSRP_FleetSweepStats* stats) {
+    KSRP_FleetStoreSweepWork work = {store, 0, NULL, callback, context};
+    uint64_t counters[KSRP_FLEET_COUNTERS];
+
+    KSRP_Fleet_RunSharded(store->vehicles, threads, KSRP_FleetStore_SweepHealthShard, &work, counters);
+
+    if (stats != NULL) {
+        *stats = (KSRP_FleetSweepStats){
+            .warning = counters[KSRP_FLEET_COUNTER_WARNING],
+            .critical = counters[KSRP_FLEET_COUNTER_CRITICAL],
+            .transitions = counters[KSRP_FLEET_COUNTER_TRANSITIONS],
+        };
+    }
+}
\ No newline at end of file
@@ -0,0 +1,360 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "ksrp/host/pipeline.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define KSRP_PIPELINE_CACHE_LINE 64
+#define KSRP_PIPELINE_RANGE(begin, end) (((uint64_t)(end) << 32) | (uint32_t)(begin))
+
+// Chunks left in the deque of a worker, begin and end are packed into one word, so owner taking from the front
+// and thieves taking from the back agree on every chunk with a single compare-and-swap
+typedef struct {
+    _Alignas(KSRP_PIPELINE_CACHE_LINE) _Atomic uint64_t range;
+} KSRP_PipelineDeque;
+
+typedef struct {
+    size_t first;
+    uint32_t frames_count;
+    uint32_t chunks_count;
+    uint8_t* decoded;
+    KSRP_Status* statuses;
+    uint32_t* order; // Frames of every chunk sorted by timestamp, relative to the first frame of the window
+} KSRP_PipelineWindow;
+
+typedef struct {
+    const KSRP_PipelineConfig* config;
+    const KSRP_TimedFrame* frames;
+    uint32_t threads;
+    uint32_t chunk_frames;
+    KSRP_PipelineDeque* deques;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    KSRP_PipelineWindow* window;
+    uint64_t generation;
+    uint32_t busy;
+    bool stop;
+
+    _Atomic uint64_t stolen_chunks;
+} KSRP_Pipeline;
+
+typedef struct {
+    KSRP_Pipeline* pipeline;
+    uint32_t index;
+    pthread_t thread;
+} KSRP_PipelineWorker;
+
+static bool KSRP_Pipeline_TakeFront(KSRP_PipelineDeque* deque, uint32_t* chunk) {
+    uint64_t range = atomic_load_explicit(&deque->range, memory_order_relaxed);
+    for (;;) {
+        uint32_t begin = (uint32_t)range;
+        uint32_t end = (uint32_t)(range >> 32);
+        if (begin >= end) {
+            return false;
+        }
+
+        if (atomic_compare_exchange_weak_explicit(&deque->range, &range, KSRP_PIPELINE_RANGE(begin + 1, end),
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            *chunk = begin;
+            return true;
+        }
+    }
+}
+
+static bool KSRP_Pipeline_TakeBack(KSRP_PipelineDeque* deque, uint32_t* chunk) {
+    uint64_t range = atomic_load_explicit(&deque->range, memory_order_relaxed);
+    for (;;) {
+        uint32_t begin = (uint32_t)range;
+        uint32_t end = (uint32_t)(range >> 32);
+        if (begin >= end) {
+            return false;
+        }
+
+        if (atomic_compare_exchange_weak_explicit(&deque->range, &range, KSRP_PIPELINE_RANGE(begin, end - 1),
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            *chunk = end - 1;
+            return true;
+        }
+    }
+}
+
+static void KSRP_Pipeline_DecodeChunk(KSRP_Pipeline* pipeline, KSRP_PipelineWindow* window, uint32_t chunk) {
+    const KSRP_PipelineConfig* config = pipeline->config;
+    const KSRP_TimedFrame* frames = &pipeline->frames[window->first];
+    uint32_t begin = chunk * pipeline->chunk_frames;
+    uint32_t end = begin + pipeline->chunk_frames < window->frames_count ? begin + pipeline->chunk_frames
+                                                                          : window->frames_count;
+
+    for (uint32_t i = begin; i < end; i++) {
+        window->statuses[i] = config->decode(&frames[i], window->decoded + (size_t)i * config->decoded_size,
+                                             config->context);
+
+        // Recordings are mostly sorted already, so insertion sort is close to linear
+        uint32_t position = i;
+        while (position > begin && frames[window->order[position - 1]].timestamp > frames[i].timestamp) {
+            window->order[position] = window->order[position - 1];
+            position--;
+        }
+        window->order[position] = i;
+    }
+}
+
+static void* KSRP_Pipeline_Worker(void* argument) {
+    KSRP_PipelineWorker* worker = argument;
+    KSRP_Pipeline* pipeline = worker->pipeline;
+    uint64_t generation = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&pipeline->mutex);
+        while (!pipeline->stop && pipeline->generation == generation) {
+            pthread_cond_wait(&pipeline->start, &pipeline->mutex);
+        }
+        if (pipeline->stop) {
+            pthread_mutex_unlock(&pipeline->mutex);
+            return NULL;
+        }
+        generation = pipeline->generation;
+        KSRP_PipelineWindow* window = pipeline->window;
+        pthread_mutex_unlock(&pipeline->mutex);
+
+        uint32_t chunk;
+        while (KSRP_Pipeline_TakeFront(&pipeline->deques[worker->index], &chunk)) {
+            KSRP_Pipeline_DecodeChunk(pipeline, window, chunk);
+        }
+
+        for (uint32_t i = 1; i < pipeline->threads; i++) {
+            KSRP_PipelineDeque* victim = &pipeline->deques[(worker->index + i) % pipeline->threads];
+            while (KSRP_Pipeline_TakeBack(victim, &chunk)) {
+                atomic_fetch_add_explicit(&pipeline->stolen_chunks, 1, memory_order_relaxed);
+                KSRP_Pipeline_DecodeChunk(pipeline, window, chunk);
+            }
+        }
+
+        pthread_mutex_lock(&pipeline->mutex);
+        if (--pipeline->busy == 0) {
+            pthread_cond_signal(&pipeline->done);
+        }
+        pthread_mutex_unlock(&pipeline->mutex);
+    }
+}
+
+static void KSRP_Pipeline_StartWindow(KSRP_Pipeline* pipeline, KSRP_PipelineWindow* window, size_t first,
+                                      size_t frames_count, uint32_t window_frames) {
+    window->first = first;
+    window->frames_count = frames_count - first < window_frames ? (uint32_t)(frames_count - first) : window_frames;
+    window->chunks_count = (window->frames_count + pipeline->chunk_frames - 1) / pipeline->chunk_frames;
+
+    // Every worker starts with contiguous block of chunks, so frames it decodes stay close in memory
+    for (uint32_t i = 0; i < pipeline->threads; i++) {
+        uint32_t begin = (uint32_t)((uint64_t)window->chunks_count * i / pipeline->threads);
+        uint32_t end = (uint32_t)((uint64_t)window->chunks_count * (i + 1) / pipeline->threads);
+        atomic_store_explicit(&pipeline->deques[i].range, KSRP_PIPELINE_RANGE(begin, end), memory_order_relaxed);
+    }
+
+    pthread_mutex_lock(&pipeline->mutex);
+    pipeline->window = window;
+    pipeline->busy = pipeline->threads;
+    pipeline->generation++;
+    pthread_cond_broadcast(&pipeline->start);
+    pthread_mutex_unlock(&pipeline->mutex);
+}
+
+static void KSRP_Pipeline_WaitWindow(KSRP_Pipeline* pipeline) {
+    pthread_mutex_lock(&pipeline->mutex);
+    while (pipeline->busy != 0) {
+        pthread_cond_wait(&pipeline->done, &pipeline->mutex);
+    }
+    pthread_mutex_unlock(&pipeline->mutex);
+}
+
+static bool KSRP_Pipeline_Before(const KSRP_Pipeline* pipeline, const KSRP_PipelineWindow* window,
+                                 const uint32_t* cursors, uint32_t chunk1, uint32_t chunk2) {
+    uint64_t timestamp1 = pipeline->frames[window->first + window->order[cursors[chunk1]]].timestamp;
+    uint64_t timestamp2 = pipeline->frames[window->first + window->order[cursors[chunk2]]].timestamp;
+
+    return timestamp1 < timestamp2 || (timestamp1 == timestamp2 && chunk1 < chunk2);
+}
+
+static void KSRP_Pipeline_SiftDown(const KSRP_Pipeline* pipeline, const KSRP_PipelineWindow* window,
+                                   const uint32_t* cursors, uint32_t* heap, uint32_t heap_size, uint32_t index) {
+    for (;;) {
+        uint32_t smallest = index;
+        uint32_t left = 2 * index + 1;
+        uint32_t right = left + 1;
+        if (left < heap_size && KSRP_Pipeline_Before(pipeline, window, cursors, heap[left], heap[smallest])) {
+            smallest = left;
+        }
+        if (right < heap_size && KSRP_Pipeline_Before(pipeline, window, cursors, heap[right], heap[smallest])) {
+            smallest = right;
+        }
+        if (smallest == index) {
+            return;
+        }
+
+        uint32_t chunk = heap[index];
+        heap[index] = heap[smallest];
+        heap[smallest] = chunk;
+        index = smallest;
+    }
+}
+
+static void KSRP_Pipeline_MergeWindow(KSRP_Pipeline* pipeline, const KSRP_PipelineWindow* window, uint32_t* cursors,
+                                      uint32_t* heap, KSRP_PipelineStats* stats) {
+    const KSRP_PipelineConfig* config = pipeline->config;
+    uint32_t heap_size = window->chunks_count;
+
+    // Chunks are merged with a min-heap keyed by timestamp of their next frame
+    for (uint32_t chunk = 0; chunk < window->chunks_count; chunk++) {
+        cursors[chunk] = chunk * pipeline->chunk_frames;
+        heap[chunk] = chunk;
+    }
+    for (uint32_t i = heap_size / 2; i-- > 0;) {
+        KSRP_Pipeline_SiftDown(pipeline, window, cursors, heap, heap_size, i);
+    }
+
+    while (heap_size > 0) {
+        uint32_t chunk = heap[0];
+        uint32_t index = window->order[cursors[chunk]];
+
+        if (window->statuses[index] != KSRP_STATUS_OK) {
+            stats->decode_failed++;
+        } else if (config->apply(window->decoded + (size_t)index * config->decoded_size,
+                                 pipeline->frames[window->first + index].timestamp,
+                                 config->context) != KSRP_STATUS_OK) {
+            stats->apply_failed++;
+        }
+        stats->frames++;
+
+        uint32_t chunk_end = (chunk + 1) * pipeline->chunk_frames;
+        if (++cursors[chunk] == (chunk_end < window->frames_count ? chunk_end : window->frames_count)) {
+            heap[0] = heap[--heap_size];
+        }
+        KSRP_Pipeline_SiftDown(pipeline, window, cursors, heap, heap_size, 0);
+    }
+}
+
+static uint32_t KSRP_Pipeline_DefaultThreads(void) {
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    return processors > 0 ? (uint32_t)processors : 1;
+}
+
+KSRP_Status KSRP_Pipeline_Run(const KSRP_PipelineConfig* config, const KSRP_TimedFrame* frames, size_t frames_count,
+                              KSRP_PipelineStats* stats) {
+    KSRP_PipelineStats local_stats = {0};
+    if (stats == NULL) {
+        stats = &local_stats;
+    }
+    *stats = (KSRP_PipelineStats){0};
+
+    if (config == NULL || config->decode == NULL || config->apply == NULL || config->decoded_size == 0 ||
+        (frames == NULL && frames_count > 0)) {
+        return KSRP_STATUS_ERROR;
+    }
+    if (frames_count == 0) {
+        return KSRP_STATUS_OK;
+    }
+
+    KSRP_Pipeline pipeline = {
+        .config = config,
+        .frames = frames,
+        .threads = config->threads ? config->threads : KSRP_Pipeline_DefaultThreads(),
+        .chunk_frames = config->chunk_frames ? config->chunk_frames : KSRP_PIPELINE_DEFAULT_CHUNK_FRAMES,
+    };
+    atomic_init(&pipeline.stolen_chunks, 0);
+
+    uint64_t window_chunks = (uint64_t)pipeline.threads * KSRP_PIPELINE_CHUNKS_PER_THREAD;
+    if (window_chunks * pipeline.chunk_frames > UINT32_MAX) {
+        return KSRP_STATUS_ERROR;
+    }
+    uint32_t window_frames = (uint32_t)(window_chunks * pipeline.chunk_frames);
+    // Short recordings don't need windows larger than themselves
+    if (window_frames > frames_count) {
+        window_frames = (uint32_t)frames_count;
+    }
+
+    KSRP_PipelineWindow windows[2] = {0};
+    KSRP_PipelineWorker* workers = calloc(pipeline.threads, sizeof(KSRP_PipelineWorker));
+    uint32_t* cursors = calloc(window_chunks, sizeof(uint32_t));
+    uint32_t* heap = calloc(window_chunks, sizeof(uint32_t));
+    pipeline.deques = aligned_alloc(KSRP_PIPELINE_CACHE_LINE, pipeline.threads * sizeof(KSRP_PipelineDeque));
+    bool allocated = workers != NULL && cursors != NULL && heap != NULL && pipeline.deques != NULL;
+    for (uint32_t i = 0; i < 2; i++) {
+        windows[i].decoded = malloc((size_t)window_frames * config->decoded_size);
+        windows[i].statuses = malloc((size_t)window_frames * sizeof(KSRP_Status));
+        windows[i].order = malloc((size_t)window_frames * sizeof(uint32_t));
+        allocated = allocated && windows[i].decoded != NULL && windows[i].statuses != NULL && windows[i].order != NULL;
+    }
+
+    uint32_t started = 0;
+    if (allocated) {
+        pthread_mutex_init(&pipeline.mutex, NULL);
+        pthread_cond_init(&pipeline.start, NULL);
+        pthread_cond_init(&pipeline.done, NULL);
+
+        for (uint32_t i = 0; i < pipeline.threads; i++) {
+            atomic_init(&pipeline.deques[i].range, 0);
+        }
+        for (; started < pipeline.threads; started++) {
+            workers[started].pipeline = &pipeline;
+            workers[started].index = started;
+            if (pthread_create(&workers[started].thread, NULL, KSRP_Pipeline_Worker, &workers[started]) != 0) {
+                break;
+            }
+        }
+    }
+
+    // Chunks are split only between workers that started, one running worker is enough
+    KSRP_Status status = started > 0 ? KSRP_STATUS_OK : KSRP_STATUS_ERROR;
+    if (status == KSRP_STATUS_OK) {
+        pipeline.threads = started;
+
+        KSRP_Pipeline_StartWindow(&pipeline, &windows[0], 0, frames_count, window_frames);
+        for (uint32_t current = 0;; current ^= 1) {
+            KSRP_Pipeline_WaitWindow(&pipeline);
+
+            size_t next = windows[current].first + windows[current].frames_count;
+            if (next < frames_count) {
+                KSRP_Pipeline_StartWindow(&pipeline, &windows[current ^ 1], next, frames_count, window_frames);
+            }
+
+            KSRP_Pipeline_MergeWindow(&pipeline, &windows[current], cursors, heap, stats);
+            if (next >= frames_count) {
+                break;
+            }
+        }
+    }
+
+    if (allocated) {
+        pthread_mutex_lock(&pipeline.mutex);
+        pipeline.stop = true;
+        pthread_cond_broadcast(&pipeline.start);
+        pthread_mutex_unlock(&pipeline.mutex);
+        for (uint32_t i = 0; i < started; i++) {
+            pthread_join(workers[i].thread, NULL);
+        }
+
+        pthread_cond_destroy(&pipeline.done);
+        pthread_cond_destroy(&pipeline.start);
+        pthread_mutex_destroy(&pipeline.mutex);
+    }
+
+    stats->stolen_chunks = atomic_load_explicit(&pipeline.stolen_chunks, memory_order_relaxed);
+
+    for (uint32_t i = 0; i < 2; i++) {
+        free(windows[i].decoded);
+        free(windows[i].statuses);
+        free(windows[i].order);
+    }
+    free(pipeline.deques);
+    free(heap);
+    free(cursors);
+    free(workers);
+
+    return status;
+}
\ No newline at end of file
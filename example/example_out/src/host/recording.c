@@ -0,0 +1,359 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "ksrp/host/recording.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ksrp/delta.h"
+#include "ksrp/endianness.h"
+
+#define KSRP_RECORDING_TYPES_COUNT 0x10000
+
+static void KSRP_Recording_StoreHeader(uint8_t* header, uint64_t protocol_hash, uint64_t records_count,
+                                       uint64_t index_offset, uint32_t flags, uint32_t types_count) {
+    memset(header, 0, KSRP_RECORDING_HEADER_SIZE);
+    memcpy(header, KSRP_RECORDING_MAGIC, 8);
+    KSRP_StoreLE32(&header[8], KSRP_RECORDING_VERSION);
+    KSRP_StoreLE32(&header[12], KSRP_RECORDING_RECORD_SIZE);
+    KSRP_StoreLE64(&header[16], protocol_hash);
+    KSRP_StoreLE64(&header[24], records_count);
+    KSRP_StoreLE64(&header[32], index_offset);
+    KSRP_StoreLE32(&header[40], flags);
+    KSRP_StoreLE32(&header[44], types_count);
+}
+
+_nonnull_
+KSRP_Status KSRP_RecordingWriter_Open(KSRP_RecordingWriter* writer, const char* path, uint64_t protocol_hash) {
+    memset(writer, 0, sizeof(KSRP_RecordingWriter));
+    writer->protocol_hash = protocol_hash;
+    writer->sorted = true;
+
+    writer->file = fopen(path, "wb");
+    if (writer->file == NULL) {
+        return KSRP_STATUS_ERROR;
+    }
+
+    // Header of unfinished recording has no index, it is rewritten on close
+    uint8_t header[KSRP_RECORDING_HEADER_SIZE];
+    KSRP_Recording_StoreHeader(header, protocol_hash, 0, 0, 0, 0);
+    if (fwrite(header, sizeof(header), 1, writer->file) != 1) {
+        fclose(writer->file);
+        writer->file = NULL;
+        return KSRP_STATUS_ERROR;
+    }
+
+    return KSRP_STATUS_OK;
+}
+
+_nonnull_
+KSRP_Status KSRP_RecordingWriter_Append(KSRP_RecordingWriter* writer, uint64_t timestamp,
+                                        const KSRP_RawData_Frame* frame) {
+    if (writer->file == NULL || writer->records_count >= KSRP_RECORDING_MAX_RECORDS) {
+        return KSRP_STATUS_ERROR;
+    }
+
+    if (frame->length < KSRP_ID_BYTES || frame->length > KSRP_RAW_DATA_FRAME_BUFFER_SIZE) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    if (writer->records_count == writer->type_ids_capacity) {
+        uint64_t capacity = writer->type_ids_capacity ? writer->type_ids_capacity * 2 : 4096;
+        KSRP_TypeID* type_ids = realloc(writer->type_ids, capacity * sizeof(KSRP_TypeID));
+        if (type_ids == NULL) {
+            return KSRP_STATUS_ERROR;
+        }
+        writer->type_ids = type_ids;
+        writer->type_ids_capacity = capacity;
+    }
+
+    KSRP_TypeID type_id = KSRP_Delta_IsDelta(frame) ? KSRP_Delta_GetTypeID(frame) : KSRP_RawData_Frame_GetTypeID(frame);
+
+    uint8_t record[KSRP_RECORDING_RECORD_SIZE] = {0};
+    KSRP_StoreLE64(&record[0], timestamp);
+    KSRP_StoreLE16(&record[8], type_id);
+    record[10] = frame->length;
+    memcpy(&record[16], frame->data, frame->length);
+    if (fwrite(record, sizeof(record), 1, writer->file) != 1) {
+        return KSRP_STATUS_ERROR;
+    }
+
+    writer->type_ids[writer->records_count++] = type_id;
+    writer->sorted = writer->sorted && timestamp >= writer->last_timestamp;
+    writer->last_timestamp = timestamp;
+
+    return KSRP_STATUS_OK;
+}
+
+static KSRP_Status KSRP_RecordingWriter_WriteIndex(KSRP_RecordingWriter* writer, uint32_t* types_count) {
+    uint32_t* counts = calloc(KSRP_RECORDING_TYPES_COUNT, sizeof(uint32_t));
+    uint64_t* next_entries = calloc(KSRP_RECORDING_TYPES_COUNT, sizeof(uint64_t));
+    uint8_t* entries = malloc(writer->records_count * sizeof(uint32_t) + 1);
+    KSRP_Status status = KSRP_STATUS_ERROR;
+
+    if (counts != NULL && next_entries != NULL && entries != NULL) {
+        for (uint64_t record = 0; record < writer->records_count; record++) {
+            counts[writer->type_ids[record]]++;
+        }
+
+        // Types are visited in order of type ID, so the table is sorted for binary search
+        status = KSRP_STATUS_OK;
+        uint64_t first_entry = 0;
+        *types_count = 0;
+        for (uint32_t type_id = 0; type_id < KSRP_RECORDING_TYPES_COUNT && status == KSRP_STATUS_OK; type_id++) {
+            if (counts[type_id] == 0) {
+                continue;
+            }
+
+            uint8_t type[KSRP_RECORDING_INDEX_TYPE_SIZE] = {0};
+            KSRP_StoreLE16(&type[0], (uint16_t)type_id);
+            KSRP_StoreLE32(&type[4], counts[type_id]);
+            KSRP_StoreLE64(&type[8], first_entry);
+            if (fwrite(type, sizeof(type), 1, writer->file) != 1) {
+                status = KSRP_STATUS_ERROR;
+            }
+
+            next_entries[type_id] = first_entry;
+            first_entry += counts[type_id];
+            (*types_count)++;
+        }
+
+        for (uint64_t record = 0; record < writer->records_count; record++) {
+            KSRP_StoreLE32(&entries[next_entries[writer->type_ids[record]]++ * sizeof(uint32_t)], (uint32_t)record);
+        }
+
+        if (status == KSRP_STATUS_OK && writer->records_count > 0 &&
+            fwrite(entries, writer->records_count * sizeof(uint32_t), 1, writer->file) != 1) {
+            status = KSRP_STATUS_ERROR;
+        }
+    }
+
+    free(entries);
+    free(next_entries);
+    free(counts);
+
+    return status;
+}
+
+_nonnull_
+KSRP_Status KSRP_RecordingWriter_Close(KSRP_RecordingWriter* writer) {
+    if (writer->file == NULL) {
+        return KSRP_STATUS_ERROR;
+    }
+
+    uint32_t types_count = 0;
+    KSRP_Status status = KSRP_RecordingWriter_WriteIndex(writer, &types_count);
+
+    if (status == KSRP_STATUS_OK) {
+        uint8_t header[KSRP_RECORDING_HEADER_SIZE];
+        uint64_t index_offset = KSRP_RECORDING_HEADER_SIZE + writer->records_count * KSRP_RECORDING_RECORD_SIZE;
+        KSRP_Recording_StoreHeader(header, writer->protocol_hash, writer->records_count, index_offset,
+                                   writer->sorted ? KSRP_RECORDING_FLAG_SORTED : 0, types_count);
+        if (fseek(writer->file, 0, SEEK_SET) != 0 || fwrite(header, sizeof(header), 1, writer->file) != 1) {
+            status = KSRP_STATUS_ERROR;
+        }
+    }
+
+    if (fclose(writer->file) != 0) {
+        status = KSRP_STATUS_ERROR;
+    }
+    free(writer->type_ids);
+    memset(writer, 0, sizeof(KSRP_RecordingWriter));
+
+    return status;
+}
+
+static const uint8_t* KSRP_RecordingReader_Record(const KSRP_RecordingReader* reader, uint64_t record) {
+    return reader->data + KSRP_RECORDING_HEADER_SIZE + record * KSRP_RECORDING_RECORD_SIZE;
+}
+
+static uint64_t KSRP_RecordingReader_Entry(const KSRP_RecordingReader* reader, uint64_t entry) {
+    return KSRP_LoadLE32(&reader->entries[entry * sizeof(uint32_t)]);
+}
+
+_nonnull_
+KSRP_Status KSRP_RecordingReader_Open(KSRP_RecordingReader* reader, const char* path) {
+    memset(reader, 0, sizeof(KSRP_RecordingReader));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return KSRP_STATUS_ERROR;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        return KSRP_STATUS_ERROR;
+    }
+
+    if (file_stat.st_size < KSRP_RECORDING_HEADER_SIZE) {
+        close(fd);
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    void* data = mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return KSRP_STATUS_ERROR;
+    }
+
+    reader->data = data;
+    reader->size = (size_t)file_stat.st_size;
+
+    const uint8_t* header = reader->data;
+    if (memcmp(header, KSRP_RECORDING_MAGIC, 8) != 0 || KSRP_LoadLE32(&header[8]) != KSRP_RECORDING_VERSION ||
+        KSRP_LoadLE32(&header[12]) != KSRP_RECORDING_RECORD_SIZE) {
+        KSRP_RecordingReader_Close(reader);
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    reader->protocol_hash = KSRP_LoadLE64(&header[16]);
+    uint64_t index_offset = KSRP_LoadLE64(&header[32]);
+    if (index_offset == 0) {
+        // Recording wasn't closed, every complete record is still readable
+        reader->records_count = (reader->size - KSRP_RECORDING_HEADER_SIZE) / KSRP_RECORDING_RECORD_SIZE;
+        return KSRP_STATUS_OK;
+    }
+
+    reader->records_count = KSRP_LoadLE64(&header[24]);
+    reader->flags = KSRP_LoadLE32(&header[40]);
+    reader->types_count = KSRP_LoadLE32(&header[44]);
+    if (reader->records_count > KSRP_RECORDING_MAX_RECORDS ||
+        index_offset != KSRP_RECORDING_HEADER_SIZE + reader->records_count * KSRP_RECORDING_RECORD_SIZE ||
+        index_offset > reader->size ||
+        (uint64_t)reader->types_count * KSRP_RECORDING_INDEX_TYPE_SIZE + reader->records_count * sizeof(uint32_t) >
+            reader->size - index_offset) {
+        KSRP_RecordingReader_Close(reader);
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    reader->types = reader->data + index_offset;
+    reader->entries = reader->types + (size_t)reader->types_count * KSRP_RECORDING_INDEX_TYPE_SIZE;
+
+    return KSRP_STATUS_OK;
+}
+
+_nonnull_
+void KSRP_RecordingReader_Close(KSRP_RecordingReader* reader) {
+    if (reader->data != NULL) {
+        munmap((void*)reader->data, reader->size);
+    }
+    memset(reader, 0, sizeof(KSRP_RecordingReader));
+}
+
+_nonnull_
+KSRP_Status KSRP_RecordingReader_Get(const KSRP_RecordingReader* reader, uint64_t record, KSRP_TimedFrame* frame) {
+    if (record >= reader->records_count) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    const uint8_t* data = KSRP_RecordingReader_Record(reader, record);
+    if (data[10] > KSRP_RAW_DATA_FRAME_BUFFER_SIZE) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    frame->timestamp = KSRP_LoadLE64(&data[0]);
+    frame->frame.length = data[10];
+    memcpy(frame->frame.data, &data[16], KSRP_RAW_DATA_FRAME_BUFFER_SIZE);
+
+    return KSRP_STATUS_OK;
+}
+
+_nonnull_
+void KSRP_RecordingReader_Query(const KSRP_RecordingReader* reader, KSRP_TypeID type_id, uint64_t from, uint64_t to,
+                                KSRP_RecordingCursor* cursor) {
+    *cursor = (KSRP_RecordingCursor){
+        .reader = reader,
+        .type_id = type_id,
+        .from = from,
+        .to = to,
+        .position = 0,
+        .end = reader->records_count,
+        .indexed = reader->types != NULL,
+    };
+
+    if (!cursor->indexed) {
+        return;
+    }
+
+    cursor->end = 0;
+    uint32_t low = 0;
+    uint32_t high = reader->types_count;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        const uint8_t* type = &reader->types[(size_t)middle * KSRP_RECORDING_INDEX_TYPE_SIZE];
+        KSRP_TypeID middle_type_id = KSRP_LoadLE16(&type[0]);
+
+        if (middle_type_id == type_id) {
+            cursor->position = KSRP_LoadLE64(&type[8]);
+            cursor->end = cursor->position + KSRP_LoadLE32(&type[4]);
+            if (cursor->end > reader->records_count) {
+                cursor->position = cursor->end = 0;
+            }
+            break;
+        }
+
+        if (middle_type_id < type_id) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    if (!(reader->flags & KSRP_RECORDING_FLAG_SORTED)) {
+        return;
+    }
+
+    // Entries of a type are in recording order, so in sorted recording their timestamps don't decrease. Corrupted
+    // entries beyond the records aren't read, KSRP_RecordingCursor_Next skips them
+    uint64_t first = cursor->position;
+    uint64_t last = cursor->end;
+    while (first < last) {
+        uint64_t middle = first + (last - first) / 2;
+        uint64_t record = KSRP_RecordingReader_Entry(reader, middle);
+        if (record < reader->records_count && KSRP_LoadLE64(KSRP_RecordingReader_Record(reader, record)) < from) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    cursor->position = first;
+}
+
+_nonnull_
+KSRP_Status KSRP_RecordingCursor_Next(KSRP_RecordingCursor* cursor, KSRP_TimedFrame* frame) {
+    const KSRP_RecordingReader* reader = cursor->reader;
+
+    while (cursor->position < cursor->end) {
+        uint64_t record = cursor->indexed ? KSRP_RecordingReader_Entry(reader, cursor->position) : cursor->position;
+        cursor->position++;
+
+        if (record >= reader->records_count) {
+            continue;
+        }
+
+        const uint8_t* data = KSRP_RecordingReader_Record(reader, record);
+        if (!cursor->indexed && KSRP_LoadLE16(&data[8]) != cursor->type_id) {
+            continue;
+        }
+
+        uint64_t timestamp = KSRP_LoadLE64(&data[0]);
+        if (timestamp >= cursor->to) {
+            if (reader->flags & KSRP_RECORDING_FLAG_SORTED) {
+                cursor->position = cursor->end;
+                break;
+            }
+            continue;
+        }
+
+        if (timestamp >= cursor->from && KSRP_RecordingReader_Get(reader, record, frame) == KSRP_STATUS_OK) {
+            return KSRP_STATUS_OK;
+        }
+    }
+
+    return KSRP_STATUS_ERROR;
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+#define _GNU_SOURCE
+
+#include "ksrp/host/socketcan.h"
+
+#include <errno.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define KSRP_SOCKETCAN_LENGTH_MASK 0x3F
+#define KSRP_SOCKETCAN_CLASSIC_PAYLOAD_BYTES 8
+
+// Payload of CAN FD frame has to have one of the lengths 0-8, 12, 16, 20, 24, 32, 48 or 64 bytes
+static uint8_t KSRP_SocketCan_PaddedLength(uint8_t length) {
+    static const uint8_t lengths[] = {12, 16, 20, 24, 32, 48, 64};
+
+    if (length <= KSRP_SOCKETCAN_CLASSIC_PAYLOAD_BYTES) {
+        return length;
+    }
+
+    for (uint32_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        if (length <= lengths[i]) {
+            return lengths[i];
+        }
+    }
+
+    return CANFD_MAX_DLEN;
+}
+
+static KSRP_Status KSRP_SocketCan_Send(void* backend, const KSRP_RawData_Frame* frames, uint32_t count,
+                                       uint32_t* sent) {
+    KSRP_SocketCan* can = (KSRP_SocketCan*)backend;
+    struct canfd_frame can_frames[KSRP_SOCKETCAN_BATCH_FRAMES];
+    struct mmsghdr messages[KSRP_SOCKETCAN_BATCH_FRAMES];
+    struct iovec vectors[KSRP_SOCKETCAN_BATCH_FRAMES];
+
+    *sent = 0;
+    while (*sent < count) {
+        uint32_t batch = count - *sent < KSRP_SOCKETCAN_BATCH_FRAMES ? count - *sent : KSRP_SOCKETCAN_BATCH_FRAMES;
+
+        memset(messages, 0, batch * sizeof(struct mmsghdr));
+        for (uint32_t i = 0; i < batch; i++) {
+            const KSRP_RawData_Frame* frame = &frames[*sent + i];
+            if (frame->length < KSRP_ID_BYTES) {
+                return KSRP_STATUS_ERROR;
+            }
+
+            uint8_t payload_length = frame->length - KSRP_ID_BYTES;
+            struct canfd_frame* can_frame = &can_frames[i];
+
+            memset(can_frame, 0, sizeof(struct canfd_frame));
+            can_frame->can_id = KSRP_SOCKETCAN_MAKE_CAN_ID(can->base_id, payload_length,
+                                                           KSRP_RawData_Frame_GetTypeID(frame)) |
+                                CAN_EFF_FLAG;
+            can_frame->len = KSRP_SocketCan_PaddedLength(payload_length);
+            memcpy(can_frame->data, &frame->data[KSRP_ID_BYTES], payload_length);
+
+            // Classic CAN frame is the prefix of CAN FD frame, so both are sent from the same buffer
+            vectors[i].iov_base = can_frame;
+            vectors[i].iov_len = payload_length <= KSRP_SOCKETCAN_CLASSIC_PAYLOAD_BYTES ? CAN_MTU : CANFD_MTU;
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int result = sendmmsg(can->socket, messages, batch, MSG_DONTWAIT);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS ? KSRP_STATUS_BUSY : KSRP_STATUS_ERROR;
+        }
+
+        *sent += (uint32_t)result;
+        if ((uint32_t)result < batch) {
+            // Transmit queue of the interface is full, failure of the next frame if any is reported by the next send
+            return KSRP_STATUS_BUSY;
+        }
+    }
+
+    return KSRP_STATUS_OK;
+}
+
+static KSRP_Status KSRP_SocketCan_Receive(void* backend, KSRP_RawData_Frame* frames, uint32_t capacity,
+                                          uint32_t* received) {
+    KSRP_SocketCan* can = (KSRP_SocketCan*)backend;
+    struct canfd_frame can_frames[KSRP_SOCKETCAN_BATCH_FRAMES];
+    struct mmsghdr messages[KSRP_SOCKETCAN_BATCH_FRAMES];
+    struct iovec vectors[KSRP_SOCKETCAN_BATCH_FRAMES];
+
+    while (*received < capacity) {
+        uint32_t batch = capacity - *received < KSRP_SOCKETCAN_BATCH_FRAMES ? capacity - *received
+                                                                             : KSRP_SOCKETCAN_BATCH_FRAMES;
+
+        memset(messages, 0, batch * sizeof(struct mmsghdr));
+        for (uint32_t i = 0; i < batch; i++) {
+            vectors[i].iov_base = &can_frames[i];
+            vectors[i].iov_len = sizeof(struct canfd_frame);
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int result = recvmmsg(can->socket, messages, batch, MSG_DONTWAIT, NULL);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK ? KSRP_STATUS_OK : KSRP_STATUS_ERROR;
+        }
+
+        for (uint32_t i = 0; i < (uint32_t)result; i++) {
+            const struct canfd_frame* can_frame = &can_frames[i];
+            uint8_t payload_length = (uint8_t)((can_frame->can_id >> 16) & KSRP_SOCKETCAN_LENGTH_MASK);
+
+            // Filter passes only extended data frames with base ID of the socket
+            if ((messages[i].msg_len != CAN_MTU && messages[i].msg_len != CANFD_MTU) ||
+                payload_length > can_frame->len || payload_length > KSRP_MAX_FRAME_SIZE) {
+                can->dropped++;
+                continue;
+            }
+
+            KSRP_RawData_Frame* frame = &frames[(*received)++];
+            frame->data[0] = (uint8_t)((can_frame->can_id >> 8) & 0xFF);
+            frame->data[1] = (uint8_t)(can_frame->can_id & 0xFF);
+            memcpy(&frame->data[KSRP_ID_BYTES], can_frame->data, payload_length);
+            frame->length = KSRP_ID_BYTES + payload_length;
+        }
+
+        if ((uint32_t)result < batch) {
+            break;
+        }
+    }
+
+    return KSRP_STATUS_OK;
+}
+
+static KSRP_Status KSRP_SocketCan_Wait(void* backend, uint32_t timeout_ms) {
+    KSRP_SocketCan* can = (KSRP_SocketCan*)backend;
+    struct pollfd descriptor = {.fd = can->socket, .events = POLLIN};
+
+    int result = poll(&descriptor, 1, timeout_ms > INT32_MAX ? -1 : (int)timeout_ms);
+    if (result < 0) {
+        return errno == EINTR ? KSRP_STATUS_BUSY : KSRP_STATUS_ERROR;
+    }
+
+    return result > 0 ? KSRP_STATUS_OK : KSRP_STATUS_BUSY;
+}
+
+static const KSRP_TransportOps KSRP_SOCKETCAN_OPS = {
+    .send = KSRP_SocketCan_Send,
+    .receive = KSRP_SocketCan_Receive,
+    .wait = KSRP_SocketCan_Wait,
+};
+
+_nonnull_
+KSRP_Status KSRP_SocketCan_Open(KSRP_SocketCan* can, KSRP_Transport* transport, const char* interface,
+                                uint8_t base_id) {
+    memset(can, 0, sizeof(KSRP_SocketCan));
+    can->socket = -1;
+
+    if (base_id > KSRP_SOCKETCAN_MAX_BASE_ID) {
+        return KSRP_STATUS_ERROR;
+    }
+    can->base_id = base_id;
+
+    unsigned int index = if_nametoindex(interface);
+    if (index == 0) {
+        return KSRP_STATUS_ERROR;
+    }
+
+    can->socket = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+    if (can->socket < 0) {
+        return KSRP_STATUS_ERROR;
+    }
+
+    int enable = 1;
+    struct can_filter filter = {
+        .can_id = KSRP_SOCKETCAN_MAKE_CAN_ID(base_id, 0, 0) | CAN_EFF_FLAG,
+        .can_mask = KSRP_SOCKETCAN_MAKE_CAN_ID(KSRP_SOCKETCAN_MAX_BASE_ID, 0, 0) | CAN_EFF_FLAG | CAN_RTR_FLAG,
+    };
+    struct sockaddr_can address = {.can_family = AF_CAN, .can_ifindex = (int)index};
+
+    if (setsockopt(can->socket, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &enable, sizeof(enable)) != 0 ||
+        setsockopt(can->socket, SOL_CAN_RAW, CAN_RAW_FILTER, &filter, sizeof(filter)) != 0 ||
+        bind(can->socket, (struct sockaddr*)&address, sizeof(address)) != 0) {
+        KSRP_SocketCan_Close(can);
+        return KSRP_STATUS_ERROR;
+    }
+
+    KSRP_Transport_Init(transport, &KSRP_SOCKETCAN_OPS, can);
+
+    return KSRP_STATUS_OK;
+}
+
+_nonnull_
+void KSRP_SocketCan_Close(KSRP_SocketCan* can) {
+    if (can->socket >= 0) {
+        close(can->socket);
+        can->socket = -1;
+    }
+}
+
+_nonnull_
+uint32_t KSRP_SocketCan_GetDropped(const KSRP_SocketCan* can) {
+    return can->dropped;
+}
\ No newline at end of file
@@ -0,0 +1,210 @@
+#define _GNU_SOURCE
+
+#include "ksrp/host/udp.h"
+
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static KSRP_Status KSRP_Udp_Send(void* backend, const KSRP_RawData_Frame* frames, uint32_t count, uint32_t* sent) {
+    KSRP_Udp* udp = (KSRP_Udp*)backend;
+    struct mmsghdr messages[KSRP_UDP_BATCH_FRAMES];
+    struct iovec vectors[KSRP_UDP_BATCH_FRAMES];
+
+    if (!udp->has_peer) {
+        return KSRP_STATUS_ERROR;
+    }
+
+    *sent = 0;
+    while (*sent < count) {
+        uint32_t batch = count - *sent < KSRP_UDP_BATCH_FRAMES ? count - *sent : KSRP_UDP_BATCH_FRAMES;
+
+        memset(messages, 0, batch * sizeof(struct mmsghdr));
+        for (uint32_t i = 0; i < batch; i++) {
+            vectors[i].iov_base = (void*)frames[*sent + i].data;
+            vectors[i].iov_len = frames[*sent + i].length;
+            messages[i].msg_hdr.msg_name = &udp->peer;
+            messages[i].msg_hdr.msg_namelen = udp->peer_length;
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int result = sendmmsg(udp->socket, messages, batch, MSG_DONTWAIT);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS ? KSRP_STATUS_BUSY : KSRP_STATUS_ERROR;
+        }
+
+        *sent += (uint32_t)result;
+        if ((uint32_t)result < batch) {
+            // Socket buffer is full, failure of the next datagram if any is reported by the next send
+            return KSRP_STATUS_BUSY;
+        }
+    }
+
+    return KSRP_STATUS_OK;
+}
+
+static KSRP_Status KSRP_Udp_Receive(void* backend, KSRP_RawData_Frame* frames, uint32_t capacity,
+                                    uint32_t* received) {
+    KSRP_Udp* udp = (KSRP_Udp*)backend;
+    struct mmsghdr messages[KSRP_UDP_BATCH_FRAMES];
+    struct iovec vectors[KSRP_UDP_BATCH_FRAMES];
+    struct sockaddr_storage senders[KSRP_UDP_BATCH_FRAMES];
+
+    while (*received < capacity) {
+        uint32_t batch = capacity - *received < KSRP_UDP_BATCH_FRAMES ? capacity - *received : KSRP_UDP_BATCH_FRAMES;
+
+        // Datagrams are received directly into the frames, invalid ones are overwritten by the following ones
+        memset(messages, 0, batch * sizeof(struct mmsghdr));
+        for (uint32_t i = 0; i < batch; i++) {
+            vectors[i].iov_base = frames[*received + i].data;
+            vectors[i].iov_len = KSRP_RAW_DATA_FRAME_BUFFER_SIZE;
+            messages[i].msg_hdr.msg_name = &senders[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int result = recvmmsg(udp->socket, messages, batch, MSG_DONTWAIT, NULL);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK ? KSRP_STATUS_OK : KSRP_STATUS_ERROR;
+        }
+
+        uint32_t valid = 0;
+        for (uint32_t i = 0; i < (uint32_t)result; i++) {
+            if ((messages[i].msg_hdr.msg_flags & MSG_TRUNC) || messages[i].msg_len < KSRP_ID_BYTES) {
+                udp->dropped++;
+                continue;
+            }
+
+            KSRP_RawData_Frame* frame = &frames[*received + valid];
+            if (i != valid) {
+                memcpy(frame->data, frames[*received + i].data, messages[i].msg_len);
+            }
+            frame->length = (uint8_t)messages[i].msg_len;
+            valid++;
+
+            if (udp->learn_peer) {
+                udp->peer = senders[i];
+                udp->peer_length = messages[i].msg_hdr.msg_namelen;
+                udp->has_peer = true;
+            }
+        }
+        *received += valid;
+
+        if ((uint32_t)result < batch) {
+            break;
+        }
+    }
+
+    return KSRP_STATUS_OK;
+}
+
+static KSRP_Status KSRP_Udp_Wait(void* backend, uint32_t timeout_ms) {
+    KSRP_Udp* udp = (KSRP_Udp*)backend;
+    struct pollfd descriptor = {.fd = udp->socket, .events = POLLIN};
+
+    int result = poll(&descriptor, 1, timeout_ms > INT32_MAX ? -1 : (int)timeout_ms);
+    if (result < 0) {
+        return errno == EINTR ? KSRP_STATUS_BUSY : KSRP_STATUS_ERROR;
+    }
+
+    return result > 0 ? KSRP_STATUS_OK : KSRP_STATUS_BUSY;
+}
+
+static const KSRP_TransportOps KSRP_UDP_OPS = {
+    .send = KSRP_Udp_Send,
+    .receive = KSRP_Udp_Receive,
+    .wait = KSRP_Udp_Wait,
+};
+
+KSRP_Status KSRP_Udp_Open(KSRP_Udp* udp, KSRP_Transport* transport, const char* bind_host, const char* bind_port,
+                          const char* peer_host, const char* peer_port) {
+    struct addrinfo hints = {.ai_family = AF_UNSPEC, .ai_socktype = SOCK_DGRAM, .ai_flags = AI_PASSIVE};
+    struct addrinfo* peer = NULL;
+    struct addrinfo* local = NULL;
+
+    memset(udp, 0, sizeof(KSRP_Udp));
+    udp->socket = -1;
+
+    if (peer_host != NULL) {
+        if (peer_port == NULL || getaddrinfo(peer_host, peer_port, &hints, &peer) != 0) {
+            return KSRP_STATUS_ERROR;
+        }
+        // Local address has to be of the same family as the peer
+        hints.ai_family = peer->ai_family;
+    }
+
+    if (getaddrinfo(bind_host, bind_port, &hints, &local) != 0) {
+        if (peer != NULL) {
+            freeaddrinfo(peer);
+        }
+        return KSRP_STATUS_ERROR;
+    }
+
+    udp->socket = socket(local->ai_family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (udp->socket < 0 || bind(udp->socket, local->ai_addr, local->ai_addrlen) != 0) {
+        freeaddrinfo(local);
+        if (peer != NULL) {
+            freeaddrinfo(peer);
+        }
+        KSRP_Udp_Close(udp);
+        return KSRP_STATUS_ERROR;
+    }
+    freeaddrinfo(local);
+
+    if (peer != NULL) {
+        memcpy(&udp->peer, peer->ai_addr, peer->ai_addrlen);
+        udp->peer_length = peer->ai_addrlen;
+        udp->has_peer = true;
+        freeaddrinfo(peer);
+    } else {
+        udp->learn_peer = true;
+    }
+
+    KSRP_Transport_Init(transport, &KSRP_UDP_OPS, udp);
+
+    return KSRP_STATUS_OK;
+}
+
+_nonnull_
+void KSRP_Udp_Close(KSRP_Udp* udp) {
+    if (udp->socket >= 0) {
+        close(udp->socket);
+        udp->socket = -1;
+    }
+}
+
+_nonnull_
+uint16_t KSRP_Udp_GetPort(const KSRP_Udp* udp) {
+    struct sockaddr_storage local;
+    socklen_t length = sizeof(local);
+
+    if (getsockname(udp->socket, (struct sockaddr*)&local, &length) != 0) {
+        return 0;
+    }
+
+    if (local.ss_family == AF_INET) {
+        return ntohs(((struct sockaddr_in*)&local)->sin_port);
+    }
+    if (local.ss_family == AF_INET6) {
+        return ntohs(((struct sockaddr_in6*)&local)->sin6_port);
+    }
+
+    return 0;
+}
+
+_nonnull_
+uint32_t KSRP_Udp_GetDropped(const KSRP_Udp* udp) {
+    return udp->dropped;
+}
\ No newline at end of file
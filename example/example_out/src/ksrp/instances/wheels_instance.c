@@ -1,10 +1,74 @@
 /**
  * @file wheels_instance.c
  * @brief Instance file for the wheels subsystem, containing structure managing subsystem's status
- */// Include standard libraries
+ */
+
+// Include standard libraries
 
 // Include user libraries
+#include "ksrp/batch.h"
+#include "ksrp/endianness.h"
 #include "ksrp/instances/wheels_instance.h"
+/**
+ * @brief Re-evaluate cached health check results of fields in WHEELS_STATUS frame, health transition
+ * callback is called for every result that changed
+ *
+ * @param instance The instance to update
+ * @param device_id The ID of the device which frame is evaluated
+ * @param field_id The ID of the field to evaluate, KSRP_ILLEGAL_FIELD_ID to evaluate all fields
+ * @return KSRP_Status The status of the update, KSRP_STATUS_OK if successful
+ */
+static KSRP_Status KSRP_UpdateHealth_Wheels_WheelsStatus(
+    KSRP_Wheels_Instance* instance, uint8_t device_id, uint32_t field_id) {
+    const KSRP_Wheels_WheelsStatus_Frame* frame = &instance->wheels_status_instance[device_id];
+
+    if (field_id == KSRP_ILLEGAL_FIELD_ID || field_id == KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_FIELD_ID) {
+        KSRP_HealthCheckResult previous = instance->wheels_status_driver_status_health[device_id];
+        KSRP_HealthCheckResult current = KSRP_HealthCheckResult_Wheels_WheelsStatus_DriverStatus(frame);
+
+        if (current != previous) {
+            instance->wheels_status_driver_status_health[device_id] = current;
+
+            if (instance->wheels_status_health_callback != NULL)
+                if (instance->wheels_status_health_callback(
+                    KSRP_WHEELS_SUBSYSTEM_ID,
+                    &instance->wheels_status_instance[device_id],
+                    KSRP_WHEELS_WHEELS_STATUS_FRAME_ID,
+                    KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_FIELD_ID,
+                    previous, current) != KSRP_STATUS_OK)
+                return KSRP_STATUS_ERROR;
+        }
+    }
+
+    if (field_id == KSRP_ILLEGAL_FIELD_ID || field_id == KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_FIELD_ID) {
+        KSRP_HealthCheckResult previous = instance->wheels_status_temperature_health[device_id];
+        KSRP_HealthCheckResult current = KSRP_HealthCheckResultOfValue_Wheels_WheelsStatus_Temperature(frame->temperature);
+
+        // Result improves only when value is at least hysteresis away from the band of the previous result
+        if (current != previous && KSRP_HealthCheckResult_Worst(current, previous) == previous) {
+            const float low = (float)(frame->temperature - 5);
+            const float high = (float)(frame->temperature + 5);
+            if (KSRP_HealthCheckResultOfValue_Wheels_WheelsStatus_Temperature(low) == previous ||
+                KSRP_HealthCheckResultOfValue_Wheels_WheelsStatus_Temperature(high) == previous)
+                current = previous;
+        }
+
+        if (current != previous) {
+            instance->wheels_status_temperature_health[device_id] = current;
+
+            if (instance->wheels_status_health_callback != NULL)
+                if (instance->wheels_status_health_callback(
+                    KSRP_WHEELS_SUBSYSTEM_ID,
+                    &instance->wheels_status_instance[device_id],
+                    KSRP_WHEELS_WHEELS_STATUS_FRAME_ID,
+                    KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_FIELD_ID,
+                    previous, current) != KSRP_STATUS_OK)
+                return KSRP_STATUS_ERROR;
+        }
+    }
+
+    return KSRP_STATUS_OK;
+}
 
 /**
  * @brief Initialize all frames in the instance
@@ -14,7 +78,32 @@
  */
 _nonnull_
 KSRP_Status KSRP_Init_Wheels_Instance(KSRP_Wheels_Instance* instance) {
-    if (KSRP_Init_Wheels_WheelsStatus_Frame(&instance->wheels_status_instance) != KSRP_STATUS_OK) {
+    instance->now_ms = 0;
+
+    KSRP_DeadlineNodes_Init(instance->deadline_nodes,
+                            sizeof(instance->deadline_nodes) / sizeof(instance->deadline_nodes[0]));
+    KSRP_DeadlineQueue_Init(&instance->deadline_queues[0], instance->deadline_nodes,
+                            KSRP_WHEELS_WHEELS_STATUS_TIMEOUT_MS);
+    instance->wheels_status_stale_callback = NULL;
+
+    for (uint32_t device_id = 0; device_id < KSRP_WHEELS_MAX_DEVICES; device_id++) {
+        if (KSRP_Init_Wheels_WheelsStatus_Frame(&instance->wheels_status_instance[device_id]) != KSRP_STATUS_OK) {
+            return KSRP_STATUS_ERROR;
+        }
+        instance->wheels_status_instance[device_id].device_id = (uint8_t)device_id;
+        instance->wheels_status_last_update_ms[device_id] = instance->now_ms;
+        KSRP_DeadlineQueue_Schedule(&instance->deadline_queues[0],
+            (uint16_t)(0 * KSRP_WHEELS_MAX_DEVICES + device_id), instance->now_ms);
+        instance->wheels_status_changed_fields[device_id] = 0;
+        instance->wheels_status_deltas_since_keyframe[device_id] = KSRP_WHEELS_KEYFRAME_INTERVAL;
+        instance->wheels_status_driver_status_health[device_id] = KSRP_HealthCheckResult_Wheels_WheelsStatus_DriverStatus(
+            &instance->wheels_status_instance[device_id]);
+        instance->wheels_status_temperature_health[device_id] = KSRP_HealthCheckResult_Wheels_WheelsStatus_Temperature(
+            &instance->wheels_status_instance[device_id]);
+    }
+
+    if (KSRP_Ring_Init(&instance->rx_queue, instance->rx_queue_frames,
+                       KSRP_WHEELS_RX_QUEUE_CAPACITY) != KSRP_STATUS_OK) {
         return KSRP_STATUS_ERROR;
     }
     return KSRP_STATUS_OK;
@@ -27,7 +116,8 @@ KSRP_Status KSRP_Init_Wheels_Instance(KSRP_Wheels_Instance* instance) {
  * @param frame_id The ID of the frame to update
  * @param frame The new frame data
  * @param frame_size The size of the new frame data
- * @return KSRP_Status The status of the update, KSRP_STATUS_OK if successful
+ * @return KSRP_Status The status of the update, KSRP_STATUS_OK if successful, KSRP_STATUS_INVALID_DEVICE_ID if
+ * device_id of the frame is not lower than KSRP_WHEELS_MAX_DEVICES
  */
 _nonnull_
 KSRP_Status KSRP_UpdateFrame_Wheels_Instance(
@@ -41,29 +131,69 @@ KSRP_Status KSRP_UpdateFrame_Wheels_Instance(
                 return KSRP_STATUS_INVALID_DATA_SIZE;
             }
 
-            bool change = memcmp(&instance->wheels_status_instance, frame, frame_size) != 0;
+            uint8_t device_id = ((const KSRP_Wheels_WheelsStatus_Frame*)frame)->device_id;
+            if (device_id >= KSRP_WHEELS_MAX_DEVICES) {
+                return KSRP_STATUS_INVALID_DEVICE_ID;
+            }
+
+            bool change = memcmp(&instance->wheels_status_instance[device_id], frame, frame_size) != 0;
+
+            if (change) {
+                const KSRP_Wheels_WheelsStatus_Frame* new_frame = frame;
+                if (memcmp(&instance->wheels_status_instance[device_id].device_id, &new_frame->device_id, sizeof(new_frame->device_id)) != 0)
+                    instance->wheels_status_changed_fields[device_id] |= (uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_DEVICE_ID_FIELD_ID;
+                if (memcmp(&instance->wheels_status_instance[device_id].driver_status, &new_frame->driver_status, sizeof(new_frame->driver_status)) != 0)
+                    instance->wheels_status_changed_fields[device_id] |= (uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_FIELD_ID;
+                if (memcmp(&instance->wheels_status_instance[device_id].temperature, &new_frame->temperature, sizeof(new_frame->temperature)) != 0)
+                    instance->wheels_status_changed_fields[device_id] |= (uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_FIELD_ID;
+                if (memcmp(&instance->wheels_status_instance[device_id].algorithm_type, &new_frame->algorithm_type, sizeof(new_frame->algorithm_type)) != 0)
+                    instance->wheels_status_changed_fields[device_id] |= (uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_ALGORITHM_TYPE_FIELD_ID;
+                if (memcmp(&instance->wheels_status_instance[device_id].algorithm_type2, &new_frame->algorithm_type2, sizeof(new_frame->algorithm_type2)) != 0)
+                    instance->wheels_status_changed_fields[device_id] |= (uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_ALGORITHM_TYPE2_FIELD_ID;
+                if (memcmp(&instance->wheels_status_instance[device_id].testbool, &new_frame->testbool, sizeof(new_frame->testbool)) != 0)
+                    instance->wheels_status_changed_fields[device_id] |= (uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_TESTBOOL_FIELD_ID;
+            }
 
-            memcpy(&instance->wheels_status_instance, frame, frame_size);
-            instance->wheels_status_ms_since_last_update = 0;
+            memcpy(&instance->wheels_status_instance[device_id], frame, frame_size);
+            instance->wheels_status_last_update_ms[device_id] = instance->now_ms;
+            KSRP_DeadlineQueue_Schedule(&instance->deadline_queues[0],
+                (uint16_t)(0 * KSRP_WHEELS_MAX_DEVICES + device_id), instance->now_ms);
 
             if (instance->wheels_status_callback != NULL)
                 if (change)
                     if (instance->wheels_status_callback(
                         KSRP_WHEELS_SUBSYSTEM_ID,
-                        &instance->wheels_status_instance,
+                        &instance->wheels_status_instance[device_id],
                         KSRP_WHEELS_WHEELS_STATUS_FRAME_ID,
                         KSRP_ILLEGAL_FIELD_ID) != KSRP_STATUS_OK)
                     return KSRP_STATUS_ERROR;
 
+            if (change)
+                if (KSRP_UpdateHealth_Wheels_WheelsStatus(
+                        instance, device_id, KSRP_ILLEGAL_FIELD_ID) != KSRP_STATUS_OK)
+                    return KSRP_STATUS_ERROR;
+
             if (instance->send_frame_callback != NULL)
                 if (change) {
                     KSRP_RawData_Frame raw_frame;
                     KSRP_RawDataFrame_Init(&raw_frame);
-                    if (KSRP_Pack_Wheels_WheelsStatus(
-                            &instance->wheels_status_instance, &raw_frame) != KSRP_STATUS_OK)
-                        return KSRP_STATUS_ERROR;
+
+                    // Delta is sent only when it is shorter than the full frame, full frame is also sent periodically for resync
+                    if (instance->wheels_status_deltas_since_keyframe[device_id] >= KSRP_WHEELS_KEYFRAME_INTERVAL ||
+                        KSRP_PackDelta_Wheels_WheelsStatus(&instance->wheels_status_instance[device_id],
+                            instance->wheels_status_changed_fields[device_id], &raw_frame) != KSRP_STATUS_OK ||
+                        raw_frame.length >= KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE + KSRP_ID_BYTES) {
+                        if (KSRP_Pack_Wheels_WheelsStatus(
+                                &instance->wheels_status_instance[device_id], &raw_frame) != KSRP_STATUS_OK)
+                            return KSRP_STATUS_ERROR;
+                        instance->wheels_status_deltas_since_keyframe[device_id] = 0;
+                    } else {
+                        instance->wheels_status_deltas_since_keyframe[device_id]++;
+                    }
+
                     if (instance->send_frame_callback(&raw_frame) != KSRP_STATUS_OK)
                         return KSRP_STATUS_ERROR;
+                    instance->wheels_status_changed_fields[device_id] = 0;
                 }
 
             break;
@@ -79,6 +209,7 @@ KSRP_Status KSRP_UpdateFrame_Wheels_Instance(
  * @brief Update a field in a frame in the instance
  *
  * @param instance The instance to update
+ * @param device_id The ID of the device which frame is updated
  * @param frame_id The ID of the frame to update
  * @param field_id The ID of the field to update
  * @param value The new field data
@@ -88,60 +219,44 @@ KSRP_Status KSRP_UpdateFrame_Wheels_Instance(
 _nonnull_
 KSRP_Status KSRP_UpdateFrameField_Wheels_Instance(
     KSRP_Wheels_Instance* instance,
+    uint8_t device_id,
     KSRP_Wheels_FrameID frame_id, uint32_t field_id,
     void* value, size_t value_size) {
 
+    if (device_id >= KSRP_WHEELS_MAX_DEVICES) {
+        return KSRP_STATUS_INVALID_DEVICE_ID;
+    }
+
     switch(frame_id) {
         case KSRP_WHEELS_WHEELS_STATUS_FRAME_ID: {
             switch(field_id) {
-                case KSRP_WHEELS_WHEELS_STATUS_DEVICE_ID_FIELD_ID: {
-                    if (value_size != sizeof(instance->wheels_status_instance.device_id)) {
+                case KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_FIELD_ID: {
+                    if (value_size != sizeof(instance->wheels_status_instance[device_id].driver_status)) {
                         return KSRP_STATUS_INVALID_DATA_SIZE;
                     }
 
-                    bool change = memcmp(&instance->wheels_status_instance.device_id, value, value_size) != 0;
+                    bool change = memcmp(&instance->wheels_status_instance[device_id].driver_status, value, value_size) != 0;
 
-                    memcpy(&instance->wheels_status_instance.device_id, value, value_size);
-                    instance->wheels_status_ms_since_last_update = 0;
+                    if (change)
+                        instance->wheels_status_changed_fields[device_id] |= (uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_FIELD_ID;
+
+                    memcpy(&instance->wheels_status_instance[device_id].driver_status, value, value_size);
+                    instance->wheels_status_last_update_ms[device_id] = instance->now_ms;
+                    KSRP_DeadlineQueue_Schedule(&instance->deadline_queues[0],
+                        (uint16_t)(0 * KSRP_WHEELS_MAX_DEVICES + device_id), instance->now_ms);
 
                     if (instance->wheels_status_callback != NULL)
                         if (change)
                             if (instance->wheels_status_callback(
                                 KSRP_WHEELS_SUBSYSTEM_ID,
-                                &instance->wheels_status_instance,
+                                &instance->wheels_status_instance[device_id],
                                 KSRP_WHEELS_WHEELS_STATUS_FRAME_ID,
-                                KSRP_WHEELS_WHEELS_STATUS_DEVICE_ID_FIELD_ID) != KSRP_STATUS_OK)
+                                KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_FIELD_ID) != KSRP_STATUS_OK)
                             return KSRP_STATUS_ERROR;
 
-                    if (instance->send_frame_callback != NULL)
-                        if (change) {
-                            KSRP_RawData_Frame raw_frame;
-                            KSRP_RawDataFrame_Init(&raw_frame);
-                            if (KSRP_Pack_Wheels_WheelsStatus(
-                                    &instance->wheels_status_instance, &raw_frame) != KSRP_STATUS_OK)
-                                return KSRP_STATUS_ERROR;
-                            if (instance->send_frame_callback(&raw_frame) != KSRP_STATUS_OK)
-                                return KSRP_STATUS_ERROR;
-                        }
-
-                    break;
-                }
-                case KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_FIELD_ID: {
-                    if (value_size != sizeof(instance->wheels_status_instance.driver_status)) {
-                        return KSRP_STATUS_INVALID_DATA_SIZE;
-                    }
-
-                    bool change = memcmp(&instance->wheels_status_instance.driver_status, value, value_size) != 0;
-
-                    memcpy(&instance->wheels_status_instance.driver_status, value, value_size);
-                    instance->wheels_status_ms_since_last_update = 0;
-
-                    if (instance->wheels_status_callback != NULL)
-                        if (change)
-                            if (instance->wheels_status_callback(
-                                KSRP_WHEELS_SUBSYSTEM_ID,
-                                &instance->wheels_status_instance,
-                                KSRP_WHEELS_WHEELS_STATUS_FRAME_ID,
+                    if (change)
+                        if (KSRP_UpdateHealth_Wheels_WheelsStatus(
+                                instance, device_id,
                                 KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_FIELD_ID) != KSRP_STATUS_OK)
                             return KSRP_STATUS_ERROR;
 
@@ -149,62 +264,102 @@ KSRP_Status KSRP_UpdateFrameField_Wheels_Instance(
                         if (change) {
                             KSRP_RawData_Frame raw_frame;
                             KSRP_RawDataFrame_Init(&raw_frame);
-                            if (KSRP_Pack_Wheels_WheelsStatus(
-                                    &instance->wheels_status_instance, &raw_frame) != KSRP_STATUS_OK)
-                                return KSRP_STATUS_ERROR;
+
+                            // Delta is sent only when it is shorter than the full frame, full frame is also sent periodically for resync
+                            if (instance->wheels_status_deltas_since_keyframe[device_id] >= KSRP_WHEELS_KEYFRAME_INTERVAL ||
+                                KSRP_PackDelta_Wheels_WheelsStatus(&instance->wheels_status_instance[device_id],
+                                    instance->wheels_status_changed_fields[device_id], &raw_frame) != KSRP_STATUS_OK ||
+                                raw_frame.length >= KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE + KSRP_ID_BYTES) {
+                                if (KSRP_Pack_Wheels_WheelsStatus(
+                                        &instance->wheels_status_instance[device_id], &raw_frame) != KSRP_STATUS_OK)
+                                    return KSRP_STATUS_ERROR;
+                                instance->wheels_status_deltas_since_keyframe[device_id] = 0;
+                            } else {
+                                instance->wheels_status_deltas_since_keyframe[device_id]++;
+                            }
+
                             if (instance->send_frame_callback(&raw_frame) != KSRP_STATUS_OK)
                                 return KSRP_STATUS_ERROR;
+                            instance->wheels_status_changed_fields[device_id] = 0;
                         }
 
                     break;
                 }
                 case KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_FIELD_ID: {
-                    if (value_size != sizeof(instance->wheels_status_instance.temperature)) {
+                    if (value_size != sizeof(instance->wheels_status_instance[device_id].temperature)) {
                         return KSRP_STATUS_INVALID_DATA_SIZE;
                     }
 
-                    bool change = memcmp(&instance->wheels_status_instance.temperature, value, value_size) != 0;
+                    bool change = memcmp(&instance->wheels_status_instance[device_id].temperature, value, value_size) != 0;
+
+                    if (change)
+                        instance->wheels_status_changed_fields[device_id] |= (uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_FIELD_ID;
 
-                    memcpy(&instance->wheels_status_instance.temperature, value, value_size);
-                    instance->wheels_status_ms_since_last_update = 0;
+                    memcpy(&instance->wheels_status_instance[device_id].temperature, value, value_size);
+                    instance->wheels_status_last_update_ms[device_id] = instance->now_ms;
+                    KSRP_DeadlineQueue_Schedule(&instance->deadline_queues[0],
+                        (uint16_t)(0 * KSRP_WHEELS_MAX_DEVICES + device_id), instance->now_ms);
 
                     if (instance->wheels_status_callback != NULL)
                         if (change)
                             if (instance->wheels_status_callback(
                                 KSRP_WHEELS_SUBSYSTEM_ID,
-                                &instance->wheels_status_instance,
+                                &instance->wheels_status_instance[device_id],
                                 KSRP_WHEELS_WHEELS_STATUS_FRAME_ID,
                                 KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_FIELD_ID) != KSRP_STATUS_OK)
                             return KSRP_STATUS_ERROR;
 
+                    if (change)
+                        if (KSRP_UpdateHealth_Wheels_WheelsStatus(
+                                instance, device_id,
+                                KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_FIELD_ID) != KSRP_STATUS_OK)
+                            return KSRP_STATUS_ERROR;
+
                     if (instance->send_frame_callback != NULL)
                         if (change) {
                             KSRP_RawData_Frame raw_frame;
                             KSRP_RawDataFrame_Init(&raw_frame);
-                            if (KSRP_Pack_Wheels_WheelsStatus(
-                                    &instance->wheels_status_instance, &raw_frame) != KSRP_STATUS_OK)
-                                return KSRP_STATUS_ERROR;
+
+                            // Delta is sent only when it is shorter than the full frame, full frame is also sent periodically for resync
+                            if (instance->wheels_status_deltas_since_keyframe[device_id] >= KSRP_WHEELS_KEYFRAME_INTERVAL ||
+                                KSRP_PackDelta_Wheels_WheelsStatus(&instance->wheels_status_instance[device_id],
+                                    instance->wheels_status_changed_fields[device_id], &raw_frame) != KSRP_STATUS_OK ||
+                                raw_frame.length >= KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE + KSRP_ID_BYTES) {
+                                if (KSRP_Pack_Wheels_WheelsStatus(
+                                        &instance->wheels_status_instance[device_id], &raw_frame) != KSRP_STATUS_OK)
+                                    return KSRP_STATUS_ERROR;
+                                instance->wheels_status_deltas_since_keyframe[device_id] = 0;
+                            } else {
+                                instance->wheels_status_deltas_since_keyframe[device_id]++;
+                            }
+
                             if (instance->send_frame_callback(&raw_frame) != KSRP_STATUS_OK)
                                 return KSRP_STATUS_ERROR;
+                            instance->wheels_status_changed_fields[device_id] = 0;
                         }
 
                     break;
                 }
                 case KSRP_WHEELS_WHEELS_STATUS_ALGORITHM_TYPE_FIELD_ID: {
-                    if (value_size != sizeof(instance->wheels_status_instance.algorithm_type)) {
+                    if (value_size != sizeof(instance->wheels_status_instance[device_id].algorithm_type)) {
                         return KSRP_STATUS_INVALID_DATA_SIZE;
                     }
 
-                    bool change = memcmp(&instance->wheels_status_instance.algorithm_type, value, value_size) != 0;
+                    bool change = memcmp(&instance->wheels_status_instance[device_id].algorithm_type, value, value_size) != 0;
 
-                    memcpy(&instance->wheels_status_instance.algorithm_type, value, value_size);
-                    instance->wheels_status_ms_since_last_update = 0;
+                    if (change)
+                        instance->wheels_status_changed_fields[device_id] |= (uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_ALGORITHM_TYPE_FIELD_ID;
+
+                    memcpy(&instance->wheels_status_instance[device_id].algorithm_type, value, value_size);
+                    instance->wheels_status_last_update_ms[device_id] = instance->now_ms;
+                    KSRP_DeadlineQueue_Schedule(&instance->deadline_queues[0],
+                        (uint16_t)(0 * KSRP_WHEELS_MAX_DEVICES + device_id), instance->now_ms);
 
                     if (instance->wheels_status_callback != NULL)
                         if (change)
                             if (instance->wheels_status_callback(
                                 KSRP_WHEELS_SUBSYSTEM_ID,
-                                &instance->wheels_status_instance,
+                                &instance->wheels_status_instance[device_id],
                                 KSRP_WHEELS_WHEELS_STATUS_FRAME_ID,
                                 KSRP_WHEELS_WHEELS_STATUS_ALGORITHM_TYPE_FIELD_ID) != KSRP_STATUS_OK)
                             return KSRP_STATUS_ERROR;
@@ -213,30 +368,47 @@ KSRP_Status KSRP_UpdateFrameField_Wheels_Instance(
                         if (change) {
                             KSRP_RawData_Frame raw_frame;
                             KSRP_RawDataFrame_Init(&raw_frame);
-                            if (KSRP_Pack_Wheels_WheelsStatus(
-                                    &instance->wheels_status_instance, &raw_frame) != KSRP_STATUS_OK)
-                                return KSRP_STATUS_ERROR;
+
+                            // Delta is sent only when it is shorter than the full frame, full frame is also sent periodically for resync
+                            if (instance->wheels_status_deltas_since_keyframe[device_id] >= KSRP_WHEELS_KEYFRAME_INTERVAL ||
+                                KSRP_PackDelta_Wheels_WheelsStatus(&instance->wheels_status_instance[device_id],
+                                    instance->wheels_status_changed_fields[device_id], &raw_frame) != KSRP_STATUS_OK ||
+                                raw_frame.length >= KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE + KSRP_ID_BYTES) {
+                                if (KSRP_Pack_Wheels_WheelsStatus(
+                                        &instance->wheels_status_instance[device_id], &raw_frame) != KSRP_STATUS_OK)
+                                    return KSRP_STATUS_ERROR;
+                                instance->wheels_status_deltas_since_keyframe[device_id] = 0;
+                            } else {
+                                instance->wheels_status_deltas_since_keyframe[device_id]++;
+                            }
+
                             if (instance->send_frame_callback(&raw_frame) != KSRP_STATUS_OK)
                                 return KSRP_STATUS_ERROR;
+                            instance->wheels_status_changed_fields[device_id] = 0;
                         }
 
                     break;
                 }
                 case KSRP_WHEELS_WHEELS_STATUS_ALGORITHM_TYPE2_FIELD_ID: {
-                    if (value_size != sizeof(instance->wheels_status_instance.algorithm_type2)) {
+                    if (value_size != sizeof(instance->wheels_status_instance[device_id].algorithm_type2)) {
                         return KSRP_STATUS_INVALID_DATA_SIZE;
                     }
 
-                    bool change = memcmp(&instance->wheels_status_instance.algorithm_type2, value, value_size) != 0;
+                    bool change = memcmp(&instance->wheels_status_instance[device_id].algorithm_type2, value, value_size) != 0;
 
-                    memcpy(&instance->wheels_status_instance.algorithm_type2, value, value_size);
-                    instance->wheels_status_ms_since_last_update = 0;
+                    if (change)
+                        instance->wheels_status_changed_fields[device_id] |= (uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_ALGORITHM_TYPE2_FIELD_ID;
+
+                    memcpy(&instance->wheels_status_instance[device_id].algorithm_type2, value, value_size);
+                    instance->wheels_status_last_update_ms[device_id] = instance->now_ms;
+                    KSRP_DeadlineQueue_Schedule(&instance->deadline_queues[0],
+                        (uint16_t)(0 * KSRP_WHEELS_MAX_DEVICES + device_id), instance->now_ms);
 
                     if (instance->wheels_status_callback != NULL)
                         if (change)
                             if (instance->wheels_status_callback(
                                 KSRP_WHEELS_SUBSYSTEM_ID,
-                                &instance->wheels_status_instance,
+                                &instance->wheels_status_instance[device_id],
                                 KSRP_WHEELS_WHEELS_STATUS_FRAME_ID,
                                 KSRP_WHEELS_WHEELS_STATUS_ALGORITHM_TYPE2_FIELD_ID) != KSRP_STATUS_OK)
                             return KSRP_STATUS_ERROR;
@@ -245,30 +417,47 @@ KSRP_Status KSRP_UpdateFrameField_Wheels_Instance(
                         if (change) {
                             KSRP_RawData_Frame raw_frame;
                             KSRP_RawDataFrame_Init(&raw_frame);
-                            if (KSRP_Pack_Wheels_WheelsStatus(
-                                    &instance->wheels_status_instance, &raw_frame) != KSRP_STATUS_OK)
-                                return KSRP_STATUS_ERROR;
+
+                            // Delta is sent only when it is shorter than the full frame, full frame is also sent periodically for resync
+                            if (instance->wheels_status_deltas_since_keyframe[device_id] >= KSRP_WHEELS_KEYFRAME_INTERVAL ||
+                                KSRP_PackDelta_Wheels_WheelsStatus(&instance->wheels_status_instance[device_id],
+                                    instance->wheels_status_changed_fields[device_id], &raw_frame) != KSRP_STATUS_OK ||
+                                raw_frame.length >= KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE + KSRP_ID_BYTES) {
+                                if (KSRP_Pack_Wheels_WheelsStatus(
+                                        &instance->wheels_status_instance[device_id], &raw_frame) != KSRP_STATUS_OK)
+                                    return KSRP_STATUS_ERROR;
+                                instance->wheels_status_deltas_since_keyframe[device_id] = 0;
+                            } else {
+                                instance->wheels_status_deltas_since_keyframe[device_id]++;
+                            }
+
                             if (instance->send_frame_callback(&raw_frame) != KSRP_STATUS_OK)
                                 return KSRP_STATUS_ERROR;
+                            instance->wheels_status_changed_fields[device_id] = 0;
                         }
 
                     break;
                 }
                 case KSRP_WHEELS_WHEELS_STATUS_TESTBOOL_FIELD_ID: {
-                    if (value_size != sizeof(instance->wheels_status_instance.testbool)) {
+                    if (value_size != sizeof(instance->wheels_status_instance[device_id].testbool)) {
                         return KSRP_STATUS_INVALID_DATA_SIZE;
                     }
 
-                    bool change = memcmp(&instance->wheels_status_instance.testbool, value, value_size) != 0;
+                    bool change = memcmp(&instance->wheels_status_instance[device_id].testbool, value, value_size) != 0;
 
-                    memcpy(&instance->wheels_status_instance.testbool, value, value_size);
-                    instance->wheels_status_ms_since_last_update = 0;
+                    if (change)
+                        instance->wheels_status_changed_fields[device_id] |= (uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_TESTBOOL_FIELD_ID;
+
+                    memcpy(&instance->wheels_status_instance[device_id].testbool, value, value_size);
+                    instance->wheels_status_last_update_ms[device_id] = instance->now_ms;
+                    KSRP_DeadlineQueue_Schedule(&instance->deadline_queues[0],
+                        (uint16_t)(0 * KSRP_WHEELS_MAX_DEVICES + device_id), instance->now_ms);
 
                     if (instance->wheels_status_callback != NULL)
                         if (change)
                             if (instance->wheels_status_callback(
                                 KSRP_WHEELS_SUBSYSTEM_ID,
-                                &instance->wheels_status_instance,
+                                &instance->wheels_status_instance[device_id],
                                 KSRP_WHEELS_WHEELS_STATUS_FRAME_ID,
                                 KSRP_WHEELS_WHEELS_STATUS_TESTBOOL_FIELD_ID) != KSRP_STATUS_OK)
                             return KSRP_STATUS_ERROR;
@@ -277,11 +466,23 @@ KSRP_Status KSRP_UpdateFrameField_Wheels_Instance(
                         if (change) {
                             KSRP_RawData_Frame raw_frame;
                             KSRP_RawDataFrame_Init(&raw_frame);
-                            if (KSRP_Pack_Wheels_WheelsStatus(
-                                    &instance->wheels_status_instance, &raw_frame) != KSRP_STATUS_OK)
-                                return KSRP_STATUS_ERROR;
+
+                            // Delta is sent only when it is shorter than the full frame, full frame is also sent periodically for resync
+                            if (instance->wheels_status_deltas_since_keyframe[device_id] >= KSRP_WHEELS_KEYFRAME_INTERVAL ||
+                                KSRP_PackDelta_Wheels_WheelsStatus(&instance->wheels_status_instance[device_id],
+                                    instance->wheels_status_changed_fields[device_id], &raw_frame) != KSRP_STATUS_OK ||
+                                raw_frame.length >= KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE + KSRP_ID_BYTES) {
+                                if (KSRP_Pack_Wheels_WheelsStatus(
+                                        &instance->wheels_status_instance[device_id], &raw_frame) != KSRP_STATUS_OK)
+                                    return KSRP_STATUS_ERROR;
+                                instance->wheels_status_deltas_since_keyframe[device_id] = 0;
+                            } else {
+                                instance->wheels_status_deltas_since_keyframe[device_id]++;
+                            }
+
                             if (instance->send_frame_callback(&raw_frame) != KSRP_STATUS_OK)
                                 return KSRP_STATUS_ERROR;
+                            instance->wheels_status_changed_fields[device_id] = 0;
                         }
 
                     break;
@@ -298,7 +499,177 @@ KSRP_Status KSRP_UpdateFrameField_Wheels_Instance(
 }
 
 /**
- * @brief Update the time since last update for all frames in the instance
+ * @brief Patch a frame in the instance with a delta, patched frame is applied as with
+ * KSRP_UpdateFrame_Wheels_Instance
+ *
+ * @param instance The instance to update
+ * @param raw_data The delta to apply
+ * @return KSRP_Status The status of the update, KSRP_STATUS_OK if successful
+ */
+_nonnull_
+KSRP_Status KSRP_ApplyDelta_Wheels_Instance(
+    KSRP_Wheels_Instance* instance,
+    const KSRP_RawData_Frame* raw_data) {
+    KSRP_TypeID type_id = KSRP_Delta_GetTypeID(raw_data);
+
+    if (KSRP_GET_SUBSYSTEM_ID_FROM_TYPE_ID(type_id) != KSRP_WHEELS_SUBSYSTEM_ID) {
+        return KSRP_STATUS_INVALID_FRAME_TYPE;
+    }
+
+    switch(KSRP_GET_TYPE_ID_FROM_TYPE_ID(type_id)) {
+        case KSRP_WHEELS_WHEELS_STATUS_FRAME_ID: {
+            uint8_t device_id;
+            KSRP_Status status = KSRP_GetDeltaDeviceID_Wheels_WheelsStatus(raw_data, &device_id);
+            if (status != KSRP_STATUS_OK) {
+                return status;
+            }
+
+            if (device_id >= KSRP_WHEELS_MAX_DEVICES) {
+                return KSRP_STATUS_INVALID_DEVICE_ID;
+            }
+
+            KSRP_Wheels_WheelsStatus_Frame frame = instance->wheels_status_instance[device_id];
+            status = KSRP_ApplyDelta_Wheels_WheelsStatus(raw_data, &frame);
+            if (status != KSRP_STATUS_OK) {
+                return status;
+            }
+
+            return KSRP_UpdateFrame_Wheels_Instance(instance,
+                KSRP_WHEELS_WHEELS_STATUS_FRAME_ID, &frame, sizeof(frame));
+        }
+        default:
+            return KSRP_STATUS_INVALID_FRAME_TYPE;
+    }
+}
+
+/**
+ * @brief Unpack a raw data frame or delta of wheels subsystem and update the instance with it
+ *
+ * @param instance The instance to update
+ * @param raw_data The raw data frame to apply
+ * @return KSRP_Status The status of the update, KSRP_STATUS_OK if successful
+ */
+static KSRP_Status KSRP_ReceiveFrame_Wheels_Instance(
+    KSRP_Wheels_Instance* instance,
+    const KSRP_RawData_Frame* raw_data) {
+    if (KSRP_Delta_IsDelta(raw_data)) {
+        return KSRP_ApplyDelta_Wheels_Instance(instance, raw_data);
+    }
+
+    switch(KSRP_RawData_Frame_GetTypeID(raw_data)) {
+        case KSRP_WHEELS_WHEELS_STATUS_TYPE_ID: {
+            KSRP_Wheels_WheelsStatus_Frame frame;
+            KSRP_Status status = KSRP_Unpack_Wheels_WheelsStatus(raw_data, &frame);
+            if (status != KSRP_STATUS_OK) {
+                return status;
+            }
+
+            return KSRP_UpdateFrame_Wheels_Instance(instance,
+                KSRP_WHEELS_WHEELS_STATUS_FRAME_ID, &frame, sizeof(frame));
+        }
+        default:
+            return KSRP_STATUS_INVALID_FRAME_TYPE;
+    }
+}
+
+/**
+ * @brief Queue a received raw data frame for the instance in constant time, frame is applied later by
+ * KSRP_Drain_Wheels_Instance. Safe to call from a single interrupt (producer) while
+ * main loop (consumer) drains the queue, without critical sections
+ *
+ * @param instance The instance to queue the frame for
+ * @param frame The raw data frame, delta or batch to queue
+ * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if successful, KSRP_STATUS_ERROR if the queue is
+ * full and the frame was dropped
+ */
+_nonnull_
+KSRP_Status KSRP_Enqueue_Wheels_Instance(
+    KSRP_Wheels_Instance* instance,
+    const KSRP_RawData_Frame* frame) {
+    return KSRP_Ring_Push(&instance->rx_queue, frame);
+}
+
+/**
+ * @brief Apply frames queued with KSRP_Enqueue_Wheels_Instance to the instance,
+ * frames queued during draining are left for the next call
+ *
+ * @param instance The instance to drain
+ * @param max_frames Maximum number of frames to apply, 0 to apply all queued frames
+ * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if all frames were applied, otherwise status of
+ * the first failed one, remaining frames are still applied
+ */
+_nonnull_
+KSRP_Status KSRP_Drain_Wheels_Instance(
+    KSRP_Wheels_Instance* instance,
+    uint32_t max_frames) {
+    KSRP_Status result = KSRP_STATUS_OK;
+    KSRP_RawData_Frame frame;
+    KSRP_RawData_Frame sub_frame;
+    KSRP_BatchReader reader;
+    KSRP_Status status;
+
+    uint32_t count = KSRP_Ring_Count(&instance->rx_queue);
+    if (max_frames != 0 && max_frames < count) {
+        count = max_frames;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (KSRP_Ring_Pop(&instance->rx_queue, &frame) != KSRP_STATUS_OK) {
+            break;
+        }
+
+        if (!KSRP_Batch_IsBatch(&frame)) {
+            status = KSRP_ReceiveFrame_Wheels_Instance(instance, &frame);
+            if (status != KSRP_STATUS_OK && result == KSRP_STATUS_OK) {
+                result = status;
+            }
+            continue;
+        }
+
+        KSRP_BatchReader_Init(&reader, &frame);
+        while ((status = KSRP_BatchReader_Next(&reader, &sub_frame)) != KSRP_STATUS_ERROR) {
+            if (status == KSRP_STATUS_OK) {
+                status = KSRP_ReceiveFrame_Wheels_Instance(instance, &sub_frame);
+            }
+
+            if (status != KSRP_STATUS_OK && result == KSRP_STATUS_OK) {
+                result = status;
+            }
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Call stale callback of the frame which deadline expired
+ *
+ * @param instance The instance which deadline expired
+ * @param index The index of the expired deadline node
+ * @return KSRP_Status The status of the callback, KSRP_STATUS_OK if successful
+ */
+static KSRP_Status KSRP_NotifyStale_Wheels_Instance(
+    KSRP_Wheels_Instance* instance, uint16_t index) {
+    uint8_t device_id = (uint8_t)(index % KSRP_WHEELS_MAX_DEVICES);
+
+    switch(index / KSRP_WHEELS_MAX_DEVICES) {
+        case 0:
+            if (instance->wheels_status_stale_callback != NULL)
+                return instance->wheels_status_stale_callback(
+                    KSRP_WHEELS_SUBSYSTEM_ID,
+                    &instance->wheels_status_instance[device_id],
+                    KSRP_WHEELS_WHEELS_STATUS_FRAME_ID,
+                    instance->now_ms - instance->wheels_status_last_update_ms[device_id]);
+            return KSRP_STATUS_OK;
+        default:
+            return KSRP_STATUS_ERROR;
+    }
+}
+
+/**
+ * @brief Advance the clock of the instance, stale callbacks of frames which timeout expired are called
+ *
+ * Only expired deadlines are visited, so the cost doesn't depend on the number of frames and devices
  *
  * @param instance The instance to update
  * @param ms_since_last_update Time delta since last update (in ms)
@@ -307,7 +678,16 @@ KSRP_Status KSRP_UpdateFrameField_Wheels_Instance(
 _nonnull_
 KSRP_Status KSRP_UpdateTime_Wheels_Instance(
     KSRP_Wheels_Instance* instance, uint32_t ms_since_last_update) {
-    instance->wheels_status_ms_since_last_update += ms_since_last_update;
+    instance->now_ms += ms_since_last_update;
+
+    for (uint32_t queue = 0; queue < sizeof(instance->deadline_queues) / sizeof(instance->deadline_queues[0]); queue++) {
+        uint16_t index;
+        while ((index = KSRP_DeadlineQueue_PopExpired(&instance->deadline_queues[queue], instance->now_ms)) !=
+               KSRP_DEADLINE_NONE) {
+            if (KSRP_NotifyStale_Wheels_Instance(instance, index) != KSRP_STATUS_OK)
+                return KSRP_STATUS_ERROR;
+        }
+    }
 
     return KSRP_STATUS_OK;
 }
@@ -316,16 +696,21 @@ KSRP_Status KSRP_UpdateTime_Wheels_Instance(
  * @brief Get the time since last update for a frame in the instance
  *
  * @param instance The instance to get the time from
+ * @param device_id The ID of the device to get the time from
  * @param frame_id The ID of the frame to get the time from
  * @return uint32_t The time since the last update (in ms)
  */
 _nonnull_
 uint32_t KSRP_Wheels_Instance_GetTimeSinceLastUpdate(
-    KSRP_Wheels_Instance* instance, KSRP_Wheels_FrameID frame_id) {
+    KSRP_Wheels_Instance* instance, uint8_t device_id, KSRP_Wheels_FrameID frame_id) {
+
+    if (device_id >= KSRP_WHEELS_MAX_DEVICES) {
+        return 0xFFFFFFFF;
+    }
 
     switch(frame_id) {
         case KSRP_WHEELS_WHEELS_STATUS_FRAME_ID:
-            return instance->wheels_status_ms_since_last_update;
+            return instance->now_ms - instance->wheels_status_last_update_ms[device_id];
         default:
             return 0xFFFFFFFF;
     }
@@ -337,7 +722,7 @@ uint32_t KSRP_Wheels_Instance_GetTimeSinceLastUpdate(
  * @param instance The instance to send the ping from
  * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if successful
  */
-KSRP_Statu KSRP_Wheels_Instance_SendPing(
+KSRP_Status KSRP_Wheels_Instance_SendPing(
     KSRP_Wheels_Instance* instance) {
 
     KSRP_RawData_Frame ping_frame;
@@ -387,5 +772,211 @@ KSRP_Status KSRP_Wheels_Instance_SetCallback(
             return KSRP_STATUS_INVALID_FRAME_TYPE;
     }
 
+    return KSRP_STATUS_OK;
+}
+
+/**
+ * @brief Set the stale callback for a frame in the instance, callback is called once when frame isn't updated for its
+ * timeout, frame is watched again after next update
+ *
+ * @param instance The instance to set the callback for
+ * @param frame_id The ID of the frame to set the callback for
+ * @param callback The callback function to set
+ * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if successful, KSRP_STATUS_INVALID_FRAME_TYPE if
+ * frame has no timeout
+ */
+_nonnull_
+KSRP_Status KSRP_Wheels_Instance_SetStaleCallback(
+    KSRP_Wheels_Instance* instance,
+    KSRP_Wheels_FrameID frame_id,
+    KSRP_FrameStaleCallback callback) {
+
+    switch(frame_id) {
+        case KSRP_WHEELS_WHEELS_STATUS_FRAME_ID:
+            instance->wheels_status_stale_callback = callback;
+            break;
+        default:
+            return KSRP_STATUS_INVALID_FRAME_TYPE;
+    }
+
+    return KSRP_STATUS_OK;
+}
+
+/**
+ * @brief Set the health transition callback for a frame in the instance, callback is called only when cached health
+ * check result of a field in the frame changes
+ *
+ * @param instance The instance to set the callback for
+ * @param frame_id The ID of the frame to set the callback for
+ * @param callback The callback function to set
+ * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if successful, KSRP_STATUS_INVALID_FRAME_TYPE if
+ * frame has no health checks
+ */
+_nonnull_
+KSRP_Status KSRP_Wheels_Instance_SetHealthCallback(
+    KSRP_Wheels_Instance* instance,
+    KSRP_Wheels_FrameID frame_id,
+    KSRP_HealthTransitionCallback callback) {
+
+    switch(frame_id) {
+        case KSRP_WHEELS_WHEELS_STATUS_FRAME_ID:
+            instance->wheels_status_health_callback = callback;
+            break;
+        default:
+            return KSRP_STATUS_INVALID_FRAME_TYPE;
+    }
+
+    return KSRP_STATUS_OK;
+}
+
+/**
+ * @brief Get the cached health check result of a field in the instance, result is updated with every frame update
+ *
+ * @param instance The instance to get the result from
+ * @param device_id The ID of the device to get the result from
+ * @param frame_id The ID of the frame to get the result from
+ * @param field_id The ID of the field to get the result from
+ * @return KSRP_HealthCheckResult The cached result, KSRP_RESULT_UNKNOWN if field has no health checks
+ */
+_nonnull_
+KSRP_HealthCheckResult KSRP_Wheels_Instance_GetHealth(
+    KSRP_Wheels_Instance* instance, uint8_t device_id, KSRP_Wheels_FrameID frame_id, uint32_t field_id) {
+
+    if (device_id >= KSRP_WHEELS_MAX_DEVICES) {
+        return KSRP_RESULT_UNKNOWN;
+    }
+
+    switch(frame_id) {
+        case KSRP_WHEELS_WHEELS_STATUS_FRAME_ID:
+            switch(field_id) {
+                case KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_FIELD_ID:
+                    return instance->wheels_status_driver_status_health[device_id];
+                case KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_FIELD_ID:
+                    return instance->wheels_status_temperature_health[device_id];
+                default:
+                    return KSRP_RESULT_UNKNOWN;
+            }
+        default:
+            return KSRP_RESULT_UNKNOWN;
+    }
+}
+
+/**
+ * @brief Append state of the instance to a snapshot image as a single section, callbacks, queued frames and transmit
+ * state aren't stored
+ *
+ * @param instance The instance to snapshot
+ * @param index Index of the registry the instance belongs to, 0 for standalone instance
+ * @param writer The writer of the image
+ * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if successful, KSRP_STATUS_INVALID_DATA_SIZE if
+ * the state doesn't fit into the image
+ */
+_nonnull_
+KSRP_Status KSRP_Snapshot_Wheels_Instance(
+    const KSRP_Wheels_Instance* instance,
+    uint32_t index,
+    KSRP_SnapshotWriter* writer) {
+    uint8_t* state = KSRP_SnapshotWriter_AddSection(writer, KSRP_WHEELS_SUBSYSTEM_ID, index,
+        KSRP_WHEELS_DEFINITION_HASH, KSRP_WHEELS_SNAPSHOT_STATE_SIZE);
+    if (state == NULL) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    KSRP_RawData_Frame raw_frame;
+
+    for (uint32_t device_id = 0; device_id < KSRP_WHEELS_MAX_DEVICES; device_id++) {
+        if (KSRP_Pack_Wheels_WheelsStatus(&instance->wheels_status_instance[device_id], &raw_frame) != KSRP_STATUS_OK)
+            return KSRP_STATUS_ERROR;
+        memcpy(state, &raw_frame.data[KSRP_ID_BYTES], KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE);
+        state += KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE;
+        KSRP_StoreLE32(state, instance->now_ms - instance->wheels_status_last_update_ms[device_id]);
+        state += sizeof(uint32_t);
+        *state++ = (uint8_t)instance->wheels_status_driver_status_health[device_id];
+        *state++ = (uint8_t)instance->wheels_status_temperature_health[device_id];
+    }
+
+    return KSRP_STATUS_OK;
+}
+
+/**
+ * @brief Restore state of the instance from a snapshot section, frames aren't initialized to their defaults and no
+ * callbacks are called
+ *
+ * @param instance The instance to restore
+ * @param section The section read by KSRP_SnapshotReader_Next
+ * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if successful. On failure the instance is left
+ * untouched: KSRP_STATUS_INVALID_FRAME_TYPE if the section belongs to another subsystem, KSRP_STATUS_ERROR if it was
+ * written with different definition, KSRP_STATUS_INVALID_DATA_SIZE if it has wrong size, otherwise status of the
+ * first frame which couldn't be unpacked
+ */
+_nonnull_
+KSRP_Status KSRP_Restore_Wheels_Instance(
+    KSRP_Wheels_Instance* instance,
+    const KSRP_SnapshotSection* section) {
+    if (section->subsystem_id != KSRP_WHEELS_SUBSYSTEM_ID) {
+        return KSRP_STATUS_INVALID_FRAME_TYPE;
+    }
+
+    if (section->definition_hash != KSRP_WHEELS_DEFINITION_HASH) {
+        return KSRP_STATUS_ERROR;
+    }
+
+    if (section->length != KSRP_WHEELS_SNAPSHOT_STATE_SIZE) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    const uint8_t* state = section->data;
+    KSRP_Status status;
+    KSRP_RawData_Frame raw_frame;
+    union {
+        KSRP_Wheels_WheelsStatus_Frame wheels_status;
+    } frame;
+
+    // Every slot is unpacked into a scratch frame first, so an invalid section leaves the instance untouched
+    for (uint32_t device_id = 0; device_id < KSRP_WHEELS_MAX_DEVICES; device_id++) {
+        raw_frame.data[0] = KSRP_WHEELS_SUBSYSTEM_ID;
+        raw_frame.data[1] = KSRP_WHEELS_WHEELS_STATUS_FRAME_ID;
+        memcpy(&raw_frame.data[KSRP_ID_BYTES], state, KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE);
+        raw_frame.length = KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE + KSRP_ID_BYTES;
+        status = KSRP_Unpack_Wheels_WheelsStatus(&raw_frame, &frame.wheels_status);
+        if (status != KSRP_STATUS_OK) {
+            return status;
+        }
+
+        if (frame.wheels_status.device_id != device_id) {
+            return KSRP_STATUS_INVALID_DEVICE_ID;
+        }
+        state += KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE + sizeof(uint32_t) + 2;
+    }
+
+    if (KSRP_Ring_Init(&instance->rx_queue, instance->rx_queue_frames,
+                       KSRP_WHEELS_RX_QUEUE_CAPACITY) != KSRP_STATUS_OK) {
+        return KSRP_STATUS_ERROR;
+    }
+
+    // Deadlines are rebuilt from restored update times, stale callbacks are kept
+    KSRP_DeadlineNodes_Init(instance->deadline_nodes,
+                            sizeof(instance->deadline_nodes) / sizeof(instance->deadline_nodes[0]));
+    KSRP_DeadlineQueue_Init(&instance->deadline_queues[0], instance->deadline_nodes,
+                            KSRP_WHEELS_WHEELS_STATUS_TIMEOUT_MS);
+
+    state = section->data;
+    for (uint32_t device_id = 0; device_id < KSRP_WHEELS_MAX_DEVICES; device_id++) {
+        raw_frame.data[0] = KSRP_WHEELS_SUBSYSTEM_ID;
+        raw_frame.data[1] = KSRP_WHEELS_WHEELS_STATUS_FRAME_ID;
+        memcpy(&raw_frame.data[KSRP_ID_BYTES], state, KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE);
+        raw_frame.length = KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE + KSRP_ID_BYTES;
+        (void)KSRP_Unpack_Wheels_WheelsStatus(&raw_frame, &instance->wheels_status_instance[device_id]);
+        state += KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE;
+        instance->wheels_status_changed_fields[device_id] = 0;
+        instance->wheels_status_deltas_since_keyframe[device_id] = KSRP_WHEELS_KEYFRAME_INTERVAL;
+        instance->wheels_status_last_update_ms[device_id] = instance->now_ms - KSRP_LoadLE32(state);
+        state += sizeof(uint32_t);
+        KSRP_DeadlineQueue_Insert(&instance->deadline_queues[0],
+            (uint16_t)(0 * KSRP_WHEELS_MAX_DEVICES + device_id), instance->wheels_status_last_update_ms[device_id]);
+        instance->wheels_status_driver_status_health[device_id] = KSRP_Snapshot_LoadHealth(*state++);
+        instance->wheels_status_temperature_health[device_id] = KSRP_Snapshot_LoadHealth(*state++);
+    }
+
     return KSRP_STATUS_OK;
 }
\ No newline at end of file
@@ -0,0 +1,327 @@
+/**
+ * @file protocol_registry.c
+ * @brief Registry laying out instances of all subsystems in a single arena
+ */
+
+// Include standard libraries
+#include <stddef.h>
+
+// Include user libraries
+#include "ksrp/batch.h"
+#include "ksrp/delta.h"
+#include "ksrp/protocols/protocol_registry.h"
+
+/**
+ * @brief Entry of a single subsystem in the registry, indexed by subsystem ID
+ */
+typedef struct {
+    size_t offset;
+    KSRP_Status (*receive)(void* instance, const KSRP_RawData_Frame* frame);
+    KSRP_Status (*restore)(void* instance, const KSRP_SnapshotSection* section);
+} KSRP_RegistryEntry;
+
+/**
+ * @brief Queue a frame for the wheels instance of a registry
+ *
+ * @param instance The wheels instance
+ * @param frame The raw data frame or delta
+ * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if successful
+ */
+static KSRP_Status KSRP_Registry_Receive_Wheels(void* instance, const KSRP_RawData_Frame* frame) {
+    return KSRP_Enqueue_Wheels_Instance((KSRP_Wheels_Instance*)instance, frame);
+}
+
+/**
+ * @brief Restore the wheels instance of a registry from a snapshot section
+ *
+ * @param instance The wheels instance
+ * @param section The section of the instance
+ * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if successful
+ */
+static KSRP_Status KSRP_Registry_Restore_Wheels(void* instance, const KSRP_SnapshotSection* section) {
+    return KSRP_Restore_Wheels_Instance((KSRP_Wheels_Instance*)instance, section);
+}
+
+/// @brief Registry entries, indexed by subsystem ID
+static const KSRP_RegistryEntry ksrp_registry_entries[2] = {
+    [KSRP_WHEELS_SUBSYSTEM_ID] = {
+        offsetof(KSRP_Registry, wheels),
+        KSRP_Registry_Receive_Wheels,
+        KSRP_Registry_Restore_Wheels
+    },
+};
+
+/**
+ * @brief Look up the registry entry of a subsystem
+ *
+ * @param subsystem_id The ID of the subsystem
+ * @return const KSRP_RegistryEntry* The entry, NULL if the subsystem is unknown
+ */
+static const KSRP_RegistryEntry* KSRP_Registry_GetEntry(uint32_t subsystem_id) {
+    if (subsystem_id >= sizeof(ksrp_registry_entries) / sizeof(KSRP_RegistryEntry) ||
+        ksrp_registry_entries[subsystem_id].receive == NULL) {
+        return NULL;
+    }
+
+    return &ksrp_registry_entries[subsystem_id];
+}
+
+/**
+ * @brief Keep the first failed status
+ */
+static inline void KSRP_Registry_KeepStatus(KSRP_Status* result, KSRP_Status status) {
+    if (status != KSRP_STATUS_OK && *result == KSRP_STATUS_OK) {
+        *result = status;
+    }
+}
+
+/**
+ * @brief Initialize instances of all subsystems in the registries
+ *
+ * @param registries The registries to initialize
+ * @param count Number of registries
+ * @return KSRP_Status KSRP_STATUS_OK if all instances were initialized, otherwise status of the first failed one
+ */
+_nonnull_
+KSRP_Status KSRP_Registry_Init(KSRP_Registry* registries, uint32_t count) {
+    KSRP_Status status;
+
+    for (uint32_t i = 0; i < count; i++) {
+        status = KSRP_Init_Wheels_Instance(&registries[i].wheels);
+        if (status != KSRP_STATUS_OK) {
+            return status;
+        }
+    }
+
+    return KSRP_STATUS_OK;
+}
+
+/**
+ * @brief Look up the instance of a subsystem in constant time
+ *
+ * @param registry The registry to look up in
+ * @param subsystem_id The ID of the subsystem
+ * @return void* The instance of the subsystem, NULL if the subsystem is unknown
+ */
+_nonnull_
+void* KSRP_Registry_GetInstance(KSRP_Registry* registry, uint32_t subsystem_id) {
+    const KSRP_RegistryEntry* entry = KSRP_Registry_GetEntry(subsystem_id);
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    return (uint8_t*)registry + entry->offset;
+}
+
+/**
+ * @brief Look up the instance of the subsystem a type ID belongs to in constant time
+ *
+ * @param registry The registry to look up in
+ * @param type_id The type ID of a frame
+ * @return void* The instance of the subsystem, NULL if the subsystem is unknown
+ */
+_nonnull_
+void* KSRP_Registry_GetInstanceByTypeID(KSRP_Registry* registry, KSRP_TypeID type_id) {
+    return KSRP_Registry_GetInstance(registry, KSRP_GET_SUBSYSTEM_ID_FROM_TYPE_ID(type_id));
+}
+
+/**
+ * @brief Pass a raw data frame or delta to the instance of its subsystem
+ *
+ * @param registry The registry of the vehicle that sent the frame
+ * @param frame The raw data frame or delta
+ * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if successful
+ */
+static KSRP_Status KSRP_Registry_ReceiveFrame(KSRP_Registry* registry, const KSRP_RawData_Frame* frame) {
+    if (frame->length < KSRP_ID_BYTES) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    KSRP_TypeID type_id = KSRP_Delta_IsDelta(frame) ? KSRP_Delta_GetTypeID(frame) : KSRP_RawData_Frame_GetTypeID(frame);
+    const KSRP_RegistryEntry* entry = KSRP_Registry_GetEntry(KSRP_GET_SUBSYSTEM_ID_FROM_TYPE_ID(type_id));
+    if (entry == NULL) {
+        return KSRP_STATUS_INVALID_FRAME_TYPE;
+    }
+
+    return entry->receive((uint8_t*)registry + entry->offset, frame);
+}
+
+/**
+ * @brief Pass a received frame to the instance of its subsystem, deltas go to the subsystem of the frame they patch
+ * and batches are split into sub-frames. Subsystems with rx_queue_capacity queue the frame until
+ * KSRP_Registry_Drain, other subsystems apply it immediately
+ *
+ * @param registry The registry of the vehicle that sent the frame
+ * @param frame The raw data frame, delta or batch
+ * @return KSRP_Status KSRP_STATUS_OK if the frame was queued or applied, KSRP_STATUS_INVALID_FRAME_TYPE if the
+ * subsystem is unknown, otherwise status of the queue or the update, for batches status of the first failed sub-frame
+ */
+_nonnull_
+KSRP_Status KSRP_Registry_Receive(KSRP_Registry* registry, const KSRP_RawData_Frame* frame) {
+    if (!KSRP_Batch_IsBatch(frame)) {
+        return KSRP_Registry_ReceiveFrame(registry, frame);
+    }
+
+    KSRP_Status result = KSRP_STATUS_OK;
+    KSRP_BatchReader reader;
+    KSRP_RawData_Frame sub_frame;
+    KSRP_Status status;
+
+    KSRP_BatchReader_Init(&reader, frame);
+    while ((status = KSRP_BatchReader_Next(&reader, &sub_frame)) != KSRP_STATUS_ERROR) {
+        if (status == KSRP_STATUS_OK) {
+            status = KSRP_Registry_ReceiveFrame(registry, &sub_frame);
+        }
+        KSRP_Registry_KeepStatus(&result, status);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Advance the clock of all instances in the registries, stale callbacks of frames which timeout expired are
+ * called
+ *
+ * @param registries The registries to update
+ * @param count Number of registries
+ * @param ms_since_last_update Time delta since last update (in ms)
+ * @return KSRP_Status KSRP_STATUS_OK if all instances were updated, otherwise status of the first failed one,
+ * remaining instances are still updated
+ */
+_nonnull_
+KSRP_Status KSRP_Registry_Tick(KSRP_Registry* registries, uint32_t count, uint32_t ms_since_last_update) {
+    KSRP_Status result = KSRP_STATUS_OK;
+
+    for (uint32_t i = 0; i < count; i++) {
+        KSRP_Registry_KeepStatus(&result, KSRP_UpdateTime_Wheels_Instance(
+            &registries[i].wheels, ms_since_last_update));
+    }
+
+    return result;
+}
+
+/**
+ * @brief Apply all frames queued for instances with rx_queue_capacity in the registries
+ *
+ * @param registries The registries to drain
+ * @param count Number of registries
+ * @return KSRP_Status KSRP_STATUS_OK if all frames were applied, otherwise status of the first failed one,
+ * remaining frames are still applied
+ */
+_nonnull_
+KSRP_Status KSRP_Registry_Drain(KSRP_Registry* registries, uint32_t count) {
+    KSRP_Status result = KSRP_STATUS_OK;
+
+    for (uint32_t i = 0; i < count; i++) {
+        KSRP_Registry_KeepStatus(&result, KSRP_Drain_Wheels_Instance(
+            &registries[i].wheels, 0));
+    }
+
+    return result;
+}
+
+/**
+ * @brief Send frames changed since the last flush of all instances with deferred_transmit in the registries
+ *
+ * @param registries The registries to flush
+ * @param count Number of registries
+ * @return KSRP_Status KSRP_STATUS_OK if all instances were flushed, otherwise status of the first failed one,
+ * remaining instances are still flushed
+ */
+_nonnull_
+KSRP_Status KSRP_Registry_Flush(KSRP_Registry* registries, uint32_t count) {
+    // No subsystem defers transmission
+    (void)registries;
+    (void)count;
+
+    return KSRP_STATUS_OK;
+}
+
+/**
+ * @brief Set the send frame callback of all instances in the registries
+ *
+ * @param registries The registries to update
+ * @param count Number of registries
+ * @param send_frame_callback The callback sending frames of all instances
+ * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if successful
+ */
+_nonnull_
+KSRP_Status KSRP_Registry_SetSendFrameCallback(KSRP_Registry* registries, uint32_t count,
+                                               KSRP_Status (*send_frame_callback)(KSRP_RawData_Frame* frame)) {
+    KSRP_Status result = KSRP_STATUS_OK;
+
+    for (uint32_t i = 0; i < count; i++) {
+        KSRP_Registry_KeepStatus(&result, KSRP_Wheels_Instance_SetSendFrameCallback(
+            &registries[i].wheels, send_frame_callback));
+    }
+
+    return result;
+}
+
+/**
+ * @brief Write state of all instances in the registries into a snapshot image, every instance is stored in its own
+ * section tagged with the index of its registry
+ *
+ * @param registries The registries to snapshot
+ * @param count Number of registries
+ * @param buffer The buffer to write the image into, KSRP_REGISTRY_SNAPSHOT_SIZE(count) bytes are enough
+ * @param capacity Size of the buffer
+ * @param length Size of the written image
+ * @return KSRP_Status KSRP_STATUS_OK if successful, KSRP_STATUS_INVALID_DATA_SIZE if the image doesn't fit into the
+ * buffer
+ */
+_nonnull_
+KSRP_Status KSRP_Registry_Snapshot(const KSRP_Registry* registries, uint32_t count, uint8_t* buffer, size_t capacity,
+                                   size_t* length) {
+    KSRP_SnapshotWriter writer;
+    KSRP_Status status;
+
+    KSRP_SnapshotWriter_Init(&writer, buffer, capacity);
+    for (uint32_t i = 0; i < count; i++) {
+        status = KSRP_Snapshot_Wheels_Instance(&registries[i].wheels, i, &writer);
+        if (status != KSRP_STATUS_OK) {
+            return status;
+        }
+    }
+
+    return KSRP_SnapshotWriter_Finish(&writer, length);
+}
+
+/**
+ * @brief Restore instances in the registries from a snapshot image without initializing frames to their defaults,
+ * see restore of single instances. Instances without a section in the image are left untouched
+ *
+ * @param registries The registries to restore
+ * @param count Number of registries
+ * @param buffer The image written by KSRP_Registry_Snapshot
+ * @param length Size of the image
+ * @return KSRP_Status KSRP_STATUS_OK if all sections were restored, status of the image header if it's invalid,
+ * otherwise status of the first section which couldn't be restored (KSRP_STATUS_INVALID_FRAME_TYPE for unknown
+ * subsystem or registry index out of range), remaining sections are still restored
+ */
+_nonnull_
+KSRP_Status KSRP_Registry_Restore(KSRP_Registry* registries, uint32_t count, const uint8_t* buffer, size_t length) {
+    KSRP_SnapshotReader reader;
+    KSRP_SnapshotSection section;
+    KSRP_Status result = KSRP_STATUS_OK;
+    KSRP_Status status;
+
+    status = KSRP_SnapshotReader_Init(&reader, buffer, length);
+    if (status != KSRP_STATUS_OK) {
+        return status;
+    }
+
+    while ((status = KSRP_SnapshotReader_Next(&reader, &section)) != KSRP_STATUS_ERROR) {
+        if (status == KSRP_STATUS_OK) {
+            const KSRP_RegistryEntry* entry = KSRP_Registry_GetEntry(section.subsystem_id);
+            if (entry == NULL || section.index >= count) {
+                status = KSRP_STATUS_INVALID_FRAME_TYPE;
+            } else {
+                status = entry->restore((uint8_t*)&registries[section.index] + entry->offset, &section);
+            }
+        }
+        KSRP_Registry_KeepStatus(&result, status);
+    }
+
+    return result;
+}
\ No newline at end of file
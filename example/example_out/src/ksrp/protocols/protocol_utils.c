@@ -25,4 +25,291 @@ KSRP_TypeID KSRP_VerifyTypeID(const KSRP_RawData_Frame* frame) {
     }
 
     return KSRP_ILLEGAL_TYPE_ID;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+/// Frame Dispatch
+/////////////////////////////////////////////////////////////////////////////////
+/**
+ * @brief Dispatch table of a single subsystem, indexed by frame ID
+ */
+typedef struct {
+    const KSRP_DispatchHandler* handlers;
+    uint16_t handlers_count;
+} KSRP_DispatchSubsystemTable;
+
+/// @brief Instance that wheels frames are dispatched into
+static KSRP_Wheels_Instance* ksrp_dispatch_wheels_instance = NULL;
+
+/**
+ * @brief Register the wheels instance that received frames are dispatched into
+ *
+ * @param instance The instance to dispatch into, NULL to stop dispatching wheels frames
+ * @return KSRP_Status The status of the operation, KSRP_STATUS_OK if successful
+ */
+KSRP_Status KSRP_Dispatch_Register_Wheels_Instance(
+    KSRP_Wheels_Instance* instance) {
+    ksrp_dispatch_wheels_instance = instance;
+
+    return KSRP_STATUS_OK;
+}
+
+/**
+ * @brief Unpack a WHEELS_STATUS frame into the registered wheels instance
+ *
+ * @param raw_data The raw data frame to unpack
+ * @return KSRP_Status The status of the update, KSRP_STATUS_OK if successful
+ */
+static KSRP_Status KSRP_Dispatch_Wheels_WheelsStatus(const KSRP_RawData_Frame* raw_data) {
+    if (ksrp_dispatch_wheels_instance == NULL) {
+        return KSRP_STATUS_ERROR;
+    }
+
+    KSRP_Wheels_WheelsStatus_Frame frame;
+    KSRP_Status status = KSRP_Unpack_Wheels_WheelsStatus(raw_data, &frame);
+    if (status != KSRP_STATUS_OK) {
+        return status;
+    }
+
+    return KSRP_UpdateFrame_Wheels_Instance(ksrp_dispatch_wheels_instance,
+        KSRP_WHEELS_WHEELS_STATUS_FRAME_ID, &frame, sizeof(frame));
+}
+
+static const KSRP_DispatchHandler ksrp_dispatch_wheels_handlers[13] = {
+    [KSRP_WHEELS_WHEELS_STATUS_FRAME_ID] = KSRP_Dispatch_Wheels_WheelsStatus,
+};
+
+/// @brief Top level dispatch table, indexed by subsystem ID
+static const KSRP_DispatchSubsystemTable ksrp_dispatch_subsystems[2] = {
+    [KSRP_WHEELS_SUBSYSTEM_ID] = {
+        ksrp_dispatch_wheels_handlers,
+        sizeof(ksrp_dispatch_wheels_handlers) / sizeof(KSRP_DispatchHandler)
+    },
+};
+
+/**
+ * @brief Look up the handler for a type ID in the dispatch table
+ *
+ * @param type_id The type ID to look up
+ * @return KSRP_DispatchHandler The handler for the type ID, NULL if the type ID is unknown
+ */
+KSRP_DispatchHandler KSRP_Dispatch_GetHandler(KSRP_TypeID type_id) {
+    uint8_t subsystem_id = KSRP_GET_SUBSYSTEM_ID_FROM_TYPE_ID(type_id);
+    uint8_t frame_id = KSRP_GET_TYPE_ID_FROM_TYPE_ID(type_id);
+
+    if (subsystem_id >= sizeof(ksrp_dispatch_subsystems) / sizeof(KSRP_DispatchSubsystemTable)) {
+        return NULL;
+    }
+
+    const KSRP_DispatchSubsystemTable* table = &ksrp_dispatch_subsystems[subsystem_id];
+    if (frame_id >= table->handlers_count) {
+        return NULL;
+    }
+
+    return table->handlers[frame_id];
+}
+
+/**
+ * @brief Unpack a raw data frame and update the registered instance of its subsystem, deltas are applied to the
+ * current frame of the instance
+ *
+ * @param frame The raw data frame to dispatch
+ * @return KSRP_Status KSRP_STATUS_OK if the frame was dispatched, KSRP_STATUS_INVALID_FRAME_TYPE if the type ID
+ * is unknown, KSRP_STATUS_ERROR if no instance is registered for the subsystem
+ */
+_nonnull_
+KSRP_Status KSRP_Dispatch(const KSRP_RawData_Frame* frame) {
+    if (KSRP_Delta_IsDelta(frame)) {
+        switch (KSRP_GET_SUBSYSTEM_ID_FROM_TYPE_ID(KSRP_Delta_GetTypeID(frame))) {
+            case KSRP_WHEELS_SUBSYSTEM_ID:
+                if (ksrp_dispatch_wheels_instance == NULL) {
+                    return KSRP_STATUS_ERROR;
+                }
+                return KSRP_ApplyDelta_Wheels_Instance(ksrp_dispatch_wheels_instance, frame);
+            default:
+                return KSRP_STATUS_INVALID_FRAME_TYPE;
+        }
+    }
+
+KSRP_DispatchHandler handler = KSRP_Dispatch_GetHandler(KSRP_RawData_Frame_GetTypeID(frame));
+    if (handler == NULL) {
+        return KSRP_STATUS_INVALID_FRAME_TYPE;
+    }
+
+    return handler(frame);
+}
+
+/**
+ * @brief Dispatch every sub-frame of a batch, frames that are not batches are dispatched directly
+ *
+ * @param frame The batch or raw data frame to dispatch
+ * @return KSRP_Status KSRP_STATUS_OK if all sub-frames were dispatched, otherwise status of the first failed one,
+ * remaining sub-frames are still dispatched
+ */
+_nonnull_
+KSRP_Status KSRP_DispatchBatch(const KSRP_RawData_Frame* frame) {
+    if (!KSRP_Batch_IsBatch(frame)) {
+        return KSRP_Dispatch(frame);
+    }
+
+    KSRP_Status result = KSRP_STATUS_OK;
+    KSRP_BatchReader reader;
+    KSRP_RawData_Frame sub_frame;
+    KSRP_Status status;
+
+    KSRP_BatchReader_Init(&reader, frame);
+    while ((status = KSRP_BatchReader_Next(&reader, &sub_frame)) != KSRP_STATUS_ERROR) {
+        if (status == KSRP_STATUS_OK) {
+            status = KSRP_Dispatch(&sub_frame);
+        }
+
+        if (status != KSRP_STATUS_OK && result == KSRP_STATUS_OK) {
+            result = status;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Unpack a reassembled segmented frame in place and update the registered instance of its subsystem
+ *
+ * @param payload The payload completed by KSRP_Reassembler_Push
+ * @return KSRP_Status KSRP_STATUS_OK if the frame was dispatched, KSRP_STATUS_INVALID_FRAME_TYPE if the type ID
+ * is not a segmented frame, KSRP_STATUS_ERROR if no instance is registered for the subsystem
+ */
+_nonnull_
+KSRP_Status KSRP_DispatchSegmented(const KSRP_SegmentedPayload* payload) {
+    switch (payload->type_id) {
+        default:
+            return KSRP_STATUS_INVALID_FRAME_TYPE;
+    }
+}
+
+/**
+ * @brief Add a segment to the reassembler and dispatch the frame once all its segments are received, frames that
+ * are not segments are dispatched with KSRP_DispatchBatch
+ *
+ * @param reassembler The reassembler collecting segments
+ * @param frame The segment or raw data frame to dispatch
+ * @param now_ms Current time (in ms), used to evict incomplete frames
+ * @return KSRP_Status KSRP_STATUS_OK if the segment was added or the frame was dispatched, otherwise status of the
+ * reassembly or the dispatch
+ */
+_nonnull_
+KSRP_Status KSRP_DispatchSegment(KSRP_Reassembler* reassembler, const KSRP_RawData_Frame* frame, uint32_t now_ms) {
+    if (!KSRP_Segment_IsSegment(frame)) {
+        return KSRP_DispatchBatch(frame);
+    }
+
+    KSRP_SegmentedPayload payload;
+    KSRP_Status status = KSRP_Reassembler_Push(reassembler, frame, now_ms, &payload);
+    if (status != KSRP_STATUS_OK || payload.data == NULL) {
+        return status;
+    }
+
+    return KSRP_DispatchSegmented(&payload);
+}
+
+/**
+ * @brief Receive every frame already available on the transport and dispatch it with KSRP_DispatchSegment
+ *
+ * Frames are received in batches of KSRP_TRANSPORT_RX_CAPACITY, all received frames are dispatched even when some
+ * of them fail.
+ *
+ * @param transport The transport to receive from
+ * @param reassembler The reassembler collecting segments
+ * @param now_ms Current time (in ms), used to evict incomplete frames
+ * @param received Number of received frames
+ * @return KSRP_Status KSRP_STATUS_OK if all received frames were dispatched, KSRP_STATUS_ERROR on failure of the
+ * transport, otherwise status of the first failed dispatch
+ */
+_nonnull_
+KSRP_Status KSRP_DispatchTransport(KSRP_Transport* transport, KSRP_Reassembler* reassembler, uint32_t now_ms,
+                                   uint32_t* received) {
+    KSRP_RawData_Frame frames[KSRP_TRANSPORT_RX_CAPACITY];
+    KSRP_Status result = KSRP_STATUS_OK;
+
+    *received = 0;
+    for (;;) {
+        uint32_t count = 0;
+        if (KSRP_Transport_Receive(transport, frames, KSRP_TRANSPORT_RX_CAPACITY, &count) != KSRP_STATUS_OK) {
+            return KSRP_STATUS_ERROR;
+        }
+
+        for (uint32_t i = 0; i < count; i++) {
+            KSRP_Status status = KSRP_DispatchSegment(reassembler, &frames[i], now_ms);
+            if (status != KSRP_STATUS_OK && result == KSRP_STATUS_OK) {
+                result = status;
+            }
+        }
+        *received += count;
+
+        if (count < KSRP_TRANSPORT_RX_CAPACITY) {
+            return result;
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+/// Frame Decoding
+/////////////////////////////////////////////////////////////////////////////////
+/**
+ * @brief Unpack a raw data frame and evaluate all its health checks without touching any instance
+ *
+ * @param frame The raw data frame to decode
+ * @param decoded The decoded frame, health is KSRP_RESULT_UNKNOWN for frames without health checks
+ * @return KSRP_Status KSRP_STATUS_OK if the frame was decoded, KSRP_STATUS_INVALID_FRAME_TYPE if the type ID is
+ * unknown, otherwise status of the unpacking
+ */
+_nonnull_
+KSRP_Status KSRP_Decode(const KSRP_RawData_Frame* frame, KSRP_DecodedFrame* decoded) {
+    decoded->health = KSRP_RESULT_UNKNOWN;
+    decoded->failing_fields = 0;
+
+    if (KSRP_Batch_IsBatch(frame) || KSRP_Delta_IsDelta(frame)) {
+        decoded->type_id = KSRP_RawData_Frame_GetTypeID(frame);
+        decoded->frame.raw = *frame;
+        return KSRP_STATUS_OK;
+    }
+
+    KSRP_Status status;
+    decoded->type_id = KSRP_VerifyTypeID(frame);
+    switch (decoded->type_id) {
+        case KSRP_WHEELS_WHEELS_STATUS_TYPE_ID:
+            status = KSRP_Unpack_Wheels_WheelsStatus(frame, &decoded->frame.wheels_wheels_status);
+            if (status == KSRP_STATUS_OK) {
+                decoded->health = KSRP_HealthCheck_Wheels_WheelsStatus_All(&decoded->frame.wheels_wheels_status,
+                    &decoded->failing_fields);
+            }
+            return status;
+    }
+
+    return KSRP_STATUS_INVALID_FRAME_TYPE;
+}
+
+/**
+ * @brief Update the registered instance of the subsystem with a decoded frame, deltas and batches are dispatched
+ * with KSRP_DispatchBatch
+ *
+ * @param decoded The frame decoded with KSRP_Decode
+ * @return KSRP_Status KSRP_STATUS_OK if the frame was dispatched, KSRP_STATUS_INVALID_FRAME_TYPE if the type ID
+ * is unknown, KSRP_STATUS_ERROR if no instance is registered for the subsystem
+ */
+_nonnull_
+KSRP_Status KSRP_DispatchDecoded(const KSRP_DecodedFrame* decoded) {
+    switch (decoded->type_id) {
+        case KSRP_BATCH_TYPE_ID:
+        case KSRP_DELTA_TYPE_ID:
+            return KSRP_DispatchBatch(&decoded->frame.raw);
+        case KSRP_WHEELS_WHEELS_STATUS_TYPE_ID:
+            if (ksrp_dispatch_wheels_instance == NULL) {
+                return KSRP_STATUS_ERROR;
+            }
+            return KSRP_UpdateFrame_Wheels_Instance(ksrp_dispatch_wheels_instance,
+                KSRP_WHEELS_WHEELS_STATUS_FRAME_ID, (void*)&decoded->frame.wheels_wheels_status,
+                sizeof(decoded->frame.wheels_wheels_status));
+    }
+
+    return KSRP_STATUS_INVALID_FRAME_TYPE;
 }
\ No newline at end of file
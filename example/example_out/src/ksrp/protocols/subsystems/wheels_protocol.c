@@ -1,9 +1,14 @@
 /**
  * @file wheels_status_report.c
  * @brief Status report protocol implementation for wheels subsystem
- */// Include standard libraries
+ */
+
+// Include standard libraries
+#include <stddef.h>
+#include <math.h>
 
 // Include user libraries
+#include "ksrp/endianness.h"
 #include "ksrp/protocols/subsystems/wheels_protocol.h"
 
 
@@ -14,6 +19,15 @@
  *  @{
  */
 
+// Packed frame structure has to match the wire layout computed by the compiler
+_Static_assert(sizeof(KSRP_Wheels_WheelsStatus_Frame) == 9, "Invalid KSRP_Wheels_WheelsStatus_Frame size");
+_Static_assert(offsetof(KSRP_Wheels_WheelsStatus_Frame, device_id) == 0, "Invalid KSRP_Wheels_WheelsStatus_Frame.device_id offset");
+_Static_assert(offsetof(KSRP_Wheels_WheelsStatus_Frame, driver_status) == 1, "Invalid KSRP_Wheels_WheelsStatus_Frame.driver_status offset");
+_Static_assert(offsetof(KSRP_Wheels_WheelsStatus_Frame, temperature) == 2, "Invalid KSRP_Wheels_WheelsStatus_Frame.temperature offset");
+_Static_assert(offsetof(KSRP_Wheels_WheelsStatus_Frame, algorithm_type) == 6, "Invalid KSRP_Wheels_WheelsStatus_Frame.algorithm_type offset");
+_Static_assert(offsetof(KSRP_Wheels_WheelsStatus_Frame, algorithm_type2) == 7, "Invalid KSRP_Wheels_WheelsStatus_Frame.algorithm_type2 offset");
+_Static_assert(offsetof(KSRP_Wheels_WheelsStatus_Frame, testbool) == 8, "Invalid KSRP_Wheels_WheelsStatus_Frame.testbool offset");
+
 /**
  * @brief Check if a type ID is an instance of WheelsStatus frame
  *
@@ -31,7 +45,7 @@ bool KSRP_IsTypeIDInstanceof_Wheels_WheelsStatus(KSRP_TypeID type_id) {
  * @return true if the raw data frame is an instance of WheelsStatus frame
  */
 bool KSRP_IsRawDataInstanceof_Wheels_WheelsStatus(const KSRP_RawData_Frame* raw_data) {
-    return raw_data->length == sizeof(KSRP_Wheels_WheelsStatus_Frame) + KSRP_ID_BYTES &&
+    return raw_data->length == KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE + KSRP_ID_BYTES &&
         KSRP_IsTypeIDInstanceof_Wheels_WheelsStatus(KSRP_MAKE_TYPE_ID(raw_data->data[0], raw_data->data[1]));
 }
 
@@ -63,20 +77,66 @@ KSRP_Status KSRP_Init_Wheels_WheelsStatus_Frame(KSRP_Wheels_WheelsStatus_Frame*
  */
 _nonnull_
 KSRP_Status KSRP_Unpack_Wheels_WheelsStatus(const KSRP_RawData_Frame* raw_data, KSRP_Wheels_WheelsStatus_Frame* frame) {
-    if (raw_data->length != sizeof(KSRP_Wheels_WheelsStatus_Frame) + KSRP_ID_BYTES) {
+    if (raw_data->length != KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE + KSRP_ID_BYTES) {
         return KSRP_STATUS_INVALID_DATA_SIZE;
     }
 
     if (!KSRP_IsRawDataInstanceof_Wheels_WheelsStatus(raw_data)) {
         return KSRP_STATUS_INVALID_FRAME_TYPE;
     }
-    
-    frame->device_id = raw_data->data[0 + KSRP_ID_BYTES];
-    frame->driver_status = raw_data->data[1 + KSRP_ID_BYTES];
-    frame->temperature = *((float*)&raw_data->data[2 + KSRP_ID_BYTES]);
-    frame->algorithm_type = (KSRP_Wheels_WheelsStatus_AlgorithmType_TypeDef)raw_data->data[6 + KSRP_ID_BYTES];
-    frame->algorithm_type2 = (KSRP_Wheels_WheelsStatus_AlgorithmType2_TypeDef)raw_data->data[7 + KSRP_ID_BYTES];
-    frame->testbool = (KSRP_Wheels_WheelsStatus_Testbool_TypeDef)raw_data->data[8 + KSRP_ID_BYTES];
+
+#if KSRP_LITTLE_ENDIAN
+    memcpy(frame, &raw_data->data[KSRP_ID_BYTES], sizeof(KSRP_Wheels_WheelsStatus_Frame));
+#else
+    const uint8_t* payload = &raw_data->data[KSRP_ID_BYTES];
+    frame->device_id = payload[0];
+    frame->driver_status = payload[1];
+    frame->temperature = KSRP_LoadLEFloat(&payload[2]);
+    frame->algorithm_type = (KSRP_Wheels_WheelsStatus_AlgorithmType_TypeDef)payload[6];
+    frame->algorithm_type2 = (KSRP_Wheels_WheelsStatus_AlgorithmType2_TypeDef)payload[7];
+    frame->testbool = (KSRP_Wheels_WheelsStatus_Testbool_TypeDef)payload[8];
+#endif // KSRP_LITTLE_ENDIAN
+
+    return KSRP_STATUS_OK;
+}
+
+/**
+ * @brief Deserialize raw data frames of WHEELS_STATUS frame directly into columns
+ *
+ * @param raw_data The raw data frames to unpack
+ * @param count The number of raw data frames, at most KSRP_COLUMNS_CAPACITY
+ * @param columns The columns to unpack into, left untouched if any of the raw data frames is invalid
+ * @return KSRP_Status KSRP_STATUS_OK if all frames were unpacked successfully
+ */
+_nonnull_
+KSRP_Status KSRP_UnpackBatch_Wheels_WheelsStatus(const KSRP_RawData_Frame* raw_data, uint32_t count,
+    KSRP_Wheels_WheelsStatus_Columns* columns) {
+    if (count > KSRP_COLUMNS_CAPACITY) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (raw_data[i].length != KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE + KSRP_ID_BYTES) {
+            return KSRP_STATUS_INVALID_DATA_SIZE;
+        }
+
+        if (!KSRP_IsRawDataInstanceof_Wheels_WheelsStatus(&raw_data[i])) {
+            return KSRP_STATUS_INVALID_FRAME_TYPE;
+        }
+    }
+
+    // Every raw data frame is read once, while each column is written sequentially
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t* payload = &raw_data[i].data[KSRP_ID_BYTES];
+        columns->device_id[i] = payload[0];
+        columns->driver_status[i] = payload[1];
+        columns->temperature[i] = KSRP_LoadLEFloat(&payload[2]);
+        columns->algorithm_type[i] = (KSRP_Wheels_WheelsStatus_AlgorithmType_TypeDef)payload[6];
+        columns->algorithm_type2[i] = (KSRP_Wheels_WheelsStatus_AlgorithmType2_TypeDef)payload[7];
+        columns->testbool[i] = (KSRP_Wheels_WheelsStatus_Testbool_TypeDef)payload[8];
+    }
+
+    columns->count = count;
 
     return KSRP_STATUS_OK;
 }
@@ -90,21 +150,204 @@ KSRP_Status KSRP_Unpack_Wheels_WheelsStatus(const KSRP_RawData_Frame* raw_data,
  */
 _nonnull_
 KSRP_Status KSRP_Pack_Wheels_WheelsStatus(const KSRP_Wheels_WheelsStatus_Frame* frame, KSRP_RawData_Frame* raw_data) {
-    if (KSRP_MAX_FRAME_SIZE < sizeof(KSRP_Wheels_WheelsStatus_Frame)) {
+    if (KSRP_MAX_FRAME_SIZE < KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE) {
         return KSRP_STATUS_INVALID_DATA_SIZE;
     }
 
     raw_data->data[0] = KSRP_WHEELS_SUBSYSTEM_ID;
     raw_data->data[1] = KSRP_WHEELS_WHEELS_STATUS_FRAME_ID;
-    
-    raw_data->data[0 + KSRP_ID_BYTES] = frame->device_id;
-    raw_data->data[1 + KSRP_ID_BYTES] = frame->driver_status;
-    *((float*)&raw_data->data[2 + KSRP_ID_BYTES]) = frame->temperature;
-    raw_data->data[6 + KSRP_ID_BYTES] = (uint8_t)frame->algorithm_type;
-    raw_data->data[7 + KSRP_ID_BYTES] = (uint8_t)frame->algorithm_type2;
-    raw_data->data[8 + KSRP_ID_BYTES] = (uint8_t)frame->testbool;
 
-    raw_data->length = sizeof(KSRP_Wheels_WheelsStatus_Frame) + KSRP_ID_BYTES;
+#if KSRP_LITTLE_ENDIAN
+    memcpy(&raw_data->data[KSRP_ID_BYTES], frame, sizeof(KSRP_Wheels_WheelsStatus_Frame));
+#else
+    uint8_t* payload = &raw_data->data[KSRP_ID_BYTES];
+    payload[0] = frame->device_id;
+    payload[1] = frame->driver_status;
+    KSRP_StoreLEFloat(&payload[2], frame->temperature);
+    payload[6] = (uint8_t)frame->algorithm_type;
+    payload[7] = (uint8_t)frame->algorithm_type2;
+    payload[8] = (uint8_t)frame->testbool;
+#endif // KSRP_LITTLE_ENDIAN
+
+    raw_data->length = KSRP_WHEELS_WHEELS_STATUS_WIRE_SIZE + KSRP_ID_BYTES;
+
+    return KSRP_STATUS_OK;
+}
+
+
+/**
+ * @brief Serialize changed fields of a WHEELS_STATUS frame into a delta
+ *
+ * Device ID is always encoded, so receiver can find the frame to patch
+ *
+ * @param frame The frame to pack
+ * @param changed_fields Bitmask of fields to pack, bit number is field ID
+ * @param raw_data The raw data frame to pack into
+ * @return KSRP_Status KSRP_STATUS_OK if the delta was packed successfully, KSRP_STATUS_INVALID_DATA_SIZE if changed
+ * fields don't fit into raw data frame
+ */
+_nonnull_
+KSRP_Status KSRP_PackDelta_Wheels_WheelsStatus(const KSRP_Wheels_WheelsStatus_Frame* frame, uint64_t changed_fields,
+    KSRP_RawData_Frame* raw_data) {
+    uint8_t* payload = &raw_data->data[KSRP_DELTA_HEADER_BYTES + KSRP_WHEELS_WHEELS_STATUS_DELTA_MASK_BYTES];
+    uint8_t length = 0;
+
+    changed_fields |= (uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_DEVICE_ID_FIELD_ID;
+
+    if (changed_fields & ((uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_DEVICE_ID_FIELD_ID)) {
+        if (length + 1 > KSRP_RAW_DATA_FRAME_BUFFER_SIZE - KSRP_DELTA_HEADER_BYTES - KSRP_WHEELS_WHEELS_STATUS_DELTA_MASK_BYTES) {
+            return KSRP_STATUS_INVALID_DATA_SIZE;
+        }
+        payload[length] = frame->device_id;
+        length += 1;
+    }
+
+    if (changed_fields & ((uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_FIELD_ID)) {
+        if (length + 1 > KSRP_RAW_DATA_FRAME_BUFFER_SIZE - KSRP_DELTA_HEADER_BYTES - KSRP_WHEELS_WHEELS_STATUS_DELTA_MASK_BYTES) {
+            return KSRP_STATUS_INVALID_DATA_SIZE;
+        }
+        payload[length] = frame->driver_status;
+        length += 1;
+    }
+
+    if (changed_fields & ((uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_FIELD_ID)) {
+        if (length + 4 > KSRP_RAW_DATA_FRAME_BUFFER_SIZE - KSRP_DELTA_HEADER_BYTES - KSRP_WHEELS_WHEELS_STATUS_DELTA_MASK_BYTES) {
+            return KSRP_STATUS_INVALID_DATA_SIZE;
+        }
+        KSRP_StoreLEFloat(&payload[length], frame->temperature);
+        length += 4;
+    }
+
+    if (changed_fields & ((uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_ALGORITHM_TYPE_FIELD_ID)) {
+        if (length + 1 > KSRP_RAW_DATA_FRAME_BUFFER_SIZE - KSRP_DELTA_HEADER_BYTES - KSRP_WHEELS_WHEELS_STATUS_DELTA_MASK_BYTES) {
+            return KSRP_STATUS_INVALID_DATA_SIZE;
+        }
+        payload[length] = (uint8_t)frame->algorithm_type;
+        length += 1;
+    }
+
+    if (changed_fields & ((uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_ALGORITHM_TYPE2_FIELD_ID)) {
+        if (length + 1 > KSRP_RAW_DATA_FRAME_BUFFER_SIZE - KSRP_DELTA_HEADER_BYTES - KSRP_WHEELS_WHEELS_STATUS_DELTA_MASK_BYTES) {
+            return KSRP_STATUS_INVALID_DATA_SIZE;
+        }
+        payload[length] = (uint8_t)frame->algorithm_type2;
+        length += 1;
+    }
+
+    if (changed_fields & ((uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_TESTBOOL_FIELD_ID)) {
+        if (length + 1 > KSRP_RAW_DATA_FRAME_BUFFER_SIZE - KSRP_DELTA_HEADER_BYTES - KSRP_WHEELS_WHEELS_STATUS_DELTA_MASK_BYTES) {
+            return KSRP_STATUS_INVALID_DATA_SIZE;
+        }
+        payload[length] = (uint8_t)frame->testbool;
+        length += 1;
+    }
+
+    KSRP_Delta_Init(raw_data, KSRP_WHEELS_WHEELS_STATUS_TYPE_ID);
+    for (uint8_t i = 0; i < KSRP_WHEELS_WHEELS_STATUS_DELTA_MASK_BYTES; i++) {
+        raw_data->data[KSRP_DELTA_HEADER_BYTES + i] = (uint8_t)(changed_fields >> (8 * i));
+    }
+    raw_data->length = (uint8_t)(KSRP_DELTA_HEADER_BYTES + KSRP_WHEELS_WHEELS_STATUS_DELTA_MASK_BYTES + length);
+
+    return KSRP_STATUS_OK;
+}
+
+/**
+ * @brief Patch a WHEELS_STATUS frame in place with fields encoded in a delta
+ *
+ * @param raw_data The delta to apply
+ * @param frame The frame to patch, left untouched if the delta is invalid
+ * @return KSRP_Status KSRP_STATUS_OK if the delta was applied successfully
+ */
+_nonnull_
+KSRP_Status KSRP_ApplyDelta_Wheels_WheelsStatus(const KSRP_RawData_Frame* raw_data, KSRP_Wheels_WheelsStatus_Frame* frame) {
+    if (KSRP_Delta_GetTypeID(raw_data) != KSRP_WHEELS_WHEELS_STATUS_TYPE_ID) {
+        return KSRP_STATUS_INVALID_FRAME_TYPE;
+    }
+
+    if (raw_data->length < KSRP_DELTA_HEADER_BYTES + KSRP_WHEELS_WHEELS_STATUS_DELTA_MASK_BYTES) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    uint64_t changed_fields = 0;
+    for (uint8_t i = 0; i < KSRP_WHEELS_WHEELS_STATUS_DELTA_MASK_BYTES; i++) {
+        changed_fields |= (uint64_t)raw_data->data[KSRP_DELTA_HEADER_BYTES + i] << (8 * i);
+    }
+
+    if (changed_fields >> KSRP_WHEELS_WHEELS_STATUS_FIELDS_COUNT) {
+        return KSRP_STATUS_INVALID_FIELD_TYPE;
+    }
+
+    // Size of all encoded fields is checked first, so invalid delta doesn't patch the frame partially
+    uint8_t length = 0;
+    if (changed_fields & ((uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_DEVICE_ID_FIELD_ID)) length += 1;
+    if (changed_fields & ((uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_FIELD_ID)) length += 1;
+    if (changed_fields & ((uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_FIELD_ID)) length += 4;
+    if (changed_fields & ((uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_ALGORITHM_TYPE_FIELD_ID)) length += 1;
+    if (changed_fields & ((uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_ALGORITHM_TYPE2_FIELD_ID)) length += 1;
+    if (changed_fields & ((uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_TESTBOOL_FIELD_ID)) length += 1;
+
+    if (raw_data->length != KSRP_DELTA_HEADER_BYTES + KSRP_WHEELS_WHEELS_STATUS_DELTA_MASK_BYTES + length) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    const uint8_t* payload = &raw_data->data[KSRP_DELTA_HEADER_BYTES + KSRP_WHEELS_WHEELS_STATUS_DELTA_MASK_BYTES];
+    uint8_t offset = 0;
+
+    if (changed_fields & ((uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_DEVICE_ID_FIELD_ID)) {
+        if (payload[offset] != frame->device_id) {
+            return KSRP_STATUS_INVALID_DEVICE_ID;
+        }
+        offset += 1;
+    }
+
+    if (changed_fields & ((uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_FIELD_ID)) {
+        frame->driver_status = payload[offset];
+        offset += 1;
+    }
+
+    if (changed_fields & ((uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_FIELD_ID)) {
+        frame->temperature = KSRP_LoadLEFloat(&payload[offset]);
+        offset += 4;
+    }
+
+    if (changed_fields & ((uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_ALGORITHM_TYPE_FIELD_ID)) {
+        frame->algorithm_type = (KSRP_Wheels_WheelsStatus_AlgorithmType_TypeDef)payload[offset];
+        offset += 1;
+    }
+
+    if (changed_fields & ((uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_ALGORITHM_TYPE2_FIELD_ID)) {
+        frame->algorithm_type2 = (KSRP_Wheels_WheelsStatus_AlgorithmType2_TypeDef)payload[offset];
+        offset += 1;
+    }
+
+    if (changed_fields & ((uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_TESTBOOL_FIELD_ID)) {
+        frame->testbool = (KSRP_Wheels_WheelsStatus_Testbool_TypeDef)payload[offset];
+        offset += 1;
+    }
+
+    return KSRP_STATUS_OK;
+}
+
+/**
+ * @brief Get the device ID encoded in a delta of WHEELS_STATUS frame
+ *
+ * @param raw_data The delta to read
+ * @param device_id The device ID read from the delta
+ * @return KSRP_Status KSRP_STATUS_OK if the device ID was read successfully
+ */
+_nonnull_
+KSRP_Status KSRP_GetDeltaDeviceID_Wheels_WheelsStatus(const KSRP_RawData_Frame* raw_data, uint8_t* device_id) {
+    if (KSRP_Delta_GetTypeID(raw_data) != KSRP_WHEELS_WHEELS_STATUS_TYPE_ID) {
+        return KSRP_STATUS_INVALID_FRAME_TYPE;
+    }
+
+    // Device ID has the lowest field ID, so it is the first encoded value
+    if (raw_data->length < KSRP_DELTA_HEADER_BYTES + KSRP_WHEELS_WHEELS_STATUS_DELTA_MASK_BYTES + 1 ||
+        !(raw_data->data[KSRP_DELTA_HEADER_BYTES] & (1 << KSRP_WHEELS_WHEELS_STATUS_DEVICE_ID_FIELD_ID))) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    *device_id = raw_data->data[KSRP_DELTA_HEADER_BYTES + KSRP_WHEELS_WHEELS_STATUS_DELTA_MASK_BYTES];
 
     return KSRP_STATUS_OK;
 }
@@ -297,6 +540,56 @@ bool KSRP_Get_Wheels_WheelsStatus_Testbool(const KSRP_Wheels_WheelsStatus_Frame*
 /////////////////////////////////////////////////////////////////////////////////
 /// WheelsStatus Health Checks
 /////////////////////////////////////////////////////////////////////////////////
+/**
+ * @brief Health check outcomes for driver_status in WHEELS_STATUS frame, in order of declaration,
+ * index 0 is used when no health check matches
+ */
+static const KSRP_HealthCheckOutcome ksrp_wheels_wheels_status_driver_status_health_check_outcomes[] = {
+    { KSRP_RESULT_UNKNOWN, "Unknown description", "Unknown troubleshoot" },
+    {
+        KSRP_RESULT_OK,
+        KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_HEALTH_CHECK_OK_1_DESCRIPTION,
+        "Unknown troubleshoot"
+    },
+    {
+        KSRP_RESULT_CRITICAL,
+        KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_HEALTH_CHECK_CRITICAL_2_DESCRIPTION,
+        "Unknown troubleshoot"
+    },
+};
+
+/**
+ * @brief Outcome index for every value of driver_status in WHEELS_STATUS frame
+ */
+static const uint8_t ksrp_wheels_wheels_status_driver_status_health_check_lut[256] = {
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2,
+};
+
+/**
+ * @brief Find health check outcome of driver_status value in WHEELS_STATUS frame with direct lookup
+ *
+ * @param value The value to check
+ * @return uint8_t Index in outcomes table
+ */
+static uint8_t KSRP_HealthCheckClassify_Wheels_WheelsStatus_DriverStatus(uint8_t value) {
+    return ksrp_wheels_wheels_status_driver_status_health_check_lut[(uint8_t)value];
+}
+
 /**
  * @brief Perform health check on driver_status in WHEELS_STATUS frame
  *
@@ -305,36 +598,32 @@ bool KSRP_Get_Wheels_WheelsStatus_Testbool(const KSRP_Wheels_WheelsStatus_Frame*
  */
 _nonnull_
 KSRP_HealthCheckResult KSRP_HealthCheckResult_Wheels_WheelsStatus_DriverStatus(const KSRP_Wheels_WheelsStatus_Frame* frame) {
-    if (frame->driver_status == KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_HEALTH_CHECK_OK_1) {
-        return KSRP_RESULT_OK;
-    }
-    if (frame->driver_status == KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_HEALTH_CHECK_CRITICAL_2) {
-        return KSRP_RESULT_CRITICAL;
-    }
-    return KSRP_RESULT_UNKNOWN;
+    return KSRP_HealthCheckResultOfValue_Wheels_WheelsStatus_DriverStatus(frame->driver_status);
 }
 
 /**
- * @brief Perform health check on temperature in WHEELS_STATUS frame
+ * @brief Perform health check on a value of driver_status in WHEELS_STATUS frame
  *
- * @param frame The frame to check
+ * @param value The value to check
  * @return KSRP_HealthCheckResult The result of the health check
  */
+KSRP_HealthCheckResult KSRP_HealthCheckResultOfValue_Wheels_WheelsStatus_DriverStatus(uint8_t value) {
+    return ksrp_wheels_wheels_status_driver_status_health_check_outcomes[KSRP_HealthCheckClassify_Wheels_WheelsStatus_DriverStatus(value)].result;
+}
+
+/**
+ * @brief Perform health check on a column of driver_status values in WHEELS_STATUS frame
+ *
+ * @param values The values to check, e.g. driver_status column of KSRP_Wheels_WheelsStatus_Columns
+ * @param count The number of values
+ * @param results The results of the health checks, one for every value
+ */
 _nonnull_
-KSRP_HealthCheckResult KSRP_HealthCheckResult_Wheels_WheelsStatus_Temperature(const KSRP_Wheels_WheelsStatus_Frame* frame) {
-    if (frame->temperature >= KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_OK_1_MIN
-            && frame->temperature < KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_OK_1_MAX) {
-        return KSRP_RESULT_OK;
-    }
-    if (frame->temperature >= KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_WARNING_2_MIN
-            && frame->temperature < KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_WARNING_2_MAX) {
-        return KSRP_RESULT_WARNING;
-    }
-    if (frame->temperature >= KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_CRITICAL_3_MIN
-            && frame->temperature < KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_CRITICAL_3_MAX) {
-        return KSRP_RESULT_CRITICAL;
+void KSRP_HealthCheckResultBatch_Wheels_WheelsStatus_DriverStatus(const uint8_t* values,
+    uint32_t count, KSRP_HealthCheckResult* results) {
+    for (uint32_t i = 0; i < count; i++) {
+        results[i] = ksrp_wheels_wheels_status_driver_status_health_check_outcomes[ksrp_wheels_wheels_status_driver_status_health_check_lut[(uint8_t)values[i]]].result;
     }
-    return KSRP_RESULT_UNKNOWN;
 }
 
 /**
@@ -345,7 +634,136 @@ KSRP_HealthCheckResult KSRP_HealthCheckResult_Wheels_WheelsStatus_Temperature(co
  */
 _nonnull_
 const char* KSRP_HealthCheckTroubleshoot_Wheels_WheelsStatus_DriverStatus(const KSRP_Wheels_WheelsStatus_Frame* frame) {
-    return "Unknown troubleshoot";
+    return ksrp_wheels_wheels_status_driver_status_health_check_outcomes[KSRP_HealthCheckClassify_Wheels_WheelsStatus_DriverStatus(frame->driver_status)].troubleshoot;
+}
+
+/**
+ * @brief Get the description for the health check on driver_status in WHEELS_STATUS frame
+ *
+ * @param frame The frame to check
+ * @return const char* The description
+ */
+_nonnull_
+const char* KSRP_HealthCheckDescription_Wheels_WheelsStatus_DriverStatus(const KSRP_Wheels_WheelsStatus_Frame* frame) {
+    return ksrp_wheels_wheels_status_driver_status_health_check_outcomes[KSRP_HealthCheckClassify_Wheels_WheelsStatus_DriverStatus(frame->driver_status)].description;
+}
+
+/**
+ * @brief Health check outcomes for temperature in WHEELS_STATUS frame, in order of declaration,
+ * index 0 is used when no health check matches
+ */
+static const KSRP_HealthCheckOutcome ksrp_wheels_wheels_status_temperature_health_check_outcomes[] = {
+    { KSRP_RESULT_UNKNOWN, "Unknown description", "Unknown troubleshoot" },
+    {
+        KSRP_RESULT_OK,
+        KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_OK_1_DESCRIPTION,
+        "Unknown troubleshoot"
+    },
+    {
+        KSRP_RESULT_WARNING,
+        KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_WARNING_2_DESCRIPTION,
+        "Unknown troubleshoot"
+    },
+    {
+        KSRP_RESULT_CRITICAL,
+        KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_CRITICAL_3_DESCRIPTION,
+        "Unknown troubleshoot"
+    },
+};
+
+/**
+ * @brief Sorted bounds of disjoint ranges [bounds[i], bounds[i + 1]) on temperature in WHEELS_STATUS frame
+ */
+static const float ksrp_wheels_wheels_status_temperature_health_check_bounds[] = {
+    0.0,
+    100.0,
+    200.0,
+    300.0,
+};
+static const uint8_t ksrp_wheels_wheels_status_temperature_health_check_interval_outcomes[] = {
+    1, 2, 3
+};
+
+/**
+ * @brief Find health check outcome of temperature value in WHEELS_STATUS frame with binary search
+ *
+ * @param value The value to check
+ * @return uint8_t Index in outcomes table
+ */
+static uint8_t KSRP_HealthCheckClassify_Wheels_WheelsStatus_Temperature(float value) {
+
+    uint32_t bound = 0;
+    uint32_t bound_end = 4;
+    while (bound < bound_end) {
+        uint32_t middle = (bound + bound_end) / 2;
+        if (ksrp_wheels_wheels_status_temperature_health_check_bounds[middle] <= value) {
+            bound = middle + 1;
+        } else {
+            bound_end = middle;
+        }
+    }
+
+    // bound is the number of bounds not greater than value, value past the last bound is outside of the ranges unless
+    // the last range reaches the end of the type
+    if (bound > 0 && bound <= 3) {
+        return ksrp_wheels_wheels_status_temperature_health_check_interval_outcomes[bound - 1];
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Results set by bounds of temperature in WHEELS_STATUS frame in batch evaluation, value past the
+ * last bound is not in any range unless the last range reaches the end of the type
+ */
+static const uint8_t ksrp_wheels_wheels_status_temperature_health_check_bound_results[] = {
+    KSRP_RESULT_OK,
+    KSRP_RESULT_WARNING,
+    KSRP_RESULT_CRITICAL,
+    KSRP_RESULT_UNKNOWN,
+};
+
+static const KSRP_HealthCheckSteps_Float ksrp_wheels_wheels_status_temperature_health_check_steps = {
+    ksrp_wheels_wheels_status_temperature_health_check_bounds,
+    ksrp_wheels_wheels_status_temperature_health_check_bound_results,
+    4,
+    NULL,
+    NULL,
+    0
+};
+
+/**
+ * @brief Perform health check on temperature in WHEELS_STATUS frame
+ *
+ * @param frame The frame to check
+ * @return KSRP_HealthCheckResult The result of the health check
+ */
+_nonnull_
+KSRP_HealthCheckResult KSRP_HealthCheckResult_Wheels_WheelsStatus_Temperature(const KSRP_Wheels_WheelsStatus_Frame* frame) {
+    return KSRP_HealthCheckResultOfValue_Wheels_WheelsStatus_Temperature(frame->temperature);
+}
+
+/**
+ * @brief Perform health check on a value of temperature in WHEELS_STATUS frame
+ *
+ * @param value The value to check
+ * @return KSRP_HealthCheckResult The result of the health check
+ */
+KSRP_HealthCheckResult KSRP_HealthCheckResultOfValue_Wheels_WheelsStatus_Temperature(float value) {
+    return ksrp_wheels_wheels_status_temperature_health_check_outcomes[KSRP_HealthCheckClassify_Wheels_WheelsStatus_Temperature(value)].result;
+}
+
+/**
+ * @brief Perform health check on a column of temperature values in WHEELS_STATUS frame
+ *
+ * @param values The values to check, e.g. temperature column of KSRP_Wheels_WheelsStatus_Columns
+ * @param count The number of values
+ * @param results The results of the health checks, one for every value
+ */
+_nonnull_
+void KSRP_HealthCheckResultBatch_Wheels_WheelsStatus_Temperature(const float* values,
+    uint32_t count, KSRP_HealthCheckResult* results) {
+    KSRP_HealthCheckBatch_Float(values, count, &ksrp_wheels_wheels_status_temperature_health_check_steps, results);
 }
 
 /**
@@ -356,48 +774,49 @@ const char* KSRP_HealthCheckTroubleshoot_Wheels_WheelsStatus_DriverStatus(const
  */
 _nonnull_
 const char* KSRP_HealthCheckTroubleshoot_Wheels_WheelsStatus_Temperature(const KSRP_Wheels_WheelsStatus_Frame* frame) {
-    return "Unknown troubleshoot";
+    return ksrp_wheels_wheels_status_temperature_health_check_outcomes[KSRP_HealthCheckClassify_Wheels_WheelsStatus_Temperature(frame->temperature)].troubleshoot;
 }
 
 /**
- * @brief Get the description for the health check on driver_status in WHEELS_STATUS frame
+ * @brief Get the description for the health check on temperature in WHEELS_STATUS frame
  *
  * @param frame The frame to check
  * @return const char* The description
  */
 _nonnull_
-const char* KSRP_HealthCheckDescription_Wheels_WheelsStatus_DriverStatus(const KSRP_Wheels_WheelsStatus_Frame* frame) {
-    if (frame->driver_status == KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_HEALTH_CHECK_OK_1) {
-        return KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_HEALTH_CHECK_OK_1_DESCRIPTION;
-    }
-    if (frame->driver_status == KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_HEALTH_CHECK_CRITICAL_2) {
-        return KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_HEALTH_CHECK_CRITICAL_2_DESCRIPTION;
-    }
-    return "Unknown description";
+const char* KSRP_HealthCheckDescription_Wheels_WheelsStatus_Temperature(const KSRP_Wheels_WheelsStatus_Frame* frame) {
+    return ksrp_wheels_wheels_status_temperature_health_check_outcomes[KSRP_HealthCheckClassify_Wheels_WheelsStatus_Temperature(frame->temperature)].description;
 }
 
 /**
- * @brief Get the description for the health check on temperature in WHEELS_STATUS frame
+ * @brief Perform all health checks of WHEELS_STATUS frame in a single pass
  *
  * @param frame The frame to check
- * @return const char* The description
+ * @param failing_fields Bitmask of fields which result is not KSRP_RESULT_OK, bit number is field ID
+ * @return KSRP_HealthCheckResult The worst result of all checked fields, ordered from best: OK, UNKNOWN, WARNING,
+ * CRITICAL
  */
 _nonnull_
-const char* KSRP_HealthCheckDescription_Wheels_WheelsStatus_Temperature(const KSRP_Wheels_WheelsStatus_Frame* frame) {
-    if (frame->temperature >= KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_OK_1_MIN
-            && frame->temperature < KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_OK_1_MAX) {
-        return KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_OK_1_DESCRIPTION;
-    }
-    if (frame->temperature >= KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_WARNING_2_MIN
-            && frame->temperature < KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_WARNING_2_MAX) {
-        return KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_WARNING_2_DESCRIPTION;
+KSRP_HealthCheckResult KSRP_HealthCheck_Wheels_WheelsStatus_All(const KSRP_Wheels_WheelsStatus_Frame* frame, uint64_t* failing_fields) {
+    KSRP_HealthCheckResult worst = KSRP_RESULT_OK;
+    uint64_t failing = 0;
+
+    KSRP_HealthCheckResult driver_status_result = KSRP_HealthCheckResult_Wheels_WheelsStatus_DriverStatus(frame);
+    if (driver_status_result != KSRP_RESULT_OK) {
+        failing |= (uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_DRIVER_STATUS_FIELD_ID;
     }
-    if (frame->temperature >= KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_CRITICAL_3_MIN
-            && frame->temperature < KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_CRITICAL_3_MAX) {
-        return KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_HEALTH_CHECK_CRITICAL_3_DESCRIPTION;
+    worst = KSRP_HealthCheckResult_Worst(worst, driver_status_result);
+
+    KSRP_HealthCheckResult temperature_result = KSRP_HealthCheckResult_Wheels_WheelsStatus_Temperature(frame);
+    if (temperature_result != KSRP_RESULT_OK) {
+        failing |= (uint64_t)1 << KSRP_WHEELS_WHEELS_STATUS_TEMPERATURE_FIELD_ID;
     }
-    return "Unknown description";
+    worst = KSRP_HealthCheckResult_Worst(worst, temperature_result);
+
+    *failing_fields = failing;
+    return worst;
 }
+
 /**
  * @}
  */
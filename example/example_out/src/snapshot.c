@@ -0,0 +1,95 @@
+#include "ksrp/snapshot.h"
+
+#include "ksrp/endianness.h"
+
+_nonnull_
+void KSRP_SnapshotWriter_Init(KSRP_SnapshotWriter* writer, uint8_t* buffer, size_t capacity) {
+    writer->buffer = buffer;
+    writer->capacity = capacity;
+    writer->length = KSRP_SNAPSHOT_HEADER_BYTES;
+    writer->sections = 0;
+    writer->overflow = capacity < KSRP_SNAPSHOT_HEADER_BYTES;
+}
+
+_nonnull_
+uint8_t* KSRP_SnapshotWriter_AddSection(KSRP_SnapshotWriter* writer, uint8_t subsystem_id, uint32_t index,
+                                        uint64_t definition_hash, uint32_t length) {
+    if (writer->overflow || writer->capacity - writer->length < (size_t)KSRP_SNAPSHOT_SECTION_HEADER_BYTES + length) {
+        writer->overflow = true;
+        return NULL;
+    }
+
+    uint8_t* header = &writer->buffer[writer->length];
+    header[0] = subsystem_id;
+    KSRP_StoreLE32(&header[1], index);
+    KSRP_StoreLE64(&header[5], definition_hash);
+    KSRP_StoreLE32(&header[13], length);
+
+    writer->length += KSRP_SNAPSHOT_SECTION_HEADER_BYTES + length;
+    writer->sections++;
+
+    return header + KSRP_SNAPSHOT_SECTION_HEADER_BYTES;
+}
+
+_nonnull_
+KSRP_Status KSRP_SnapshotWriter_Finish(KSRP_SnapshotWriter* writer, size_t* length) {
+    if (writer->overflow) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    KSRP_StoreLE32(&writer->buffer[0], KSRP_SNAPSHOT_MAGIC);
+    KSRP_StoreLE16(&writer->buffer[4], KSRP_SNAPSHOT_VERSION);
+    KSRP_StoreLE32(&writer->buffer[6], writer->sections);
+    *length = writer->length;
+
+    return KSRP_STATUS_OK;
+}
+
+_nonnull_
+KSRP_Status KSRP_SnapshotReader_Init(KSRP_SnapshotReader* reader, const uint8_t* buffer, size_t length) {
+    reader->buffer = buffer;
+    reader->length = length;
+    reader->offset = length;
+    reader->sections = 0;
+
+    if (length < KSRP_SNAPSHOT_HEADER_BYTES) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    if (KSRP_LoadLE32(&buffer[0]) != KSRP_SNAPSHOT_MAGIC || KSRP_LoadLE16(&buffer[4]) != KSRP_SNAPSHOT_VERSION) {
+        return KSRP_STATUS_ERROR;
+    }
+
+    reader->offset = KSRP_SNAPSHOT_HEADER_BYTES;
+    reader->sections = KSRP_LoadLE32(&buffer[6]);
+
+    return KSRP_STATUS_OK;
+}
+
+_nonnull_
+KSRP_Status KSRP_SnapshotReader_Next(KSRP_SnapshotReader* reader, KSRP_SnapshotSection* section) {
+    if (reader->sections == 0) {
+        return KSRP_STATUS_ERROR;
+    }
+
+    const uint8_t* header = &reader->buffer[reader->offset];
+    size_t remaining = reader->length - reader->offset;
+
+    // Truncated image ends the iteration, following sections can't be located
+    if (remaining < KSRP_SNAPSHOT_SECTION_HEADER_BYTES ||
+        remaining - KSRP_SNAPSHOT_SECTION_HEADER_BYTES < KSRP_LoadLE32(&header[13])) {
+        reader->sections = 0;
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    section->subsystem_id = header[0];
+    section->index = KSRP_LoadLE32(&header[1]);
+    section->definition_hash = KSRP_LoadLE64(&header[5]);
+    section->length = KSRP_LoadLE32(&header[13]);
+    section->data = header + KSRP_SNAPSHOT_SECTION_HEADER_BYTES;
+
+    reader->offset += KSRP_SNAPSHOT_SECTION_HEADER_BYTES + section->length;
+    reader->sections--;
+
+    return KSRP_STATUS_OK;
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "ksrp/transport.h"
+
+_nonnull_
+void KSRP_Transport_Init(KSRP_Transport* transport, const KSRP_TransportOps* ops, void* backend) {
+    transport->ops = ops;
+    transport->backend = backend;
+    transport->queued = 0;
+}
+
+_nonnull_
+KSRP_Status KSRP_Transport_Send(KSRP_Transport* transport, const KSRP_RawData_Frame* frames, uint32_t count,
+                                uint32_t* sent) {
+    *sent = 0;
+
+    if (count == 0) {
+        return KSRP_STATUS_OK;
+    }
+
+    return transport->ops->send(transport->backend, frames, count, sent);
+}
+
+_nonnull_
+KSRP_Status KSRP_Transport_Queue(KSRP_Transport* transport, const KSRP_RawData_Frame* frame) {
+    if (frame->length > KSRP_RAW_DATA_FRAME_BUFFER_SIZE) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    if (transport->queued == KSRP_TRANSPORT_TX_CAPACITY) {
+        KSRP_Status status = KSRP_Transport_Flush(transport);
+        if (status == KSRP_STATUS_ERROR) {
+            return status;
+        }
+
+        // Frame is rejected only when the backend didn't accept any of the queued ones
+        if (transport->queued == KSRP_TRANSPORT_TX_CAPACITY) {
+            return KSRP_STATUS_BUSY;
+        }
+    }
+
+    KSRP_RawData_Frame* slot = &transport->queue[transport->queued++];
+    memcpy(slot->data, frame->data, frame->length);
+    slot->length = frame->length;
+
+    return KSRP_STATUS_OK;
+}
+
+_nonnull_
+KSRP_Status KSRP_Transport_Flush(KSRP_Transport* transport) {
+    uint32_t sent = 0;
+    KSRP_Status status = KSRP_Transport_Send(transport, transport->queue, transport->queued, &sent);
+
+    // Unsent frames keep their order at the front of the queue
+    if (sent > 0 && sent < transport->queued) {
+        memmove(transport->queue, &transport->queue[sent], (transport->queued - sent) * sizeof(KSRP_RawData_Frame));
+    }
+    transport->queued -= sent;
+
+    if (status == KSRP_STATUS_ERROR) {
+        return status;
+    }
+
+    return transport->queued == 0 ? KSRP_STATUS_OK : KSRP_STATUS_BUSY;
+}
+
+_nonnull_
+uint32_t KSRP_Transport_GetQueued(const KSRP_Transport* transport) {
+    return transport->queued;
+}
+
+_nonnull_
+KSRP_Status KSRP_Transport_Receive(KSRP_Transport* transport, KSRP_RawData_Frame* frames, uint32_t capacity,
+                                   uint32_t* received) {
+    *received = 0;
+
+    if (capacity == 0) {
+        return KSRP_STATUS_OK;
+    }
+
+    return transport->ops->receive(transport->backend, frames, capacity, received);
+}
+
+_nonnull_
+KSRP_Status KSRP_Transport_Wait(KSRP_Transport* transport, uint32_t timeout_ms) {
+    if (transport->ops->wait == NULL) {
+        return KSRP_STATUS_BUSY;
+    }
+
+    return transport->ops->wait(transport->backend, timeout_ms);
+}
+
+static KSRP_Status KSRP_Loopback_Send(void* backend, const KSRP_RawData_Frame* frames, uint32_t count,
+                                      uint32_t* sent) {
+    KSRP_Ring* ring = (KSRP_Ring*)backend;
+
+    for (*sent = 0; *sent < count; (*sent)++) {
+        // Only the consumer makes room, so a frame fitting now is never dropped by the push
+        if (KSRP_Ring_Count(ring) >= ring->capacity) {
+            return KSRP_STATUS_BUSY;
+        }
+
+        if (KSRP_Ring_Push(ring, &frames[*sent]) != KSRP_STATUS_OK) {
+            return KSRP_STATUS_ERROR;
+        }
+    }
+
+    return KSRP_STATUS_OK;
+}
+
+static KSRP_Status KSRP_Loopback_Receive(void* backend, KSRP_RawData_Frame* frames, uint32_t capacity,
+                                         uint32_t* received) {
+    KSRP_Ring* ring = (KSRP_Ring*)backend;
+
+    while (*received < capacity && KSRP_Ring_Pop(ring, &frames[*received]) == KSRP_STATUS_OK) {
+        (*received)++;
+    }
+
+    return KSRP_STATUS_OK;
+}
+
+static KSRP_Status KSRP_Loopback_Wait(void* backend, uint32_t timeout_ms) {
+    (void)timeout_ms;
+
+    return KSRP_Ring_Count((KSRP_Ring*)backend) > 0 ? KSRP_STATUS_OK : KSRP_STATUS_BUSY;
+}
+
+static const KSRP_TransportOps KSRP_LOOPBACK_OPS = {
+    .send = KSRP_Loopback_Send,
+    .receive = KSRP_Loopback_Receive,
+    .wait = KSRP_Loopback_Wait,
+};
+
+_nonnull_
+KSRP_Status KSRP_Loopback_Open(KSRP_Transport* transport, KSRP_Ring* ring, KSRP_RawData_Frame* frames,
+                               uint32_t capacity) {
+    KSRP_Status status = KSRP_Ring_Init(ring, frames, capacity);
+    if (status != KSRP_STATUS_OK) {
+        return status;
+    }
+
+    KSRP_Transport_Init(transport, &KSRP_LOOPBACK_OPS, ring);
+
+    return KSRP_STATUS_OK;
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#ifndef KALMAN_PROTOCOL_STATUS_REPORT_BATCH_H_
+#define KALMAN_PROTOCOL_STATUS_REPORT_BATCH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ksrp/common.h"
+#include "ksrp/frames.h"
+
+// Batch is a raw data frame with reserved type ID, followed by sub-frames packed back-to-back. Each sub-frame is
+// stored as one length byte and raw data of the frame (type ID bytes and payload):
+// | 0xFF | 0x00 | length_1 | frame_1 ... | length_2 | frame_2 ... | ...
+#define KSRP_BATCH_SUBSYSTEM_ID 0xFF
+#define KSRP_BATCH_FRAME_ID 0x00
+#define KSRP_BATCH_TYPE_ID KSRP_MAKE_TYPE_ID(KSRP_BATCH_SUBSYSTEM_ID, KSRP_BATCH_FRAME_ID)
+#define KSRP_BATCH_ENTRY_HEADER_BYTES 1
+
+/**
+ * @brief Iterator over sub-frames of a batch
+ */
+typedef struct {
+    const KSRP_RawData_Frame* batch;
+    uint8_t offset;
+} KSRP_BatchReader;
+
+/**
+ * @brief Batch being filled before sending, full batches are passed to send_frame_callback
+ */
+typedef struct {
+    KSRP_RawData_Frame batch;
+    KSRP_Status (*send_frame_callback)(KSRP_RawData_Frame* frame);
+} KSRP_Batcher;
+
+/**
+ * @brief Initialize an empty batch
+ *
+ * @param batch The raw data frame to initialize as batch
+ */
+_nonnull_
+void KSRP_Batch_Init(KSRP_RawData_Frame* batch);
+
+/**
+ * @brief Append a raw data frame to the batch
+ *
+ * @param batch The batch to append to
+ * @param frame The frame to append, must contain type ID
+ * @return KSRP_Status KSRP_STATUS_OK if appended, KSRP_STATUS_INVALID_DATA_SIZE if the frame doesn't fit
+ */
+_nonnull_
+KSRP_Status KSRP_Batch_Append(KSRP_RawData_Frame* batch, const KSRP_RawData_Frame* frame);
+
+/**
+ * @brief Check if a raw data frame is a batch
+ *
+ * @param frame The frame to check
+ * @return true if the frame is a batch
+ */
+_nonnull_
+bool KSRP_Batch_IsBatch(const KSRP_RawData_Frame* frame);
+
+/**
+ * @brief Check if a batch contains no sub-frames
+ *
+ * @param batch The batch to check
+ * @return true if the batch is empty
+ */
+_nonnull_
+bool KSRP_Batch_IsEmpty(const KSRP_RawData_Frame* batch);
+
+/**
+ * @brief Start iterating over sub-frames of a batch
+ *
+ * @param reader The reader to initialize
+ * @param batch The batch to read, has to outlive the reader
+ */
+_nonnull_
+void KSRP_BatchReader_Init(KSRP_BatchReader* reader, const KSRP_RawData_Frame* batch);
+
+/**
+ * @brief Copy the next sub-frame of a batch
+ *
+ * @param reader The reader to advance
+ * @param frame The frame to copy the sub-frame into
+ * @return KSRP_Status KSRP_STATUS_OK if a sub-frame was read, KSRP_STATUS_INVALID_DATA_SIZE if the batch is
+ * truncated, KSRP_STATUS_ERROR if there are no more sub-frames
+ */
+_nonnull_
+KSRP_Status KSRP_BatchReader_Next(KSRP_BatchReader* reader, KSRP_RawData_Frame* frame);
+
+/**
+ * @brief Initialize a batcher
+ *
+ * @param batcher The batcher to initialize
+ * @param send_frame_callback Callback sending complete batches
+ */
+_nonnull_
+void KSRP_Batcher_Init(KSRP_Batcher* batcher, KSRP_Status (*send_frame_callback)(KSRP_RawData_Frame* frame));
+
+/**
+ * @brief Add a frame to the current batch, current batch is sent first if the frame doesn't fit
+ *
+ * @param batcher The batcher to add the frame to
+ * @param frame The frame to add
+ * @return KSRP_Status KSRP_STATUS_OK if successful
+ */
+_nonnull_
+KSRP_Status KSRP_Batcher_Append(KSRP_Batcher* batcher, const KSRP_RawData_Frame* frame);
+
+/**
+ * @brief Send the current batch if it is not empty
+ *
+ * @param batcher The batcher to flush
+ * @return KSRP_Status KSRP_STATUS_OK if successful
+ */
+_nonnull_
+KSRP_Status KSRP_Batcher_Flush(KSRP_Batcher* batcher);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // KALMAN_PROTOCOL_STATUS_REPORT_BATCH_H_
\ No newline at end of file
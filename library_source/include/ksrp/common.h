@@ -21,11 +21,33 @@ typedef enum {
     KSRP_RESULT_UNKNOWN
 } KSRP_HealthCheckResult;
 
+/**
+ * @brief Result of a single health check with its descriptions, used in generated health check lookup tables
+ */
+typedef struct {
+    KSRP_HealthCheckResult result;
+    const char* description;
+    const char* troubleshoot;
+} KSRP_HealthCheckOutcome;
+
+/**
+ * @brief Get the worse of two health check results, results are ordered from best: OK, UNKNOWN, WARNING, CRITICAL
+ */
+static inline KSRP_HealthCheckResult KSRP_HealthCheckResult_Worst(KSRP_HealthCheckResult result1,
+                                                                  KSRP_HealthCheckResult result2) {
+    // Indexed by KSRP_HealthCheckResult: OK, WARNING, CRITICAL, UNKNOWN
+    static const uint8_t severity[] = {0, 2, 3, 1};
+
+    return severity[result1] >= severity[result2] ? result1 : result2;
+}
+
 typedef enum {
     KSRP_STATUS_OK,
     KSRP_STATUS_INVALID_DATA_SIZE,
     KSRP_STATUS_INVALID_FRAME_TYPE,
     KSRP_STATUS_INVALID_FIELD_TYPE,
+    KSRP_STATUS_INVALID_DEVICE_ID,
+    KSRP_STATUS_BUSY,
 
     KSRP_STATUS_ERROR
 } KSRP_Status;
@@ -33,6 +55,10 @@ typedef enum {
 #define KSRP_ILLEGAL_FRAME_ID 0xFFFFFFFF
 #define KSRP_ILLEGAL_FIELD_ID 0xFFFFFFFF
 typedef KSRP_Status (*KSRP_FrameUpdateCallback)(uint32_t subsystem_id, void* frame_instance, uint32_t frame_id, uint32_t field_id);
+typedef KSRP_Status (*KSRP_FrameStaleCallback)(uint32_t subsystem_id, void* frame_instance, uint32_t frame_id,
+                                               uint32_t ms_since_last_update);
+typedef KSRP_Status (*KSRP_HealthTransitionCallback)(uint32_t subsystem_id, void* frame_instance, uint32_t frame_id, uint32_t field_id,
+                                                    KSRP_HealthCheckResult previous, KSRP_HealthCheckResult current);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,173 @@
+#ifndef KALMAN_PROTOCOL_STATUS_REPORT_CPP_KSRP_HPP_
+#define KALMAN_PROTOCOL_STATUS_REPORT_CPP_KSRP_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <type_traits>
+
+#include "ksrp/common.h"
+#include "ksrp/frames.h"
+#include "ksrp/segments.h"
+
+/**
+ * @brief C++17 facade over generated protocol code
+ *
+ * Every frame is described by a generated descriptor type with constexpr members (type ID, size, name, list of
+ * fields), every field by descriptor with its offset, storage and value type. Accessors and dispatch are templates
+ * resolved at compile time, so they inline down to loads and stores of the packed frame structure.
+ */
+namespace ksrp {
+
+/**
+ * @brief Compile-time list of descriptor types
+ */
+template <typename... Ts>
+struct type_list {
+    static constexpr std::size_t size = sizeof...(Ts);
+};
+
+/**
+ * @brief Map generated C frame structure to its descriptor, specialized by generated headers
+ */
+template <typename Frame>
+struct descriptor_of;
+
+template <typename Frame>
+using descriptor_of_t = typename descriptor_of<Frame>::type;
+
+/**
+ * @brief Helper combining several lambdas into one visitor
+ */
+template <typename... Ts>
+struct overloaded : Ts... {
+    using Ts::operator()...;
+};
+
+template <typename... Ts>
+overloaded(Ts...) -> overloaded<Ts...>;
+
+/**
+ * @brief Call function with default constructed instance of every descriptor in the list
+ *
+ * @param function The function to call, i.e. generic lambda taking descriptor
+ */
+template <typename... Ts, typename Function>
+constexpr void for_each(type_list<Ts...>, Function&& function) {
+    (function(Ts{}), ...);
+}
+
+/**
+ * @brief Get the value of a field in a frame
+ *
+ * @tparam Field The descriptor of the field
+ * @param frame The frame to read
+ * @return The value of the field
+ */
+template <typename Field>
+inline typename Field::value_type get(const typename Field::frame::frame_type& frame) {
+    typename Field::storage_type storage;
+    std::memcpy(&storage, reinterpret_cast<const unsigned char*>(&frame) + Field::offset, sizeof(storage));
+    return static_cast<typename Field::value_type>(storage);
+}
+
+/**
+ * @brief Set the value of a field in a frame
+ *
+ * @tparam Field The descriptor of the field
+ * @param frame The frame to modify
+ * @param value The new value of the field
+ */
+template <typename Field>
+inline void set(typename Field::frame::frame_type& frame, typename Field::value_type value) {
+    const auto storage = static_cast<typename Field::storage_type>(value);
+    std::memcpy(reinterpret_cast<unsigned char*>(&frame) + Field::offset, &storage, sizeof(storage));
+}
+
+/**
+ * @brief Get the health check result of a field in a frame
+ *
+ * @tparam Field The descriptor of the field, field must have health checks
+ * @param frame The frame to check
+ * @return KSRP_HealthCheckResult The result of the health check
+ */
+template <typename Field>
+inline KSRP_HealthCheckResult health(const typename Field::frame::frame_type& frame) {
+    static_assert(Field::has_health_checks, "Field has no health checks");
+    return Field::health_check(frame);
+}
+
+namespace detail {
+
+template <typename Frame, typename Visitor>
+inline KSRP_Status unpack_and_visit(const KSRP_RawData_Frame& raw_data, Visitor&& visitor) {
+    typename Frame::frame_type frame;
+    const KSRP_Status status = Frame::unpack(raw_data, frame);
+    if (status != KSRP_STATUS_OK) {
+        return status;
+    }
+
+    std::forward<Visitor>(visitor)(frame);
+    return KSRP_STATUS_OK;
+}
+
+template <typename... Frames, typename Visitor>
+inline KSRP_Status visit(type_list<Frames...>, const KSRP_RawData_Frame& raw_data, Visitor&& visitor) {
+    const KSRP_TypeID type_id = KSRP_RawData_Frame_GetTypeID(&raw_data);
+    KSRP_Status status = KSRP_STATUS_INVALID_FRAME_TYPE;
+    (void)((type_id == Frames::type_id && (status = unpack_and_visit<Frames>(raw_data, visitor), true)) || ...);
+    return status;
+}
+
+template <typename Frame, typename Visitor>
+inline KSRP_Status unpack_segmented_and_visit(const KSRP_SegmentedPayload& payload, Visitor&& visitor) {
+    typename Frame::frame_type frame;
+    const KSRP_Status status = Frame::unpack_segmented(payload, frame);
+    if (status != KSRP_STATUS_OK) {
+        return status;
+    }
+
+    std::forward<Visitor>(visitor)(frame);
+    return KSRP_STATUS_OK;
+}
+
+template <typename... Frames, typename Visitor>
+inline KSRP_Status visit(type_list<Frames...>, const KSRP_SegmentedPayload& payload, Visitor&& visitor) {
+    KSRP_Status status = KSRP_STATUS_INVALID_FRAME_TYPE;
+    (void)((payload.type_id == Frames::type_id &&
+            (status = unpack_segmented_and_visit<Frames>(payload, visitor), true)) || ...);
+    return status;
+}
+
+} // namespace detail
+
+/**
+ * @brief Unpack a raw data frame into the frame of matching type and pass it to the visitor
+ *
+ * @tparam Frames The list of frame descriptors to match, i.e. ksrp::wheels::Frames or ksrp::Frames
+ * @param raw_data The raw data frame to unpack
+ * @param visitor Callable accepting every frame structure in the list, i.e. ksrp::overloaded lambdas
+ * @return KSRP_Status The status of the unpacking, KSRP_STATUS_INVALID_FRAME_TYPE if no frame in the list matches
+ */
+template <typename Frames, typename Visitor>
+inline KSRP_Status visit(const KSRP_RawData_Frame& raw_data, Visitor&& visitor) {
+    return detail::visit(Frames{}, raw_data, std::forward<Visitor>(visitor));
+}
+
+/**
+ * @brief Unpack a reassembled segmented frame into the frame of matching type and pass it to the visitor
+ *
+ * @tparam Frames The list of segmented frame descriptors to match, i.e. ksrp::SegmentedFrames
+ * @param payload The payload completed by KSRP_Reassembler_Push
+ * @param visitor Callable accepting every frame structure in the list
+ * @return KSRP_Status The status of the unpacking, KSRP_STATUS_INVALID_FRAME_TYPE if no frame in the list matches
+ */
+template <typename Frames, typename Visitor>
+inline KSRP_Status visit(const KSRP_SegmentedPayload& payload, Visitor&& visitor) {
+    return detail::visit(Frames{}, payload, std::forward<Visitor>(visitor));
+}
+
+} // namespace ksrp
+
+#endif // KALMAN_PROTOCOL_STATUS_REPORT_CPP_KSRP_HPP_
\ No newline at end of file
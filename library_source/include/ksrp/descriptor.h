@@ -0,0 +1,75 @@
+#ifndef KALMAN_PROTOCOL_STATUS_REPORT_DESCRIPTOR_H_
+#define KALMAN_PROTOCOL_STATUS_REPORT_DESCRIPTOR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ksrp/common.h"
+
+/// @brief Field is the device ID of the frame and can't be updated on its own
+#define KSRP_FIELD_FLAG_DEVICE_ID 0x01
+/// @brief Field has health checks
+#define KSRP_FIELD_FLAG_HEALTH_CHECK 0x02
+
+/**
+ * @brief Type of a frame field
+ */
+typedef enum {
+    KSRP_FIELD_TYPE_UINT8,
+    KSRP_FIELD_TYPE_UINT16,
+    KSRP_FIELD_TYPE_UINT32,
+    KSRP_FIELD_TYPE_UINT64,
+    KSRP_FIELD_TYPE_INT8,
+    KSRP_FIELD_TYPE_INT16,
+    KSRP_FIELD_TYPE_INT32,
+    KSRP_FIELD_TYPE_INT64,
+    KSRP_FIELD_TYPE_FLOAT,
+    KSRP_FIELD_TYPE_DOUBLE,
+    KSRP_FIELD_TYPE_ENUM,
+    KSRP_FIELD_TYPE_BOOL,
+} KSRP_FieldType;
+
+/**
+ * @brief Layout of a single field inside of packed frame structure
+ */
+typedef struct {
+    uint8_t offset;
+    uint8_t size;
+    uint8_t type;
+    uint8_t flags;
+} KSRP_FieldDescriptor;
+
+/**
+ * @brief Layout of a frame structure, fields are indexed by field ID
+ */
+typedef struct {
+    const KSRP_FieldDescriptor* fields;
+    uint32_t fields_count;
+} KSRP_FrameDescriptor;
+
+/**
+ * @brief Copy new value of a field into frame structure, shared by all fields of all frames in tables layout
+ *
+ * @param descriptor The descriptor of the frame
+ * @param frame The frame structure to update
+ * @param field_id The ID of the field to update
+ * @param value The new field data
+ * @param value_size The size of the new field data
+ * @param change Set to true if value of the field changed
+ * @return KSRP_Status The status of the update, KSRP_STATUS_OK if successful, KSRP_STATUS_INVALID_FIELD_TYPE if frame
+ * has no such field, KSRP_STATUS_INVALID_DATA_SIZE if value size doesn't match the field
+ */
+_nonnull_
+KSRP_Status KSRP_FrameDescriptor_UpdateField(const KSRP_FrameDescriptor* descriptor, void* frame, uint32_t field_id,
+                                             const void* value, size_t value_size, bool* change);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // KALMAN_PROTOCOL_STATUS_REPORT_DESCRIPTOR_H_
\ No newline at end of file
@@ -0,0 +1,125 @@
+#ifndef KALMAN_PROTOCOL_STATUS_REPORT_HOST_FLEET_H_
+#define KALMAN_PROTOCOL_STATUS_REPORT_HOST_FLEET_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ksrp/common.h"
+#include "ksrp/frames.h"
+
+// Arrays of the fleet store start on cache lines and shards cover multiples of KSRP_FLEET_SHARD_VEHICLES vehicles,
+// so threads working on neighbouring shards don't share cache lines of per-frame arrays
+#define KSRP_FLEET_CACHE_LINE 64
+#define KSRP_FLEET_SHARD_VEHICLES 64
+
+// Number of counters every shard accumulates, summed after all shards finish
+#define KSRP_FLEET_COUNTERS 4
+
+/**
+ * @brief Received raw data frame tagged with the vehicle that sent it
+ */
+typedef struct {
+    uint32_t vehicle;
+    uint32_t timestamp_ms;
+    KSRP_RawData_Frame frame;
+} KSRP_FleetFrame;
+
+/**
+ * @brief Counters of a batch update of the fleet store
+ */
+typedef struct {
+    uint64_t applied;
+    uint64_t failed;
+} KSRP_FleetUpdateStats;
+
+/**
+ * @brief Counters of a sweep over the fleet store
+ */
+typedef struct {
+    uint64_t stale;       // Frames not updated for their timeout
+    uint64_t warning;     // Frames which worst health check result is KSRP_RESULT_WARNING
+    uint64_t critical;    // Frames which worst health check result is KSRP_RESULT_CRITICAL
+    uint64_t transitions; // Frames which worst health check result changed since the previous sweep
+} KSRP_FleetSweepStats;
+
+/**
+ * @brief Called for every stale frame found by a sweep, concurrently from worker threads for different vehicles
+ */
+typedef void (*KSRP_FleetStaleCallback)(uint32_t vehicle, KSRP_TypeID type_id, uint8_t device_id, uint32_t age_ms,
+                                        void* context);
+
+/**
+ * @brief Called when worst health check result of a frame changes, concurrently from worker threads for different
+ * vehicles
+ */
+typedef void (*KSRP_FleetHealthCallback)(uint32_t vehicle, KSRP_TypeID type_id, uint8_t device_id,
+                                         KSRP_HealthCheckResult previous, KSRP_HealthCheckResult current,
+                                         uint64_t failing_fields, void* context);
+
+/**
+ * @brief Work on vehicles [first_vehicle, end_vehicle), may only write state of these vehicles and its counters
+ */
+typedef void (*KSRP_FleetShardWork)(uint32_t first_vehicle, uint32_t end_vehicle, void* context,
+                                    uint64_t counters[KSRP_FLEET_COUNTERS]);
+
+/**
+ * @brief Reserve a cache line aligned array in an arena being laid out
+ *
+ * @param arena_size Size of the arena laid out so far, increased by the array
+ * @param bytes Size of the array
+ * @return size_t Offset of the array in the arena
+ */
+_nonnull_
+size_t KSRP_Fleet_Reserve(size_t* arena_size, size_t bytes);
+
+/**
+ * @brief Allocate a zeroed cache line aligned arena
+ *
+ * @param arena_size Size of the arena laid out with KSRP_Fleet_Reserve
+ * @return void* The arena, NULL if it couldn't be allocated, free it with free
+ */
+void* KSRP_Fleet_AllocateArena(size_t arena_size);
+
+/**
+ * @brief Get the number of threads to work with
+ *
+ * @param threads Requested number of threads, 0 for the number of online processors
+ * @return uint32_t Number of threads, at least 1
+ */
+uint32_t KSRP_Fleet_ResolveThreads(uint32_t threads);
+
+/**
+ * @brief Get the number of vehicles in every shard of KSRP_Fleet_RunSharded, the last shard may have fewer
+ *
+ * @param vehicles Number of vehicles
+ * @param threads Number of threads, 0 for the number of online processors. Pass the number resolved with
+ * KSRP_Fleet_ResolveThreads, so the shards match the ones of KSRP_Fleet_RunSharded
+ * @return uint32_t Number of vehicles in a shard, multiple of KSRP_FLEET_SHARD_VEHICLES, 0 without vehicles
+ */
+uint32_t KSRP_Fleet_ShardVehicles(uint32_t vehicles, uint32_t threads);
+
+/**
+ * @brief Split vehicles into contiguous shards and run work on every shard in its own thread
+ *
+ * The calling thread works on the first shard. Shard which thread couldn't be created is worked on by the calling
+ * thread too, so all vehicles are always processed.
+ *
+ * @param vehicles Number of vehicles
+ * @param threads Number of threads including the calling one, 0 for the number of online processors
+ * @param work The work of a single shard
+ * @param context The context passed to the work
+ * @param counters Sums of counters of all shards
+ */
+void KSRP_Fleet_RunSharded(uint32_t vehicles, uint32_t threads, KSRP_FleetShardWork work, void* context,
+                           uint64_t counters[KSRP_FLEET_COUNTERS]);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // KALMAN_PROTOCOL_STATUS_REPORT_HOST_FLEET_H_
\ No newline at end of file
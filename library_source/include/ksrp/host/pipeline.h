@@ -0,0 +1,80 @@
+#ifndef KALMAN_PROTOCOL_STATUS_REPORT_HOST_PIPELINE_H_
+#define KALMAN_PROTOCOL_STATUS_REPORT_HOST_PIPELINE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "ksrp/common.h"
+#include "ksrp/frames.h"
+
+#define KSRP_PIPELINE_DEFAULT_CHUNK_FRAMES 1024
+#define KSRP_PIPELINE_CHUNKS_PER_THREAD 16
+
+/**
+ * @brief Raw data frame recorded with its reception time
+ */
+typedef struct {
+    uint64_t timestamp;
+    KSRP_RawData_Frame frame;
+} KSRP_TimedFrame;
+
+/**
+ * @brief Decode a single recorded frame, called concurrently from worker threads, so it may only write to decoded
+ */
+typedef KSRP_Status (*KSRP_PipelineDecode)(const KSRP_TimedFrame* frame, void* decoded, void* context);
+
+/**
+ * @brief Apply a decoded frame to the state, called from the thread running the pipeline in timestamp order
+ */
+typedef KSRP_Status (*KSRP_PipelineApply)(const void* decoded, uint64_t timestamp, void* context);
+
+/**
+ * @brief Configuration of the decode pipeline
+ */
+typedef struct {
+    uint32_t threads;      // Number of worker threads, 0 uses all online processors
+    uint32_t chunk_frames; // Number of frames in a single work item, 0 uses KSRP_PIPELINE_DEFAULT_CHUNK_FRAMES
+    size_t decoded_size;   // Size of the result of decode, i.e. sizeof(KSRP_DecodedFrame)
+    KSRP_PipelineDecode decode;
+    KSRP_PipelineApply apply;
+    void* context;
+} KSRP_PipelineConfig;
+
+/**
+ * @brief Counters of a finished pipeline run
+ */
+typedef struct {
+    uint64_t frames;
+    uint64_t decode_failed;
+    uint64_t apply_failed;
+    uint64_t stolen_chunks;
+} KSRP_PipelineStats;
+
+/**
+ * @brief Decode recorded frames on worker threads and apply them in timestamp order
+ *
+ * Frames are processed in windows of KSRP_PIPELINE_CHUNKS_PER_THREAD chunks per thread. Chunks of a window are
+ * split between per-thread deques, every worker decodes chunks from the front of its own deque and steals from
+ * the back of other deques once it runs out of work. Decoded frames of every chunk are sorted by timestamp and
+ * chunks are merged, so frames of a window are applied in timestamp order (frames with equal timestamps in
+ * recording order). The next window is decoded while the current one is applied.
+ *
+ * @param config The configuration of the pipeline
+ * @param frames The recorded frames, expected to be sorted by timestamp up to reordering within a window
+ * @param frames_count Number of recorded frames
+ * @param stats Counters of the run, may be NULL
+ * @return KSRP_Status KSRP_STATUS_OK if all frames were processed (failures of single frames are counted in
+ * stats), KSRP_STATUS_ERROR if the configuration is invalid or resources couldn't be allocated
+ */
+KSRP_Status KSRP_Pipeline_Run(const KSRP_PipelineConfig* config, const KSRP_TimedFrame* frames, size_t frames_count,
+                              KSRP_PipelineStats* stats);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // KALMAN_PROTOCOL_STATUS_REPORT_HOST_PIPELINE_H_
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef KALMAN_PROTOCOL_STATUS_REPORT_RING_H_
+#define KALMAN_PROTOCOL_STATUS_REPORT_RING_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ksrp/common.h"
+#include "ksrp/frames.h"
+
+// Ring indices are accessed only with C11 atomics inside of the library, C++ sees them as plain integers
+// of the same layout
+#ifdef __cplusplus
+typedef uint32_t KSRP_RingIndex;
+#else
+#include <stdatomic.h>
+typedef _Atomic uint32_t KSRP_RingIndex;
+#endif // __cplusplus
+
+/**
+ * @brief Fixed-capacity lock-free ring of raw data frames for single producer and single consumer
+ *
+ * Producer (i.e. CAN RX interrupt) only pushes and consumer (i.e. main loop) only pops, so neither side has to
+ * disable interrupts. Indices run freely and are masked with capacity, only atomic loads and stores are used, so
+ * the ring works on cores without atomic read-modify-write instructions.
+ */
+typedef struct {
+    KSRP_RawData_Frame* frames;
+    uint32_t capacity;
+    KSRP_RingIndex head;
+    KSRP_RingIndex tail;
+    KSRP_RingIndex dropped;
+} KSRP_Ring;
+
+/**
+ * @brief Initialize an empty ring
+ *
+ * @param ring The ring to initialize
+ * @param frames Storage of the ring, has to outlive the ring
+ * @param capacity Number of frames in the storage, must be a power of two
+ * @return KSRP_Status KSRP_STATUS_OK if successful, KSRP_STATUS_INVALID_DATA_SIZE if capacity is not a power of two
+ */
+_nonnull_
+KSRP_Status KSRP_Ring_Init(KSRP_Ring* ring, KSRP_RawData_Frame* frames, uint32_t capacity);
+
+/**
+ * @brief Copy a frame into the ring, may be called only by the producer
+ *
+ * @param ring The ring to push into
+ * @param frame The frame to push
+ * @return KSRP_Status KSRP_STATUS_OK if pushed, KSRP_STATUS_ERROR if the ring is full and the frame was dropped
+ */
+_nonnull_
+KSRP_Status KSRP_Ring_Push(KSRP_Ring* ring, const KSRP_RawData_Frame* frame);
+
+/**
+ * @brief Copy the oldest frame out of the ring, may be called only by the consumer
+ *
+ * @param ring The ring to pop from
+ * @param frame The frame to copy into
+ * @return KSRP_Status KSRP_STATUS_OK if popped, KSRP_STATUS_ERROR if the ring is empty
+ */
+_nonnull_
+KSRP_Status KSRP_Ring_Pop(KSRP_Ring* ring, KSRP_RawData_Frame* frame);
+
+/**
+ * @brief Get the number of frames waiting in the ring
+ *
+ * @param ring The ring to check
+ * @return uint32_t The number of frames in the ring
+ */
+_nonnull_
+uint32_t KSRP_Ring_Count(KSRP_Ring* ring);
+
+/**
+ * @brief Get the number of frames dropped because the ring was full
+ *
+ * @param ring The ring to check
+ * @return uint32_t The number of dropped frames
+ */
+_nonnull_
+uint32_t KSRP_Ring_GetDropped(KSRP_Ring* ring);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // KALMAN_PROTOCOL_STATUS_REPORT_RING_H_
\ No newline at end of file
@@ -0,0 +1,169 @@
+#ifndef KALMAN_PROTOCOL_STATUS_REPORT_SEGMENTS_H_
+#define KALMAN_PROTOCOL_STATUS_REPORT_SEGMENTS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ksrp/common.h"
+#include "ksrp/frames.h"
+
+// Segment is a raw data frame with reserved type ID carrying a part of serialized frame too large for a single raw
+// data frame. It is followed by type ID of the segmented frame, device ID (0 for subsystems without multiple devices),
+// sequence number of the segmented frame, index of the segment, number of segments and part of the payload. All
+// segments except the last one carry exactly KSRP_SEGMENT_PAYLOAD_BYTES:
+// | 0xFF | 0x02 | subsystem_id | frame_id | device_id | sequence | index | count | payload ... |
+#define KSRP_SEGMENT_SUBSYSTEM_ID 0xFF
+#define KSRP_SEGMENT_FRAME_ID 0x02
+#define KSRP_SEGMENT_TYPE_ID KSRP_MAKE_TYPE_ID(KSRP_SEGMENT_SUBSYSTEM_ID, KSRP_SEGMENT_FRAME_ID)
+#define KSRP_SEGMENT_HEADER_BYTES (2 * KSRP_ID_BYTES + 4)
+#define KSRP_SEGMENT_PAYLOAD_BYTES (KSRP_RAW_DATA_FRAME_BUFFER_SIZE - KSRP_SEGMENT_HEADER_BYTES)
+#define KSRP_SEGMENTS_COUNT(payload_size) (((payload_size) + KSRP_SEGMENT_PAYLOAD_BYTES - 1) / KSRP_SEGMENT_PAYLOAD_BYTES)
+
+// Largest payload that can be reassembled, every reassembly slot reserves that much memory
+#ifndef KSRP_SEGMENTED_MAX_SIZE
+#define KSRP_SEGMENTED_MAX_SIZE 1024
+#endif // KSRP_SEGMENTED_MAX_SIZE
+
+#define KSRP_SEGMENTS_MAX_COUNT KSRP_SEGMENTS_COUNT(KSRP_SEGMENTED_MAX_SIZE)
+
+// Generated code serializes one segment at a time into a window of the payload, it starts KSRP_SEGMENT_WINDOW_MARGIN
+// bytes before the segment, so fields crossing boundaries of the segment fit into it
+#define KSRP_SEGMENT_WINDOW_MARGIN 8
+#define KSRP_SEGMENT_WINDOW_BYTES (KSRP_SEGMENT_PAYLOAD_BYTES + 2 * KSRP_SEGMENT_WINDOW_MARGIN)
+
+/**
+ * @brief Payload of a segmented frame, points into the reassembly slot it was completed in
+ */
+typedef struct {
+    KSRP_TypeID type_id;
+    uint8_t device_id;
+    uint16_t length;
+    const uint8_t* data;
+} KSRP_SegmentedPayload;
+
+/**
+ * @brief Segmented frame being reassembled, received segments are written directly to their place in the payload
+ */
+typedef struct {
+    uint8_t payload[KSRP_SEGMENTED_MAX_SIZE];
+    uint8_t received[(KSRP_SEGMENTS_MAX_COUNT + 7) / 8];
+    uint32_t started_ms;
+    uint16_t length;
+    KSRP_TypeID type_id;
+    uint8_t device_id;
+    uint8_t sequence;
+    uint8_t count;
+    uint8_t received_count;
+} KSRP_ReassemblySlot;
+
+/**
+ * @brief Bounded set of segmented frames being reassembled, at most one per type ID and device ID
+ */
+typedef struct {
+    KSRP_ReassemblySlot* slots;
+    uint32_t slots_count;
+    uint32_t timeout_ms;
+    uint32_t dropped;
+} KSRP_Reassembler;
+
+/**
+ * @brief Split a serialized frame into segments and send all of them
+ *
+ * @param type_id The type ID of the segmented frame
+ * @param device_id The device ID of the segmented frame, 0 for subsystems without multiple devices
+ * @param sequence The sequence number of the segmented frame, should differ from previous frame of the same type
+ * @param payload The serialized frame without type ID
+ * @param length The size of the serialized frame, at most 255 segments
+ * @param send_frame_callback Callback sending every segment
+ * @return KSRP_Status KSRP_STATUS_OK if all segments were sent, KSRP_STATUS_INVALID_DATA_SIZE if the payload is
+ * empty or too large, KSRP_STATUS_ERROR if sending of any segment failed
+ */
+_nonnull_
+KSRP_Status KSRP_Segments_Send(KSRP_TypeID type_id, uint8_t device_id, uint8_t sequence, const uint8_t* payload,
+                               uint16_t length, KSRP_Status (*send_frame_callback)(KSRP_RawData_Frame* frame));
+
+/**
+ * @brief Write the header of a single segment, its part of the payload is written by the caller
+ *
+ * @param segment The segment to initialize, its length includes the part of the payload
+ * @param type_id The type ID of the segmented frame
+ * @param device_id The device ID of the segmented frame, 0 for subsystems without multiple devices
+ * @param sequence The sequence number of the segmented frame
+ * @param index The index of the segment, lower than KSRP_SEGMENTS_COUNT(length)
+ * @param length The size of the serialized frame, at most 255 segments
+ * @return uint8_t* Part of the payload carried by the segment, KSRP_SEGMENT_PAYLOAD_BYTES except for the last one
+ */
+_nonnull_
+uint8_t* KSRP_Segment_Init(KSRP_RawData_Frame* segment, KSRP_TypeID type_id, uint8_t device_id, uint8_t sequence,
+                           uint8_t index, uint16_t length);
+
+/**
+ * @brief Check if a raw data frame is a segment
+ *
+ * @param frame The frame to check
+ * @return true if the frame is a segment
+ */
+_nonnull_
+bool KSRP_Segment_IsSegment(const KSRP_RawData_Frame* frame);
+
+/**
+ * @brief Initialize a reassembler with all slots free
+ *
+ * @param reassembler The reassembler to initialize
+ * @param slots Storage of the reassembler, has to outlive the reassembler
+ * @param slots_count Number of slots in the storage, limits number of frames reassembled at once
+ * @param timeout_ms Time after the first segment when incomplete frame is evicted
+ */
+_nonnull_
+void KSRP_Reassembler_Init(KSRP_Reassembler* reassembler, KSRP_ReassemblySlot* slots, uint32_t slots_count,
+                           uint32_t timeout_ms);
+
+/**
+ * @brief Add a received segment to its frame
+ *
+ * Segments may arrive in any order and duplicates are ignored, also of the last completed frame. Segment with a new
+ * sequence number replaces incomplete frame of the same type ID and device ID. When no slot is free, incomplete
+ * frames older than timeout are evicted.
+ *
+ * @param reassembler The reassembler to add the segment to
+ * @param segment The received segment
+ * @param now_ms Current time (in ms)
+ * @param payload Completed payload, data is NULL until the last missing segment is added. It is not copied, so it
+ * is valid only until the next call of KSRP_Reassembler_Push
+ * @return KSRP_Status KSRP_STATUS_OK if the segment was added, KSRP_STATUS_INVALID_FRAME_TYPE if the frame is not
+ * a segment, KSRP_STATUS_INVALID_DATA_SIZE if the segment is malformed or the frame exceeds KSRP_SEGMENTED_MAX_SIZE,
+ * KSRP_STATUS_ERROR if all slots are taken by frames still being reassembled
+ */
+_nonnull_
+KSRP_Status KSRP_Reassembler_Push(KSRP_Reassembler* reassembler, const KSRP_RawData_Frame* segment, uint32_t now_ms,
+                                  KSRP_SegmentedPayload* payload);
+
+/**
+ * @brief Free slots of incomplete frames older than timeout
+ *
+ * @param reassembler The reassembler to evict from
+ * @param now_ms Current time (in ms)
+ * @return uint32_t Number of evicted frames
+ */
+_nonnull_
+uint32_t KSRP_Reassembler_Evict(KSRP_Reassembler* reassembler, uint32_t now_ms);
+
+/**
+ * @brief Get the number of incomplete frames that were evicted or replaced by a newer frame
+ *
+ * @param reassembler The reassembler to read
+ * @return uint32_t Number of dropped frames
+ */
+_nonnull_
+uint32_t KSRP_Reassembler_GetDropped(const KSRP_Reassembler* reassembler);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // KALMAN_PROTOCOL_STATUS_REPORT_SEGMENTS_H_
\ No newline at end of file
@@ -0,0 +1,127 @@
+#ifndef KALMAN_PROTOCOL_STATUS_REPORT_SNAPSHOT_H_
+#define KALMAN_PROTOCOL_STATUS_REPORT_SNAPSHOT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ksrp/common.h"
+
+// Snapshot image is a header followed by sections, every section holds state of a single instance. All integers are
+// little-endian, frames are stored in their wire layout, so images don't depend on the build that wrote them:
+// | magic (4) | version (2) | sections count (4) |
+// | subsystem ID (1) | index (4) | definition hash (8) | length (4) | state ... | ...
+#define KSRP_SNAPSHOT_MAGIC 0x5352534BU // "KSRS"
+#define KSRP_SNAPSHOT_VERSION 1
+#define KSRP_SNAPSHOT_HEADER_BYTES 10
+#define KSRP_SNAPSHOT_SECTION_HEADER_BYTES 17
+
+/**
+ * @brief Snapshot image being written into a caller provided buffer
+ */
+typedef struct {
+    uint8_t* buffer;
+    size_t capacity;
+    size_t length;
+    uint32_t sections;
+    bool overflow;
+} KSRP_SnapshotWriter;
+
+/**
+ * @brief State of a single instance in a snapshot image
+ */
+typedef struct {
+    uint8_t subsystem_id;
+    uint32_t index;           // Index of the registry the instance belongs to, 0 for standalone instances
+    uint64_t definition_hash; // KSRP_<SUBSYSTEM>_DEFINITION_HASH of the definition the instance was generated from
+    uint32_t length;
+    const uint8_t* data;
+} KSRP_SnapshotSection;
+
+/**
+ * @brief Iterator over sections of a snapshot image
+ */
+typedef struct {
+    const uint8_t* buffer;
+    size_t length;
+    size_t offset;
+    uint32_t sections;
+} KSRP_SnapshotReader;
+
+/**
+ * @brief Read a cached health check result stored in a snapshot
+ *
+ * @param value The stored result
+ * @return KSRP_HealthCheckResult The result, KSRP_RESULT_UNKNOWN if the value isn't a valid result
+ */
+static inline KSRP_HealthCheckResult KSRP_Snapshot_LoadHealth(uint8_t value) {
+    return value <= KSRP_RESULT_UNKNOWN ? (KSRP_HealthCheckResult)value : KSRP_RESULT_UNKNOWN;
+}
+
+/**
+ * @brief Start writing a snapshot image
+ *
+ * @param writer The writer to initialize
+ * @param buffer The buffer to write the image into, has to outlive the writer
+ * @param capacity Size of the buffer
+ */
+_nonnull_
+void KSRP_SnapshotWriter_Init(KSRP_SnapshotWriter* writer, uint8_t* buffer, size_t capacity);
+
+/**
+ * @brief Append a section to the image
+ *
+ * @param writer The writer to append to
+ * @param subsystem_id The ID of the subsystem of the instance
+ * @param index The index of the registry the instance belongs to, 0 for standalone instances
+ * @param definition_hash The definition hash of the subsystem
+ * @param length Size of the state of the instance
+ * @return uint8_t* Buffer for the state of the instance, NULL if the section doesn't fit
+ */
+_nonnull_
+uint8_t* KSRP_SnapshotWriter_AddSection(KSRP_SnapshotWriter* writer, uint8_t subsystem_id, uint32_t index,
+                                        uint64_t definition_hash, uint32_t length);
+
+/**
+ * @brief Write the header of the image
+ *
+ * @param writer The writer to finish
+ * @param length Size of the image
+ * @return KSRP_Status KSRP_STATUS_OK if the image is complete, KSRP_STATUS_INVALID_DATA_SIZE if any section didn't
+ * fit into the buffer
+ */
+_nonnull_
+KSRP_Status KSRP_SnapshotWriter_Finish(KSRP_SnapshotWriter* writer, size_t* length);
+
+/**
+ * @brief Start reading sections of a snapshot image
+ *
+ * @param reader The reader to initialize
+ * @param buffer The image, has to outlive the reader
+ * @param length Size of the image
+ * @return KSRP_Status KSRP_STATUS_OK if the header is valid, KSRP_STATUS_INVALID_DATA_SIZE if the image is
+ * truncated, KSRP_STATUS_ERROR if it isn't a snapshot image or was written by a different version
+ */
+_nonnull_
+KSRP_Status KSRP_SnapshotReader_Init(KSRP_SnapshotReader* reader, const uint8_t* buffer, size_t length);
+
+/**
+ * @brief Read the next section of the image, section data points into the image
+ *
+ * @param reader The reader to read from
+ * @param section The section read
+ * @return KSRP_Status KSRP_STATUS_OK if a section was read, KSRP_STATUS_INVALID_DATA_SIZE if the section is
+ * truncated, KSRP_STATUS_ERROR if there are no more sections
+ */
+_nonnull_
+KSRP_Status KSRP_SnapshotReader_Next(KSRP_SnapshotReader* reader, KSRP_SnapshotSection* section);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // KALMAN_PROTOCOL_STATUS_REPORT_SNAPSHOT_H_
\ No newline at end of file
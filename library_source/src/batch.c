@@ -0,0 +1,93 @@
+#include "ksrp/batch.h"
+
+_nonnull_
+void KSRP_Batch_Init(KSRP_RawData_Frame* batch) {
+    batch->data[0] = KSRP_BATCH_SUBSYSTEM_ID;
+    batch->data[1] = KSRP_BATCH_FRAME_ID;
+    batch->length = KSRP_ID_BYTES;
+}
+
+_nonnull_
+KSRP_Status KSRP_Batch_Append(KSRP_RawData_Frame* batch, const KSRP_RawData_Frame* frame) {
+    if (frame->length < KSRP_ID_BYTES) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    if (batch->length + KSRP_BATCH_ENTRY_HEADER_BYTES + frame->length > KSRP_RAW_DATA_FRAME_BUFFER_SIZE) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    batch->data[batch->length] = frame->length;
+    memcpy(&batch->data[batch->length + KSRP_BATCH_ENTRY_HEADER_BYTES], frame->data, frame->length);
+    batch->length += KSRP_BATCH_ENTRY_HEADER_BYTES + frame->length;
+
+    return KSRP_STATUS_OK;
+}
+
+_nonnull_
+bool KSRP_Batch_IsBatch(const KSRP_RawData_Frame* frame) {
+    return KSRP_RawData_Frame_GetTypeID(frame) == KSRP_BATCH_TYPE_ID;
+}
+
+_nonnull_
+bool KSRP_Batch_IsEmpty(const KSRP_RawData_Frame* batch) {
+    return batch->length <= KSRP_ID_BYTES;
+}
+
+_nonnull_
+void KSRP_BatchReader_Init(KSRP_BatchReader* reader, const KSRP_RawData_Frame* batch) {
+    reader->batch = batch;
+    reader->offset = KSRP_ID_BYTES;
+}
+
+_nonnull_
+KSRP_Status KSRP_BatchReader_Next(KSRP_BatchReader* reader, KSRP_RawData_Frame* frame) {
+    const KSRP_RawData_Frame* batch = reader->batch;
+
+    if (reader->offset >= batch->length) {
+        return KSRP_STATUS_ERROR;
+    }
+
+    uint8_t length = batch->data[reader->offset];
+    if (length < KSRP_ID_BYTES || reader->offset + KSRP_BATCH_ENTRY_HEADER_BYTES + length > batch->length) {
+        reader->offset = batch->length;
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    memcpy(frame->data, &batch->data[reader->offset + KSRP_BATCH_ENTRY_HEADER_BYTES], length);
+    frame->length = length;
+    reader->offset += KSRP_BATCH_ENTRY_HEADER_BYTES + length;
+
+    return KSRP_STATUS_OK;
+}
+
+_nonnull_
+void KSRP_Batcher_Init(KSRP_Batcher* batcher, KSRP_Status (*send_frame_callback)(KSRP_RawData_Frame* frame)) {
+    KSRP_Batch_Init(&batcher->batch);
+    batcher->send_frame_callback = send_frame_callback;
+}
+
+_nonnull_
+KSRP_Status KSRP_Batcher_Append(KSRP_Batcher* batcher, const KSRP_RawData_Frame* frame) {
+    if (KSRP_Batch_Append(&batcher->batch, frame) == KSRP_STATUS_OK) {
+        return KSRP_STATUS_OK;
+    }
+
+    if (KSRP_Batcher_Flush(batcher) != KSRP_STATUS_OK) {
+        return KSRP_STATUS_ERROR;
+    }
+
+    return KSRP_Batch_Append(&batcher->batch, frame);
+}
+
+_nonnull_
+KSRP_Status KSRP_Batcher_Flush(KSRP_Batcher* batcher) {
+    if (KSRP_Batch_IsEmpty(&batcher->batch)) {
+        return KSRP_STATUS_OK;
+    }
+
+    KSRP_Status status = batcher->send_frame_callback(&batcher->batch);
+    KSRP_Batch_Init(&batcher->batch);
+
+    return status;
+}
\ No newline at end of file
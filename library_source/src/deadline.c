@@ -0,0 +1,105 @@
+#include "ksrp/deadline.h"
+
+static void KSRP_DeadlineQueue_Unlink(KSRP_DeadlineQueue* queue, uint16_t index) {
+    KSRP_DeadlineNode* node = &queue->nodes[index];
+
+    if (node->prev != KSRP_DEADLINE_NONE) {
+        queue->nodes[node->prev].next = node->next;
+    } else {
+        queue->head = node->next;
+    }
+
+    if (node->next != KSRP_DEADLINE_NONE) {
+        queue->nodes[node->next].prev = node->prev;
+    } else {
+        queue->tail = node->prev;
+    }
+
+    node->armed = false;
+}
+
+_nonnull_
+void KSRP_DeadlineNodes_Init(KSRP_DeadlineNode* nodes, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) {
+        nodes[i].deadline_ms = 0;
+        nodes[i].prev = KSRP_DEADLINE_NONE;
+        nodes[i].next = KSRP_DEADLINE_NONE;
+        nodes[i].armed = false;
+    }
+}
+
+_nonnull_
+void KSRP_DeadlineQueue_Init(KSRP_DeadlineQueue* queue, KSRP_DeadlineNode* nodes, uint32_t timeout_ms) {
+    queue->nodes = nodes;
+    queue->timeout_ms = timeout_ms;
+    queue->head = KSRP_DEADLINE_NONE;
+    queue->tail = KSRP_DEADLINE_NONE;
+}
+
+_nonnull_
+void KSRP_DeadlineQueue_Schedule(KSRP_DeadlineQueue* queue, uint16_t index, uint32_t now_ms) {
+    KSRP_DeadlineNode* node = &queue->nodes[index];
+
+    if (node->armed) {
+        KSRP_DeadlineQueue_Unlink(queue, index);
+    }
+
+    node->deadline_ms = now_ms + queue->timeout_ms;
+    node->prev = queue->tail;
+    node->next = KSRP_DEADLINE_NONE;
+    node->armed = true;
+
+    if (queue->tail != KSRP_DEADLINE_NONE) {
+        queue->nodes[queue->tail].next = index;
+    } else {
+        queue->head = index;
+    }
+    queue->tail = index;
+}
+
+_nonnull_
+void KSRP_DeadlineQueue_Insert(KSRP_DeadlineQueue* queue, uint16_t index, uint32_t updated_ms) {
+    KSRP_DeadlineNode* node = &queue->nodes[index];
+
+    if (node->armed) {
+        KSRP_DeadlineQueue_Unlink(queue, index);
+    }
+
+    node->deadline_ms = updated_ms + queue->timeout_ms;
+
+    // Walk from the tail, restored nodes are mostly recent
+    uint16_t prev = queue->tail;
+    while (prev != KSRP_DEADLINE_NONE && (int32_t)(queue->nodes[prev].deadline_ms - node->deadline_ms) > 0) {
+        prev = queue->nodes[prev].prev;
+    }
+
+    node->prev = prev;
+    node->next = prev != KSRP_DEADLINE_NONE ? queue->nodes[prev].next : queue->head;
+    node->armed = true;
+
+    if (prev != KSRP_DEADLINE_NONE) {
+        queue->nodes[prev].next = index;
+    } else {
+        queue->head = index;
+    }
+
+    if (node->next != KSRP_DEADLINE_NONE) {
+        queue->nodes[node->next].prev = index;
+    } else {
+        queue->tail = index;
+    }
+}
+
+_nonnull_
+uint16_t KSRP_DeadlineQueue_PopExpired(KSRP_DeadlineQueue* queue, uint32_t now_ms) {
+    uint16_t index = queue->head;
+
+    // Difference is compared as signed value, so expiration works across wrap around of the millisecond clock
+    if (index == KSRP_DEADLINE_NONE || (int32_t)(now_ms - queue->nodes[index].deadline_ms) < 0) {
+        return KSRP_DEADLINE_NONE;
+    }
+
+    KSRP_DeadlineQueue_Unlink(queue, index);
+
+    return index;
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#include "ksrp/delta.h"
+
+_nonnull_
+void KSRP_Delta_Init(KSRP_RawData_Frame* delta, KSRP_TypeID type_id) {
+    delta->data[0] = KSRP_DELTA_SUBSYSTEM_ID;
+    delta->data[1] = KSRP_DELTA_FRAME_ID;
+    delta->data[2] = (uint8_t)KSRP_GET_SUBSYSTEM_ID_FROM_TYPE_ID(type_id);
+    delta->data[3] = (uint8_t)KSRP_GET_TYPE_ID_FROM_TYPE_ID(type_id);
+    delta->length = KSRP_DELTA_HEADER_BYTES;
+}
+
+_nonnull_
+bool KSRP_Delta_IsDelta(const KSRP_RawData_Frame* frame) {
+    return frame->length >= KSRP_DELTA_HEADER_BYTES && KSRP_RawData_Frame_GetTypeID(frame) == KSRP_DELTA_TYPE_ID;
+}
+
+_nonnull_
+KSRP_TypeID KSRP_Delta_GetTypeID(const KSRP_RawData_Frame* delta) {
+    if (!KSRP_Delta_IsDelta(delta)) {
+        return KSRP_ILLEGAL_TYPE_ID;
+    }
+
+    return KSRP_MAKE_TYPE_ID(delta->data[2], delta->data[3]);
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include <string.h>
+
+#include "ksrp/descriptor.h"
+
+_nonnull_
+KSRP_Status KSRP_FrameDescriptor_UpdateField(const KSRP_FrameDescriptor* descriptor, void* frame, uint32_t field_id,
+                                             const void* value, size_t value_size, bool* change) {
+    if (field_id >= descriptor->fields_count || descriptor->fields[field_id].flags & KSRP_FIELD_FLAG_DEVICE_ID) {
+        return KSRP_STATUS_INVALID_FIELD_TYPE;
+    }
+
+    const KSRP_FieldDescriptor* field = &descriptor->fields[field_id];
+    if (value_size != field->size) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    // Fixed size copies are inlined by compiler, fields are compared as integers of the same width
+    uint8_t* destination = (uint8_t*)frame + field->offset;
+    switch (field->size) {
+        case sizeof(uint8_t): {
+            uint8_t previous = *destination;
+            *destination = *(const uint8_t*)value;
+            *change = previous != *destination;
+            break;
+        }
+        case sizeof(uint16_t): {
+            uint16_t previous, current;
+            memcpy(&previous, destination, sizeof(current));
+            memcpy(&current, value, sizeof(current));
+            memcpy(destination, &current, sizeof(current));
+            *change = previous != current;
+            break;
+        }
+        case sizeof(uint32_t): {
+            uint32_t previous, current;
+            memcpy(&previous, destination, sizeof(current));
+            memcpy(&current, value, sizeof(current));
+            memcpy(destination, &current, sizeof(current));
+            *change = previous != current;
+            break;
+        }
+        case sizeof(uint64_t): {
+            uint64_t previous, current;
+            memcpy(&previous, destination, sizeof(current));
+            memcpy(&current, value, sizeof(current));
+            memcpy(destination, &current, sizeof(current));
+            *change = previous != current;
+            break;
+        }
+        default:
+            *change = memcmp(destination, value, value_size) != 0;
+            memcpy(destination, value, value_size);
+            break;
+    }
+
+    return KSRP_STATUS_OK;
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "ksrp/host/fleet.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define KSRP_FLEET_ROUND_UP(value, multiple) (((value) + (multiple) - 1) / (multiple) * (multiple))
+
+typedef struct {
+    KSRP_FleetShardWork work;
+    void* context;
+    uint32_t first_vehicle;
+    uint32_t end_vehicle;
+    uint64_t counters[KSRP_FLEET_COUNTERS];
+    pthread_t thread;
+    bool started;
+} KSRP_FleetShard;
+
+_nonnull_
+size_t KSRP_Fleet_Reserve(size_t* arena_size, size_t bytes) {
+    size_t offset = KSRP_FLEET_ROUND_UP(*arena_size, KSRP_FLEET_CACHE_LINE);
+    *arena_size = offset + bytes;
+
+    return offset;
+}
+
+void* KSRP_Fleet_AllocateArena(size_t arena_size) {
+    // aligned_alloc requires size to be a multiple of the alignment
+    size_t size = KSRP_FLEET_ROUND_UP(arena_size > 0 ? arena_size : 1, KSRP_FLEET_CACHE_LINE);
+    void* arena = aligned_alloc(KSRP_FLEET_CACHE_LINE, size);
+    if (arena != NULL) {
+        memset(arena, 0, size);
+    }
+
+    return arena;
+}
+
+static void* KSRP_Fleet_ShardThread(void* argument) {
+    KSRP_FleetShard* shard = (KSRP_FleetShard*)argument;
+    shard->work(shard->first_vehicle, shard->end_vehicle, shard->context, shard->counters);
+
+    return NULL;
+}
+
+uint32_t KSRP_Fleet_ResolveThreads(uint32_t threads) {
+    if (threads == 0) {
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = processors > 0 ? (uint32_t)processors : 1;
+    }
+
+    return threads;
+}
+
+uint32_t KSRP_Fleet_ShardVehicles(uint32_t vehicles, uint32_t threads) {
+    threads = KSRP_Fleet_ResolveThreads(threads);
+
+    return KSRP_FLEET_ROUND_UP((vehicles + threads - 1) / threads, KSRP_FLEET_SHARD_VEHICLES);
+}
+
+void KSRP_Fleet_RunSharded(uint32_t vehicles, uint32_t threads, KSRP_FleetShardWork work, void* context,
+                           uint64_t counters[KSRP_FLEET_COUNTERS]) {
+    memset(counters, 0, KSRP_FLEET_COUNTERS * sizeof(uint64_t));
+
+    uint32_t shard_vehicles = KSRP_Fleet_ShardVehicles(vehicles, threads);
+    uint32_t shards_count = shard_vehicles > 0 ? (vehicles + shard_vehicles - 1) / shard_vehicles : 0;
+
+    KSRP_FleetShard* shards = shards_count > 1 ? calloc(shards_count, sizeof(KSRP_FleetShard)) : NULL;
+    if (shards == NULL) {
+        // Single shard or no memory for more, calling thread works on all vehicles
+        uint64_t shard_counters[KSRP_FLEET_COUNTERS] = {0};
+        work(0, vehicles, context, shard_counters);
+        memcpy(counters, shard_counters, sizeof(shard_counters));
+        return;
+    }
+
+    for (uint32_t i = 0; i < shards_count; i++) {
+        shards[i].work = work;
+        shards[i].context = context;
+        shards[i].first_vehicle = i * shard_vehicles;
+        shards[i].end_vehicle = i + 1 < shards_count ? (i + 1) * shard_vehicles : vehicles;
+    }
+
+    for (uint32_t i = 1; i < shards_count; i++) {
+        shards[i].started = pthread_create(&shards[i].thread, NULL, KSRP_Fleet_ShardThread, &shards[i]) == 0;
+    }
+
+    for (uint32_t i = 0; i < shards_count; i++) {
+        if (i == 0 || !shards[i].started) {
+            KSRP_Fleet_ShardThread(&shards[i]);
+        }
+    }
+
+    for (uint32_t i = 0; i < shards_count; i++) {
+        if (shards[i].started) {
+            pthread_join(shards[i].thread, NULL);
+        }
+        for (uint32_t j = 0; j < KSRP_FLEET_COUNTERS; j++) {
+            counters[j] += shards[i].counters[j];
+        }
+    }
+
+    free(shards);
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include "ksrp/ring.h"
+
+_nonnull_
+KSRP_Status KSRP_Ring_Init(KSRP_Ring* ring, KSRP_RawData_Frame* frames, uint32_t capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    ring->frames = frames;
+    ring->capacity = capacity;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->dropped, 0);
+
+    return KSRP_STATUS_OK;
+}
+
+_nonnull_
+KSRP_Status KSRP_Ring_Push(KSRP_Ring* ring, const KSRP_RawData_Frame* frame) {
+    if (frame->length > KSRP_RAW_DATA_FRAME_BUFFER_SIZE) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    if (head - tail >= ring->capacity) {
+        // Only producer writes the counter, so no read-modify-write is needed
+        atomic_store_explicit(&ring->dropped, atomic_load_explicit(&ring->dropped, memory_order_relaxed) + 1,
+                              memory_order_relaxed);
+        return KSRP_STATUS_ERROR;
+    }
+
+    KSRP_RawData_Frame* slot = &ring->frames[head & (ring->capacity - 1)];
+    memcpy(slot->data, frame->data, frame->length);
+    slot->length = frame->length;
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    return KSRP_STATUS_OK;
+}
+
+_nonnull_
+KSRP_Status KSRP_Ring_Pop(KSRP_Ring* ring, KSRP_RawData_Frame* frame) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    if (head == tail) {
+        return KSRP_STATUS_ERROR;
+    }
+
+    const KSRP_RawData_Frame* slot = &ring->frames[tail & (ring->capacity - 1)];
+    memcpy(frame->data, slot->data, slot->length);
+    frame->length = slot->length;
+
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+
+    return KSRP_STATUS_OK;
+}
+
+_nonnull_
+uint32_t KSRP_Ring_Count(KSRP_Ring* ring) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    return head - tail;
+}
+
+_nonnull_
+uint32_t KSRP_Ring_GetDropped(KSRP_Ring* ring) {
+    return atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+}
\ No newline at end of file
@@ -0,0 +1,191 @@
+#include "ksrp/segments.h"
+
+// Number of segments is encoded in a single byte
+_Static_assert(KSRP_SEGMENTS_MAX_COUNT <= 0xFF, "KSRP_SEGMENTED_MAX_SIZE needs more than 255 segments");
+
+_nonnull_
+KSRP_Status KSRP_Segments_Send(KSRP_TypeID type_id, uint8_t device_id, uint8_t sequence, const uint8_t* payload,
+                               uint16_t length, KSRP_Status (*send_frame_callback)(KSRP_RawData_Frame* frame)) {
+    if (length == 0 || KSRP_SEGMENTS_COUNT(length) > 0xFF) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    uint8_t count = (uint8_t)KSRP_SEGMENTS_COUNT(length);
+    KSRP_RawData_Frame segment;
+
+    for (uint8_t index = 0; index < count; index++) {
+        uint8_t* chunk = KSRP_Segment_Init(&segment, type_id, device_id, sequence, index, length);
+        memcpy(chunk, &payload[(uint16_t)index * KSRP_SEGMENT_PAYLOAD_BYTES],
+               segment.length - KSRP_SEGMENT_HEADER_BYTES);
+
+        if (send_frame_callback(&segment) != KSRP_STATUS_OK) {
+            return KSRP_STATUS_ERROR;
+        }
+    }
+
+    return KSRP_STATUS_OK;
+}
+
+_nonnull_
+uint8_t* KSRP_Segment_Init(KSRP_RawData_Frame* segment, KSRP_TypeID type_id, uint8_t device_id, uint8_t sequence,
+                           uint8_t index, uint16_t length) {
+    uint16_t offset = (uint16_t)index * KSRP_SEGMENT_PAYLOAD_BYTES;
+    uint16_t chunk = length - offset < KSRP_SEGMENT_PAYLOAD_BYTES ? length - offset : KSRP_SEGMENT_PAYLOAD_BYTES;
+
+    segment->data[0] = KSRP_SEGMENT_SUBSYSTEM_ID;
+    segment->data[1] = KSRP_SEGMENT_FRAME_ID;
+    segment->data[2] = (uint8_t)KSRP_GET_SUBSYSTEM_ID_FROM_TYPE_ID(type_id);
+    segment->data[3] = (uint8_t)KSRP_GET_TYPE_ID_FROM_TYPE_ID(type_id);
+    segment->data[4] = device_id;
+    segment->data[5] = sequence;
+    segment->data[6] = index;
+    segment->data[7] = (uint8_t)KSRP_SEGMENTS_COUNT(length);
+    segment->length = (uint8_t)(KSRP_SEGMENT_HEADER_BYTES + chunk);
+
+    return &segment->data[KSRP_SEGMENT_HEADER_BYTES];
+}
+
+_nonnull_
+bool KSRP_Segment_IsSegment(const KSRP_RawData_Frame* frame) {
+    return frame->length >= KSRP_ID_BYTES && KSRP_RawData_Frame_GetTypeID(frame) == KSRP_SEGMENT_TYPE_ID;
+}
+
+_nonnull_
+void KSRP_Reassembler_Init(KSRP_Reassembler* reassembler, KSRP_ReassemblySlot* slots, uint32_t slots_count,
+                           uint32_t timeout_ms) {
+    reassembler->slots = slots;
+    reassembler->slots_count = slots_count;
+    reassembler->timeout_ms = timeout_ms;
+    reassembler->dropped = 0;
+
+    for (uint32_t i = 0; i < slots_count; i++) {
+        slots[i].type_id = KSRP_ILLEGAL_TYPE_ID;
+    }
+}
+
+// Completed slots keep their type ID, device ID and sequence, so late duplicates of their segments are ignored
+static bool KSRP_ReassemblySlot_IsBusy(const KSRP_ReassemblySlot* slot) {
+    return slot->type_id != KSRP_ILLEGAL_TYPE_ID && slot->received_count < slot->count;
+}
+
+static KSRP_ReassemblySlot* KSRP_Reassembler_FindSlot(KSRP_Reassembler* reassembler, KSRP_TypeID type_id,
+                                                      uint8_t device_id) {
+    for (uint32_t i = 0; i < reassembler->slots_count; i++) {
+        KSRP_ReassemblySlot* slot = &reassembler->slots[i];
+        if (slot->type_id == type_id && slot->device_id == device_id) {
+            return slot;
+        }
+    }
+
+    return NULL;
+}
+
+static KSRP_ReassemblySlot* KSRP_Reassembler_FindFreeSlot(KSRP_Reassembler* reassembler) {
+    for (uint32_t i = 0; i < reassembler->slots_count; i++) {
+        if (!KSRP_ReassemblySlot_IsBusy(&reassembler->slots[i])) {
+            return &reassembler->slots[i];
+        }
+    }
+
+    return NULL;
+}
+
+_nonnull_
+KSRP_Status KSRP_Reassembler_Push(KSRP_Reassembler* reassembler, const KSRP_RawData_Frame* segment, uint32_t now_ms,
+                                  KSRP_SegmentedPayload* payload) {
+    payload->data = NULL;
+
+    if (!KSRP_Segment_IsSegment(segment)) {
+        return KSRP_STATUS_INVALID_FRAME_TYPE;
+    }
+
+    if (segment->length <= KSRP_SEGMENT_HEADER_BYTES) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    KSRP_TypeID type_id = KSRP_MAKE_TYPE_ID(segment->data[2], segment->data[3]);
+    uint8_t device_id = segment->data[4];
+    uint8_t sequence = segment->data[5];
+    uint8_t index = segment->data[6];
+    uint8_t count = segment->data[7];
+    uint16_t offset = (uint16_t)index * KSRP_SEGMENT_PAYLOAD_BYTES;
+    uint8_t chunk = segment->length - KSRP_SEGMENT_HEADER_BYTES;
+
+    // Only the last segment may be shorter, so every segment has fixed place in the payload
+    if (type_id == KSRP_ILLEGAL_TYPE_ID || index >= count || count > KSRP_SEGMENTS_MAX_COUNT ||
+        (index + 1 < count && chunk != KSRP_SEGMENT_PAYLOAD_BYTES) || offset + chunk > KSRP_SEGMENTED_MAX_SIZE) {
+        return KSRP_STATUS_INVALID_DATA_SIZE;
+    }
+
+    KSRP_ReassemblySlot* slot = KSRP_Reassembler_FindSlot(reassembler, type_id, device_id);
+    if (slot != NULL && (slot->sequence != sequence || slot->count != count)) {
+        if (KSRP_ReassemblySlot_IsBusy(slot)) {
+            // Rest of the previous frame was lost
+            reassembler->dropped++;
+        }
+        slot->type_id = KSRP_ILLEGAL_TYPE_ID;
+    }
+
+    if (slot == NULL || slot->type_id == KSRP_ILLEGAL_TYPE_ID) {
+        slot = KSRP_Reassembler_FindFreeSlot(reassembler);
+        if (slot == NULL && KSRP_Reassembler_Evict(reassembler, now_ms) > 0) {
+            slot = KSRP_Reassembler_FindFreeSlot(reassembler);
+        }
+
+        if (slot == NULL) {
+            return KSRP_STATUS_ERROR;
+        }
+
+        memset(slot->received, 0, sizeof(slot->received));
+        slot->started_ms = now_ms;
+        slot->length = 0;
+        slot->type_id = type_id;
+        slot->device_id = device_id;
+        slot->sequence = sequence;
+        slot->count = count;
+        slot->received_count = 0;
+    }
+
+    if (slot->received[index / 8] & (1 << (index % 8))) {
+        return KSRP_STATUS_OK;
+    }
+
+    memcpy(&slot->payload[offset], &segment->data[KSRP_SEGMENT_HEADER_BYTES], chunk);
+    slot->received[index / 8] |= (uint8_t)(1 << (index % 8));
+    slot->received_count++;
+
+    if (index + 1 == count) {
+        slot->length = offset + chunk;
+    }
+
+    if (slot->received_count == count) {
+        payload->type_id = type_id;
+        payload->device_id = device_id;
+        payload->length = slot->length;
+        payload->data = slot->payload;
+    }
+
+    return KSRP_STATUS_OK;
+}
+
+_nonnull_
+uint32_t KSRP_Reassembler_Evict(KSRP_Reassembler* reassembler, uint32_t now_ms) {
+    uint32_t evicted = 0;
+
+    for (uint32_t i = 0; i < reassembler->slots_count; i++) {
+        KSRP_ReassemblySlot* slot = &reassembler->slots[i];
+        if (KSRP_ReassemblySlot_IsBusy(slot) && now_ms - slot->started_ms >= reassembler->timeout_ms) {
+            slot->type_id = KSRP_ILLEGAL_TYPE_ID;
+            evicted++;
+        }
+    }
+
+    reassembler->dropped += evicted;
+
+    return evicted;
+}
+
+_nonnull_
+uint32_t KSRP_Reassembler_GetDropped(const KSRP_Reassembler* reassembler) {
+    return reassembler->dropped;
+}
\ No newline at end of file
@@ -1,65 +1,132 @@
 import os
+import json
+import hashlib
 import argparse
+import concurrent.futures
 
 from pathlib import Path
 from jinja2 import Environment, FileSystemLoader
 from yaml_parser import Parser, ALLOWED_TYPES
-from distutils.dir_util import copy_tree
 
+GENERATOR_SOURCES = [os.path.abspath(__file__),
+                     os.path.join(os.path.dirname(os.path.abspath(__file__)), 'yaml_parser.py')]
+LIBRARY_SOURCE = 'library_source'
+# Hashes of inputs and list of files written by previous run, kept in the output directory
+MANIFEST_FILE = '.ksrp_manifest.json'
+
+SPECIFIC_FILES = [
+    ('protocol_file_template.h.jinja2', 'include/ksrp/protocols/subsystems/{protocol_name}_protocol.h', {
+        'clibraries': ["stdint.h", "stdbool.h"],
+        'libraries': ["ksrp/frames.h", "ksrp/common.h", "ksrp/delta.h", "ksrp/segments.h", "ksrp/descriptor.h",
+                      "ksrp/columns.h", "ksrp/health_batch.h",
+                      "ksrp/protocols/protocol_common.h"]}),
+    ('protocol_file_template.c.jinja2', 'src/ksrp/protocols/subsystems/{protocol_name}_protocol.c', {
+        'clibraries': ["stddef.h", "math.h"],
+        'libraries': ["ksrp/endianness.h", "ksrp/protocols/subsystems/{protocol_name}_protocol.h"]}),
+    ('instance_file_template.h.jinja2', 'include/ksrp/instances/{protocol_name}_instance.h', {
+        'clibraries': ["stdint.h", "stdbool.h"],
+        'libraries': ["ksrp/frames.h", "ksrp/common.h", "ksrp/ring.h", "ksrp/deadline.h", "ksrp/snapshot.h",
+                      "ksrp/protocols/subsystems/{protocol_name}_protocol.h"]}),
+    ('instance_file_template.c.jinja2', 'src/ksrp/instances/{protocol_name}_instance.c', {
+        'libraries': ["ksrp/batch.h", "ksrp/endianness.h", "ksrp/instances/{protocol_name}_instance.h"]}),
+    ('cpp_protocol_file_template.hpp.jinja2', 'include/ksrp/cpp/subsystems/{protocol_name}.hpp', {
+        'clibraries': ["cstddef", "cstdint", "string_view"],
+        'libraries': ["ksrp/cpp/ksrp.hpp", "ksrp/protocols/subsystems/{protocol_name}_protocol.h"]})
+]
+
+# Jinja environment of the worker process, created once instead of per rendered protocol
+jinja_env = None
 
-def generate_specific_files(protocols):
-    SPECIFIC_FILES = [
-        ('protocol_file_template.h.jinja2', 'include/ksrp/protocols/subsystems/{protocol_name}_protocol.h', {
-            'clibraries': ["stdint.h", "stdbool.h"],
-            'libraries': ["ksrp/frames.h", "ksrp/common.h", "ksrp/protocols/protocol_common.h"],
-            'protocols': protocols.values()}),
-        ('protocol_file_template.c.jinja2', 'src/ksrp/protocols/subsystems/{protocol_name}_protocol.c', {
-            'libraries': ["ksrp/protocols/subsystems/{protocol_name}_protocol.h"],
-            'protocols': protocols.values()}),
-        ('instance_file_template.h.jinja2', 'include/ksrp/instances/{protocol_name}_instance.h', {
-            'clibraries': ["stdint.h", "stdbool.h"],
-            'libraries': ["ksrp/frames.h", "ksrp/common.h",
-                          "ksrp/protocols/subsystems/{protocol_name}_protocol.h"],
-            'protocols': protocols.values()}),
-        ('instance_file_template.c.jinja2', 'src/ksrp/instances/{protocol_name}_instance.c', {
-            'libraries': ["ksrp/instances/{protocol_name}_instance.h"],
-            'protocols': protocols.values()})
-    ]
 
+def init_renderer(templates):
+    global jinja_env
+    jinja_env = Environment(loader=FileSystemLoader(templates))
+
+
+def specific_files(protocol_name):
+    return [output_file.format(protocol_name=protocol_name) for _, output_file, _ in SPECIFIC_FILES]
+
+
+def generate_specific_files(protocol_name, protocol, layout):
+    """Render files of a single protocol, they don't depend on other protocols"""
     devices_protocols_c_codes = {}
-    jinja_env = Environment(loader=FileSystemLoader(args.templates))
+    protocol_hash = definition_hash(protocol)
 
     for template_file, output_file, context in SPECIFIC_FILES:
         template = jinja_env.get_template(template_file)
-        for protocol_name, protocol in protocols.items():
-            ctx = context.copy()
+        ctx = context.copy()
 
-            ctx['libraries'] = [lib.format(protocol_name=protocol_name) for lib in context['libraries']]
-            c_code = template.render(protocol=protocol, **ctx)
-            devices_protocols_c_codes[output_file.format(protocol_name=protocol_name)] = c_code
+        ctx['libraries'] = [lib.format(protocol_name=protocol_name) for lib in context['libraries']]
+        ctx['layout'] = layout
+        ctx['definition_hash'] = protocol_hash
+        c_code = template.render(protocol=protocol, **ctx)
+        devices_protocols_c_codes[output_file.format(protocol_name=protocol_name)] = c_code
 
     return devices_protocols_c_codes
 
 
-def generate_common_files(protocols):
-    COMMON_FILES = [
+def definition_hash(protocol):
+    """64-bit hash of a single protocol definition, independent of formatting of its yaml file"""
+    definition = json.dumps(protocol.definition, sort_keys=True)
+    return int.from_bytes(hashlib.sha256(definition.encode()).digest()[:8], 'little')
+
+
+def protocols_hash(protocols):
+    """64-bit hash of all protocol definitions, independent of formatting and order of yaml files"""
+    definitions = json.dumps([protocols[name].definition for name in sorted(protocols)], sort_keys=True)
+    return int.from_bytes(hashlib.sha256(definitions.encode()).digest()[:8], 'little')
+
+
+def common_files(protocols):
+    return [
         ('common_protocol_file_template.h.jinja2', 'include/ksrp/protocols/protocol_common.h', {
             'clibraries': ["stdint.h", "stdbool.h"],
             'libraries': ["ksrp/frames.h", "ksrp/common.h"],
-            'protocols': protocols.values()}),
+            'protocols': protocols.values(),
+            'segmented_max_size': max((frame.wire_size for protocol in protocols.values() for frame in protocol.frames
+                                       if frame.is_segmented), default=0)}),
+        ('protocol_hash_file_template.h.jinja2', 'include/ksrp/protocols/protocol_hash.h', {
+            'protocol_hash': protocols_hash(protocols)}),
         ('util_protocol_file_template.h.jinja2', 'include/ksrp/protocols/protocol_utils.h', {
             'clibraries': ["stdint.h", "stdbool.h"],
-            'libraries': ["ksrp/frames.h", "ksrp/common.h"] + [f"ksrp/protocols/subsystems/{protocol_name}_protocol.h" for protocol_name in protocols.keys()],
+            'libraries': ["ksrp/frames.h", "ksrp/common.h", "ksrp/batch.h", "ksrp/delta.h", "ksrp/segments.h",
+                          "ksrp/transport.h"]
+                         + [f"ksrp/protocols/subsystems/{protocol_name}_protocol.h" for protocol_name in protocols.keys()]
+                         + [f"ksrp/instances/{protocol_name}_instance.h" for protocol_name in protocols.keys()],
             'protocols': protocols.values()}),
         ('util_protocol_file_template.c.jinja2', 'src/ksrp/protocols/protocol_utils.c', {
             'libraries': ["ksrp/protocols/protocol_utils.h"],
-            'protocols': protocols.values()})
+            'protocols': protocols.values()}),
+        ('registry_protocol_file_template.h.jinja2', 'include/ksrp/protocols/protocol_registry.h', {
+            'clibraries': ["stdint.h", "stdbool.h", "stddef.h"],
+            'libraries': ["ksrp/frames.h", "ksrp/common.h", "ksrp/snapshot.h", "ksrp/protocols/protocol_common.h"]
+                         + [f"ksrp/instances/{protocol_name}_instance.h" for protocol_name in protocols.keys()],
+            'protocols': protocols.values()}),
+        ('registry_protocol_file_template.c.jinja2', 'src/ksrp/protocols/protocol_registry.c', {
+            'clibraries': ["stddef.h"],
+            'libraries': ["ksrp/batch.h", "ksrp/delta.h", "ksrp/protocols/protocol_registry.h"],
+            'protocols': protocols.values()}),
+        ('fleet_store_file_template.h.jinja2', 'include/ksrp/host/fleet_store.h', {
+            'clibraries': ["stdint.h", "stdbool.h", "stddef.h"],
+            'libraries': ["ksrp/frames.h", "ksrp/common.h", "ksrp/batch.h", "ksrp/delta.h", "ksrp/segments.h",
+                          "ksrp/host/fleet.h", "ksrp/protocols/protocol_common.h"]
+                         + [f"ksrp/protocols/subsystems/{protocol_name}_protocol.h" for protocol_name in protocols.keys()],
+            'protocols': protocols.values()}),
+        ('fleet_store_file_template.c.jinja2', 'src/host/fleet_store.c', {
+            'clibraries': ["stdlib.h"],
+            'libraries': ["ksrp/host/fleet_store.h"],
+            'protocols': protocols.values()}),
+        ('cpp_common_file_template.hpp.jinja2', 'include/ksrp/cpp/protocols.hpp', {
+            'libraries': ["ksrp/cpp/ksrp.hpp"] + [f"ksrp/cpp/subsystems/{protocol_name}.hpp"
+                                                 for protocol_name in protocols.keys()],
+            'frames': [(protocol, frame) for protocol in protocols.values() for frame in protocol.frames]})
     ]
 
+
+def generate_common_files(protocols):
     devices_protocols_c_codes = {}
-    jinja_env = Environment(loader=FileSystemLoader(args.templates))
 
-    for template_file, output_file, context in COMMON_FILES:
+    for template_file, output_file, context in common_files(protocols):
         template = jinja_env.get_template(template_file)
         c_code = template.render(**context)
         devices_protocols_c_codes[output_file] = c_code
@@ -67,13 +134,129 @@ def generate_common_files(protocols):
     return devices_protocols_c_codes
 
 
+def list_files(path):
+    """Sorted paths of all files in the directory tree"""
+    return sorted(os.path.join(root, file) for root, _, files in os.walk(path) for file in files)
+
+
+def hash_files(paths):
+    digest = hashlib.sha256()
+    for path in paths:
+        digest.update(path.encode())
+        with open(path, 'rb') as f:
+            digest.update(f.read())
+    return digest.hexdigest()
+
+
+def inputs_hashes(protocols, templates, layout):
+    """Hash of inputs of every protocol and of common files, protocol files depend only on their own definition"""
+    shared = hash_files(list_files(templates) + GENERATOR_SOURCES) + layout
+
+    def hash_of(definition):
+        return hashlib.sha256((shared + json.dumps(definition, sort_keys=True)).encode()).hexdigest()
+
+    hashes = {protocol_name: hash_of(protocol.definition) for protocol_name, protocol in protocols.items()}
+    hashes[''] = hash_of([protocols[name].definition for name in sorted(protocols)])
+    return hashes
+
+
+def load_manifest(path):
+    try:
+        with open(os.path.join(path, MANIFEST_FILE), 'r') as f:
+            return json.load(f)
+    except (OSError, ValueError):
+        return {'inputs': {}, 'outputs': {}, 'files': []}
+
+
+def save_manifest(path, inputs, outputs, files):
+    manifest = {'inputs': inputs, 'outputs': outputs, 'files': sorted(files)}
+    write_if_changed(Path(path, MANIFEST_FILE), json.dumps(manifest, indent=2, sort_keys=True).encode())
+
+
+def content_hash(content):
+    return hashlib.sha256(content).hexdigest()
+
+
+def is_intact(path, expected_hash):
+    """Check that generated file exists and wasn't modified since it was written"""
+    try:
+        with open(path, 'rb') as f:
+            return content_hash(f.read()) == expected_hash
+    except OSError:
+        return False
+
+
+def write_if_changed(final_path, content):
+    """Write the file only if its content differs, so unchanged files keep their modification time"""
+    try:
+        with open(final_path, 'rb') as f:
+            if f.read() == content:
+                return False
+    except OSError:
+        pass
+
+    final_path.parent.mkdir(parents=True, exist_ok=True)
+    with open(final_path, 'wb') as f:
+        f.write(content)
+    return True
+
+
 def save_c_codes(c_codes, path):
+    """Save rendered files, returns hashes of their contents"""
+    hashes = {}
     for file_path, code in c_codes.items():
         final_path = Path(str(os.path.join(path, file_path)))
-        final_path.parent.mkdir(parents=True, exist_ok=True)
+        content = str(code).encode()
+        write_if_changed(final_path, content)
+        hashes[file_path] = content_hash(content)
+    return hashes
+
+
+def library_files(source):
+    """Paths of library sources relative to the library directory, same as in the output"""
+    return [Path(os.path.relpath(file, source)).as_posix() for file in list_files(source)]
+
 
-        with open(final_path, 'w') as f:
-            f.write(str(code))
+def copy_library(source, path):
+    """Copy library sources into the output, returns paths of copied files relative to the output"""
+    files = library_files(source)
+    for file in files:
+        with open(os.path.join(source, file), 'rb') as f:
+            write_if_changed(Path(path, file), f.read())
+    return files
+
+
+def render_protocols(protocols, outdated, templates, layout, jobs):
+    """Render files of outdated protocols and common files if set, in parallel when there is more than one job"""
+    tasks = [(generate_specific_files, (protocol_name, protocols[protocol_name], layout))
+             for protocol_name in outdated if protocol_name]
+    if '' in outdated:
+        tasks.append((generate_common_files, (protocols,)))
+
+    c_codes = {}
+    if jobs <= 1 or len(tasks) <= 1:
+        init_renderer(templates)
+        for function, arguments in tasks:
+            c_codes.update(function(*arguments))
+        return c_codes
+
+    with concurrent.futures.ProcessPoolExecutor(max_workers=min(jobs, len(tasks)), initializer=init_renderer,
+                                                initargs=(templates,)) as executor:
+        futures = [executor.submit(function, *arguments) for function, arguments in tasks]
+        for future in futures:
+            c_codes.update(future.result())
+    return c_codes
+
+
+def save_depfile(depfile, outputs, inputs):
+    """Make syntax depfile, so build system re-runs the compiler only when any of its inputs changes"""
+    def escape(path):
+        return os.path.abspath(path).replace('\\', '/').replace(' ', '\\ ').replace('#', '\\#').replace('$', '$$')
+
+    Path(depfile).parent.mkdir(parents=True, exist_ok=True)
+    with open(depfile, 'w') as f:
+        f.write(' \\\n '.join(escape(output) for output in outputs) + ': \\\n ')
+        f.write(' \\\n '.join(escape(dependency) for dependency in inputs) + '\n')
 
 
 if __name__ == '__main__':
@@ -85,17 +268,65 @@ if __name__ == '__main__':
     argument_parser.add_argument('-o', '--output', type=str, help='Path to the output directory')
     argument_parser.add_argument('-t', '--templates', type=str, help='Path to the templates directory', default='templates',
                                  required=False)
+    argument_parser.add_argument('-l', '--layout', type=str, choices=['switch', 'tables'], default='switch',
+                                 help='Layout of generated instance code: switch with code per field or tables of field '
+                                      'descriptors walked by shared routine (smaller code)', required=False)
+    argument_parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count() or 1,
+                                 help='Number of protocols rendered in parallel, defaults to number of processors',
+                                 required=False)
+    argument_parser.add_argument('-d', '--depfile', type=str, required=False,
+                                 help='Path of depfile listing generated files and all inputs they depend on')
+    argument_parser.add_argument('--list-outputs', action='store_true', required=False,
+                                 help='Print JSON with paths of library, common and subsystem files relative to the '
+                                      'output directory without generating them')
 
     args = argument_parser.parse_args()
 
     parser = Parser()
 
-    for file in os.listdir(args.source):
-        parser.load_from_yaml(os.path.join(args.source, file))
+    source_files = sorted(os.path.join(args.source, file) for file in os.listdir(args.source))
+    for file in source_files:
+        parser.load_from_yaml(file)
 
     protocols = parser.get_protocols()
 
-    copy_tree('library_source', args.output)
+    # Field descriptors store offsets in a single byte, larger segmented frames need switch layout
+    if args.layout == 'tables':
+        for protocol in protocols.values():
+            for frame in protocol.frames:
+                if frame.fields and frame.fields[-1].offset > 0xFF:
+                    raise ValueError(f"Frame {frame.name} of {protocol.subsystem} is too large for tables layout")
+
+    generated = {'': [output_file for _, output_file, _ in common_files(protocols)]}
+    generated.update({protocol_name: specific_files(protocol_name) for protocol_name in protocols})
+
+    if args.list_outputs:
+        print(json.dumps({'library': library_files(LIBRARY_SOURCE), 'common': generated[''],
+                          'subsystems': {name: files for name, files in generated.items() if name}}))
+        exit(0)
+
+    manifest = load_manifest(args.output)
+    inputs = inputs_hashes(protocols, args.templates, args.layout)
+
+    # Protocol is rendered again only when its inputs changed or some of its files is missing or modified
+    outdated = [name for name, files in generated.items()
+                if manifest['inputs'].get(name) != inputs[name]
+                or not all(is_intact(os.path.join(args.output, file), manifest['outputs'].get(file)) for file in files)]
+
+    files = copy_library(LIBRARY_SOURCE, args.output) + [file for files in generated.values() for file in files]
+    outputs = {file: output_hash for file, output_hash in manifest['outputs'].items() if file in files}
+    c_codes = render_protocols(protocols, outdated, args.templates, args.layout, args.jobs)
+    outputs.update(save_c_codes(c_codes, args.output))
+
+    # Files of previous run which are no longer generated, e.g. of removed protocols
+    for file in set(manifest['files']) - set(files):
+        if os.path.isfile(os.path.join(args.output, file)):
+            os.remove(os.path.join(args.output, file))
+
+    save_manifest(args.output, inputs, outputs, files)
 
-    save_c_codes(generate_specific_files(protocols), args.output)
-    save_c_codes(generate_common_files(protocols), args.output)
+    # Source directory changes when protocol file is added or removed
+    if args.depfile:
+        save_depfile(args.depfile, [os.path.join(args.output, file) for file in files],
+                     [args.source] + source_files + list_files(args.templates) + GENERATOR_SOURCES
+                     + list_files(LIBRARY_SOURCE))
@@ -0,0 +1,25 @@
+#ifndef KALMAN_PROTOCOL_STATUS_REPORT_TESTS_KSRP_TEST_H_
+#define KALMAN_PROTOCOL_STATUS_REPORT_TESTS_KSRP_TEST_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Checks stay enabled in release builds, unlike assert, and the test exits on the first failure
+#define CHECK(condition)                                                                     \
+    do {                                                                                     \
+        if (!(condition)) {                                                                  \
+            fprintf(stderr, "%s:%d: %s: check failed: %s\n", __FILE__, __LINE__, __func__,   \
+                    #condition);                                                             \
+            exit(EXIT_FAILURE);                                                              \
+        }                                                                                    \
+    } while (0)
+
+#define CHECK_OK(expression) CHECK((expression) == KSRP_STATUS_OK)
+
+#define RUN_TEST(test)                     \
+    do {                                   \
+        test();                            \
+        printf("%s passed\n", #test);      \
+    } while (0)
+
+#endif // KALMAN_PROTOCOL_STATUS_REPORT_TESTS_KSRP_TEST_H_
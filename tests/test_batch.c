@@ -0,0 +1,160 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "ksrp/batch.h"
+#include "ksrp/protocols/protocol_utils.h"
+#include "ksrp_test.h"
+
+static KSRP_RawData_Frame sent[4];
+static uint32_t sent_count;
+
+static KSRP_Status record_frame(KSRP_RawData_Frame* frame) {
+    CHECK(sent_count < sizeof(sent) / sizeof(sent[0]));
+    sent[sent_count++] = *frame;
+    return KSRP_STATUS_OK;
+}
+
+static KSRP_RawData_Frame motor_status(uint8_t device_id, uint32_t counter) {
+    KSRP_Telemetry_MotorStatus_Frame frame;
+    KSRP_RawData_Frame raw;
+    KSRP_Init_Telemetry_MotorStatus_Frame(&frame);
+    frame.device_id = device_id;
+    frame.counter = counter;
+    CHECK_OK(KSRP_Pack_Telemetry_MotorStatus(&frame, &raw));
+    return raw;
+}
+
+static void check_next(KSRP_BatchReader* reader, const KSRP_RawData_Frame* expected) {
+    KSRP_RawData_Frame frame;
+    CHECK_OK(KSRP_BatchReader_Next(reader, &frame));
+    CHECK(frame.length == expected->length);
+    CHECK(memcmp(frame.data, expected->data, frame.length) == 0);
+}
+
+static void test_round_trip(void) {
+    KSRP_Batcher batcher;
+    KSRP_BatchReader reader;
+    KSRP_RawData_Frame frames[3];
+    KSRP_RawData_Frame frame;
+
+    KSRP_Telemetry_PowerStatus_Frame power_status;
+    KSRP_Init_Telemetry_PowerStatus_Frame(&power_status);
+    power_status.energy = 1234;
+    frames[0] = motor_status(1, 100);
+    CHECK_OK(KSRP_Pack_Telemetry_PowerStatus(&power_status, &frames[1]));
+    frames[2] = motor_status(3, 300);
+
+    sent_count = 0;
+    KSRP_Batcher_Init(&batcher, record_frame);
+    for (uint32_t i = 0; i < 3; i++) {
+        CHECK_OK(KSRP_Batcher_Append(&batcher, &frames[i]));
+    }
+    CHECK(sent_count == 0);
+    CHECK_OK(KSRP_Batcher_Flush(&batcher));
+    CHECK(sent_count == 1);
+    CHECK(KSRP_Batch_IsBatch(&sent[0]));
+    CHECK(sent[0].length == KSRP_ID_BYTES + 3 * KSRP_BATCH_ENTRY_HEADER_BYTES + frames[0].length +
+                                frames[1].length + frames[2].length);
+
+    // Sub-frames come out in order and unpack to the packed frames
+    KSRP_BatchReader_Init(&reader, &sent[0]);
+    for (uint32_t i = 0; i < 3; i++) {
+        check_next(&reader, &frames[i]);
+    }
+    CHECK(KSRP_BatchReader_Next(&reader, &frame) == KSRP_STATUS_ERROR);
+
+    KSRP_Telemetry_MotorStatus_Frame received;
+    KSRP_BatchReader_Init(&reader, &sent[0]);
+    CHECK_OK(KSRP_BatchReader_Next(&reader, &frame));
+    CHECK_OK(KSRP_Unpack_Telemetry_MotorStatus(&frame, &received));
+    CHECK(received.device_id == 1);
+    CHECK(received.counter == 100);
+
+    // Empty batch is not sent
+    CHECK_OK(KSRP_Batcher_Flush(&batcher));
+    CHECK(sent_count == 1);
+    CHECK(KSRP_Batch_IsEmpty(&batcher.batch));
+
+    // Frame without type ID can't be appended
+    frame.length = KSRP_ID_BYTES - 1;
+    CHECK(KSRP_Batcher_Append(&batcher, &frame) == KSRP_STATUS_INVALID_DATA_SIZE);
+    CHECK(KSRP_Batch_IsEmpty(&batcher.batch));
+}
+
+static void test_overflow_flushes_batch(void) {
+    KSRP_Batcher batcher;
+    KSRP_BatchReader reader;
+    KSRP_RawData_Frame frame = motor_status(0, 0);
+    const uint32_t fits = (KSRP_RAW_DATA_FRAME_BUFFER_SIZE - KSRP_ID_BYTES) /
+                          (KSRP_BATCH_ENTRY_HEADER_BYTES + frame.length);
+    CHECK(fits >= 1);
+
+    // Frame which doesn't fit sends the full batch and starts the next one
+    sent_count = 0;
+    KSRP_Batcher_Init(&batcher, record_frame);
+    for (uint32_t i = 0; i <= fits; i++) {
+        frame = motor_status(0, i);
+        CHECK_OK(KSRP_Batcher_Append(&batcher, &frame));
+        CHECK(sent_count == (i == fits ? 1 : 0));
+    }
+    CHECK_OK(KSRP_Batcher_Flush(&batcher));
+    CHECK(sent_count == 2);
+
+    KSRP_BatchReader_Init(&reader, &sent[0]);
+    for (uint32_t i = 0; i < fits; i++) {
+        const KSRP_RawData_Frame expected = motor_status(0, i);
+        check_next(&reader, &expected);
+    }
+    CHECK(KSRP_BatchReader_Next(&reader, &frame) == KSRP_STATUS_ERROR);
+
+    KSRP_BatchReader_Init(&reader, &sent[1]);
+    frame = motor_status(0, fits);
+    check_next(&reader, &frame);
+    CHECK(KSRP_BatchReader_Next(&reader, &frame) == KSRP_STATUS_ERROR);
+}
+
+static void test_malformed_length_stops_reader(void) {
+    KSRP_RawData_Frame batch;
+    KSRP_BatchReader reader;
+    KSRP_RawData_Frame frames[3];
+    KSRP_RawData_Frame frame;
+    const uint8_t malformed[] = {0, KSRP_ID_BYTES - 1, UINT8_MAX};
+
+    for (uint32_t i = 0; i < 3; i++) {
+        frames[i] = motor_status((uint8_t)i, i);
+    }
+    const uint32_t second_entry = KSRP_ID_BYTES + KSRP_BATCH_ENTRY_HEADER_BYTES + frames[0].length;
+
+    // Length shorter than type ID or past the end of the batch ends reading, following sub-frames are not read
+    for (uint32_t m = 0; m < sizeof(malformed) / sizeof(malformed[0]); m++) {
+        KSRP_Batch_Init(&batch);
+        for (uint32_t i = 0; i < 3; i++) {
+            CHECK_OK(KSRP_Batch_Append(&batch, &frames[i]));
+        }
+        batch.data[second_entry] = malformed[m];
+
+        KSRP_BatchReader_Init(&reader, &batch);
+        check_next(&reader, &frames[0]);
+        CHECK(KSRP_BatchReader_Next(&reader, &frame) == KSRP_STATUS_INVALID_DATA_SIZE);
+        CHECK(KSRP_BatchReader_Next(&reader, &frame) == KSRP_STATUS_ERROR);
+    }
+
+    // Truncated last sub-frame
+    KSRP_Batch_Init(&batch);
+    for (uint32_t i = 0; i < 3; i++) {
+        CHECK_OK(KSRP_Batch_Append(&batch, &frames[i]));
+    }
+    batch.length--;
+    KSRP_BatchReader_Init(&reader, &batch);
+    check_next(&reader, &frames[0]);
+    check_next(&reader, &frames[1]);
+    CHECK(KSRP_BatchReader_Next(&reader, &frame) == KSRP_STATUS_INVALID_DATA_SIZE);
+    CHECK(KSRP_BatchReader_Next(&reader, &frame) == KSRP_STATUS_ERROR);
+}
+
+int main(void) {
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_overflow_flushes_batch);
+    RUN_TEST(test_malformed_length_stops_reader);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,178 @@
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ksrp/protocols/subsystems/telemetry_protocol.h"
+#include "ksrp_test.h"
+
+#define TEMPERATURE_SCALE 0.1
+#define TEMPERATURE_OFFSET (-40.0)
+#define TEMPERATURE_MAX (TEMPERATURE_OFFSET + 4095 * TEMPERATURE_SCALE)
+#define VOLTAGE_SCALE 0.001
+#define VOLTAGE_OFFSET (-10.0)
+#define VOLTAGE_MAX (VOLTAGE_OFFSET + 1048575 * VOLTAGE_SCALE)
+
+static uint32_t random_state = 1;
+
+static uint32_t next_random(void) {
+    random_state = random_state * 1103515245u + 12345u;
+    return random_state >> 8;
+}
+
+static double random_in(double min, double max) {
+    return min + (max - min) * (double)(next_random() % 1000001) / 1000000.0;
+}
+
+static KSRP_Telemetry_MotorStatus_Frame round_trip(const KSRP_Telemetry_MotorStatus_Frame* frame) {
+    KSRP_RawData_Frame raw;
+    KSRP_Telemetry_MotorStatus_Frame unpacked;
+    CHECK_OK(KSRP_Pack_Telemetry_MotorStatus(frame, &raw));
+    CHECK(raw.length == KSRP_ID_BYTES + KSRP_TELEMETRY_MOTOR_STATUS_WIRE_SIZE);
+    CHECK_OK(KSRP_Unpack_Telemetry_MotorStatus(&raw, &unpacked));
+    return unpacked;
+}
+
+static void test_wire_size(void) {
+    // 8 + 12 + 2 + 1 + 11 + 20 + 32 + 32 bits
+    CHECK(KSRP_TELEMETRY_MOTOR_STATUS_WIRE_SIZE == 15);
+    CHECK(KSRP_TELEMETRY_MOTOR_STATUS_WIRE_SIZE < KSRP_TELEMETRY_MOTOR_STATUS_FRAME_SIZE);
+}
+
+static void test_fields_are_packed_least_significant_bit_first(void) {
+    KSRP_Telemetry_MotorStatus_Frame frame;
+    KSRP_RawData_Frame raw;
+    KSRP_Init_Telemetry_MotorStatus_Frame(&frame);
+    frame.device_id = 3;
+    frame.temperature = (float)(TEMPERATURE_OFFSET + 0xABC * TEMPERATURE_SCALE);
+    frame.mode = KSRP_TELEMETRY_MOTOR_STATUS_MODE_FAULT;
+    frame.enabled = 1;
+    frame.current = -1;
+    frame.voltage = VOLTAGE_OFFSET;
+    frame.counter = 0;
+    frame.torque = 0.0f;
+
+    CHECK_OK(KSRP_Pack_Telemetry_MotorStatus(&frame, &raw));
+    const uint8_t* payload = &raw.data[KSRP_ID_BYTES];
+    CHECK(raw.data[0] == KSRP_TELEMETRY_SUBSYSTEM_ID && raw.data[1] == KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID);
+    CHECK(payload[0] == 0x03);
+    CHECK(payload[1] == 0xBC);
+    // Temperature nibble 0xA, mode 0b10 in bits 20-21, enabled in bit 22, lowest current bit in bit 23
+    CHECK(payload[2] == (0x0A | 0x20 | 0x40 | 0x80));
+    // Remaining 10 bits of current, voltage and the rest are zero
+    CHECK(payload[3] == 0xFF && (payload[4] & 0x03) == 0x03 && (payload[4] & ~0x03) == 0);
+    for (uint32_t i = 5; i < KSRP_TELEMETRY_MOTOR_STATUS_WIRE_SIZE; i++) {
+        CHECK(payload[i] == 0);
+    }
+}
+
+static void test_round_trip_within_resolution(void) {
+    for (uint32_t i = 0; i < 10000; i++) {
+        KSRP_Telemetry_MotorStatus_Frame frame;
+        KSRP_Init_Telemetry_MotorStatus_Frame(&frame);
+        frame.device_id = (uint8_t)(next_random() % KSRP_TELEMETRY_MAX_DEVICES);
+        frame.temperature = (float)random_in(TEMPERATURE_OFFSET, TEMPERATURE_MAX);
+        frame.mode = (uint8_t)(next_random() % 3);
+        frame.enabled = (uint8_t)(next_random() % 2);
+        frame.current = (int16_t)((int32_t)(next_random() % 2048) - 1024);
+        frame.voltage = random_in(VOLTAGE_OFFSET, VOLTAGE_MAX);
+        frame.counter = next_random() ^ (next_random() << 16);
+        frame.torque = (float)random_in(-1e6, 1e6);
+
+        const KSRP_Telemetry_MotorStatus_Frame unpacked = round_trip(&frame);
+        CHECK(unpacked.device_id == frame.device_id);
+        CHECK(fabs((double)unpacked.temperature - (double)frame.temperature) <= TEMPERATURE_SCALE / 2 + 1e-4);
+        CHECK(unpacked.mode == frame.mode);
+        CHECK(unpacked.enabled == frame.enabled);
+        CHECK(unpacked.current == frame.current);
+        CHECK(fabs(unpacked.voltage - frame.voltage) <= VOLTAGE_SCALE / 2 + 1e-9);
+        CHECK(unpacked.counter == frame.counter);
+        CHECK(memcmp(&unpacked.torque, &frame.torque, sizeof(float)) == 0);
+
+        // Quantized values are stable, packing them again gives the same frame
+        const KSRP_Telemetry_MotorStatus_Frame again = round_trip(&unpacked);
+        CHECK(memcmp(&again, &unpacked, sizeof(again)) == 0);
+    }
+}
+
+static void test_out_of_range_values(void) {
+    KSRP_Telemetry_MotorStatus_Frame frame;
+    KSRP_Init_Telemetry_MotorStatus_Frame(&frame);
+
+    // Scaled values saturate, NaN is encoded as the lowest value
+    frame.temperature = -1000.0f;
+    frame.voltage = 1e9;
+    KSRP_Telemetry_MotorStatus_Frame unpacked = round_trip(&frame);
+    CHECK(fabs((double)unpacked.temperature - TEMPERATURE_OFFSET) < 1e-4);
+    CHECK(fabs(unpacked.voltage - VOLTAGE_MAX) < 1e-6);
+
+    frame.temperature = 1e6f;
+    frame.voltage = NAN;
+    unpacked = round_trip(&frame);
+    CHECK(fabs((double)unpacked.temperature - TEMPERATURE_MAX) < 1e-3);
+    CHECK(unpacked.voltage == VOLTAGE_OFFSET);
+
+    // Integers are truncated to their bits and sign-extended
+    frame.current = 1500;
+    unpacked = round_trip(&frame);
+    CHECK(unpacked.current == 1500 - 2048);
+    frame.current = -1024;
+    unpacked = round_trip(&frame);
+    CHECK(unpacked.current == -1024);
+}
+
+static void test_unpack_rejects_invalid_frames(void) {
+    KSRP_Telemetry_MotorStatus_Frame frame;
+    KSRP_RawData_Frame raw;
+    KSRP_Init_Telemetry_MotorStatus_Frame(&frame);
+    CHECK_OK(KSRP_Pack_Telemetry_MotorStatus(&frame, &raw));
+
+    raw.length--;
+    CHECK(KSRP_Unpack_Telemetry_MotorStatus(&raw, &frame) == KSRP_STATUS_INVALID_DATA_SIZE);
+    raw.length++;
+    raw.data[1] = KSRP_TELEMETRY_POWER_STATUS_FRAME_ID;
+    CHECK(KSRP_Unpack_Telemetry_MotorStatus(&raw, &frame) == KSRP_STATUS_INVALID_FRAME_TYPE);
+}
+
+static void test_batch_unpack_matches_single_unpack(void) {
+    static KSRP_RawData_Frame raw[KSRP_COLUMNS_CAPACITY];
+    static KSRP_Telemetry_MotorStatus_Frame frames[KSRP_COLUMNS_CAPACITY];
+    static KSRP_Telemetry_MotorStatus_Columns columns;
+
+    for (uint32_t i = 0; i < KSRP_COLUMNS_CAPACITY; i++) {
+        KSRP_Telemetry_MotorStatus_Frame frame;
+        KSRP_Init_Telemetry_MotorStatus_Frame(&frame);
+        frame.device_id = (uint8_t)(i % KSRP_TELEMETRY_MAX_DEVICES);
+        frame.temperature = (float)random_in(TEMPERATURE_OFFSET, TEMPERATURE_MAX);
+        frame.current = (int16_t)((int32_t)(next_random() % 2048) - 1024);
+        frame.voltage = random_in(VOLTAGE_OFFSET, VOLTAGE_MAX);
+        frame.counter = i;
+        CHECK_OK(KSRP_Pack_Telemetry_MotorStatus(&frame, &raw[i]));
+        CHECK_OK(KSRP_Unpack_Telemetry_MotorStatus(&raw[i], &frames[i]));
+    }
+
+    CHECK_OK(KSRP_UnpackBatch_Telemetry_MotorStatus(raw, KSRP_COLUMNS_CAPACITY, &columns));
+    CHECK(columns.count == KSRP_COLUMNS_CAPACITY);
+    for (uint32_t i = 0; i < KSRP_COLUMNS_CAPACITY; i++) {
+        CHECK(columns.device_id[i] == frames[i].device_id);
+        CHECK(columns.temperature[i] == frames[i].temperature);
+        CHECK(columns.current[i] == frames[i].current);
+        CHECK(columns.voltage[i] == frames[i].voltage);
+        CHECK(columns.counter[i] == frames[i].counter);
+    }
+
+    // One invalid frame leaves the columns untouched
+    raw[7].length--;
+    columns.count = 0;
+    CHECK(KSRP_UnpackBatch_Telemetry_MotorStatus(raw, KSRP_COLUMNS_CAPACITY, &columns) != KSRP_STATUS_OK);
+    CHECK(columns.count == 0);
+}
+
+int main(void) {
+    RUN_TEST(test_wire_size);
+    RUN_TEST(test_fields_are_packed_least_significant_bit_first);
+    RUN_TEST(test_round_trip_within_resolution);
+    RUN_TEST(test_out_of_range_values);
+    RUN_TEST(test_unpack_rejects_invalid_frames);
+    RUN_TEST(test_batch_unpack_matches_single_unpack);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,156 @@
+#include <cstdint>
+
+#include "ksrp/cpp/protocols.hpp"
+#include "ksrp_test.h"
+
+namespace motor_status = ksrp::telemetry::motor_status;
+namespace report = ksrp::diagnostics::report;
+
+static_assert(ksrp::telemetry::MotorStatus::type_id ==
+              KSRP_MAKE_TYPE_ID(KSRP_TELEMETRY_SUBSYSTEM_ID, KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID));
+static_assert(ksrp::telemetry::MotorStatus::subsystem_id == KSRP_TELEMETRY_SUBSYSTEM_ID);
+static_assert(ksrp::telemetry::MotorStatus::frame_id == KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID);
+static_assert(ksrp::telemetry::PowerStatus::type_id == KSRP_TELEMETRY_POWER_STATUS_TYPE_ID);
+static_assert(ksrp::limits::Levels::type_id ==
+              KSRP_MAKE_TYPE_ID(KSRP_LIMITS_SUBSYSTEM_ID, KSRP_LIMITS_LEVELS_FRAME_ID));
+static_assert(ksrp::diagnostics::Report::type_id ==
+              KSRP_MAKE_TYPE_ID(KSRP_DIAGNOSTICS_SUBSYSTEM_ID, KSRP_DIAGNOSTICS_REPORT_FRAME_ID));
+static_assert(ksrp::diagnostics::Report::type_id != ksrp::diagnostics::PackedReport::type_id);
+static_assert(ksrp::telemetry::MotorStatus::size == sizeof(KSRP_Telemetry_MotorStatus_Frame));
+static_assert(motor_status::Counter::id == KSRP_TELEMETRY_MOTOR_STATUS_COUNTER_FIELD_ID);
+static_assert(motor_status::Temperature::has_health_checks);
+static_assert(!motor_status::Counter::has_health_checks);
+static_assert(ksrp::telemetry::MotorStatus::name == "motor_status");
+
+#define MAX_SEGMENTS 8
+
+static KSRP_RawData_Frame segments[MAX_SEGMENTS];
+static uint32_t segments_count;
+
+static KSRP_Status record_segment(KSRP_RawData_Frame* frame) {
+    CHECK(segments_count < MAX_SEGMENTS);
+    segments[segments_count++] = *frame;
+    return KSRP_STATUS_OK;
+}
+
+static KSRP_Telemetry_MotorStatus_Frame motor_status_frame() {
+    KSRP_Telemetry_MotorStatus_Frame frame;
+    CHECK_OK(ksrp::telemetry::MotorStatus::init(frame));
+    ksrp::set<motor_status::DeviceId>(frame, 2);
+    ksrp::set<motor_status::Temperature>(frame, 90.5f);
+    ksrp::set<motor_status::Mode>(frame, KSRP_TELEMETRY_MOTOR_STATUS_MODE_FAULT);
+    ksrp::set<motor_status::Current>(frame, -300);
+    ksrp::set<motor_status::Counter>(frame, 0xDEADBEEF);
+    return frame;
+}
+
+static void test_get_and_set(void) {
+    const KSRP_Telemetry_MotorStatus_Frame frame = motor_status_frame();
+
+    // Accessors read and write the same bytes as the C structure
+    CHECK(frame.device_id == 2);
+    CHECK(frame.temperature == 90.5f);
+    CHECK(frame.mode == KSRP_TELEMETRY_MOTOR_STATUS_MODE_FAULT);
+    CHECK(frame.current == -300);
+    CHECK(frame.counter == 0xDEADBEEF);
+    CHECK(ksrp::get<motor_status::Temperature>(frame) == 90.5f);
+    CHECK(ksrp::get<motor_status::Mode>(frame) == KSRP_TELEMETRY_MOTOR_STATUS_MODE_FAULT);
+    CHECK(ksrp::get<motor_status::Current>(frame) == -300);
+    CHECK(ksrp::get<motor_status::Counter>(frame) == 0xDEADBEEF);
+    CHECK(ksrp::health<motor_status::Temperature>(frame) == KSRP_RESULT_WARNING);
+
+    uint32_t fields = 0;
+    ksrp::for_each(ksrp::telemetry::MotorStatus::fields{}, [&](auto field) {
+        CHECK(decltype(field)::id == fields);
+        fields++;
+    });
+    CHECK(fields == KSRP_TELEMETRY_MOTOR_STATUS_FIELDS_COUNT);
+}
+
+static void test_visit_frames(void) {
+    const KSRP_Telemetry_MotorStatus_Frame frame = motor_status_frame();
+    KSRP_RawData_Frame raw;
+    CHECK_OK(ksrp::telemetry::MotorStatus::pack(frame, raw));
+
+    uint32_t motor_status_calls = 0;
+    uint32_t other_calls = 0;
+    const auto visitor = ksrp::overloaded{
+        [&](const KSRP_Telemetry_MotorStatus_Frame& received) {
+            // Temperature is quantized on the wire, the other fields arrive exactly
+            CHECK(ksrp::get<motor_status::DeviceId>(received) == 2);
+            CHECK(ksrp::get<motor_status::Temperature>(received) > 90.4f);
+            CHECK(ksrp::get<motor_status::Temperature>(received) < 90.6f);
+            CHECK(ksrp::get<motor_status::Mode>(received) == KSRP_TELEMETRY_MOTOR_STATUS_MODE_FAULT);
+            CHECK(ksrp::get<motor_status::Current>(received) == -300);
+            CHECK(ksrp::get<motor_status::Counter>(received) == 0xDEADBEEF);
+            motor_status_calls++;
+        },
+        [&](const auto&) { other_calls++; },
+    };
+    CHECK_OK(ksrp::visit<ksrp::Frames>(raw, visitor));
+    CHECK(motor_status_calls == 1);
+    CHECK(other_calls == 0);
+
+    KSRP_Limits_Levels_Frame levels;
+    CHECK_OK(ksrp::limits::Levels::init(levels));
+    CHECK_OK(ksrp::limits::Levels::pack(levels, raw));
+    CHECK_OK(ksrp::visit<ksrp::Frames>(raw, visitor));
+    CHECK(motor_status_calls == 1);
+    CHECK(other_calls == 1);
+
+    // Frames outside of the list are not unpacked
+    CHECK_OK(ksrp::telemetry::MotorStatus::pack(frame, raw));
+    CHECK(ksrp::visit<ksrp::type_list<ksrp::limits::Levels>>(raw, visitor) == KSRP_STATUS_INVALID_FRAME_TYPE);
+    raw.data[KSRP_ID_BYTES - 1] = UINT8_MAX;
+    CHECK(ksrp::visit<ksrp::Frames>(raw, visitor) == KSRP_STATUS_INVALID_FRAME_TYPE);
+    CHECK(motor_status_calls == 1);
+    CHECK(other_calls == 1);
+}
+
+static void test_visit_segmented_frames(void) {
+    KSRP_Diagnostics_Report_Frame frame;
+    CHECK_OK(ksrp::diagnostics::Report::init(frame));
+    ksrp::set<report::DeviceId>(frame, 3);
+    ksrp::set<report::Sample0>(frame, -1.5);
+    ksrp::set<report::Sample39>(frame, 1e300);
+    CHECK(ksrp::get<report::Sample39>(frame) == 1e300);
+
+    segments_count = 0;
+    CHECK_OK(ksrp::diagnostics::Report::pack_segmented(frame, 5, record_segment));
+    CHECK(segments_count == ksrp::diagnostics::Report::segments_count);
+
+    static KSRP_ReassemblySlot slots[1];
+    KSRP_Reassembler reassembler;
+    KSRP_SegmentedPayload payload;
+    KSRP_Reassembler_Init(&reassembler, slots, 1, 100);
+    for (uint32_t i = 0; i < segments_count; i++) {
+        CHECK_OK(KSRP_Reassembler_Push(&reassembler, &segments[i], 0, &payload));
+    }
+    CHECK(payload.data != NULL);
+
+    uint32_t report_calls = 0;
+    uint32_t other_calls = 0;
+    const auto visitor = ksrp::overloaded{
+        [&](const KSRP_Diagnostics_Report_Frame& received) {
+            CHECK(ksrp::get<report::DeviceId>(received) == 3);
+            CHECK(ksrp::get<report::Sample0>(received) == -1.5);
+            CHECK(ksrp::get<report::Sample39>(received) == 1e300);
+            report_calls++;
+        },
+        [&](const KSRP_Diagnostics_PackedReport_Frame&) { other_calls++; },
+    };
+    CHECK_OK(ksrp::visit<ksrp::SegmentedFrames>(payload, visitor));
+    CHECK(report_calls == 1);
+    CHECK(other_calls == 0);
+
+    payload.type_id = ksrp::telemetry::MotorStatus::type_id;
+    CHECK(ksrp::visit<ksrp::SegmentedFrames>(payload, visitor) == KSRP_STATUS_INVALID_FRAME_TYPE);
+    CHECK(report_calls == 1);
+}
+
+int main(void) {
+    RUN_TEST(test_get_and_set);
+    RUN_TEST(test_visit_frames);
+    RUN_TEST(test_visit_segmented_frames);
+    return EXIT_SUCCESS;
+}
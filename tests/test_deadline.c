@@ -0,0 +1,160 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ksrp/deadline.h"
+#include "ksrp_test.h"
+
+#define NODES 16
+#define TIMEOUT_MS 100
+
+static void test_expires_in_schedule_order(void) {
+    KSRP_DeadlineNode nodes[NODES];
+    KSRP_DeadlineQueue queue;
+    KSRP_DeadlineNodes_Init(nodes, NODES);
+    KSRP_DeadlineQueue_Init(&queue, nodes, TIMEOUT_MS);
+
+    CHECK(KSRP_DeadlineQueue_PopExpired(&queue, 0) == KSRP_DEADLINE_NONE);
+    KSRP_DeadlineQueue_Schedule(&queue, 3, 0);
+    KSRP_DeadlineQueue_Schedule(&queue, 1, 10);
+    KSRP_DeadlineQueue_Schedule(&queue, 2, 20);
+
+    CHECK(KSRP_DeadlineQueue_PopExpired(&queue, 99) == KSRP_DEADLINE_NONE);
+    CHECK(KSRP_DeadlineQueue_PopExpired(&queue, 100) == 3);
+    CHECK(KSRP_DeadlineQueue_PopExpired(&queue, 100) == KSRP_DEADLINE_NONE);
+    CHECK(KSRP_DeadlineQueue_PopExpired(&queue, 500) == 1);
+    CHECK(KSRP_DeadlineQueue_PopExpired(&queue, 500) == 2);
+    CHECK(KSRP_DeadlineQueue_PopExpired(&queue, 500) == KSRP_DEADLINE_NONE);
+    CHECK(!nodes[1].armed && !nodes[2].armed && !nodes[3].armed);
+}
+
+static void test_reschedule_moves_node_to_tail(void) {
+    KSRP_DeadlineNode nodes[NODES];
+    KSRP_DeadlineQueue queue;
+    KSRP_DeadlineNodes_Init(nodes, NODES);
+    KSRP_DeadlineQueue_Init(&queue, nodes, TIMEOUT_MS);
+
+    KSRP_DeadlineQueue_Schedule(&queue, 0, 0);
+    KSRP_DeadlineQueue_Schedule(&queue, 1, 10);
+    KSRP_DeadlineQueue_Schedule(&queue, 2, 20);
+    KSRP_DeadlineQueue_Schedule(&queue, 0, 50);
+    KSRP_DeadlineQueue_Schedule(&queue, 2, 60);
+
+    CHECK(KSRP_DeadlineQueue_PopExpired(&queue, 120) == 1);
+    CHECK(KSRP_DeadlineQueue_PopExpired(&queue, 120) == KSRP_DEADLINE_NONE);
+    CHECK(KSRP_DeadlineQueue_PopExpired(&queue, 150) == 0);
+    CHECK(KSRP_DeadlineQueue_PopExpired(&queue, 160) == 2);
+    CHECK(queue.head == KSRP_DEADLINE_NONE && queue.tail == KSRP_DEADLINE_NONE);
+}
+
+static void test_queues_share_nodes(void) {
+    KSRP_DeadlineNode nodes[NODES];
+    KSRP_DeadlineQueue fast;
+    KSRP_DeadlineQueue slow;
+    KSRP_DeadlineNodes_Init(nodes, NODES);
+    KSRP_DeadlineQueue_Init(&fast, nodes, 10);
+    KSRP_DeadlineQueue_Init(&slow, nodes, 1000);
+
+    KSRP_DeadlineQueue_Schedule(&slow, 0, 0);
+    KSRP_DeadlineQueue_Schedule(&fast, 1, 0);
+    KSRP_DeadlineQueue_Schedule(&slow, 2, 5);
+    KSRP_DeadlineQueue_Schedule(&fast, 3, 5);
+
+    CHECK(KSRP_DeadlineQueue_PopExpired(&fast, 15) == 1);
+    CHECK(KSRP_DeadlineQueue_PopExpired(&fast, 15) == 3);
+    CHECK(KSRP_DeadlineQueue_PopExpired(&slow, 15) == KSRP_DEADLINE_NONE);
+    CHECK(KSRP_DeadlineQueue_PopExpired(&slow, 1005) == 0);
+    CHECK(KSRP_DeadlineQueue_PopExpired(&slow, 1005) == 2);
+}
+
+static void test_insert_keeps_deadline_order(void) {
+    KSRP_DeadlineNode nodes[NODES];
+    KSRP_DeadlineQueue queue;
+    KSRP_DeadlineNodes_Init(nodes, NODES);
+    KSRP_DeadlineQueue_Init(&queue, nodes, TIMEOUT_MS);
+
+    // Restored update times come in any order, equal deadlines keep insertion order
+    const uint32_t updated_ms[] = {50, 10, 70, 10, 0, 60};
+    for (uint16_t i = 0; i < sizeof(updated_ms) / sizeof(updated_ms[0]); i++) {
+        KSRP_DeadlineQueue_Insert(&queue, i, updated_ms[i]);
+    }
+    // Inserting an armed node moves it
+    KSRP_DeadlineQueue_Insert(&queue, 2, 5);
+
+    const uint16_t expected[] = {4, 2, 1, 3, 0, 5};
+    for (uint32_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        CHECK(KSRP_DeadlineQueue_PopExpired(&queue, 1000) == expected[i]);
+    }
+    CHECK(KSRP_DeadlineQueue_PopExpired(&queue, 1000) == KSRP_DEADLINE_NONE);
+
+    // Scheduling after insert appends to the sorted queue
+    KSRP_DeadlineQueue_Insert(&queue, 0, 20);
+    KSRP_DeadlineQueue_Schedule(&queue, 1, 30);
+    KSRP_DeadlineQueue_Insert(&queue, 2, 25);
+    CHECK(KSRP_DeadlineQueue_PopExpired(&queue, 1000) == 0);
+    CHECK(KSRP_DeadlineQueue_PopExpired(&queue, 1000) == 2);
+    CHECK(KSRP_DeadlineQueue_PopExpired(&queue, 1000) == 1);
+}
+
+static void test_clock_wrap_around(void) {
+    KSRP_DeadlineNode nodes[NODES];
+    KSRP_DeadlineQueue queue;
+    KSRP_DeadlineNodes_Init(nodes, NODES);
+    KSRP_DeadlineQueue_Init(&queue, nodes, TIMEOUT_MS);
+
+    const uint32_t start = UINT32_MAX - 50;
+    KSRP_DeadlineQueue_Schedule(&queue, 0, start);
+    KSRP_DeadlineQueue_Insert(&queue, 1, start + 20);
+
+    CHECK(KSRP_DeadlineQueue_PopExpired(&queue, start + 99) == KSRP_DEADLINE_NONE);
+    CHECK(KSRP_DeadlineQueue_PopExpired(&queue, start + 100) == 0);
+    CHECK(KSRP_DeadlineQueue_PopExpired(&queue, start + 119) == KSRP_DEADLINE_NONE);
+    CHECK(KSRP_DeadlineQueue_PopExpired(&queue, start + 120) == 1);
+}
+
+static void test_matches_scan_of_all_nodes(void) {
+    KSRP_DeadlineNode nodes[NODES];
+    KSRP_DeadlineQueue queue;
+    KSRP_DeadlineNodes_Init(nodes, NODES);
+    KSRP_DeadlineQueue_Init(&queue, nodes, TIMEOUT_MS);
+
+    bool armed[NODES] = {false};
+    uint32_t deadline_ms[NODES] = {0};
+    uint32_t random = 12345;
+    uint32_t now_ms = UINT32_MAX - 5000;
+
+    for (uint32_t step = 0; step < 20000; step++) {
+        random = random * 1103515245u + 12345u;
+        const uint16_t index = (uint16_t)((random >> 16) % NODES);
+        if ((random >> 8) % 3 != 0) {
+            KSRP_DeadlineQueue_Schedule(&queue, index, now_ms);
+            armed[index] = true;
+            deadline_ms[index] = now_ms + TIMEOUT_MS;
+        }
+        now_ms += (random >> 4) % 7;
+
+        // Expired nodes come out earliest deadline first, exactly the ones a scan of all nodes finds
+        uint16_t expired;
+        while ((expired = KSRP_DeadlineQueue_PopExpired(&queue, now_ms)) != KSRP_DEADLINE_NONE) {
+            CHECK(expired < NODES && armed[expired]);
+            CHECK((int32_t)(now_ms - deadline_ms[expired]) >= 0);
+            for (uint16_t i = 0; i < NODES; i++) {
+                CHECK(!armed[i] || (int32_t)(deadline_ms[i] - deadline_ms[expired]) >= 0);
+            }
+            armed[expired] = false;
+        }
+        for (uint16_t i = 0; i < NODES; i++) {
+            CHECK(!armed[i] || (int32_t)(now_ms - deadline_ms[i]) < 0);
+            CHECK(armed[i] == nodes[i].armed);
+        }
+    }
+}
+
+int main(void) {
+    RUN_TEST(test_expires_in_schedule_order);
+    RUN_TEST(test_reschedule_moves_node_to_tail);
+    RUN_TEST(test_queues_share_nodes);
+    RUN_TEST(test_insert_keeps_deadline_order);
+    RUN_TEST(test_clock_wrap_around);
+    RUN_TEST(test_matches_scan_of_all_nodes);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,133 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "ksrp/protocols/protocol_registry.h"
+#include "ksrp/protocols/protocol_utils.h"
+#include "ksrp_test.h"
+
+#define UPDATES 25
+#define REGISTRIES 3
+
+static KSRP_RawData_Frame sent[8];
+static uint32_t sent_count;
+
+static KSRP_Status record_frame(KSRP_RawData_Frame* frame) {
+    CHECK(sent_count < sizeof(sent) / sizeof(sent[0]));
+    sent[sent_count++] = *frame;
+    return KSRP_STATUS_OK;
+}
+
+static void update_step(KSRP_Control_Instance* instance, uint32_t step) {
+    CHECK_OK(KSRP_UpdateFrameField_Control_Instance(instance, KSRP_CONTROL_SETPOINT_FRAME_ID,
+                                                    KSRP_CONTROL_SETPOINT_STEP_FIELD_ID, &step, sizeof(step)));
+}
+
+static void update_command(KSRP_Control_Instance* instance, int16_t throttle, uint32_t sequence) {
+    KSRP_Control_Command_Frame frame;
+    KSRP_Init_Control_Command_Frame(&frame);
+    frame.throttle = throttle;
+    frame.sequence = sequence;
+    CHECK_OK(KSRP_UpdateFrame_Control_Instance(instance, KSRP_CONTROL_COMMAND_FRAME_ID, &frame, sizeof(frame)));
+}
+
+static void test_updates_are_sent_once_per_flush(void) {
+    static KSRP_Control_Instance instance;
+    CHECK_OK(KSRP_Init_Control_Instance(&instance));
+    CHECK_OK(KSRP_Control_Instance_SetSendFrameCallback(&instance, record_frame));
+
+    // Nothing is sent on update, only the last value of every field goes out on flush
+    sent_count = 0;
+    for (uint32_t i = 1; i <= UPDATES; i++) {
+        update_step(&instance, i);
+        float position = (float)i * 0.5f;
+        CHECK_OK(KSRP_UpdateFrameField_Control_Instance(&instance, KSRP_CONTROL_SETPOINT_FRAME_ID,
+                                                        KSRP_CONTROL_SETPOINT_POSITION_FIELD_ID, &position,
+                                                        sizeof(position)));
+    }
+    CHECK(sent_count == 0);
+
+    CHECK_OK(KSRP_Flush_Control_Instance(&instance));
+    CHECK(sent_count == 1);
+    KSRP_Control_Setpoint_Frame received;
+    CHECK_OK(KSRP_Unpack_Control_Setpoint(&sent[0], &received));
+    CHECK(received.step == UPDATES);
+    CHECK(received.position == (float)UPDATES * 0.5f);
+    CHECK(memcmp(&received, &instance.setpoint_instance, sizeof(received)) == 0);
+
+    // Clean frames and updates without change are not sent again
+    CHECK_OK(KSRP_Flush_Control_Instance(&instance));
+    update_step(&instance, UPDATES);
+    CHECK_OK(KSRP_Flush_Control_Instance(&instance));
+    CHECK(sent_count == 1);
+
+    // Value changed and changed back still marks the frame dirty
+    update_step(&instance, 0);
+    update_step(&instance, UPDATES);
+    CHECK_OK(KSRP_Flush_Control_Instance(&instance));
+    CHECK(sent_count == 2);
+}
+
+static void test_throttled_frame_stays_pending(void) {
+    static KSRP_Control_Instance instance;
+    CHECK_OK(KSRP_Init_Control_Instance(&instance));
+    CHECK_OK(KSRP_Control_Instance_SetSendFrameCallback(&instance, record_frame));
+    KSRP_Control_Command_Frame received;
+
+    // First transmission isn't delayed
+    sent_count = 0;
+    update_command(&instance, 100, 1);
+    CHECK_OK(KSRP_Flush_Control_Instance(&instance));
+    CHECK(sent_count == 1);
+
+    // Updates within the interval stay pending, unthrottled frames are still sent
+    CHECK_OK(KSRP_UpdateTime_Control_Instance(&instance, 10));
+    update_command(&instance, 200, 2);
+    update_step(&instance, 7);
+    CHECK_OK(KSRP_Flush_Control_Instance(&instance));
+    CHECK(sent_count == 2);
+    CHECK(KSRP_RawData_Frame_GetTypeID(&sent[1]) == KSRP_CONTROL_SETPOINT_TYPE_ID);
+
+    update_command(&instance, 300, 3);
+    CHECK_OK(KSRP_UpdateTime_Control_Instance(&instance, KSRP_CONTROL_COMMAND_MIN_TRANSMIT_INTERVAL_MS - 11));
+    CHECK_OK(KSRP_Flush_Control_Instance(&instance));
+    CHECK(sent_count == 2);
+
+    // Latest value is sent once the interval passes
+    CHECK_OK(KSRP_UpdateTime_Control_Instance(&instance, 1));
+    CHECK_OK(KSRP_Flush_Control_Instance(&instance));
+    CHECK(sent_count == 3);
+    CHECK_OK(KSRP_Unpack_Control_Command(&sent[2], &received));
+    CHECK(received.throttle == 300);
+    CHECK(received.sequence == 3);
+
+    CHECK_OK(KSRP_UpdateTime_Control_Instance(&instance, KSRP_CONTROL_COMMAND_MIN_TRANSMIT_INTERVAL_MS));
+    CHECK_OK(KSRP_Flush_Control_Instance(&instance));
+    CHECK(sent_count == 3);
+}
+
+static void test_registry_flush(void) {
+    static KSRP_Registry registries[REGISTRIES];
+    CHECK_OK(KSRP_Registry_Init(registries, REGISTRIES));
+    CHECK_OK(KSRP_Registry_SetSendFrameCallback(registries, REGISTRIES, record_frame));
+
+    sent_count = 0;
+    for (uint32_t i = 0; i < UPDATES; i++) {
+        update_step(&registries[0].control, i + 1);
+        update_command(&registries[2].control, (int16_t)i, i + 1);
+    }
+    CHECK(sent_count == 0);
+
+    CHECK_OK(KSRP_Registry_Flush(registries, REGISTRIES));
+    CHECK(sent_count == 2);
+    CHECK(KSRP_RawData_Frame_GetTypeID(&sent[0]) == KSRP_CONTROL_SETPOINT_TYPE_ID);
+    CHECK(KSRP_RawData_Frame_GetTypeID(&sent[1]) == KSRP_CONTROL_COMMAND_TYPE_ID);
+    CHECK_OK(KSRP_Registry_Flush(registries, REGISTRIES));
+    CHECK(sent_count == 2);
+}
+
+int main(void) {
+    RUN_TEST(test_updates_are_sent_once_per_flush);
+    RUN_TEST(test_throttled_frame_stays_pending);
+    RUN_TEST(test_registry_flush);
+    return EXIT_SUCCESS;
+}
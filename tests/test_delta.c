@@ -0,0 +1,185 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "ksrp/protocols/protocol_utils.h"
+#include "ksrp_test.h"
+
+#define MOTOR_STATUS_ALL_FIELDS ((1u << KSRP_TELEMETRY_MOTOR_STATUS_FIELDS_COUNT) - 1)
+#define POWER_STATUS_ALL_FIELDS ((1u << KSRP_TELEMETRY_POWER_STATUS_FIELDS_COUNT) - 1)
+#define UPDATES 42
+
+static KSRP_RawData_Frame sent[64];
+static uint32_t sent_count;
+static bool drop_sent;
+
+static KSRP_Status record_frame(KSRP_RawData_Frame* frame) {
+    CHECK(sent_count < sizeof(sent) / sizeof(sent[0]));
+    sent[sent_count++] = *frame;
+    return drop_sent ? KSRP_STATUS_OK : KSRP_Dispatch(frame);
+}
+
+// Scaled fields lose precision on the wire, frames are compared after a round trip
+static KSRP_Telemetry_MotorStatus_Frame quantized(const KSRP_Telemetry_MotorStatus_Frame* frame) {
+    KSRP_RawData_Frame raw;
+    KSRP_Telemetry_MotorStatus_Frame result;
+    CHECK_OK(KSRP_Pack_Telemetry_MotorStatus(frame, &raw));
+    CHECK_OK(KSRP_Unpack_Telemetry_MotorStatus(&raw, &result));
+    return result;
+}
+
+static KSRP_Telemetry_MotorStatus_Frame motor_status(uint8_t device_id, uint32_t seed) {
+    KSRP_Telemetry_MotorStatus_Frame frame;
+    KSRP_Init_Telemetry_MotorStatus_Frame(&frame);
+    frame.device_id = device_id;
+    frame.temperature = 20.0f + (float)(seed % 500) * 0.1f;
+    frame.mode = (uint8_t)(seed % 3);
+    frame.enabled = (uint8_t)(seed % 2);
+    frame.current = (int16_t)((int32_t)(seed % 2000) - 1000);
+    frame.voltage = 12.0 + (double)(seed % 1000) * 0.001;
+    frame.counter = seed * 2654435761u;
+    frame.torque = (float)seed * -0.25f;
+    return quantized(&frame);
+}
+
+static void check_motor_status_fields(const KSRP_Telemetry_MotorStatus_Frame* patched,
+                                      const KSRP_Telemetry_MotorStatus_Frame* old,
+                                      const KSRP_Telemetry_MotorStatus_Frame* new, uint64_t mask) {
+#define CHECK_FIELD(field, id) \
+    CHECK(patched->field == ((mask >> KSRP_TELEMETRY_MOTOR_STATUS_##id##_FIELD_ID) & 1 ? new : old)->field)
+    CHECK(patched->device_id == new->device_id);
+    CHECK_FIELD(temperature, TEMPERATURE);
+    CHECK_FIELD(mode, MODE);
+    CHECK_FIELD(enabled, ENABLED);
+    CHECK_FIELD(current, CURRENT);
+    CHECK_FIELD(voltage, VOLTAGE);
+    CHECK_FIELD(counter, COUNTER);
+    CHECK_FIELD(torque, TORQUE);
+#undef CHECK_FIELD
+}
+
+static void test_bit_packed_delta_of_every_field_subset(void) {
+    const KSRP_Telemetry_MotorStatus_Frame old = motor_status(2, 7);
+    const KSRP_Telemetry_MotorStatus_Frame new = motor_status(2, 1234);
+    KSRP_RawData_Frame delta;
+
+    for (uint64_t mask = 0; mask <= MOTOR_STATUS_ALL_FIELDS; mask++) {
+        KSRP_Telemetry_MotorStatus_Frame patched = old;
+        CHECK_OK(KSRP_PackDelta_Telemetry_MotorStatus(&new, mask, &delta));
+        CHECK(KSRP_Delta_IsDelta(&delta));
+        CHECK(KSRP_Delta_GetTypeID(&delta) == KSRP_TELEMETRY_MOTOR_STATUS_TYPE_ID);
+        CHECK_OK(KSRP_ApplyDelta_Telemetry_MotorStatus(&delta, &patched));
+        check_motor_status_fields(&patched, &old, &new, mask);
+    }
+
+    // Single changed field takes a fraction of the full frame
+    CHECK_OK(KSRP_PackDelta_Telemetry_MotorStatus(
+        &new, (uint64_t)1 << KSRP_TELEMETRY_MOTOR_STATUS_MODE_FIELD_ID, &delta));
+    CHECK(delta.length == KSRP_DELTA_HEADER_BYTES + KSRP_TELEMETRY_MOTOR_STATUS_DELTA_MASK_BYTES + 2);
+    CHECK(delta.length < KSRP_ID_BYTES + KSRP_TELEMETRY_MOTOR_STATUS_WIRE_SIZE);
+}
+
+static void test_byte_aligned_delta_of_every_field_subset(void) {
+    KSRP_Telemetry_PowerStatus_Frame old;
+    KSRP_Telemetry_PowerStatus_Frame new;
+    KSRP_RawData_Frame delta;
+    KSRP_Init_Telemetry_PowerStatus_Frame(&old);
+    KSRP_Init_Telemetry_PowerStatus_Frame(&new);
+    old.device_id = new.device_id = 1;
+    new.state = 3;
+    new.voltage = 23.5f;
+    new.current = -300;
+    new.energy = 0x0123456789ABCDEFULL;
+
+    for (uint64_t mask = 0; mask <= POWER_STATUS_ALL_FIELDS; mask++) {
+        KSRP_Telemetry_PowerStatus_Frame patched = old;
+        CHECK_OK(KSRP_PackDelta_Telemetry_PowerStatus(&new, mask, &delta));
+        CHECK_OK(KSRP_ApplyDelta_Telemetry_PowerStatus(&delta, &patched));
+        CHECK(patched.state == ((mask >> KSRP_TELEMETRY_POWER_STATUS_STATE_FIELD_ID) & 1 ? new : old).state);
+        CHECK(patched.voltage == ((mask >> KSRP_TELEMETRY_POWER_STATUS_VOLTAGE_FIELD_ID) & 1 ? new : old).voltage);
+        CHECK(patched.current == ((mask >> KSRP_TELEMETRY_POWER_STATUS_CURRENT_FIELD_ID) & 1 ? new : old).current);
+        CHECK(patched.energy == ((mask >> KSRP_TELEMETRY_POWER_STATUS_ENERGY_FIELD_ID) & 1 ? new : old).energy);
+    }
+}
+
+static void test_invalid_delta_leaves_frame_untouched(void) {
+    const KSRP_Telemetry_MotorStatus_Frame old = motor_status(1, 3);
+    const KSRP_Telemetry_MotorStatus_Frame new = motor_status(1, 99);
+    KSRP_Telemetry_MotorStatus_Frame patched = old;
+    KSRP_RawData_Frame delta;
+    KSRP_RawData_Frame invalid;
+    CHECK_OK(KSRP_PackDelta_Telemetry_MotorStatus(&new, MOTOR_STATUS_ALL_FIELDS, &delta));
+
+    // Truncated values
+    invalid = delta;
+    invalid.length--;
+    CHECK(KSRP_ApplyDelta_Telemetry_MotorStatus(&invalid, &patched) == KSRP_STATUS_INVALID_DATA_SIZE);
+    invalid.length = KSRP_DELTA_HEADER_BYTES;
+    CHECK(KSRP_ApplyDelta_Telemetry_MotorStatus(&invalid, &patched) == KSRP_STATUS_INVALID_DATA_SIZE);
+
+    // Delta of another frame, full frame instead of delta
+    invalid = delta;
+    invalid.data[KSRP_ID_BYTES + 1] = KSRP_TELEMETRY_POWER_STATUS_FRAME_ID;
+    CHECK(KSRP_ApplyDelta_Telemetry_MotorStatus(&invalid, &patched) == KSRP_STATUS_INVALID_FRAME_TYPE);
+    CHECK_OK(KSRP_Pack_Telemetry_MotorStatus(&new, &invalid));
+    CHECK(KSRP_ApplyDelta_Telemetry_MotorStatus(&invalid, &patched) == KSRP_STATUS_INVALID_FRAME_TYPE);
+
+    CHECK(memcmp(&patched, &old, sizeof(old)) == 0);
+
+    // Field ID beyond the frame
+    KSRP_Telemetry_PowerStatus_Frame power_status;
+    KSRP_Telemetry_PowerStatus_Frame power_status_patched;
+    KSRP_Init_Telemetry_PowerStatus_Frame(&power_status);
+    power_status_patched = power_status;
+    CHECK_OK(KSRP_PackDelta_Telemetry_PowerStatus(&power_status, POWER_STATUS_ALL_FIELDS, &invalid));
+    invalid.data[KSRP_DELTA_HEADER_BYTES] |= 1u << KSRP_TELEMETRY_POWER_STATUS_FIELDS_COUNT;
+    CHECK(KSRP_ApplyDelta_Telemetry_PowerStatus(&invalid, &power_status_patched) == KSRP_STATUS_INVALID_FIELD_TYPE);
+    CHECK(power_status_patched.state == 0);
+}
+
+static void test_receiver_follows_sender(void) {
+    static KSRP_Telemetry_Instance sender;
+    static KSRP_Telemetry_Instance receiver;
+    CHECK_OK(KSRP_Init_Telemetry_Instance(&sender));
+    CHECK_OK(KSRP_Init_Telemetry_Instance(&receiver));
+    CHECK_OK(KSRP_Telemetry_Instance_SetSendFrameCallback(&sender, record_frame));
+    CHECK_OK(KSRP_Dispatch_Register_Telemetry_Instance(&receiver));
+
+    KSRP_Telemetry_MotorStatus_Frame frame = motor_status(3, 1);
+    uint32_t deltas = 0;
+    uint32_t keyframes = 0;
+    bool synced = true;
+    for (uint32_t i = 0; i < UPDATES; i++) {
+        // Change a single field, every tenth frame is lost and the receiver is resynced by the next keyframe
+        switch (i % 3) {
+            case 0: frame.counter++; break;
+            case 1: frame.mode = (uint8_t)((frame.mode + 1) % 3); break;
+            default: frame.current = (int16_t)(frame.current + 37); break;
+        }
+        sent_count = 0;
+        drop_sent = i % 10 == 7;
+        CHECK_OK(KSRP_UpdateFrame_Telemetry_Instance(&sender, KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID, &frame,
+                                                     sizeof(frame)));
+        CHECK(sent_count == 1);
+
+        const bool keyframe = !KSRP_Delta_IsDelta(&sent[0]);
+        keyframes += keyframe;
+        deltas += !keyframe;
+        synced = drop_sent ? false : synced || keyframe;
+        if (synced) {
+            CHECK(memcmp(&receiver.motor_status_instance[3], &frame, sizeof(frame)) == 0);
+        }
+    }
+
+    // Keyframe after every KSRP_TELEMETRY_KEYFRAME_INTERVAL deltas
+    CHECK(keyframes == (UPDATES + KSRP_TELEMETRY_KEYFRAME_INTERVAL) / (KSRP_TELEMETRY_KEYFRAME_INTERVAL + 1));
+    CHECK(deltas == UPDATES - keyframes);
+    CHECK(synced);
+}
+
+int main(void) {
+    RUN_TEST(test_bit_packed_delta_of_every_field_subset);
+    RUN_TEST(test_byte_aligned_delta_of_every_field_subset);
+    RUN_TEST(test_invalid_delta_leaves_frame_untouched);
+    RUN_TEST(test_receiver_follows_sender);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,219 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ksrp/host/fleet_store.h"
+#include "ksrp/protocols/protocol_utils.h"
+#include "ksrp_test.h"
+
+// Not a multiple of the thread counts, so the last shard is shorter
+#define VEHICLES 37
+#define START_MS 1000
+#define KEYFRAME_MS 1100
+#define DELTA_MS 1120
+#define SWEEP_MS 1150
+#define MAX_FRAMES (VEHICLES * (2 * KSRP_TELEMETRY_MAX_DEVICES + 4) + 2)
+
+static KSRP_FleetFrame frames[MAX_FRAMES];
+static size_t frames_count;
+static uint32_t stale_ages[VEHICLES][KSRP_TELEMETRY_MAX_DEVICES];
+static KSRP_HealthCheckResult motor_health[VEHICLES][KSRP_TELEMETRY_MAX_DEVICES];
+static uint64_t motor_failing_fields[VEHICLES][KSRP_TELEMETRY_MAX_DEVICES];
+
+static void add_frame(uint32_t vehicle, uint32_t timestamp_ms, const KSRP_RawData_Frame* frame) {
+    CHECK(frames_count < MAX_FRAMES);
+    frames[frames_count++] = (KSRP_FleetFrame){vehicle, timestamp_ms, *frame};
+}
+
+static KSRP_Telemetry_MotorStatus_Frame motor_status(uint32_t vehicle, uint8_t device_id) {
+    KSRP_Telemetry_MotorStatus_Frame frame;
+    KSRP_Init_Telemetry_MotorStatus_Frame(&frame);
+    frame.device_id = device_id;
+    frame.counter = vehicle * 16 + device_id;
+    frame.mode = (uint8_t)(vehicle % 3);
+    return frame;
+}
+
+// Keyframes of motor status for even vehicles, power status and limits of some vehicles, deltas come in a later
+// round so frames of every vehicle are spread over the whole batch
+static void make_frames(void) {
+    KSRP_RawData_Frame raw;
+    frames_count = 0;
+
+    for (uint32_t vehicle = 0; vehicle < VEHICLES; vehicle++) {
+        for (uint8_t device_id = 0; device_id < KSRP_TELEMETRY_MAX_DEVICES && vehicle % 2 == 0; device_id++) {
+            const KSRP_Telemetry_MotorStatus_Frame frame = motor_status(vehicle, device_id);
+            CHECK_OK(KSRP_Pack_Telemetry_MotorStatus(&frame, &raw));
+            add_frame(vehicle, KEYFRAME_MS, &raw);
+        }
+
+        KSRP_Telemetry_PowerStatus_Frame power_status;
+        KSRP_Init_Telemetry_PowerStatus_Frame(&power_status);
+        power_status.device_id = (uint8_t)(vehicle % KSRP_TELEMETRY_MAX_DEVICES);
+        power_status.energy = (uint64_t)vehicle << 33;
+        CHECK_OK(KSRP_Pack_Telemetry_PowerStatus(&power_status, &raw));
+        add_frame(vehicle, KEYFRAME_MS, &raw);
+
+        if (vehicle % 3 == 0) {
+            KSRP_Limits_Levels_Frame levels;
+            KSRP_Init_Limits_Levels_Frame(&levels);
+            levels.u16 = (uint16_t)(vehicle * 1000);
+            levels.f32 = (float)vehicle;
+            CHECK_OK(KSRP_Pack_Limits_Levels(&levels, &raw));
+            add_frame(vehicle, KEYFRAME_MS, &raw);
+        }
+    }
+
+    for (uint32_t vehicle = 0; vehicle < VEHICLES; vehicle += 4) {
+        for (uint8_t device_id = 0; device_id < KSRP_TELEMETRY_MAX_DEVICES; device_id++) {
+            KSRP_Telemetry_MotorStatus_Frame frame = motor_status(vehicle, device_id);
+            frame.counter += 1000;
+            CHECK_OK(KSRP_PackDelta_Telemetry_MotorStatus(
+                &frame, (uint64_t)1 << KSRP_TELEMETRY_MOTOR_STATUS_COUNTER_FIELD_ID, &raw));
+            add_frame(vehicle, DELTA_MS, &raw);
+        }
+    }
+
+    // Device and vehicle out of range fail without touching the store
+    KSRP_Telemetry_MotorStatus_Frame invalid = motor_status(5, KSRP_TELEMETRY_MAX_DEVICES);
+    CHECK_OK(KSRP_Pack_Telemetry_MotorStatus(&invalid, &raw));
+    add_frame(5, KEYFRAME_MS, &raw);
+    add_frame(VEHICLES + 2, KEYFRAME_MS, &raw);
+}
+
+#define CHECK_SAME_ARRAY(member, devices)                                                                      \
+    do {                                                                                                       \
+        CHECK(memcmp(store->member, expected->member, VEHICLES * (devices) * sizeof(store->member[0])) == 0);  \
+        CHECK(memcmp(store->member##_updated_ms, expected->member##_updated_ms,                                \
+                     VEHICLES * (devices) * sizeof(uint32_t)) == 0);                                           \
+    } while (0)
+
+static void check_same_store(const KSRP_FleetStore* store, const KSRP_FleetStore* expected) {
+    CHECK_SAME_ARRAY(telemetry_motor_status, KSRP_TELEMETRY_MAX_DEVICES);
+    CHECK_SAME_ARRAY(telemetry_power_status, KSRP_TELEMETRY_MAX_DEVICES);
+    CHECK_SAME_ARRAY(limits_levels, 1);
+    CHECK_SAME_ARRAY(thermal_sensors, 1);
+    CHECK_SAME_ARRAY(control_setpoint, 1);
+}
+
+static void record_stale(uint32_t vehicle, KSRP_TypeID type_id, uint8_t device_id, uint32_t age_ms, void* context) {
+    (void)context;
+    CHECK(vehicle < VEHICLES);
+    CHECK(type_id == KSRP_TELEMETRY_MOTOR_STATUS_TYPE_ID);
+    CHECK(device_id < KSRP_TELEMETRY_MAX_DEVICES);
+    stale_ages[vehicle][device_id] = age_ms;
+}
+
+static void record_health(uint32_t vehicle, KSRP_TypeID type_id, uint8_t device_id, KSRP_HealthCheckResult previous,
+                          KSRP_HealthCheckResult current, uint64_t failing_fields, void* context) {
+    (void)context;
+    CHECK(vehicle < VEHICLES);
+    CHECK(previous != current);
+    if (type_id == KSRP_TELEMETRY_MOTOR_STATUS_TYPE_ID) {
+        CHECK(device_id < KSRP_TELEMETRY_MAX_DEVICES);
+        CHECK(motor_health[vehicle][device_id] == previous);
+        motor_health[vehicle][device_id] = current;
+        motor_failing_fields[vehicle][device_id] = failing_fields;
+    }
+}
+
+static void test_batch_update_matches_sequential(void) {
+    const uint32_t threads[] = {1, 2, 4, 7};
+    KSRP_FleetStore expected;
+    KSRP_FleetStore store;
+    KSRP_FleetUpdateStats stats;
+
+    make_frames();
+    CHECK_OK(KSRP_FleetStore_Init(&expected, VEHICLES, START_MS));
+    uint64_t failed = 0;
+    for (size_t i = 0; i < frames_count; i++) {
+        failed += KSRP_FleetStore_Update(&expected, frames[i].vehicle, &frames[i].frame, frames[i].timestamp_ms) !=
+                  KSRP_STATUS_OK;
+    }
+    CHECK(failed == 2);
+
+    // Deltas patched the keyframes received earlier in the batch
+    const size_t slot = 8 * KSRP_TELEMETRY_MAX_DEVICES + 3;
+    CHECK(expected.telemetry_motor_status[slot].counter == 8 * 16 + 3 + 1000);
+    CHECK(expected.telemetry_motor_status[slot].mode == 8 % 3);
+    CHECK(expected.telemetry_motor_status_updated_ms[slot] == DELTA_MS);
+    CHECK(expected.telemetry_motor_status[5 * KSRP_TELEMETRY_MAX_DEVICES].counter == 0);
+
+    for (uint32_t t = 0; t < sizeof(threads) / sizeof(threads[0]); t++) {
+        CHECK_OK(KSRP_FleetStore_Init(&store, VEHICLES, START_MS));
+        KSRP_FleetStore_UpdateBatch(&store, frames, frames_count, threads[t], &stats);
+        CHECK(stats.applied == frames_count - 2);
+        CHECK(stats.failed == 2);
+        check_same_store(&store, &expected);
+        KSRP_FleetStore_Free(&store);
+    }
+
+    KSRP_FleetStore_Free(&expected);
+}
+
+static void test_sweeps(void) {
+    KSRP_FleetStore store;
+    KSRP_FleetSweepStats stats;
+    KSRP_RawData_Frame raw;
+
+    make_frames();
+    CHECK_OK(KSRP_FleetStore_Init(&store, VEHICLES, START_MS));
+    KSRP_FleetStore_UpdateBatch(&store, frames, frames_count, 4, NULL);
+
+    // Motor status of odd vehicles was never received, power status timeout is longer than the sweep time
+    memset(stale_ages, 0, sizeof(stale_ages));
+    KSRP_FleetStore_SweepStale(&store, SWEEP_MS, record_stale, NULL, 4, &stats);
+    CHECK(stats.stale == VEHICLES / 2 * KSRP_TELEMETRY_MAX_DEVICES);
+    for (uint32_t vehicle = 0; vehicle < VEHICLES; vehicle++) {
+        for (uint32_t device_id = 0; device_id < KSRP_TELEMETRY_MAX_DEVICES; device_id++) {
+            CHECK(stale_ages[vehicle][device_id] == (vehicle % 2 ? SWEEP_MS - START_MS : 0));
+        }
+    }
+
+    // First sweep reports every frame with health checks, results of the second one are cached
+    for (uint32_t vehicle = 0; vehicle < VEHICLES; vehicle++) {
+        for (uint32_t device_id = 0; device_id < KSRP_TELEMETRY_MAX_DEVICES; device_id++) {
+            motor_health[vehicle][device_id] = KSRP_RESULT_UNKNOWN;
+        }
+    }
+    KSRP_FleetStore_SweepHealth(&store, record_health, NULL, 4, &stats);
+    CHECK(stats.transitions == VEHICLES * (2 * KSRP_TELEMETRY_MAX_DEVICES + 2));
+    for (uint32_t vehicle = 0; vehicle < VEHICLES; vehicle++) {
+        for (uint32_t device_id = 0; device_id < KSRP_TELEMETRY_MAX_DEVICES; device_id++) {
+            CHECK(motor_health[vehicle][device_id] == KSRP_RESULT_OK);
+        }
+    }
+    const KSRP_FleetSweepStats first = stats;
+    KSRP_FleetStore_SweepHealth(&store, record_health, NULL, 3, &stats);
+    CHECK(stats.transitions == 0);
+    CHECK(stats.warning == first.warning);
+    CHECK(stats.critical == first.critical);
+
+    // Overheating motors of every fifth vehicle
+    frames_count = 0;
+    for (uint32_t vehicle = 0; vehicle < VEHICLES; vehicle += 5) {
+        KSRP_Telemetry_MotorStatus_Frame frame = motor_status(vehicle, 1);
+        frame.temperature = 90.0f;
+        CHECK_OK(KSRP_Pack_Telemetry_MotorStatus(&frame, &raw));
+        add_frame(vehicle, SWEEP_MS, &raw);
+    }
+    KSRP_FleetStore_UpdateBatch(&store, frames, frames_count, 4, NULL);
+    KSRP_FleetStore_SweepHealth(&store, record_health, NULL, 4, &stats);
+    CHECK(stats.transitions == frames_count);
+    CHECK(stats.warning == first.warning + frames_count);
+    for (uint32_t vehicle = 0; vehicle < VEHICLES; vehicle++) {
+        const bool overheated = vehicle % 5 == 0;
+        CHECK(motor_health[vehicle][1] == (overheated ? KSRP_RESULT_WARNING : KSRP_RESULT_OK));
+        if (overheated) {
+            CHECK(motor_failing_fields[vehicle][1] == (uint64_t)1 << KSRP_TELEMETRY_MOTOR_STATUS_TEMPERATURE_FIELD_ID);
+        }
+    }
+
+    KSRP_FleetStore_Free(&store);
+}
+
+int main(void) {
+    RUN_TEST(test_batch_update_matches_sequential);
+    RUN_TEST(test_sweeps);
+    return EXIT_SUCCESS;
+}
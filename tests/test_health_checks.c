@@ -0,0 +1,182 @@
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+
+#include "ksrp/protocols/protocol_utils.h"
+#include "ksrp_test.h"
+
+#define RANDOM_VALUES 20000
+#define MAX_TAIL 19
+#define TAIL_OFFSETS 8
+#define RESULT_UNTOUCHED ((KSRP_HealthCheckResult)(KSRP_RESULT_UNKNOWN + 1))
+
+// Health check of the protocol definition, evaluated as an if-chain over exact values without any conversion
+typedef struct {
+    bool exact;
+    long double min;
+    long double max;
+    KSRP_HealthCheckResult result;
+} ReferenceCheck;
+
+#define EXACT(value, result) {true, (value), (value), KSRP_RESULT_##result}
+#define RANGE(min, max, result) {false, (min), (max), KSRP_RESULT_##result}
+#define CHECKS_COUNT(checks) (sizeof(checks) / sizeof(checks[0]))
+
+static const ReferenceCheck u8_checks[] = {
+    RANGE(KSRP_LIMITS_LEVELS_U8_HEALTH_CHECK_OK_1_MIN, KSRP_LIMITS_LEVELS_U8_HEALTH_CHECK_OK_1_MAX, OK),
+    RANGE(KSRP_LIMITS_LEVELS_U8_HEALTH_CHECK_WARNING_2_MIN, KSRP_LIMITS_LEVELS_U8_HEALTH_CHECK_WARNING_2_MAX, WARNING),
+};
+static const ReferenceCheck u16_checks[] = {
+    EXACT(KSRP_LIMITS_LEVELS_U16_HEALTH_CHECK_CRITICAL_1, CRITICAL),
+    RANGE(KSRP_LIMITS_LEVELS_U16_HEALTH_CHECK_OK_2_MIN, KSRP_LIMITS_LEVELS_U16_HEALTH_CHECK_OK_2_MAX, OK),
+    RANGE(KSRP_LIMITS_LEVELS_U16_HEALTH_CHECK_WARNING_3_MIN, KSRP_LIMITS_LEVELS_U16_HEALTH_CHECK_WARNING_3_MAX, WARNING),
+    EXACT(KSRP_LIMITS_LEVELS_U16_HEALTH_CHECK_CRITICAL_4, CRITICAL),
+};
+static const ReferenceCheck i16_checks[] = {
+    RANGE(KSRP_LIMITS_LEVELS_I16_HEALTH_CHECK_CRITICAL_1_MIN, KSRP_LIMITS_LEVELS_I16_HEALTH_CHECK_CRITICAL_1_MAX, CRITICAL),
+    RANGE(KSRP_LIMITS_LEVELS_I16_HEALTH_CHECK_OK_2_MIN, KSRP_LIMITS_LEVELS_I16_HEALTH_CHECK_OK_2_MAX, OK),
+    EXACT(KSRP_LIMITS_LEVELS_I16_HEALTH_CHECK_CRITICAL_3, CRITICAL),
+    RANGE(KSRP_LIMITS_LEVELS_I16_HEALTH_CHECK_WARNING_4_MIN, KSRP_LIMITS_LEVELS_I16_HEALTH_CHECK_WARNING_4_MAX, WARNING),
+};
+static const ReferenceCheck u32_checks[] = {
+    RANGE(KSRP_LIMITS_LEVELS_U32_HEALTH_CHECK_OK_1_MIN, KSRP_LIMITS_LEVELS_U32_HEALTH_CHECK_OK_1_MAX, OK),
+    RANGE(KSRP_LIMITS_LEVELS_U32_HEALTH_CHECK_CRITICAL_2_MIN, KSRP_LIMITS_LEVELS_U32_HEALTH_CHECK_CRITICAL_2_MAX, CRITICAL),
+};
+static const ReferenceCheck i32_checks[] = {
+    RANGE(KSRP_LIMITS_LEVELS_I32_HEALTH_CHECK_WARNING_1_MIN, KSRP_LIMITS_LEVELS_I32_HEALTH_CHECK_WARNING_1_MAX, WARNING),
+    EXACT(KSRP_LIMITS_LEVELS_I32_HEALTH_CHECK_CRITICAL_2, CRITICAL),
+    RANGE(KSRP_LIMITS_LEVELS_I32_HEALTH_CHECK_OK_3_MIN, KSRP_LIMITS_LEVELS_I32_HEALTH_CHECK_OK_3_MAX, OK),
+};
+static const ReferenceCheck u64_checks[] = {
+    RANGE(KSRP_LIMITS_LEVELS_U64_HEALTH_CHECK_OK_1_MIN, KSRP_LIMITS_LEVELS_U64_HEALTH_CHECK_OK_1_MAX, OK),
+    RANGE(KSRP_LIMITS_LEVELS_U64_HEALTH_CHECK_WARNING_2_MIN, KSRP_LIMITS_LEVELS_U64_HEALTH_CHECK_WARNING_2_MAX, WARNING),
+};
+static const ReferenceCheck i64_checks[] = {
+    RANGE(KSRP_LIMITS_LEVELS_I64_HEALTH_CHECK_CRITICAL_1_MIN, KSRP_LIMITS_LEVELS_I64_HEALTH_CHECK_CRITICAL_1_MAX, CRITICAL),
+    RANGE(KSRP_LIMITS_LEVELS_I64_HEALTH_CHECK_OK_2_MIN, KSRP_LIMITS_LEVELS_I64_HEALTH_CHECK_OK_2_MAX, OK),
+};
+static const ReferenceCheck f32_checks[] = {
+    EXACT(KSRP_LIMITS_LEVELS_F32_HEALTH_CHECK_CRITICAL_1, CRITICAL),
+    RANGE(KSRP_LIMITS_LEVELS_F32_HEALTH_CHECK_WARNING_2_MIN, KSRP_LIMITS_LEVELS_F32_HEALTH_CHECK_WARNING_2_MAX, WARNING),
+    RANGE(KSRP_LIMITS_LEVELS_F32_HEALTH_CHECK_OK_3_MIN, KSRP_LIMITS_LEVELS_F32_HEALTH_CHECK_OK_3_MAX, OK),
+    RANGE(KSRP_LIMITS_LEVELS_F32_HEALTH_CHECK_CRITICAL_4_MIN, KSRP_LIMITS_LEVELS_F32_HEALTH_CHECK_CRITICAL_4_MAX, CRITICAL),
+};
+
+static KSRP_HealthCheckResult reference(const ReferenceCheck* checks, size_t count, long double value) {
+    for (size_t i = 0; i < count; i++) {
+        if (checks[i].exact ? value == checks[i].min : value >= checks[i].min && value < checks[i].max) {
+            return checks[i].result;
+        }
+    }
+    return KSRP_RESULT_UNKNOWN;
+}
+
+static uint64_t random_state = 0x9E3779B97F4A7C15ull;
+
+static uint64_t random_bits(void) {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return random_state;
+}
+
+// Batches shorter than the vector width and not a multiple of it, starting at every offset within a vector, so the
+// values at the start of the array (type limits, NaN) go through both vector and scalar tail and nothing past the
+// count is written
+#define CHECK_BATCH_TAILS(name, values)                                                                     \
+    do {                                                                                                    \
+        KSRP_HealthCheckResult tail[MAX_TAIL + 1];                                                          \
+        for (uint32_t offset = 0; offset < TAIL_OFFSETS; offset++) {                                        \
+            for (uint32_t length = 0; length <= MAX_TAIL; length++) {                                       \
+                for (uint32_t i = 0; i <= MAX_TAIL; i++) {                                                  \
+                    tail[i] = RESULT_UNTOUCHED;                                                             \
+                }                                                                                           \
+                KSRP_HealthCheckResultBatch_Limits_Levels_##name(&values[offset], length, tail);            \
+                for (uint32_t i = 0; i < length; i++) {                                                     \
+                    CHECK(tail[i] == KSRP_HealthCheckResultOfValue_Limits_Levels_##name(values[offset + i])); \
+                }                                                                                           \
+                CHECK(tail[length] == RESULT_UNTOUCHED);                                                    \
+            }                                                                                               \
+        }                                                                                                   \
+    } while (0)
+
+// Values of the type near every bound of the checks, the type limits and random values of all magnitudes
+#define TEST_FIELD(type, type_min, type_max, name, checks)                                                   \
+    static void test_##name(void) {                                                                         \
+        static type values[RANDOM_VALUES + 8 * CHECKS_COUNT(checks) + 4];                                   \
+        static KSRP_HealthCheckResult results[sizeof(values) / sizeof(values[0])];                          \
+        uint32_t count = 0;                                                                                 \
+        values[count++] = type_min;                                                                         \
+        values[count++] = type_max;                                                                         \
+        values[count++] = (type)(type_min + 1);                                                             \
+        values[count++] = (type)(type_max - 1);                                                             \
+        for (size_t i = 0; i < CHECKS_COUNT(checks); i++) {                                                 \
+            const long double bounds[] = {checks[i].min, checks[i].max};                                    \
+            for (uint32_t b = 0; b < 2; b++) {                                                              \
+                for (int delta = -1; delta <= 2; delta++) {                                                 \
+                    const long double value = bounds[b] + delta;                                            \
+                    if (value >= (long double)type_min && value <= (long double)type_max) {                 \
+                        values[count++] = (type)value;                                                      \
+                    }                                                                                       \
+                }                                                                                           \
+            }                                                                                               \
+        }                                                                                                   \
+        while (count < sizeof(values) / sizeof(values[0])) {                                                \
+            const uint64_t bits = random_bits();                                                            \
+            values[count++] = (type)(bits >> (bits % 64));                                                  \
+        }                                                                                                   \
+                                                                                                            \
+        KSRP_HealthCheckResultBatch_Limits_Levels_##name(values, count, results);                           \
+        for (uint32_t i = 0; i < count; i++) {                                                              \
+            const KSRP_HealthCheckResult expected = reference(checks, CHECKS_COUNT(checks), values[i]);     \
+            CHECK(KSRP_HealthCheckResultOfValue_Limits_Levels_##name(values[i]) == expected);               \
+            CHECK(results[i] == expected);                                                                  \
+        }                                                                                                   \
+        CHECK_BATCH_TAILS(name, values);                                                                    \
+    }
+
+TEST_FIELD(uint8_t, 0, UINT8_MAX, U8, u8_checks)
+TEST_FIELD(uint16_t, 0, UINT16_MAX, U16, u16_checks)
+TEST_FIELD(int16_t, INT16_MIN, INT16_MAX, I16, i16_checks)
+TEST_FIELD(uint32_t, 0, UINT32_MAX, U32, u32_checks)
+TEST_FIELD(int32_t, INT32_MIN, INT32_MAX, I32, i32_checks)
+TEST_FIELD(uint64_t, 0, UINT64_MAX, U64, u64_checks)
+TEST_FIELD(int64_t, INT64_MIN, INT64_MAX, I64, i64_checks)
+
+static void test_f32(void) {
+    static float values[RANDOM_VALUES];
+    static KSRP_HealthCheckResult results[RANDOM_VALUES];
+    // Neighbours of bounds which aren't representable as float, whose nearest float lies on the other side
+    const float special[] = {NAN,           -INFINITY,         INFINITY,         -1e30f,
+                             nextafterf(-1e30f, 0.0f), nextafterf(-1e30f, -INFINITY), 0.1f, nextafterf(0.1f, 0.0f),
+                             -0.0f,         0.0f,              100.5f,           nextafterf(100.5f, 0.0f),
+                             -FLT_MAX,      FLT_MAX};
+    uint32_t count = 0;
+    for (; count < sizeof(special) / sizeof(special[0]); count++) {
+        values[count] = special[count];
+    }
+    while (count < RANDOM_VALUES) {
+        const uint64_t bits = random_bits();
+        values[count++] = (float)((double)(int64_t)bits / (double)(1ull << (bits % 63)));
+    }
+
+    KSRP_HealthCheckResultBatch_Limits_Levels_F32(values, count, results);
+    for (uint32_t i = 0; i < count; i++) {
+        const KSRP_HealthCheckResult expected = reference(f32_checks, CHECKS_COUNT(f32_checks), values[i]);
+        CHECK(KSRP_HealthCheckResultOfValue_Limits_Levels_F32(values[i]) == expected);
+        CHECK(results[i] == expected);
+    }
+    CHECK_BATCH_TAILS(F32, values);
+}
+
+int main(void) {
+    RUN_TEST(test_U8);
+    RUN_TEST(test_U16);
+    RUN_TEST(test_I16);
+    RUN_TEST(test_U32);
+    RUN_TEST(test_I32);
+    RUN_TEST(test_U64);
+    RUN_TEST(test_I64);
+    RUN_TEST(test_f32);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,150 @@
+#include <stdint.h>
+
+#include "ksrp/protocols/protocol_utils.h"
+#include "ksrp_test.h"
+
+#define OSCILLATIONS 50
+
+typedef struct {
+    uint32_t field_id;
+    KSRP_HealthCheckResult previous;
+    KSRP_HealthCheckResult current;
+} Transition;
+
+static KSRP_Thermal_Instance instance;
+static Transition transitions[16];
+static uint32_t transitions_count;
+
+static KSRP_Status record_transition(uint32_t subsystem_id, void* frame_instance, uint32_t frame_id,
+                                     uint32_t field_id, KSRP_HealthCheckResult previous,
+                                     KSRP_HealthCheckResult current) {
+    CHECK(subsystem_id == KSRP_THERMAL_SUBSYSTEM_ID);
+    CHECK(frame_instance == &instance.sensors_instance);
+    CHECK(frame_id == KSRP_THERMAL_SENSORS_FRAME_ID);
+    CHECK(previous != current);
+    CHECK(transitions_count < sizeof(transitions) / sizeof(transitions[0]));
+    transitions[transitions_count++] = (Transition){field_id, previous, current};
+    return KSRP_STATUS_OK;
+}
+
+static void init_instance(void) {
+    CHECK_OK(KSRP_Init_Thermal_Instance(&instance));
+    CHECK_OK(KSRP_Thermal_Instance_SetHealthCallback(&instance, KSRP_THERMAL_SENSORS_FRAME_ID, record_transition));
+    transitions_count = 0;
+}
+
+static KSRP_HealthCheckResult temperature_health(void) {
+    return KSRP_Thermal_Instance_GetHealth(&instance, KSRP_THERMAL_SENSORS_FRAME_ID,
+                                          KSRP_THERMAL_SENSORS_TEMPERATURE_FIELD_ID);
+}
+
+static void set_temperature(float temperature) {
+    CHECK_OK(KSRP_UpdateFrameField_Thermal_Instance(&instance, KSRP_THERMAL_SENSORS_FRAME_ID,
+                                                    KSRP_THERMAL_SENSORS_TEMPERATURE_FIELD_ID, &temperature,
+                                                    sizeof(temperature)));
+}
+
+static void set_pressure(uint16_t pressure) {
+    KSRP_Thermal_Sensors_Frame frame = instance.sensors_instance;
+    frame.pressure = pressure;
+    CHECK_OK(KSRP_UpdateFrame_Thermal_Instance(&instance, KSRP_THERMAL_SENSORS_FRAME_ID, &frame, sizeof(frame)));
+}
+
+static void check_transition(uint32_t index, uint32_t field_id, KSRP_HealthCheckResult previous,
+                             KSRP_HealthCheckResult current) {
+    CHECK(index < transitions_count);
+    CHECK(transitions[index].field_id == field_id);
+    CHECK(transitions[index].previous == previous);
+    CHECK(transitions[index].current == current);
+}
+
+static void test_worse_result_applies_at_once(void) {
+    init_instance();
+    CHECK(temperature_health() == KSRP_RESULT_OK);
+
+    // Just past the threshold, no margin is needed to get worse
+    set_temperature(80.0f);
+    CHECK(temperature_health() == KSRP_RESULT_WARNING);
+    set_temperature(100.0f);
+    CHECK(temperature_health() == KSRP_RESULT_CRITICAL);
+    CHECK(transitions_count == 2);
+    check_transition(0, KSRP_THERMAL_SENSORS_TEMPERATURE_FIELD_ID, KSRP_RESULT_OK, KSRP_RESULT_WARNING);
+    check_transition(1, KSRP_THERMAL_SENSORS_TEMPERATURE_FIELD_ID, KSRP_RESULT_WARNING, KSRP_RESULT_CRITICAL);
+
+    // Skipping a band
+    init_instance();
+    set_temperature(150.0f);
+    CHECK(transitions_count == 1);
+    check_transition(0, KSRP_THERMAL_SENSORS_TEMPERATURE_FIELD_ID, KSRP_RESULT_OK, KSRP_RESULT_CRITICAL);
+}
+
+static void test_better_result_applies_past_margin(void) {
+    init_instance();
+    set_temperature(120.0f);
+    transitions_count = 0;
+
+    // Within the margin of the critical band
+    set_temperature(99.0f);
+    set_temperature(98.0f);
+    CHECK(temperature_health() == KSRP_RESULT_CRITICAL);
+    CHECK(transitions_count == 0);
+
+    set_temperature(97.9f);
+    CHECK(temperature_health() == KSRP_RESULT_WARNING);
+    CHECK(transitions_count == 1);
+    check_transition(0, KSRP_THERMAL_SENSORS_TEMPERATURE_FIELD_ID, KSRP_RESULT_CRITICAL, KSRP_RESULT_WARNING);
+
+    set_temperature(78.0f);
+    CHECK(temperature_health() == KSRP_RESULT_WARNING);
+    set_temperature(77.9f);
+    CHECK(temperature_health() == KSRP_RESULT_OK);
+    CHECK(transitions_count == 2);
+    check_transition(1, KSRP_THERMAL_SENSORS_TEMPERATURE_FIELD_ID, KSRP_RESULT_WARNING, KSRP_RESULT_OK);
+
+    // Value far from the critical band drops straight to OK
+    set_temperature(120.0f);
+    set_temperature(50.0f);
+    CHECK(temperature_health() == KSRP_RESULT_OK);
+    CHECK(transitions_count == 4);
+    check_transition(3, KSRP_THERMAL_SENSORS_TEMPERATURE_FIELD_ID, KSRP_RESULT_CRITICAL, KSRP_RESULT_OK);
+}
+
+static void test_noisy_value_does_not_flap(void) {
+    init_instance();
+    for (uint32_t i = 0; i < OSCILLATIONS; i++) {
+        set_temperature(i % 2 ? 79.5f : 80.5f);
+    }
+    CHECK(temperature_health() == KSRP_RESULT_WARNING);
+    CHECK(transitions_count == 1);
+
+    // Same for integer field, margin is clamped at the limits of the type
+    for (uint32_t i = 0; i < OSCILLATIONS; i++) {
+        set_pressure(i % 2 ? 995 : 1003);
+    }
+    CHECK(transitions_count == 2);
+    check_transition(1, KSRP_THERMAL_SENSORS_PRESSURE_FIELD_ID, KSRP_RESULT_OK, KSRP_RESULT_CRITICAL);
+    set_pressure(990);
+    CHECK(KSRP_Thermal_Instance_GetHealth(&instance, KSRP_THERMAL_SENSORS_FRAME_ID,
+                                          KSRP_THERMAL_SENSORS_PRESSURE_FIELD_ID) == KSRP_RESULT_CRITICAL);
+    set_pressure(989);
+    CHECK(transitions_count == 3);
+    check_transition(2, KSRP_THERMAL_SENSORS_PRESSURE_FIELD_ID, KSRP_RESULT_CRITICAL, KSRP_RESULT_OK);
+
+    set_pressure(UINT16_MAX);
+    set_pressure(UINT16_MAX - 5);
+    set_pressure(5);
+    CHECK(transitions_count == 5);
+    check_transition(4, KSRP_THERMAL_SENSORS_PRESSURE_FIELD_ID, KSRP_RESULT_CRITICAL, KSRP_RESULT_OK);
+
+    // Update without change re-evaluates nothing
+    set_pressure(5);
+    set_temperature(79.5f);
+    CHECK(transitions_count == 5);
+}
+
+int main(void) {
+    RUN_TEST(test_worse_result_applies_at_once);
+    RUN_TEST(test_better_result_applies_past_margin);
+    RUN_TEST(test_noisy_value_does_not_flap);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,269 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ksrp/endianness.h"
+#include "ksrp/host/pipeline.h"
+#include "ksrp/protocols/protocol_utils.h"
+#include "ksrp_test.h"
+
+#define FRAMES 5000
+// Timestamps are shuffled only within aligned blocks, so chunks of the sizes below never split a block
+#define SHUFFLE_BLOCK 8
+
+typedef struct {
+    uint64_t timestamp;
+    uint32_t index;
+} Decoded;
+
+typedef struct {
+    uint32_t* applied;
+    uint32_t applied_count;
+    uint64_t last_timestamp;
+    bool ordered;
+    uint32_t fail_decode_every;
+    uint32_t fail_apply_every;
+    uint32_t slow_frames;
+} Context;
+
+static KSRP_TimedFrame recording[FRAMES];
+static uint32_t expected[FRAMES];
+
+static uint32_t frame_index(const KSRP_TimedFrame* frame) {
+    return KSRP_LoadLE32(&frame->frame.data[KSRP_ID_BYTES]);
+}
+
+static KSRP_Status decode(const KSRP_TimedFrame* frame, void* decoded, void* context) {
+    const Context* ctx = context;
+    Decoded* result = decoded;
+    result->timestamp = frame->timestamp;
+    result->index = frame_index(frame);
+
+    if (result->index < ctx->slow_frames) {
+        nanosleep(&(struct timespec){0, 100000}, NULL);
+    }
+    return ctx->fail_decode_every && result->index % ctx->fail_decode_every == 0 ? KSRP_STATUS_ERROR : KSRP_STATUS_OK;
+}
+
+static KSRP_Status apply(const void* decoded, uint64_t timestamp, void* context) {
+    Context* ctx = context;
+    const Decoded* result = decoded;
+    CHECK(result->timestamp == timestamp);
+    if (timestamp < ctx->last_timestamp) {
+        ctx->ordered = false;
+    }
+    ctx->last_timestamp = timestamp;
+    ctx->applied[ctx->applied_count++] = result->index;
+    return ctx->fail_apply_every && result->index % ctx->fail_apply_every == 0 ? KSRP_STATUS_ERROR : KSRP_STATUS_OK;
+}
+
+// Recording with runs of equal timestamps, shuffled within blocks as if frames of several buses were interleaved
+static void make_recording(void) {
+    uint32_t random = 7;
+    for (uint32_t i = 0; i < FRAMES; i++) {
+        recording[i].timestamp = 1000 + (i / SHUFFLE_BLOCK) * 10;
+        if (i % SHUFFLE_BLOCK != 0) {
+            random = random * 1103515245u + 12345u;
+            recording[i].timestamp += (random >> 16) % 4;
+        }
+        KSRP_RawDataFrame_Init(&recording[i].frame);
+        recording[i].frame.data[0] = 1;
+        recording[i].frame.data[1] = 1;
+        KSRP_StoreLE32(&recording[i].frame.data[KSRP_ID_BYTES], i);
+        recording[i].frame.length = KSRP_ID_BYTES + sizeof(uint32_t);
+    }
+
+    // Stable insertion sort by timestamp gives the expected apply order
+    for (uint32_t i = 0; i < FRAMES; i++) {
+        uint32_t position = i;
+        while (position > 0 && recording[expected[position - 1]].timestamp > recording[i].timestamp) {
+            expected[position] = expected[position - 1];
+            position--;
+        }
+        expected[position] = i;
+    }
+}
+
+static KSRP_PipelineConfig config_of(Context* context, uint32_t threads, uint32_t chunk_frames) {
+    return (KSRP_PipelineConfig){
+        .threads = threads,
+        .chunk_frames = chunk_frames,
+        .decoded_size = sizeof(Decoded),
+        .decode = decode,
+        .apply = apply,
+        .context = context,
+    };
+}
+
+static void run(Context* context, uint32_t threads, uint32_t chunk_frames, size_t frames_count,
+                KSRP_PipelineStats* stats) {
+    context->applied_count = 0;
+    context->last_timestamp = 0;
+    context->ordered = true;
+    const KSRP_PipelineConfig config = config_of(context, threads, chunk_frames);
+    CHECK_OK(KSRP_Pipeline_Run(&config, recording, frames_count, stats));
+}
+
+static void test_applies_in_timestamp_order(void) {
+    static uint32_t applied[FRAMES];
+    const uint32_t threads[] = {1, 2, 3, 8};
+    const uint32_t chunk_frames[] = {SHUFFLE_BLOCK, 3 * SHUFFLE_BLOCK, 1024};
+    Context context = {.applied = applied};
+
+    for (uint32_t t = 0; t < sizeof(threads) / sizeof(threads[0]); t++) {
+        for (uint32_t c = 0; c < sizeof(chunk_frames) / sizeof(chunk_frames[0]); c++) {
+            KSRP_PipelineStats stats;
+            run(&context, threads[t], chunk_frames[c], FRAMES, &stats);
+            CHECK(context.ordered);
+            CHECK(context.applied_count == FRAMES);
+            CHECK(memcmp(applied, expected, sizeof(expected)) == 0);
+            CHECK(stats.frames == FRAMES && stats.decode_failed == 0 && stats.apply_failed == 0);
+            CHECK(threads[t] > 1 || stats.stolen_chunks == 0);
+        }
+    }
+}
+
+static void test_short_recordings(void) {
+    static uint32_t applied[FRAMES];
+    Context context = {.applied = applied};
+    KSRP_PipelineStats stats;
+
+    // Shorter than a single chunk and than a single window of the default configuration
+    run(&context, 4, 0, 1, &stats);
+    CHECK(context.applied_count == 1 && applied[0] == 0 && stats.frames == 1);
+    run(&context, 0, 0, 3 * SHUFFLE_BLOCK, &stats);
+    CHECK(context.applied_count == 3 * SHUFFLE_BLOCK && context.ordered);
+    CHECK(memcmp(applied, expected, 3 * SHUFFLE_BLOCK * sizeof(uint32_t)) == 0);
+
+    run(&context, 2, 0, 0, &stats);
+    CHECK(context.applied_count == 0 && stats.frames == 0);
+}
+
+static void test_failures_are_counted(void) {
+    static uint32_t applied[FRAMES];
+    Context context = {.applied = applied, .fail_decode_every = 97, .fail_apply_every = 89};
+    KSRP_PipelineStats stats;
+    run(&context, 4, 16, FRAMES, &stats);
+
+    uint32_t decode_failed = 0;
+    uint32_t apply_failed = 0;
+    for (uint32_t i = 0; i < FRAMES; i++) {
+        decode_failed += i % 97 == 0;
+        apply_failed += i % 97 != 0 && i % 89 == 0;
+    }
+    CHECK(stats.frames == FRAMES);
+    CHECK(stats.decode_failed == decode_failed && stats.apply_failed == apply_failed);
+
+    // Frames which failed to decode are skipped, the rest keeps its order
+    CHECK(context.applied_count == FRAMES - decode_failed);
+    for (uint32_t i = 0, j = 0; i < FRAMES; i++) {
+        if (expected[i] % 97 != 0) {
+            CHECK(applied[j++] == expected[i]);
+        }
+    }
+}
+
+static void test_idle_workers_steal_chunks(void) {
+    static uint32_t applied[FRAMES];
+    // First worker starts with the slow chunks of the window, the others run out of work and steal them
+    Context context = {.applied = applied, .slow_frames = 64};
+    KSRP_PipelineStats stats;
+    run(&context, 4, 4, 4 * KSRP_PIPELINE_CHUNKS_PER_THREAD * 4, &stats);
+    CHECK(context.ordered);
+    CHECK(memcmp(applied, expected, context.applied_count * sizeof(uint32_t)) == 0);
+    CHECK(stats.stolen_chunks > 0);
+}
+
+static void test_invalid_configuration(void) {
+    Context context = {0};
+    KSRP_PipelineConfig config = config_of(&context, 2, 0);
+    KSRP_PipelineStats stats;
+
+    config.decoded_size = 0;
+    CHECK(KSRP_Pipeline_Run(&config, recording, FRAMES, &stats) == KSRP_STATUS_ERROR);
+    config = config_of(&context, 2, 0);
+    config.apply = NULL;
+    CHECK(KSRP_Pipeline_Run(&config, recording, FRAMES, &stats) == KSRP_STATUS_ERROR);
+    config = config_of(&context, 2, 0);
+    CHECK(KSRP_Pipeline_Run(&config, NULL, 1, &stats) == KSRP_STATUS_ERROR);
+    CHECK(KSRP_Pipeline_Run(NULL, recording, FRAMES, &stats) == KSRP_STATUS_ERROR);
+}
+
+static KSRP_RawData_Frame sent[2 * FRAMES];
+static uint32_t sent_count;
+
+static KSRP_Status record_frame(KSRP_RawData_Frame* frame) {
+    CHECK(sent_count < sizeof(sent) / sizeof(sent[0]));
+    sent[sent_count++] = *frame;
+    return KSRP_STATUS_OK;
+}
+
+static KSRP_Status decode_frame(const KSRP_TimedFrame* frame, void* decoded, void* context) {
+    (void)context;
+    return KSRP_Decode(&frame->frame, decoded);
+}
+
+static KSRP_Status dispatch_frame(const void* decoded, uint64_t timestamp, void* context) {
+    (void)timestamp;
+    (void)context;
+    return KSRP_DispatchDecoded(decoded);
+}
+
+static void test_decoded_frames_rebuild_state(void) {
+    static KSRP_Telemetry_Instance sender;
+    static KSRP_Telemetry_Instance sequential;
+    static KSRP_Telemetry_Instance pipelined;
+    static KSRP_TimedFrame frames[2 * FRAMES];
+    CHECK_OK(KSRP_Init_Telemetry_Instance(&sender));
+    CHECK_OK(KSRP_Init_Telemetry_Instance(&sequential));
+    CHECK_OK(KSRP_Init_Telemetry_Instance(&pipelined));
+
+    // Full frames only, deltas aren't decoded into frames
+    CHECK_OK(KSRP_Telemetry_Instance_SetSendFrameCallback(&sender, record_frame));
+    KSRP_Telemetry_PowerStatus_Frame power_status;
+    KSRP_Init_Telemetry_PowerStatus_Frame(&power_status);
+    for (uint32_t i = 0; i < FRAMES; i++) {
+        power_status.device_id = (uint8_t)(i % KSRP_TELEMETRY_MAX_DEVICES);
+        power_status.state = (uint8_t)(i % 3);
+        power_status.energy = i;
+        CHECK_OK(KSRP_Pack_Telemetry_PowerStatus(&power_status, &sent[sent_count++]));
+    }
+    for (uint32_t i = 0; i < sent_count; i++) {
+        frames[i].timestamp = i / 2;
+        frames[i].frame = sent[i];
+    }
+
+    CHECK_OK(KSRP_Dispatch_Register_Telemetry_Instance(&sequential));
+    for (uint32_t i = 0; i < sent_count; i++) {
+        CHECK_OK(KSRP_Dispatch(&frames[i].frame));
+    }
+
+    CHECK_OK(KSRP_Dispatch_Register_Telemetry_Instance(&pipelined));
+    const KSRP_PipelineConfig config = {
+        .threads = 4,
+        .chunk_frames = 64,
+        .decoded_size = sizeof(KSRP_DecodedFrame),
+        .decode = decode_frame,
+        .apply = dispatch_frame,
+    };
+    KSRP_PipelineStats stats;
+    CHECK_OK(KSRP_Pipeline_Run(&config, frames, sent_count, &stats));
+    CHECK(stats.frames == sent_count && stats.decode_failed == 0 && stats.apply_failed == 0);
+    CHECK(memcmp(pipelined.power_status_instance, sequential.power_status_instance,
+                 sizeof(sequential.power_status_instance)) == 0);
+    CHECK(pipelined.power_status_instance[1].energy == FRAMES - 3);
+}
+
+int main(void) {
+    make_recording();
+    RUN_TEST(test_applies_in_timestamp_order);
+    RUN_TEST(test_short_recordings);
+    RUN_TEST(test_failures_are_counted);
+    RUN_TEST(test_idle_workers_steal_chunks);
+    RUN_TEST(test_invalid_configuration);
+    RUN_TEST(test_decoded_frames_rebuild_state);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,286 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ksrp/delta.h"
+#include "ksrp/endianness.h"
+#include "ksrp/host/recording.h"
+#include "ksrp/protocols/protocol_hash.h"
+#include "ksrp/protocols/protocol_utils.h"
+#include "ksrp_test.h"
+
+#define RECORDING_PATH "test_recording.ksrprec"
+#define UPDATES 300
+
+static KSRP_RawData_Frame written[2 * UPDATES];
+static uint64_t written_timestamps[2 * UPDATES];
+static uint32_t written_count;
+
+static KSRP_Status record_frame(KSRP_RawData_Frame* frame) {
+    CHECK(written_count < sizeof(written) / sizeof(written[0]));
+    written[written_count++] = *frame;
+    return KSRP_STATUS_OK;
+}
+
+static KSRP_TypeID indexed_type_id(const KSRP_RawData_Frame* frame) {
+    return KSRP_Delta_IsDelta(frame) ? KSRP_Delta_GetTypeID(frame) : KSRP_RawData_Frame_GetTypeID(frame);
+}
+
+// Motor status is sent by an instance with delta encoding, power status as full frames. Timestamps repeat and, in
+// the unsorted variant, every tenth frame arrives late
+static void make_frames(KSRP_Telemetry_Instance* sender, bool sorted) {
+    written_count = 0;
+    CHECK_OK(KSRP_Init_Telemetry_Instance(sender));
+    CHECK_OK(KSRP_Telemetry_Instance_SetSendFrameCallback(sender, record_frame));
+
+    KSRP_Telemetry_MotorStatus_Frame motor_status;
+    KSRP_Init_Telemetry_MotorStatus_Frame(&motor_status);
+    motor_status.device_id = 2;
+    KSRP_Telemetry_PowerStatus_Frame power_status;
+    KSRP_Init_Telemetry_PowerStatus_Frame(&power_status);
+    power_status.device_id = 1;
+
+    for (uint32_t i = 0; i < UPDATES; i++) {
+        const uint32_t first = written_count;
+        motor_status.counter = i;
+        motor_status.mode = (uint8_t)(i / 7 % 3);
+        CHECK_OK(KSRP_UpdateFrame_Telemetry_Instance(sender, KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID, &motor_status,
+                                                     sizeof(motor_status)));
+        if (i % 2 == 0) {
+            power_status.energy = i;
+            CHECK_OK(KSRP_Pack_Telemetry_PowerStatus(&power_status, &written[written_count++]));
+        }
+
+        for (uint32_t frame = first; frame < written_count; frame++) {
+            written_timestamps[frame] = 100 + i / 3 * 10;
+            if (!sorted && i % 10 == 9) {
+                written_timestamps[frame] -= 25;
+            }
+        }
+    }
+}
+
+static void write_recording(bool close) {
+    KSRP_RecordingWriter writer;
+    CHECK_OK(KSRP_RecordingWriter_Open(&writer, RECORDING_PATH, KSRP_PROTOCOL_HASH));
+    for (uint32_t i = 0; i < written_count; i++) {
+        CHECK_OK(KSRP_RecordingWriter_Append(&writer, written_timestamps[i], &written[i]));
+    }
+
+    if (close) {
+        CHECK_OK(KSRP_RecordingWriter_Close(&writer));
+        return;
+    }
+
+    // Simulates a crash of the recorder, records are flushed but the index is never written
+    CHECK(fflush(writer.file) == 0);
+    CHECK(fclose(writer.file) == 0);
+    free(writer.type_ids);
+}
+
+static void check_query(const KSRP_RecordingReader* reader, KSRP_TypeID type_id, uint64_t from, uint64_t to) {
+    KSRP_RecordingCursor cursor;
+    KSRP_RecordingReader_Query(reader, type_id, from, to, &cursor);
+
+    KSRP_TimedFrame frame;
+    for (uint32_t i = 0; i < written_count; i++) {
+        if (indexed_type_id(&written[i]) != type_id || written_timestamps[i] < from || written_timestamps[i] >= to) {
+            continue;
+        }
+        CHECK_OK(KSRP_RecordingCursor_Next(&cursor, &frame));
+        CHECK(frame.timestamp == written_timestamps[i]);
+        CHECK(frame.frame.length == written[i].length);
+        CHECK(memcmp(frame.frame.data, written[i].data, written[i].length) == 0);
+    }
+    CHECK(KSRP_RecordingCursor_Next(&cursor, &frame) == KSRP_STATUS_ERROR);
+}
+
+static void check_queries(const KSRP_RecordingReader* reader) {
+    const uint8_t subsystem_id = KSRP_TELEMETRY_SUBSYSTEM_ID;
+    const KSRP_TypeID motor_status = KSRP_MAKE_TYPE_ID(subsystem_id, KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID);
+    const KSRP_TypeID power_status = KSRP_MAKE_TYPE_ID(subsystem_id, KSRP_TELEMETRY_POWER_STATUS_FRAME_ID);
+    const uint64_t ranges[][2] = {{0, UINT64_MAX}, {100, 101}, {105, 405}, {370, 380}, {990, 1100}, {5000, 6000}};
+
+    for (uint32_t i = 0; i < sizeof(ranges) / sizeof(ranges[0]); i++) {
+        check_query(reader, motor_status, ranges[i][0], ranges[i][1]);
+        check_query(reader, power_status, ranges[i][0], ranges[i][1]);
+        check_query(reader, KSRP_MAKE_TYPE_ID(subsystem_id, 9), ranges[i][0], ranges[i][1]);
+    }
+
+    // Every record is readable in recording order
+    KSRP_TimedFrame frame;
+    for (uint32_t i = 0; i < written_count; i++) {
+        CHECK_OK(KSRP_RecordingReader_Get(reader, i, &frame));
+        CHECK(frame.timestamp == written_timestamps[i]);
+        CHECK(memcmp(frame.frame.data, written[i].data, written[i].length) == 0);
+    }
+    CHECK(KSRP_RecordingReader_Get(reader, written_count, &frame) == KSRP_STATUS_INVALID_DATA_SIZE);
+}
+
+static void test_sorted_recording(void) {
+    static KSRP_Telemetry_Instance sender;
+    make_frames(&sender, true);
+    write_recording(true);
+
+    KSRP_RecordingReader reader;
+    CHECK_OK(KSRP_RecordingReader_Open(&reader, RECORDING_PATH));
+    CHECK(reader.protocol_hash == KSRP_PROTOCOL_HASH);
+    CHECK(reader.records_count == written_count);
+    CHECK(reader.flags & KSRP_RECORDING_FLAG_SORTED);
+    CHECK(reader.types != NULL && reader.types_count == 2);
+    check_queries(&reader);
+    KSRP_RecordingReader_Close(&reader);
+}
+
+static void test_unsorted_recording(void) {
+    static KSRP_Telemetry_Instance sender;
+    make_frames(&sender, false);
+    write_recording(true);
+
+    KSRP_RecordingReader reader;
+    CHECK_OK(KSRP_RecordingReader_Open(&reader, RECORDING_PATH));
+    CHECK(!(reader.flags & KSRP_RECORDING_FLAG_SORTED));
+    check_queries(&reader);
+    KSRP_RecordingReader_Close(&reader);
+}
+
+static void test_unclosed_recording(void) {
+    static KSRP_Telemetry_Instance sender;
+    make_frames(&sender, true);
+    write_recording(false);
+
+    // Queries scan all records, including a partially written one at the end
+    FILE* file = fopen(RECORDING_PATH, "ab");
+    CHECK(file != NULL);
+    CHECK(fwrite("partial", 7, 1, file) == 1);
+    CHECK(fclose(file) == 0);
+
+    KSRP_RecordingReader reader;
+    CHECK_OK(KSRP_RecordingReader_Open(&reader, RECORDING_PATH));
+    CHECK(reader.types == NULL);
+    CHECK(reader.records_count == written_count);
+    check_queries(&reader);
+    KSRP_RecordingReader_Close(&reader);
+}
+
+static void test_replay_rebuilds_state(void) {
+    static KSRP_Telemetry_Instance sender;
+    static KSRP_Telemetry_Instance receiver;
+    make_frames(&sender, true);
+    write_recording(true);
+
+    // Deltas are returned with the frames they patch, so replaying a single type rebuilds it
+    KSRP_RecordingReader reader;
+    CHECK_OK(KSRP_RecordingReader_Open(&reader, RECORDING_PATH));
+    CHECK_OK(KSRP_Init_Telemetry_Instance(&receiver));
+    CHECK_OK(KSRP_Dispatch_Register_Telemetry_Instance(&receiver));
+
+    KSRP_RecordingCursor cursor;
+    KSRP_TimedFrame frame;
+    uint32_t deltas = 0;
+    KSRP_RecordingReader_Query(&reader,
+                               KSRP_MAKE_TYPE_ID(KSRP_TELEMETRY_SUBSYSTEM_ID, KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID),
+                               0, UINT64_MAX, &cursor);
+    while (KSRP_RecordingCursor_Next(&cursor, &frame) == KSRP_STATUS_OK) {
+        deltas += KSRP_Delta_IsDelta(&frame.frame);
+        CHECK_OK(KSRP_Dispatch(&frame.frame));
+    }
+    KSRP_RecordingReader_Close(&reader);
+
+    CHECK(deltas > 0);
+    CHECK(memcmp(&receiver.motor_status_instance[2], &sender.motor_status_instance[2],
+                 sizeof(receiver.motor_status_instance[2])) == 0);
+    CHECK(receiver.power_status_instance[1].energy == 0);
+}
+
+static void write_file(const void* data, size_t size) {
+    FILE* file = fopen(RECORDING_PATH, "wb");
+    CHECK(file != NULL);
+    CHECK(size == 0 || fwrite(data, size, 1, file) == 1);
+    CHECK(fclose(file) == 0);
+}
+
+static void test_invalid_files(void) {
+    KSRP_RecordingReader reader;
+    KSRP_RecordingWriter writer;
+
+    KSRP_RawData_Frame frame;
+    KSRP_RawDataFrame_Init(&frame);
+    CHECK_OK(KSRP_RecordingWriter_Open(&writer, RECORDING_PATH, KSRP_PROTOCOL_HASH));
+    frame.length = KSRP_ID_BYTES - 1;
+    CHECK(KSRP_RecordingWriter_Append(&writer, 0, &frame) == KSRP_STATUS_INVALID_DATA_SIZE);
+    frame.length = KSRP_RAW_DATA_FRAME_BUFFER_SIZE + 1;
+    CHECK(KSRP_RecordingWriter_Append(&writer, 0, &frame) == KSRP_STATUS_INVALID_DATA_SIZE);
+    CHECK_OK(KSRP_RecordingWriter_Close(&writer));
+    CHECK(KSRP_RecordingWriter_Close(&writer) == KSRP_STATUS_ERROR);
+
+    // Empty recording is valid
+    CHECK_OK(KSRP_RecordingReader_Open(&reader, RECORDING_PATH));
+    CHECK(reader.records_count == 0 && reader.types_count == 0);
+    KSRP_RecordingCursor cursor;
+    KSRP_TimedFrame timed_frame;
+    KSRP_RecordingReader_Query(&reader, 0, 0, UINT64_MAX, &cursor);
+    CHECK(KSRP_RecordingCursor_Next(&cursor, &timed_frame) == KSRP_STATUS_ERROR);
+    KSRP_RecordingReader_Close(&reader);
+
+    CHECK(KSRP_RecordingReader_Open(&reader, "missing.ksrprec") == KSRP_STATUS_ERROR);
+    CHECK(KSRP_RecordingWriter_Open(&writer, "missing/recording.ksrprec", 0) == KSRP_STATUS_ERROR);
+
+    uint8_t header[KSRP_RECORDING_HEADER_SIZE] = "KSRPREC1";
+    write_file(header, sizeof(header) - 1);
+    CHECK(KSRP_RecordingReader_Open(&reader, RECORDING_PATH) == KSRP_STATUS_INVALID_DATA_SIZE);
+    write_file(header, sizeof(header));
+    CHECK(KSRP_RecordingReader_Open(&reader, RECORDING_PATH) == KSRP_STATUS_INVALID_DATA_SIZE);
+
+    // Truncated index
+    static KSRP_Telemetry_Instance sender;
+    make_frames(&sender, true);
+    write_recording(true);
+    const off_t index_offset = KSRP_RECORDING_HEADER_SIZE + (off_t)written_count * KSRP_RECORDING_RECORD_SIZE;
+    CHECK(truncate(RECORDING_PATH, index_offset + 2 * KSRP_RECORDING_INDEX_TYPE_SIZE) == 0);
+    CHECK(KSRP_RecordingReader_Open(&reader, RECORDING_PATH) == KSRP_STATUS_INVALID_DATA_SIZE);
+    CHECK(reader.data == NULL);
+}
+
+static void test_corrupted_index_entries(void) {
+    static KSRP_Telemetry_Instance sender;
+    make_frames(&sender, true);
+    write_recording(true);
+
+    // Every index entry points beyond the records, half of them past the mapped file
+    const long entries_offset = KSRP_RECORDING_HEADER_SIZE + (long)written_count * KSRP_RECORDING_RECORD_SIZE +
+                                2 * KSRP_RECORDING_INDEX_TYPE_SIZE;
+    const uint32_t entries_count = written_count;
+    FILE* file = fopen(RECORDING_PATH, "r+b");
+    CHECK(file != NULL);
+    CHECK(fseek(file, entries_offset, SEEK_SET) == 0);
+    for (uint32_t i = 0; i < entries_count; i++) {
+        uint8_t entry[sizeof(uint32_t)];
+        KSRP_StoreLE32(entry, i % 2 ? UINT32_MAX : written_count + i);
+        CHECK(fwrite(entry, sizeof(entry), 1, file) == 1);
+    }
+    CHECK(fclose(file) == 0);
+
+    KSRP_RecordingReader reader;
+    KSRP_RecordingCursor cursor;
+    KSRP_TimedFrame frame;
+    CHECK_OK(KSRP_RecordingReader_Open(&reader, RECORDING_PATH));
+    const KSRP_TypeID type_ids[] = {KSRP_TELEMETRY_MOTOR_STATUS_TYPE_ID, KSRP_TELEMETRY_POWER_STATUS_TYPE_ID};
+    for (uint32_t i = 0; i < sizeof(type_ids) / sizeof(type_ids[0]); i++) {
+        KSRP_RecordingReader_Query(&reader, type_ids[i], 150, 300, &cursor);
+        CHECK(KSRP_RecordingCursor_Next(&cursor, &frame) == KSRP_STATUS_ERROR);
+    }
+    KSRP_RecordingReader_Close(&reader);
+}
+
+int main(void) {
+    RUN_TEST(test_sorted_recording);
+    RUN_TEST(test_unsorted_recording);
+    RUN_TEST(test_unclosed_recording);
+    RUN_TEST(test_replay_rebuilds_state);
+    RUN_TEST(test_invalid_files);
+    RUN_TEST(test_corrupted_index_entries);
+    remove(RECORDING_PATH);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,205 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "ksrp/batch.h"
+#include "ksrp/delta.h"
+#include "ksrp/protocols/protocol_registry.h"
+#include "ksrp/protocols/protocol_utils.h"
+#include "ksrp_test.h"
+
+#define REGISTRIES 3
+#define UNKNOWN_SUBSYSTEM_ID 0
+
+static KSRP_Registry registries[REGISTRIES];
+static void* stale_instances[16];
+static uint32_t stale_count;
+
+static KSRP_Status record_stale(uint32_t subsystem_id, void* frame_instance, uint32_t frame_id, uint32_t age) {
+    CHECK(subsystem_id == KSRP_TELEMETRY_SUBSYSTEM_ID);
+    CHECK(frame_id == KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID);
+    CHECK(age >= KSRP_TELEMETRY_MOTOR_STATUS_TIMEOUT_MS);
+    CHECK(stale_count < sizeof(stale_instances) / sizeof(stale_instances[0]));
+    stale_instances[stale_count++] = frame_instance;
+    return KSRP_STATUS_OK;
+}
+
+static KSRP_Telemetry_MotorStatus_Frame motor_status(uint8_t device_id, uint32_t counter) {
+    KSRP_Telemetry_MotorStatus_Frame frame;
+    KSRP_Init_Telemetry_MotorStatus_Frame(&frame);
+    frame.device_id = device_id;
+    frame.mode = 2;
+    frame.current = -250;
+    frame.counter = counter;
+    return frame;
+}
+
+static KSRP_Limits_Levels_Frame levels(int32_t seed) {
+    KSRP_Limits_Levels_Frame frame;
+    KSRP_Init_Limits_Levels_Frame(&frame);
+    frame.i16 = (int16_t)-seed;
+    frame.i32 = seed * 1000;
+    frame.u64 = (uint64_t)seed << 40;
+    return frame;
+}
+
+static void test_lookup(void) {
+    KSRP_Registry* registry = &registries[1];
+    CHECK_OK(KSRP_Registry_Init(registries, REGISTRIES));
+
+    CHECK(KSRP_Registry_GetInstance(registry, KSRP_TELEMETRY_SUBSYSTEM_ID) == &registry->telemetry);
+    CHECK(KSRP_Registry_GetInstance(registry, KSRP_LIMITS_SUBSYSTEM_ID) == &registry->limits);
+    CHECK(KSRP_Registry_GetInstance(registry, KSRP_DIAGNOSTICS_SUBSYSTEM_ID) == &registry->diagnostics);
+    CHECK(KSRP_Registry_GetInstanceByTypeID(registry, KSRP_TELEMETRY_POWER_STATUS_TYPE_ID) == &registry->telemetry);
+    CHECK(KSRP_Registry_GetInstanceByTypeID(registry, KSRP_LIMITS_LEVELS_TYPE_ID) == &registry->limits);
+
+    // Gap in the subsystem IDs, IDs beyond the last subsystem and IDs reserved for deltas and batches
+    CHECK(KSRP_Registry_GetInstance(registry, UNKNOWN_SUBSYSTEM_ID) == NULL);
+    CHECK(KSRP_Registry_GetInstance(registry, KSRP_BATCH_SUBSYSTEM_ID - 1) == NULL);
+    CHECK(KSRP_Registry_GetInstance(registry, UINT32_MAX) == NULL);
+    CHECK(KSRP_Registry_GetInstanceByTypeID(registry, KSRP_MAKE_TYPE_ID(UNKNOWN_SUBSYSTEM_ID, 1)) == NULL);
+    CHECK(KSRP_Registry_GetInstanceByTypeID(registry, KSRP_BATCH_TYPE_ID) == NULL);
+    CHECK(KSRP_Registry_GetInstanceByTypeID(registry, KSRP_ILLEGAL_TYPE_ID) == NULL);
+
+    // Frames of unknown subsystems are rejected without touching the registry
+    KSRP_RawData_Frame raw;
+    const KSRP_Limits_Levels_Frame frame = levels(7);
+    CHECK_OK(KSRP_Pack_Limits_Levels(&frame, &raw));
+    raw.data[0] = UNKNOWN_SUBSYSTEM_ID;
+    CHECK(KSRP_Registry_Receive(registry, &raw) == KSRP_STATUS_INVALID_FRAME_TYPE);
+    raw.length = 1;
+    CHECK(KSRP_Registry_Receive(registry, &raw) == KSRP_STATUS_INVALID_DATA_SIZE);
+    CHECK(registry->limits.levels_instance.i32 == 0);
+}
+
+static void test_queued_and_immediate_subsystems(void) {
+    CHECK_OK(KSRP_Registry_Init(registries, REGISTRIES));
+    KSRP_RawData_Frame raw;
+
+    // Limits have no receive queue, the frame is applied to the registry of its vehicle only
+    const KSRP_Limits_Levels_Frame frame = levels(3);
+    CHECK_OK(KSRP_Pack_Limits_Levels(&frame, &raw));
+    CHECK_OK(KSRP_Registry_Receive(&registries[2], &raw));
+    CHECK(memcmp(&registries[2].limits.levels_instance, &frame, sizeof(frame)) == 0);
+    CHECK(registries[1].limits.levels_instance.i32 == 0);
+
+    // Telemetry queues frames until the registries are drained
+    const KSRP_Telemetry_MotorStatus_Frame status = motor_status(1, 77);
+    CHECK_OK(KSRP_Pack_Telemetry_MotorStatus(&status, &raw));
+    CHECK_OK(KSRP_Registry_Receive(&registries[0], &raw));
+    CHECK(registries[0].telemetry.motor_status_instance[1].counter == 0);
+    CHECK(KSRP_Ring_Count(&registries[0].telemetry.rx_queue) == 1);
+
+    CHECK_OK(KSRP_Registry_Drain(registries, REGISTRIES));
+    CHECK(registries[0].telemetry.motor_status_instance[1].counter == 77);
+    CHECK(registries[0].telemetry.motor_status_instance[1].current == -250);
+    CHECK(KSRP_Ring_Count(&registries[0].telemetry.rx_queue) == 0);
+    CHECK(registries[1].telemetry.motor_status_instance[1].counter == 0);
+
+    // Full queue rejects the frame, the queued ones are still applied
+    for (uint32_t i = 0; i < KSRP_TELEMETRY_RX_QUEUE_CAPACITY; i++) {
+        const KSRP_Telemetry_MotorStatus_Frame update = motor_status(2, 100 + i);
+        CHECK_OK(KSRP_Pack_Telemetry_MotorStatus(&update, &raw));
+        CHECK_OK(KSRP_Registry_Receive(&registries[1], &raw));
+    }
+    CHECK(KSRP_Registry_Receive(&registries[1], &raw) != KSRP_STATUS_OK);
+    CHECK_OK(KSRP_Registry_Drain(registries, REGISTRIES));
+    CHECK(registries[1].telemetry.motor_status_instance[2].counter == 100 + KSRP_TELEMETRY_RX_QUEUE_CAPACITY - 1);
+}
+
+static void test_deltas_and_batches(void) {
+    CHECK_OK(KSRP_Registry_Init(registries, REGISTRIES));
+    KSRP_Registry* registry = &registries[1];
+    KSRP_RawData_Frame raw;
+    KSRP_RawData_Frame delta;
+    KSRP_RawData_Frame batch;
+
+    // Delta is routed to the subsystem of the frame it patches
+    const KSRP_Telemetry_MotorStatus_Frame keyframe = motor_status(3, 10);
+    KSRP_Telemetry_MotorStatus_Frame update = keyframe;
+    update.counter = 11;
+    CHECK_OK(KSRP_Pack_Telemetry_MotorStatus(&keyframe, &raw));
+    CHECK_OK(KSRP_PackDelta_Telemetry_MotorStatus(
+        &update, (uint64_t)1 << KSRP_TELEMETRY_MOTOR_STATUS_COUNTER_FIELD_ID, &delta));
+    CHECK_OK(KSRP_Registry_Receive(registry, &raw));
+    CHECK_OK(KSRP_Registry_Receive(registry, &delta));
+    CHECK(registry->telemetry.motor_status_instance[3].counter == 0);
+    CHECK_OK(KSRP_Registry_Drain(registries, REGISTRIES));
+    CHECK(memcmp(&registry->telemetry.motor_status_instance[3], &update, sizeof(update)) == 0);
+
+    // Batch of frames of both subsystems, the limits frame is applied at once and telemetry waits for the drain
+    const KSRP_Limits_Levels_Frame frame = levels(5);
+    update.counter = 12;
+    update.mode = 1;
+    KSRP_Batch_Init(&batch);
+    CHECK_OK(KSRP_PackDelta_Telemetry_MotorStatus(
+        &update,
+        ((uint64_t)1 << KSRP_TELEMETRY_MOTOR_STATUS_COUNTER_FIELD_ID) |
+            ((uint64_t)1 << KSRP_TELEMETRY_MOTOR_STATUS_MODE_FIELD_ID),
+        &delta));
+    CHECK_OK(KSRP_Batch_Append(&batch, &delta));
+    CHECK_OK(KSRP_Pack_Limits_Levels(&frame, &raw));
+    CHECK_OK(KSRP_Batch_Append(&batch, &raw));
+    CHECK_OK(KSRP_Registry_Receive(registry, &batch));
+    CHECK(memcmp(&registry->limits.levels_instance, &frame, sizeof(frame)) == 0);
+    CHECK(registry->telemetry.motor_status_instance[3].counter == 11);
+    CHECK_OK(KSRP_Registry_Drain(registries, REGISTRIES));
+    CHECK(memcmp(&registry->telemetry.motor_status_instance[3], &update, sizeof(update)) == 0);
+
+    // Sub-frame of unknown subsystem fails the batch, the other sub-frames are still applied
+    const KSRP_Limits_Levels_Frame next = levels(6);
+    KSRP_RawData_Frame unknown;
+    CHECK_OK(KSRP_Pack_Limits_Levels(&next, &unknown));
+    unknown.data[0] = UNKNOWN_SUBSYSTEM_ID;
+    unknown.length = KSRP_ID_BYTES + 4;
+    CHECK_OK(KSRP_Pack_Limits_Levels(&next, &raw));
+    KSRP_Batch_Init(&batch);
+    CHECK_OK(KSRP_Batch_Append(&batch, &unknown));
+    CHECK_OK(KSRP_Batch_Append(&batch, &raw));
+    CHECK(KSRP_Registry_Receive(registry, &batch) == KSRP_STATUS_INVALID_FRAME_TYPE);
+    CHECK(memcmp(&registry->limits.levels_instance, &next, sizeof(next)) == 0);
+}
+
+static void test_tick_calls_stale_callbacks(void) {
+    CHECK_OK(KSRP_Registry_Init(registries, REGISTRIES));
+    for (uint32_t i = 0; i < REGISTRIES; i++) {
+        CHECK_OK(KSRP_Telemetry_Instance_SetStaleCallback(&registries[i].telemetry,
+                                                          KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID, record_stale));
+    }
+
+    // Deadlines start at initialization, the frame received halfway is reported later than the others
+    const uint32_t timeout = KSRP_TELEMETRY_MOTOR_STATUS_TIMEOUT_MS;
+    const uint32_t slots = REGISTRIES * KSRP_TELEMETRY_MAX_DEVICES;
+    stale_count = 0;
+    CHECK_OK(KSRP_Registry_Tick(registries, REGISTRIES, timeout / 2));
+    KSRP_RawData_Frame raw;
+    const KSRP_Telemetry_MotorStatus_Frame status = motor_status(2, 1);
+    CHECK_OK(KSRP_Pack_Telemetry_MotorStatus(&status, &raw));
+    CHECK_OK(KSRP_Registry_Receive(&registries[2], &raw));
+    CHECK_OK(KSRP_Registry_Drain(registries, REGISTRIES));
+
+    CHECK_OK(KSRP_Registry_Tick(registries, REGISTRIES, timeout - timeout / 2 - 1));
+    CHECK(stale_count == 0);
+    CHECK_OK(KSRP_Registry_Tick(registries, REGISTRIES, 1));
+    CHECK(stale_count == slots - 1);
+    for (uint32_t i = 0; i < stale_count; i++) {
+        CHECK(stale_instances[i] != &registries[2].telemetry.motor_status_instance[2]);
+    }
+
+    CHECK_OK(KSRP_Registry_Tick(registries, REGISTRIES, timeout / 2 - 1));
+    CHECK(stale_count == slots - 1);
+    CHECK_OK(KSRP_Registry_Tick(registries, REGISTRIES, 1));
+    CHECK(stale_count == slots);
+    CHECK(stale_instances[slots - 1] == &registries[2].telemetry.motor_status_instance[2]);
+
+    // Reported once until the frame is updated again
+    CHECK_OK(KSRP_Registry_Tick(registries, REGISTRIES, timeout));
+    CHECK(stale_count == slots);
+}
+
+int main(void) {
+    RUN_TEST(test_lookup);
+    RUN_TEST(test_queued_and_immediate_subsystems);
+    RUN_TEST(test_deltas_and_batches);
+    RUN_TEST(test_tick_calls_stale_callbacks);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "ksrp/ring.h"
+#include "ksrp/endianness.h"
+#include "ksrp_test.h"
+
+#define CAPACITY 8
+#define CONCURRENT_FRAMES 200000
+
+static void make_frame(KSRP_RawData_Frame* frame, uint32_t sequence) {
+    memset(frame, 0, sizeof(*frame));
+    frame->data[0] = 1;
+    frame->data[1] = 2;
+    KSRP_StoreLE32(&frame->data[KSRP_ID_BYTES], sequence);
+    frame->length = KSRP_ID_BYTES + sizeof(uint32_t) + sequence % 4;
+}
+
+static uint32_t frame_sequence(const KSRP_RawData_Frame* frame) {
+    return KSRP_LoadLE32(&frame->data[KSRP_ID_BYTES]);
+}
+
+static void test_capacity_must_be_power_of_two(void) {
+    KSRP_Ring ring;
+    KSRP_RawData_Frame frames[CAPACITY];
+
+    CHECK(KSRP_Ring_Init(&ring, frames, 0) == KSRP_STATUS_INVALID_DATA_SIZE);
+    CHECK(KSRP_Ring_Init(&ring, frames, 6) == KSRP_STATUS_INVALID_DATA_SIZE);
+    CHECK_OK(KSRP_Ring_Init(&ring, frames, 1));
+    CHECK_OK(KSRP_Ring_Init(&ring, frames, CAPACITY));
+}
+
+static void test_fifo_order_and_drops(void) {
+    KSRP_Ring ring;
+    KSRP_RawData_Frame frames[CAPACITY];
+    KSRP_RawData_Frame frame;
+    CHECK_OK(KSRP_Ring_Init(&ring, frames, CAPACITY));
+
+    CHECK(KSRP_Ring_Pop(&ring, &frame) == KSRP_STATUS_ERROR);
+    make_frame(&frame, 0);
+    frame.length = KSRP_RAW_DATA_FRAME_BUFFER_SIZE + 1;
+    CHECK(KSRP_Ring_Push(&ring, &frame) == KSRP_STATUS_INVALID_DATA_SIZE);
+    CHECK(KSRP_Ring_Count(&ring) == 0 && KSRP_Ring_GetDropped(&ring) == 0);
+
+    for (uint32_t i = 0; i < CAPACITY; i++) {
+        make_frame(&frame, i);
+        CHECK_OK(KSRP_Ring_Push(&ring, &frame));
+    }
+    CHECK(KSRP_Ring_Count(&ring) == CAPACITY);
+
+    // Full ring drops new frames and keeps the old ones
+    make_frame(&frame, 100);
+    CHECK(KSRP_Ring_Push(&ring, &frame) == KSRP_STATUS_ERROR);
+    CHECK(KSRP_Ring_Push(&ring, &frame) == KSRP_STATUS_ERROR);
+    CHECK(KSRP_Ring_GetDropped(&ring) == 2);
+
+    for (uint32_t i = 0; i < CAPACITY; i++) {
+        KSRP_RawData_Frame expected;
+        make_frame(&expected, i);
+        CHECK_OK(KSRP_Ring_Pop(&ring, &frame));
+        CHECK(frame.length == expected.length && memcmp(frame.data, expected.data, frame.length) == 0);
+    }
+    CHECK(KSRP_Ring_Count(&ring) == 0);
+    CHECK(KSRP_Ring_Pop(&ring, &frame) == KSRP_STATUS_ERROR);
+}
+
+static void test_indices_wrap_around(void) {
+    KSRP_Ring ring;
+    KSRP_RawData_Frame frames[CAPACITY];
+    KSRP_RawData_Frame frame;
+    CHECK_OK(KSRP_Ring_Init(&ring, frames, CAPACITY));
+
+    // Indices run freely, start right before they overflow
+    atomic_store(&ring.head, UINT32_MAX - 2);
+    atomic_store(&ring.tail, UINT32_MAX - 2);
+
+    uint32_t pushed = 0;
+    uint32_t popped = 0;
+    for (uint32_t round = 0; round < 3 * CAPACITY; round++) {
+        while (KSRP_Ring_Count(&ring) < CAPACITY - 1) {
+            make_frame(&frame, pushed++);
+            CHECK_OK(KSRP_Ring_Push(&ring, &frame));
+        }
+        CHECK_OK(KSRP_Ring_Pop(&ring, &frame));
+        CHECK(frame_sequence(&frame) == popped++);
+    }
+    while (KSRP_Ring_Pop(&ring, &frame) == KSRP_STATUS_OK) {
+        CHECK(frame_sequence(&frame) == popped++);
+    }
+    CHECK(popped == pushed);
+    CHECK(KSRP_Ring_GetDropped(&ring) == 0);
+}
+
+typedef struct {
+    KSRP_Ring* ring;
+    bool retry;
+} Producer;
+
+static void* produce(void* argument) {
+    const Producer* producer = argument;
+    KSRP_RawData_Frame frame;
+
+    for (uint32_t i = 0; i < CONCURRENT_FRAMES; i++) {
+        make_frame(&frame, i);
+        while (KSRP_Ring_Push(producer->ring, &frame) != KSRP_STATUS_OK && producer->retry) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void run_concurrent(bool retry) {
+    static KSRP_RawData_Frame frames[CAPACITY];
+    KSRP_Ring ring;
+    KSRP_RawData_Frame frame;
+    CHECK_OK(KSRP_Ring_Init(&ring, frames, CAPACITY));
+
+    Producer producer = {&ring, retry};
+    pthread_t thread;
+    CHECK(pthread_create(&thread, NULL, produce, &producer) == 0);
+
+    // Frames come out in push order, without gaps unless the producer dropped them
+    uint32_t popped = 0;
+    int64_t last = -1;
+    while (last < CONCURRENT_FRAMES - 1) {
+        if (KSRP_Ring_Pop(&ring, &frame) != KSRP_STATUS_OK) {
+            if (!retry && popped + KSRP_Ring_GetDropped(&ring) == CONCURRENT_FRAMES) {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        KSRP_RawData_Frame expected;
+        const uint32_t sequence = frame_sequence(&frame);
+        make_frame(&expected, sequence);
+        CHECK((int64_t)sequence > last);
+        CHECK(!retry || (int64_t)sequence == last + 1);
+        CHECK(frame.length == expected.length && memcmp(frame.data, expected.data, frame.length) == 0);
+        last = sequence;
+        popped++;
+    }
+
+    CHECK(pthread_join(thread, NULL) == 0);
+    while (KSRP_Ring_Pop(&ring, &frame) == KSRP_STATUS_OK) {
+        popped++;
+    }
+    // Every push into full ring counts as dropped, also when the producer retries it
+    CHECK(retry ? popped == CONCURRENT_FRAMES : popped + KSRP_Ring_GetDropped(&ring) == CONCURRENT_FRAMES);
+}
+
+static void test_concurrent_producer_and_consumer(void) {
+    run_concurrent(true);
+}
+
+static void test_concurrent_producer_dropping_frames(void) {
+    run_concurrent(false);
+}
+
+int main(void) {
+    RUN_TEST(test_capacity_must_be_power_of_two);
+    RUN_TEST(test_fifo_order_and_drops);
+    RUN_TEST(test_indices_wrap_around);
+    RUN_TEST(test_concurrent_producer_and_consumer);
+    RUN_TEST(test_concurrent_producer_dropping_frames);
+    return EXIT_SUCCESS;
+}
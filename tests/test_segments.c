@@ -0,0 +1,301 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ksrp/protocols/protocol_utils.h"
+#include "ksrp_test.h"
+
+#define TIMEOUT_MS 100
+#define MAX_SEGMENTS 8
+
+static KSRP_RawData_Frame segments[MAX_SEGMENTS];
+static uint32_t segments_count;
+
+static KSRP_Status record_segment(KSRP_RawData_Frame* frame) {
+    CHECK(segments_count < MAX_SEGMENTS);
+    segments[segments_count++] = *frame;
+    return KSRP_STATUS_OK;
+}
+
+// Samples are consecutive fields of packed frames, so they are accessed through bytes of the frame
+#define SAMPLE_OFFSET(frame_type, sample_type, index) (offsetof(frame_type, sample_0) + (index) * sizeof(sample_type))
+
+static KSRP_Diagnostics_Report_Frame report(uint8_t device_id, double seed) {
+    KSRP_Diagnostics_Report_Frame frame;
+    KSRP_Init_Diagnostics_Report_Frame(&frame);
+    frame.device_id = device_id;
+    for (uint32_t i = 0; i < 40; i++) {
+        const double sample = seed + i * 0.5;
+        memcpy((uint8_t*)&frame + SAMPLE_OFFSET(KSRP_Diagnostics_Report_Frame, double, i), &sample, sizeof(sample));
+    }
+    return frame;
+}
+
+static float packed_sample(const KSRP_Diagnostics_PackedReport_Frame* frame, uint32_t index) {
+    float sample;
+    memcpy(&sample, (const uint8_t*)frame + SAMPLE_OFFSET(KSRP_Diagnostics_PackedReport_Frame, float, index),
+           sizeof(sample));
+    return sample;
+}
+
+static void pack_report(const KSRP_Diagnostics_Report_Frame* frame, uint8_t sequence) {
+    segments_count = 0;
+    CHECK_OK(KSRP_PackSegmented_Diagnostics_Report(frame, sequence, record_segment));
+    CHECK(segments_count == KSRP_DIAGNOSTICS_REPORT_SEGMENTS_COUNT);
+}
+
+static void push(KSRP_Reassembler* reassembler, uint32_t index, uint32_t now_ms, bool completes) {
+    KSRP_SegmentedPayload payload;
+    CHECK_OK(KSRP_Reassembler_Push(reassembler, &segments[index], now_ms, &payload));
+    CHECK((payload.data != NULL) == completes);
+}
+
+static void check_completed_report(const KSRP_SegmentedPayload* payload,
+                                   const KSRP_Diagnostics_Report_Frame* expected) {
+    KSRP_Diagnostics_Report_Frame frame;
+    CHECK(payload->data != NULL);
+    CHECK(payload->type_id == KSRP_DIAGNOSTICS_REPORT_TYPE_ID);
+    CHECK(payload->device_id == expected->device_id);
+    CHECK(payload->length == KSRP_DIAGNOSTICS_REPORT_WIRE_SIZE);
+    CHECK_OK(KSRP_UnpackSegmented_Diagnostics_Report(payload, &frame));
+    CHECK(memcmp(&frame, expected, sizeof(frame)) == 0);
+}
+
+static void test_segments_carry_serialized_frame(void) {
+    const KSRP_Diagnostics_Report_Frame frame = report(1, 3.25);
+    uint8_t serialized[KSRP_DIAGNOSTICS_REPORT_WIRE_SIZE];
+    KSRP_Serialize_Diagnostics_Report(&frame, serialized);
+    pack_report(&frame, 9);
+
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < segments_count; i++) {
+        const KSRP_RawData_Frame* segment = &segments[i];
+        CHECK(KSRP_Segment_IsSegment(segment));
+        CHECK(segment->data[2] == KSRP_DIAGNOSTICS_SUBSYSTEM_ID);
+        CHECK(segment->data[3] == KSRP_DIAGNOSTICS_REPORT_FRAME_ID);
+        CHECK(segment->data[4] == 1 && segment->data[5] == 9 && segment->data[6] == i);
+        CHECK(segment->data[7] == KSRP_DIAGNOSTICS_REPORT_SEGMENTS_COUNT);
+        const uint32_t chunk = segment->length - KSRP_SEGMENT_HEADER_BYTES;
+        CHECK(i + 1 == segments_count || chunk == KSRP_SEGMENT_PAYLOAD_BYTES);
+        CHECK(memcmp(&segment->data[KSRP_SEGMENT_HEADER_BYTES], &serialized[offset], chunk) == 0);
+        offset += chunk;
+    }
+    CHECK(offset == KSRP_DIAGNOSTICS_REPORT_WIRE_SIZE);
+
+    // Single raw data frame can't carry it
+    KSRP_RawData_Frame raw;
+    CHECK(KSRP_Pack_Diagnostics_Report(&frame, &raw) == KSRP_STATUS_INVALID_DATA_SIZE);
+}
+
+static void test_bit_packed_frame_crossing_segments(void) {
+    KSRP_Diagnostics_PackedReport_Frame frame;
+    KSRP_Diagnostics_PackedReport_Frame unpacked;
+    KSRP_Init_Diagnostics_PackedReport_Frame(&frame);
+    frame.device_id = 1;
+    for (uint32_t i = 0; i < 80; i++) {
+        const float sample = -40.0f + (float)i * 0.97f;
+        memcpy((uint8_t*)&frame + SAMPLE_OFFSET(KSRP_Diagnostics_PackedReport_Frame, float, i), &sample,
+               sizeof(sample));
+    }
+
+    uint8_t serialized[KSRP_DIAGNOSTICS_PACKED_REPORT_WIRE_SIZE];
+    KSRP_Serialize_Diagnostics_PackedReport(&frame, serialized);
+    segments_count = 0;
+    CHECK_OK(KSRP_PackSegmented_Diagnostics_PackedReport(&frame, 4, record_segment));
+    CHECK(segments_count == KSRP_DIAGNOSTICS_PACKED_REPORT_SEGMENTS_COUNT);
+
+    KSRP_ReassemblySlot slots[1];
+    KSRP_Reassembler reassembler;
+    KSRP_SegmentedPayload payload;
+    KSRP_Reassembler_Init(&reassembler, slots, 1, TIMEOUT_MS);
+    for (uint32_t i = 0; i < segments_count; i++) {
+        CHECK_OK(KSRP_Reassembler_Push(&reassembler, &segments[segments_count - 1 - i], 0, &payload));
+    }
+    CHECK(payload.data != NULL && payload.length == KSRP_DIAGNOSTICS_PACKED_REPORT_WIRE_SIZE);
+    CHECK(memcmp(payload.data, serialized, sizeof(serialized)) == 0);
+
+    CHECK_OK(KSRP_UnpackSegmented_Diagnostics_PackedReport(&payload, &unpacked));
+    for (uint32_t i = 0; i < 80; i++) {
+        const float error = packed_sample(&unpacked, i) - packed_sample(&frame, i);
+        CHECK(error <= 0.005f + 1e-4f && error >= -0.005f - 1e-4f);
+    }
+}
+
+static void test_reassembly_in_any_order_with_duplicates(void) {
+    static KSRP_ReassemblySlot slots[2];
+    KSRP_Reassembler reassembler;
+    KSRP_SegmentedPayload payload;
+    KSRP_Reassembler_Init(&reassembler, slots, 2, TIMEOUT_MS);
+    const KSRP_Diagnostics_Report_Frame frame = report(0, -7.5);
+    pack_report(&frame, 1);
+
+    const uint32_t order[] = {3, 0, 5, 0, 3, 1, 4};
+    for (uint32_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+        push(&reassembler, order[i], 10, false);
+    }
+    CHECK_OK(KSRP_Reassembler_Push(&reassembler, &segments[2], 20, &payload));
+    check_completed_report(&payload, &frame);
+
+    // Late duplicates of the completed frame are ignored
+    push(&reassembler, 4, 30, false);
+    push(&reassembler, 2, 30, false);
+    CHECK(KSRP_Reassembler_GetDropped(&reassembler) == 0);
+}
+
+static void test_lost_segment_is_evicted(void) {
+    static KSRP_ReassemblySlot slots[2];
+    KSRP_Reassembler reassembler;
+    KSRP_SegmentedPayload payload;
+    KSRP_Reassembler_Init(&reassembler, slots, 2, TIMEOUT_MS);
+    const KSRP_Diagnostics_Report_Frame lost = report(1, 1.0);
+    const KSRP_Diagnostics_Report_Frame next = report(1, 2.0);
+
+    pack_report(&lost, 1);
+    for (uint32_t i = 0; i + 1 < segments_count; i++) {
+        push(&reassembler, i, 0, false);
+    }
+    CHECK(KSRP_Reassembler_Evict(&reassembler, TIMEOUT_MS - 1) == 0);
+    CHECK(KSRP_Reassembler_Evict(&reassembler, TIMEOUT_MS) == 1);
+    CHECK(KSRP_Reassembler_GetDropped(&reassembler) == 1);
+
+    // Segment of the evicted frame starts it over, so it never completes with stale parts
+    push(&reassembler, segments_count - 1, TIMEOUT_MS, false);
+
+    pack_report(&next, 2);
+    for (uint32_t i = 0; i < segments_count; i++) {
+        CHECK_OK(KSRP_Reassembler_Push(&reassembler, &segments[i], TIMEOUT_MS + 1, &payload));
+    }
+    check_completed_report(&payload, &next);
+    CHECK(KSRP_Reassembler_GetDropped(&reassembler) == 2);
+}
+
+static void test_new_sequence_replaces_incomplete_frame(void) {
+    static KSRP_ReassemblySlot slots[1];
+    KSRP_Reassembler reassembler;
+    KSRP_SegmentedPayload payload;
+    KSRP_Reassembler_Init(&reassembler, slots, 1, TIMEOUT_MS);
+    const KSRP_Diagnostics_Report_Frame old = report(0, 10.0);
+    const KSRP_Diagnostics_Report_Frame new = report(0, 20.0);
+
+    pack_report(&old, 5);
+    push(&reassembler, 0, 0, false);
+    push(&reassembler, 1, 0, false);
+    pack_report(&new, 6);
+    for (uint32_t i = segments_count; i > 0; i--) {
+        CHECK_OK(KSRP_Reassembler_Push(&reassembler, &segments[i - 1], 1, &payload));
+    }
+    check_completed_report(&payload, &new);
+    CHECK(KSRP_Reassembler_GetDropped(&reassembler) == 1);
+}
+
+static void test_slots_limit_frames_in_progress(void) {
+    static KSRP_ReassemblySlot slots[2];
+    static KSRP_RawData_Frame first_segments[3][MAX_SEGMENTS];
+    KSRP_Reassembler reassembler;
+    KSRP_SegmentedPayload payload;
+    KSRP_Reassembler_Init(&reassembler, slots, 2, TIMEOUT_MS);
+
+    // Reports of both devices and a packed report, each frame takes its own slot
+    const KSRP_Diagnostics_Report_Frame device_0 = report(0, 1.0);
+    const KSRP_Diagnostics_Report_Frame device_1 = report(1, 2.0);
+    KSRP_Diagnostics_PackedReport_Frame packed;
+    KSRP_Init_Diagnostics_PackedReport_Frame(&packed);
+    pack_report(&device_0, 1);
+    memcpy(first_segments[0], segments, sizeof(segments));
+    pack_report(&device_1, 1);
+    memcpy(first_segments[1], segments, sizeof(segments));
+    segments_count = 0;
+    CHECK_OK(KSRP_PackSegmented_Diagnostics_PackedReport(&packed, 1, record_segment));
+    memcpy(first_segments[2], segments, sizeof(segments));
+
+    CHECK_OK(KSRP_Reassembler_Push(&reassembler, &first_segments[0][0], 0, &payload));
+    CHECK_OK(KSRP_Reassembler_Push(&reassembler, &first_segments[1][0], 50, &payload));
+    CHECK(KSRP_Reassembler_Push(&reassembler, &first_segments[2][0], 60, &payload) == KSRP_STATUS_ERROR);
+
+    // Once the oldest frame times out its slot is taken over
+    CHECK_OK(KSRP_Reassembler_Push(&reassembler, &first_segments[2][0], TIMEOUT_MS, &payload));
+    CHECK(KSRP_Reassembler_GetDropped(&reassembler) == 1);
+
+    // Interleaved frames complete independently
+    for (uint32_t i = 1; i < KSRP_DIAGNOSTICS_REPORT_SEGMENTS_COUNT; i++) {
+        CHECK_OK(KSRP_Reassembler_Push(&reassembler, &first_segments[1][i], TIMEOUT_MS, &payload));
+        if (i < KSRP_DIAGNOSTICS_PACKED_REPORT_SEGMENTS_COUNT) {
+            KSRP_SegmentedPayload packed_payload;
+            CHECK_OK(KSRP_Reassembler_Push(&reassembler, &first_segments[2][i], TIMEOUT_MS, &packed_payload));
+            CHECK((packed_payload.data != NULL) == (i + 1 == KSRP_DIAGNOSTICS_PACKED_REPORT_SEGMENTS_COUNT));
+        }
+    }
+    check_completed_report(&payload, &device_1);
+}
+
+static void test_malformed_segments_are_rejected(void) {
+    static KSRP_ReassemblySlot slots[1];
+    KSRP_Reassembler reassembler;
+    KSRP_SegmentedPayload payload;
+    KSRP_RawData_Frame segment;
+    KSRP_Reassembler_Init(&reassembler, slots, 1, TIMEOUT_MS);
+    const KSRP_Diagnostics_Report_Frame frame = report(0, 0.0);
+    pack_report(&frame, 1);
+
+    KSRP_RawData_Frame raw = {.data = {KSRP_DIAGNOSTICS_SUBSYSTEM_ID, KSRP_DIAGNOSTICS_REPORT_FRAME_ID}, .length = 2};
+    CHECK(KSRP_Reassembler_Push(&reassembler, &raw, 0, &payload) == KSRP_STATUS_INVALID_FRAME_TYPE);
+
+    segment = segments[0];
+    segment.length = KSRP_SEGMENT_HEADER_BYTES;
+    CHECK(KSRP_Reassembler_Push(&reassembler, &segment, 0, &payload) == KSRP_STATUS_INVALID_DATA_SIZE);
+
+    // Only the last segment may be shorter
+    segment = segments[1];
+    segment.length--;
+    CHECK(KSRP_Reassembler_Push(&reassembler, &segment, 0, &payload) == KSRP_STATUS_INVALID_DATA_SIZE);
+
+    segment = segments[0];
+    segment.data[6] = segment.data[7];
+    CHECK(KSRP_Reassembler_Push(&reassembler, &segment, 0, &payload) == KSRP_STATUS_INVALID_DATA_SIZE);
+
+    // Frame larger than reassembly slots
+    segment = segments[0];
+    segment.data[7] = KSRP_SEGMENTS_MAX_COUNT + 1;
+    CHECK(KSRP_Reassembler_Push(&reassembler, &segment, 0, &payload) == KSRP_STATUS_INVALID_DATA_SIZE);
+
+    segment = segments[0];
+    segment.data[2] = KSRP_GET_SUBSYSTEM_ID_FROM_TYPE_ID(KSRP_ILLEGAL_TYPE_ID);
+    segment.data[3] = KSRP_GET_TYPE_ID_FROM_TYPE_ID(KSRP_ILLEGAL_TYPE_ID);
+    CHECK(KSRP_Reassembler_Push(&reassembler, &segment, 0, &payload) == KSRP_STATUS_INVALID_DATA_SIZE);
+
+    CHECK(KSRP_Reassembler_GetDropped(&reassembler) == 0);
+    CHECK(KSRP_Reassembler_Evict(&reassembler, 10 * TIMEOUT_MS) == 0);
+}
+
+static void test_instance_receives_segmented_frame(void) {
+    static KSRP_Diagnostics_Instance sender;
+    static KSRP_Diagnostics_Instance receiver;
+    static KSRP_ReassemblySlot slots[2];
+    KSRP_Reassembler reassembler;
+    KSRP_Reassembler_Init(&reassembler, slots, 2, TIMEOUT_MS);
+    CHECK_OK(KSRP_Init_Diagnostics_Instance(&sender));
+    CHECK_OK(KSRP_Init_Diagnostics_Instance(&receiver));
+    CHECK_OK(KSRP_Diagnostics_Instance_SetSendFrameCallback(&sender, record_segment));
+    CHECK_OK(KSRP_Dispatch_Register_Diagnostics_Instance(&receiver));
+
+    KSRP_Diagnostics_Report_Frame frame = report(1, 42.0);
+    segments_count = 0;
+    CHECK_OK(KSRP_UpdateFrame_Diagnostics_Instance(&sender, KSRP_DIAGNOSTICS_REPORT_FRAME_ID, &frame, sizeof(frame)));
+    CHECK(segments_count == KSRP_DIAGNOSTICS_REPORT_SEGMENTS_COUNT);
+    for (uint32_t i = 0; i < segments_count; i++) {
+        CHECK_OK(KSRP_DispatchSegment(&reassembler, &segments[i], 0));
+        CHECK((memcmp(&receiver.report_instance[1], &frame, sizeof(frame)) == 0) == (i + 1 == segments_count));
+    }
+}
+
+int main(void) {
+    RUN_TEST(test_segments_carry_serialized_frame);
+    RUN_TEST(test_bit_packed_frame_crossing_segments);
+    RUN_TEST(test_reassembly_in_any_order_with_duplicates);
+    RUN_TEST(test_lost_segment_is_evicted);
+    RUN_TEST(test_new_sequence_replaces_incomplete_frame);
+    RUN_TEST(test_slots_limit_frames_in_progress);
+    RUN_TEST(test_malformed_segments_are_rejected);
+    RUN_TEST(test_instance_receives_segmented_frame);
+    return EXIT_SUCCESS;
+}
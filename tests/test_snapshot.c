@@ -0,0 +1,247 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "ksrp/delta.h"
+#include "ksrp/protocols/protocol_registry.h"
+#include "ksrp/protocols/protocol_utils.h"
+#include "ksrp_test.h"
+
+#define REGISTRIES 3
+// Bytes of a single device in telemetry section, frames are stored with time since their update and health results
+#define TELEMETRY_DEVICE_STATE_SIZE (KSRP_TELEMETRY_SNAPSHOT_STATE_SIZE / KSRP_TELEMETRY_MAX_DEVICES)
+
+static KSRP_Registry original[REGISTRIES];
+static KSRP_Registry restored[REGISTRIES];
+static uint32_t motor_status_stale;
+static uint32_t power_status_stale;
+
+static KSRP_Status on_stale(uint32_t subsystem_id, void* frame_instance, uint32_t frame_id, uint32_t age) {
+    (void)frame_instance;
+    (void)age;
+    CHECK(subsystem_id == KSRP_TELEMETRY_SUBSYSTEM_ID);
+    motor_status_stale += frame_id == KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID;
+    power_status_stale += frame_id == KSRP_TELEMETRY_POWER_STATUS_FRAME_ID;
+    return KSRP_STATUS_OK;
+}
+
+static void update_motor_status(KSRP_Telemetry_Instance* instance, uint8_t device_id, float temperature) {
+    KSRP_Telemetry_MotorStatus_Frame frame;
+    KSRP_Init_Telemetry_MotorStatus_Frame(&frame);
+    frame.device_id = device_id;
+    frame.temperature = temperature;
+    frame.counter = device_id * 1000u;
+    CHECK_OK(KSRP_UpdateFrame_Telemetry_Instance(instance, KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID, &frame,
+                                                 sizeof(frame)));
+}
+
+// Registry 1 has frames of different ages and health, registry 2 holds a segmented diagnostics report
+static void make_registries(void) {
+    CHECK_OK(KSRP_Registry_Init(original, REGISTRIES));
+
+    KSRP_Telemetry_Instance* telemetry = &original[1].telemetry;
+    CHECK_OK(KSRP_UpdateTime_Telemetry_Instance(telemetry, 1000));
+    update_motor_status(telemetry, 2, 90.0f);
+    KSRP_Telemetry_PowerStatus_Frame power_status;
+    KSRP_Init_Telemetry_PowerStatus_Frame(&power_status);
+    power_status.device_id = 3;
+    power_status.state = 2;
+    power_status.energy = UINT64_MAX - 1;
+    CHECK_OK(KSRP_UpdateFrame_Telemetry_Instance(telemetry, KSRP_TELEMETRY_POWER_STATUS_FRAME_ID, &power_status,
+                                                 sizeof(power_status)));
+    CHECK_OK(KSRP_UpdateTime_Telemetry_Instance(telemetry, 30));
+    update_motor_status(telemetry, 0, 20.0f);
+    CHECK_OK(KSRP_UpdateTime_Telemetry_Instance(telemetry, 10));
+
+    KSRP_Diagnostics_Report_Frame report;
+    KSRP_Init_Diagnostics_Report_Frame(&report);
+    report.device_id = 1;
+    report.sample_0 = -1.5;
+    report.sample_39 = 1e300;
+    CHECK_OK(KSRP_UpdateFrame_Diagnostics_Instance(&original[2].diagnostics, KSRP_DIAGNOSTICS_REPORT_FRAME_ID, &report,
+                                                   sizeof(report)));
+}
+
+static void test_registry_round_trip(void) {
+    make_registries();
+    static uint8_t image[KSRP_REGISTRY_SNAPSHOT_SIZE(REGISTRIES)];
+    size_t length;
+    CHECK(KSRP_Registry_Snapshot(original, REGISTRIES, image, sizeof(image) - 1, &length) ==
+          KSRP_STATUS_INVALID_DATA_SIZE);
+    CHECK_OK(KSRP_Registry_Snapshot(original, REGISTRIES, image, sizeof(image), &length));
+    CHECK(length == sizeof(image));
+
+    // Restored into zeroed registries, callbacks set before the restore are kept
+    memset(restored, 0, sizeof(restored));
+    KSRP_Telemetry_Instance* telemetry = &restored[1].telemetry;
+    CHECK_OK(KSRP_Telemetry_Instance_SetStaleCallback(telemetry, KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID, on_stale));
+    CHECK_OK(KSRP_Telemetry_Instance_SetStaleCallback(telemetry, KSRP_TELEMETRY_POWER_STATUS_FRAME_ID, on_stale));
+    CHECK_OK(KSRP_Registry_Restore(restored, REGISTRIES, image, length));
+
+    const KSRP_Telemetry_Instance* expected = &original[1].telemetry;
+    CHECK(memcmp(telemetry->motor_status_instance, expected->motor_status_instance,
+                 sizeof(expected->motor_status_instance)) == 0);
+    CHECK(memcmp(telemetry->power_status_instance, expected->power_status_instance,
+                 sizeof(expected->power_status_instance)) == 0);
+    CHECK(memcmp(restored[2].diagnostics.report_instance, original[2].diagnostics.report_instance,
+                 sizeof(original[2].diagnostics.report_instance)) == 0);
+    for (uint8_t device_id = 0; device_id < KSRP_TELEMETRY_MAX_DEVICES; device_id++) {
+        CHECK(KSRP_Telemetry_Instance_GetTimeSinceLastUpdate(telemetry, device_id,
+                                                             KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID) ==
+              KSRP_Telemetry_Instance_GetTimeSinceLastUpdate((KSRP_Telemetry_Instance*)expected, device_id,
+                                                             KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID));
+        CHECK(telemetry->motor_status_temperature_health[device_id] ==
+              expected->motor_status_temperature_health[device_id]);
+        CHECK(telemetry->power_status_state_health[device_id] == expected->power_status_state_health[device_id]);
+    }
+    CHECK(telemetry->motor_status_temperature_health[2] == KSRP_RESULT_WARNING);
+    CHECK(telemetry->power_status_state_health[3] == KSRP_RESULT_CRITICAL);
+
+    // Frames already stale are reported again, the rest when their timeout expires
+    CHECK_OK(KSRP_UpdateTime_Telemetry_Instance(telemetry, 0));
+    CHECK(motor_status_stale == 2 && power_status_stale == 3);
+    CHECK_OK(KSRP_UpdateTime_Telemetry_Instance(telemetry, 59));
+    CHECK(motor_status_stale == 2);
+    CHECK_OK(KSRP_UpdateTime_Telemetry_Instance(telemetry, 1));
+    CHECK(motor_status_stale == 3);
+    CHECK_OK(KSRP_UpdateTime_Telemetry_Instance(telemetry, 30));
+    CHECK(motor_status_stale == 4);
+    CHECK_OK(KSRP_UpdateTime_Telemetry_Instance(telemetry, 200));
+    CHECK(motor_status_stale == 4 && power_status_stale == 4);
+
+    // Receive queue works after the restore
+    KSRP_Telemetry_MotorStatus_Frame frame;
+    KSRP_Init_Telemetry_MotorStatus_Frame(&frame);
+    frame.device_id = 3;
+    frame.counter = 77;
+    KSRP_RawData_Frame raw;
+    CHECK_OK(KSRP_Pack_Telemetry_MotorStatus(&frame, &raw));
+    CHECK_OK(KSRP_Registry_Receive(&restored[1], &raw));
+    CHECK_OK(KSRP_Registry_Drain(restored, REGISTRIES));
+    CHECK(telemetry->motor_status_instance[3].counter == 77);
+}
+
+static KSRP_RawData_Frame sent;
+static uint32_t sent_count;
+
+static KSRP_Status record_frame(KSRP_RawData_Frame* frame) {
+    sent = *frame;
+    sent_count++;
+    return KSRP_STATUS_OK;
+}
+
+static void test_restored_sender_starts_with_keyframe(void) {
+    static KSRP_Telemetry_Instance sender;
+    CHECK_OK(KSRP_Init_Telemetry_Instance(&sender));
+    CHECK_OK(KSRP_Telemetry_Instance_SetSendFrameCallback(&sender, record_frame));
+    update_motor_status(&sender, 1, 30.0f);
+    update_motor_status(&sender, 1, 31.0f);
+    CHECK(sent_count == 2 && KSRP_Delta_IsDelta(&sent));
+
+    uint8_t image[KSRP_TELEMETRY_SNAPSHOT_SIZE];
+    size_t length;
+    KSRP_SnapshotWriter writer;
+    KSRP_SnapshotWriter_Init(&writer, image, sizeof(image));
+    CHECK_OK(KSRP_Snapshot_Telemetry_Instance(&sender, 0, &writer));
+    CHECK_OK(KSRP_SnapshotWriter_Finish(&writer, &length));
+    KSRP_SnapshotReader reader;
+    KSRP_SnapshotSection section;
+    CHECK_OK(KSRP_SnapshotReader_Init(&reader, image, length));
+    CHECK_OK(KSRP_SnapshotReader_Next(&reader, &section));
+
+    // Receivers may have missed anything since the snapshot, so they are resynced first
+    CHECK_OK(KSRP_Restore_Telemetry_Instance(&sender, &section));
+    update_motor_status(&sender, 1, 32.0f);
+    CHECK(sent_count == 3 && !KSRP_Delta_IsDelta(&sent));
+    update_motor_status(&sender, 1, 33.0f);
+    CHECK(sent_count == 4 && KSRP_Delta_IsDelta(&sent));
+}
+
+static void read_single_section(const KSRP_Telemetry_Instance* instance, uint8_t* image,
+                                KSRP_SnapshotSection* section) {
+    size_t length;
+    KSRP_SnapshotWriter writer;
+    KSRP_SnapshotWriter_Init(&writer, image, KSRP_TELEMETRY_SNAPSHOT_SIZE);
+    CHECK_OK(KSRP_Snapshot_Telemetry_Instance(instance, 0, &writer));
+    CHECK_OK(KSRP_SnapshotWriter_Finish(&writer, &length));
+    CHECK(length == KSRP_TELEMETRY_SNAPSHOT_SIZE);
+
+    KSRP_SnapshotReader reader;
+    CHECK_OK(KSRP_SnapshotReader_Init(&reader, image, length));
+    CHECK_OK(KSRP_SnapshotReader_Next(&reader, section));
+    CHECK(KSRP_SnapshotReader_Next(&reader, section + 1) == KSRP_STATUS_ERROR);
+}
+
+static void test_invalid_section_leaves_instance_untouched(void) {
+    static KSRP_Telemetry_Instance instance;
+    static KSRP_Telemetry_Instance before;
+    CHECK_OK(KSRP_Init_Telemetry_Instance(&instance));
+    for (uint8_t device_id = 0; device_id < KSRP_TELEMETRY_MAX_DEVICES; device_id++) {
+        update_motor_status(&instance, device_id, 10.0f + device_id);
+    }
+
+    uint8_t image[KSRP_TELEMETRY_SNAPSHOT_SIZE];
+    KSRP_SnapshotSection sections[2];
+    read_single_section(&instance, image, sections);
+    const KSRP_SnapshotSection section = sections[0];
+
+    // The live instance moves on, so a partial restore would be visible
+    update_motor_status(&instance, 1, 99.0f);
+    CHECK_OK(KSRP_UpdateTime_Telemetry_Instance(&instance, 50));
+    memcpy(&before, &instance, sizeof(instance));
+
+    // Power status of the last device claims to belong to another device
+    uint8_t state[KSRP_TELEMETRY_SNAPSHOT_STATE_SIZE];
+    memcpy(state, section.data, sizeof(state));
+    state[(KSRP_TELEMETRY_MAX_DEVICES - 1) * TELEMETRY_DEVICE_STATE_SIZE + KSRP_TELEMETRY_MOTOR_STATUS_WIRE_SIZE +
+          sizeof(uint32_t) + 1] = 0;
+    KSRP_SnapshotSection invalid = section;
+    invalid.data = state;
+    CHECK(KSRP_Restore_Telemetry_Instance(&instance, &invalid) == KSRP_STATUS_INVALID_DEVICE_ID);
+    CHECK(memcmp(&before, &instance, sizeof(instance)) == 0);
+
+    invalid = section;
+    invalid.definition_hash ^= 1;
+    CHECK(KSRP_Restore_Telemetry_Instance(&instance, &invalid) == KSRP_STATUS_ERROR);
+    invalid = section;
+    invalid.length--;
+    CHECK(KSRP_Restore_Telemetry_Instance(&instance, &invalid) == KSRP_STATUS_INVALID_DATA_SIZE);
+    invalid = section;
+    invalid.subsystem_id = KSRP_DIAGNOSTICS_SUBSYSTEM_ID;
+    CHECK(KSRP_Restore_Telemetry_Instance(&instance, &invalid) == KSRP_STATUS_INVALID_FRAME_TYPE);
+    CHECK(memcmp(&before, &instance, sizeof(instance)) == 0);
+
+    CHECK_OK(KSRP_Restore_Telemetry_Instance(&instance, &section));
+    CHECK(instance.motor_status_instance[1].temperature == before.motor_status_instance[0].temperature + 1.0f);
+}
+
+static void test_invalid_images(void) {
+    static KSRP_Telemetry_Instance instance;
+    CHECK_OK(KSRP_Init_Telemetry_Instance(&instance));
+    uint8_t image[KSRP_TELEMETRY_SNAPSHOT_SIZE];
+    KSRP_SnapshotSection sections[2];
+    read_single_section(&instance, image, sections);
+
+    KSRP_SnapshotReader reader;
+    CHECK_OK(KSRP_SnapshotReader_Init(&reader, image, sizeof(image) - 1));
+    CHECK(KSRP_SnapshotReader_Next(&reader, sections) == KSRP_STATUS_INVALID_DATA_SIZE);
+    CHECK(KSRP_SnapshotReader_Init(&reader, image, KSRP_SNAPSHOT_HEADER_BYTES - 1) != KSRP_STATUS_OK);
+
+    // Telemetry section of registry 0 restores fine, sections of registries out of range are rejected
+    static uint8_t registry_image[KSRP_REGISTRY_SNAPSHOT_SIZE(REGISTRIES)];
+    size_t length;
+    make_registries();
+    CHECK_OK(KSRP_Registry_Snapshot(original, REGISTRIES, registry_image, sizeof(registry_image), &length));
+    CHECK(KSRP_Registry_Restore(restored, 1, registry_image, length) == KSRP_STATUS_INVALID_FRAME_TYPE);
+
+    image[0] ^= 0xFF;
+    CHECK(KSRP_SnapshotReader_Init(&reader, image, sizeof(image)) == KSRP_STATUS_ERROR);
+    CHECK(KSRP_Registry_Restore(restored, REGISTRIES, image, sizeof(image)) == KSRP_STATUS_ERROR);
+}
+
+int main(void) {
+    RUN_TEST(test_registry_round_trip);
+    RUN_TEST(test_restored_sender_starts_with_keyframe);
+    RUN_TEST(test_invalid_section_leaves_instance_untouched);
+    RUN_TEST(test_invalid_images);
+    return EXIT_SUCCESS;
+}
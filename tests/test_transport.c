@@ -0,0 +1,229 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ksrp/host/udp.h"
+#include "ksrp/protocols/protocol_utils.h"
+#include "ksrp/transport.h"
+#include "ksrp_test.h"
+
+#define LOOPBACK_FRAMES 64
+#define REASSEMBLY_SLOTS 4
+#define BATCH_FRAMES (3 * KSRP_UDP_BATCH_FRAMES + 5)
+
+static KSRP_Transport* sender_transport;
+
+static KSRP_Status queue_frame(KSRP_RawData_Frame* frame) {
+    return KSRP_Transport_Queue(sender_transport, frame);
+}
+
+static KSRP_RawData_Frame small_frame(uint8_t value) {
+    KSRP_RawData_Frame frame;
+    KSRP_RawDataFrame_Init(&frame);
+    frame.data[0] = 1;
+    frame.data[1] = 2;
+    frame.data[2] = value;
+    frame.length = 3;
+    return frame;
+}
+
+// Receives until the transport stays idle, frames have to arrive in the order they were sent
+static uint32_t receive_in_order(KSRP_Transport* transport, uint32_t timeout_ms, uint8_t first) {
+    KSRP_RawData_Frame frames[KSRP_TRANSPORT_RX_CAPACITY];
+    uint32_t total = 0;
+    while (KSRP_Transport_Wait(transport, timeout_ms) == KSRP_STATUS_OK) {
+        uint32_t received = 0;
+        CHECK_OK(KSRP_Transport_Receive(transport, frames, KSRP_TRANSPORT_RX_CAPACITY, &received));
+        for (uint32_t i = 0; i < received; i++) {
+            CHECK(frames[i].length == 3 && frames[i].data[2] == (uint8_t)(first + total + i));
+        }
+        total += received;
+    }
+    return total;
+}
+
+static void test_loopback_backpressure(void) {
+    static KSRP_Ring ring;
+    static KSRP_RawData_Frame ring_frames[4];
+    static KSRP_Transport transport;
+    CHECK(KSRP_Loopback_Open(&transport, &ring, ring_frames, 3) == KSRP_STATUS_INVALID_DATA_SIZE);
+    CHECK_OK(KSRP_Loopback_Open(&transport, &ring, ring_frames, 4));
+
+    // Queueing into a full transmit queue flushes it, the backend takes only as many frames as it has room for
+    for (uint32_t i = 0; i <= KSRP_TRANSPORT_TX_CAPACITY; i++) {
+        KSRP_RawData_Frame frame = small_frame((uint8_t)i);
+        CHECK_OK(KSRP_Transport_Queue(&transport, &frame));
+    }
+    CHECK(KSRP_Transport_GetQueued(&transport) == KSRP_TRANSPORT_TX_CAPACITY - 4 + 1);
+    CHECK(KSRP_Transport_Flush(&transport) == KSRP_STATUS_BUSY);
+
+    KSRP_RawData_Frame frames[KSRP_TRANSPORT_RX_CAPACITY];
+    uint32_t total = 0;
+    while (KSRP_Transport_GetQueued(&transport) > 0 || KSRP_Transport_Wait(&transport, 0) == KSRP_STATUS_OK) {
+        uint32_t received = 0;
+        CHECK_OK(KSRP_Transport_Receive(&transport, frames, KSRP_TRANSPORT_RX_CAPACITY, &received));
+        for (uint32_t i = 0; i < received; i++) {
+            CHECK(frames[i].length == 3 && frames[i].data[2] == total + i);
+        }
+        total += received;
+        (void)KSRP_Transport_Flush(&transport);
+    }
+    CHECK(total == KSRP_TRANSPORT_TX_CAPACITY + 1);
+    CHECK(KSRP_Transport_Wait(&transport, 0) == KSRP_STATUS_BUSY);
+
+    // Nothing is dropped, a full queue of a full backend refuses new frames instead
+    KSRP_RawData_Frame frame = small_frame(0);
+    for (uint32_t i = 0; i < 4 + KSRP_TRANSPORT_TX_CAPACITY; i++) {
+        CHECK_OK(KSRP_Transport_Queue(&transport, &frame));
+    }
+    CHECK(KSRP_Transport_Queue(&transport, &frame) == KSRP_STATUS_BUSY);
+    CHECK(KSRP_Transport_GetQueued(&transport) == KSRP_TRANSPORT_TX_CAPACITY);
+}
+
+// Segmented and bit-packed reports together with a delta encoded frame go through the transport and the
+// reassembler into the receiving instances
+static void check_dispatch(KSRP_Transport* sender, KSRP_Transport* receiver) {
+    static KSRP_Diagnostics_Instance diagnostics_sender;
+    static KSRP_Diagnostics_Instance diagnostics_receiver;
+    static KSRP_Telemetry_Instance telemetry_sender;
+    static KSRP_Telemetry_Instance telemetry_receiver;
+    static KSRP_ReassemblySlot slots[REASSEMBLY_SLOTS];
+    CHECK_OK(KSRP_Init_Diagnostics_Instance(&diagnostics_sender));
+    CHECK_OK(KSRP_Init_Diagnostics_Instance(&diagnostics_receiver));
+    CHECK_OK(KSRP_Init_Telemetry_Instance(&telemetry_sender));
+    CHECK_OK(KSRP_Init_Telemetry_Instance(&telemetry_receiver));
+    CHECK_OK(KSRP_Diagnostics_Instance_SetSendFrameCallback(&diagnostics_sender, queue_frame));
+    CHECK_OK(KSRP_Telemetry_Instance_SetSendFrameCallback(&telemetry_sender, queue_frame));
+    CHECK_OK(KSRP_Dispatch_Register_Diagnostics_Instance(&diagnostics_receiver));
+    CHECK_OK(KSRP_Dispatch_Register_Telemetry_Instance(&telemetry_receiver));
+    KSRP_Reassembler reassembler;
+    KSRP_Reassembler_Init(&reassembler, slots, REASSEMBLY_SLOTS, 50);
+    sender_transport = sender;
+
+    KSRP_Diagnostics_Report_Frame report;
+    KSRP_Init_Diagnostics_Report_Frame(&report);
+    report.device_id = 1;
+    report.sample_0 = 1.5;
+    report.sample_39 = -2.25;
+    CHECK_OK(KSRP_UpdateFrame_Diagnostics_Instance(&diagnostics_sender, KSRP_DIAGNOSTICS_REPORT_FRAME_ID, &report,
+                                                   sizeof(report)));
+    KSRP_Diagnostics_PackedReport_Frame packed_report;
+    KSRP_Init_Diagnostics_PackedReport_Frame(&packed_report);
+    packed_report.device_id = 0;
+    packed_report.sample_79 = 12.5f;
+    CHECK_OK(KSRP_UpdateFrame_Diagnostics_Instance(&diagnostics_sender, KSRP_DIAGNOSTICS_PACKED_REPORT_FRAME_ID,
+                                                   &packed_report, sizeof(packed_report)));
+    KSRP_Telemetry_MotorStatus_Frame motor_status;
+    KSRP_Init_Telemetry_MotorStatus_Frame(&motor_status);
+    motor_status.device_id = 3;
+    for (uint32_t i = 0; i < 3; i++) {
+        motor_status.counter = i + 1;
+        CHECK_OK(KSRP_UpdateFrame_Telemetry_Instance(&telemetry_sender, KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID,
+                                                     &motor_status, sizeof(motor_status)));
+    }
+
+    const uint32_t queued = KSRP_Transport_GetQueued(sender);
+    CHECK(queued == KSRP_DIAGNOSTICS_REPORT_SEGMENTS_COUNT + KSRP_DIAGNOSTICS_PACKED_REPORT_SEGMENTS_COUNT + 3);
+    CHECK_OK(KSRP_Transport_Flush(sender));
+    CHECK_OK(KSRP_Transport_Wait(receiver, 1000));
+    uint32_t received = 0;
+    while (received < queued && KSRP_Transport_Wait(receiver, 1000) == KSRP_STATUS_OK) {
+        uint32_t batch = 0;
+        CHECK_OK(KSRP_DispatchTransport(receiver, &reassembler, 1, &batch));
+        received += batch;
+    }
+    CHECK(received == queued);
+    CHECK(memcmp(&diagnostics_receiver.report_instance[1], &report, sizeof(report)) == 0);
+    CHECK(diagnostics_receiver.packed_report_instance[0].sample_79 > 12.49f);
+    CHECK(diagnostics_receiver.packed_report_instance[0].sample_79 < 12.51f);
+    CHECK(memcmp(&telemetry_receiver.motor_status_instance[3], &motor_status, sizeof(motor_status)) == 0);
+    CHECK(KSRP_Transport_Wait(receiver, 10) == KSRP_STATUS_BUSY);
+}
+
+static void test_loopback_dispatch(void) {
+    static KSRP_Ring ring;
+    static KSRP_RawData_Frame ring_frames[LOOPBACK_FRAMES];
+    static KSRP_Transport transport;
+    CHECK_OK(KSRP_Loopback_Open(&transport, &ring, ring_frames, LOOPBACK_FRAMES));
+    check_dispatch(&transport, &transport);
+}
+
+static void test_udp(void) {
+    static KSRP_Udp server;
+    static KSRP_Udp client;
+    static KSRP_Transport server_transport;
+    static KSRP_Transport client_transport;
+
+    // Server without a peer learns it from the first datagram, it can't send before
+    CHECK_OK(KSRP_Udp_Open(&server, &server_transport, "127.0.0.1", "0", NULL, NULL));
+    CHECK(KSRP_Udp_GetPort(&server) != 0);
+    char port[16];
+    snprintf(port, sizeof(port), "%u", KSRP_Udp_GetPort(&server));
+    KSRP_RawData_Frame frame = small_frame(100);
+    uint32_t sent = 0;
+    CHECK(KSRP_Transport_Send(&server_transport, &frame, 1, &sent) == KSRP_STATUS_ERROR);
+    CHECK_OK(KSRP_Udp_Open(&client, &client_transport, "127.0.0.1", "0", "127.0.0.1", port));
+
+    check_dispatch(&client_transport, &server_transport);
+    CHECK_OK(KSRP_Transport_Send(&server_transport, &frame, 1, &sent));
+    CHECK(sent == 1);
+    CHECK(receive_in_order(&client_transport, 100, 100) == 1);
+
+    // Datagrams too short to hold a frame are dropped and counted
+    KSRP_RawData_Frame malformed;
+    KSRP_RawDataFrame_Init(&malformed);
+    malformed.length = 1;
+    CHECK_OK(KSRP_Transport_Send(&client_transport, &malformed, 1, &sent));
+    CHECK_OK(KSRP_Transport_Send(&client_transport, &frame, 1, &sent));
+    CHECK(receive_in_order(&server_transport, 100, 100) == 1);
+    CHECK(KSRP_Udp_GetDropped(&server) == 1);
+
+    // Sends larger than a single system call batch keep their order
+    static KSRP_RawData_Frame frames[BATCH_FRAMES];
+    for (uint32_t i = 0; i < BATCH_FRAMES; i++) {
+        frames[i] = small_frame((uint8_t)i);
+    }
+    CHECK_OK(KSRP_Transport_Send(&client_transport, frames, BATCH_FRAMES, &sent));
+    CHECK(sent == BATCH_FRAMES);
+    CHECK(receive_in_order(&server_transport, 100, 0) == BATCH_FRAMES);
+
+    KSRP_Udp_Close(&client);
+    KSRP_Udp_Close(&server);
+}
+
+static void test_udp_pinned_peer(void) {
+    static KSRP_Udp first;
+    static KSRP_Udp second;
+    static KSRP_Udp third;
+    static KSRP_Transport first_transport;
+    static KSRP_Transport second_transport;
+    static KSRP_Transport third_transport;
+    char port[16];
+
+    CHECK_OK(KSRP_Udp_Open(&first, &first_transport, "127.0.0.1", "0", NULL, NULL));
+    snprintf(port, sizeof(port), "%u", KSRP_Udp_GetPort(&first));
+    CHECK_OK(KSRP_Udp_Open(&second, &second_transport, "127.0.0.1", "0", "127.0.0.1", port));
+    snprintf(port, sizeof(port), "%u", KSRP_Udp_GetPort(&second));
+    CHECK_OK(KSRP_Udp_Open(&third, &third_transport, "127.0.0.1", "0", "127.0.0.1", port));
+
+    // Datagram from the third socket doesn't redirect the configured peer of the second one
+    KSRP_RawData_Frame frame = small_frame(7);
+    uint32_t sent = 0;
+    CHECK_OK(KSRP_Transport_Send(&third_transport, &frame, 1, &sent));
+    CHECK(receive_in_order(&second_transport, 100, 7) == 1);
+    CHECK_OK(KSRP_Transport_Send(&second_transport, &frame, 1, &sent));
+    CHECK(receive_in_order(&first_transport, 100, 7) == 1);
+    CHECK(KSRP_Transport_Wait(&third_transport, 50) == KSRP_STATUS_BUSY);
+
+    KSRP_Udp_Close(&third);
+    KSRP_Udp_Close(&second);
+    KSRP_Udp_Close(&first);
+}
+
+int main(void) {
+    RUN_TEST(test_loopback_backpressure);
+    RUN_TEST(test_loopback_dispatch);
+    RUN_TEST(test_udp);
+    RUN_TEST(test_udp_pinned_peer);
+    return EXIT_SUCCESS;
+}
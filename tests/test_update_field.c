@@ -0,0 +1,155 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "ksrp/delta.h"
+#include "ksrp/protocols/protocol_utils.h"
+#include "ksrp_test.h"
+
+// Built against both instance layouts, expectations below are the same for switch and tables layout
+
+#define DEVICE_ID 2
+#define FIELD_BIT(field) ((uint64_t)1 << KSRP_TELEMETRY_MOTOR_STATUS_##field##_FIELD_ID)
+
+static KSRP_Telemetry_Instance instance;
+static KSRP_RawData_Frame sent[4];
+static uint32_t sent_count;
+static uint32_t update_calls;
+static uint32_t last_updated_field;
+static uint32_t health_calls;
+
+static KSRP_Status record_frame(KSRP_RawData_Frame* frame) {
+    CHECK(sent_count < sizeof(sent) / sizeof(sent[0]));
+    sent[sent_count++] = *frame;
+    return KSRP_STATUS_OK;
+}
+
+static KSRP_Status record_update(uint32_t subsystem_id, void* frame_instance, uint32_t frame_id, uint32_t field_id) {
+    CHECK(subsystem_id == KSRP_TELEMETRY_SUBSYSTEM_ID);
+    CHECK(frame_instance == &instance.motor_status_instance[DEVICE_ID]);
+    CHECK(frame_id == KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID);
+    update_calls++;
+    last_updated_field = field_id;
+    return KSRP_STATUS_OK;
+}
+
+static KSRP_Status record_health(uint32_t subsystem_id, void* frame_instance, uint32_t frame_id, uint32_t field_id,
+                                 KSRP_HealthCheckResult previous, KSRP_HealthCheckResult current) {
+    (void)subsystem_id;
+    (void)frame_instance;
+    (void)frame_id;
+    CHECK(field_id == KSRP_TELEMETRY_MOTOR_STATUS_TEMPERATURE_FIELD_ID);
+    CHECK(previous != current);
+    health_calls++;
+    return KSRP_STATUS_OK;
+}
+
+static KSRP_Status update_field(uint32_t field_id, void* value, size_t value_size) {
+    return KSRP_UpdateFrameField_Telemetry_Instance(&instance, DEVICE_ID, KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID,
+                                                    field_id, value, value_size);
+}
+
+static void init_instance(void) {
+    CHECK_OK(KSRP_Init_Telemetry_Instance(&instance));
+    CHECK_OK(KSRP_Telemetry_Instance_SetCallback(&instance, KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID, record_update));
+    CHECK_OK(KSRP_Telemetry_Instance_SetHealthCallback(&instance, KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID,
+                                                       record_health));
+    sent_count = 0;
+    update_calls = 0;
+    health_calls = 0;
+}
+
+static void test_change_detection_and_delta_bits(void) {
+    init_instance();
+    uint32_t counter = 7;
+    int16_t current = -300;
+
+    CHECK_OK(update_field(KSRP_TELEMETRY_MOTOR_STATUS_COUNTER_FIELD_ID, &counter, sizeof(counter)));
+    CHECK_OK(update_field(KSRP_TELEMETRY_MOTOR_STATUS_CURRENT_FIELD_ID, &current, sizeof(current)));
+    CHECK(instance.motor_status_instance[DEVICE_ID].counter == 7);
+    CHECK(instance.motor_status_instance[DEVICE_ID].current == -300);
+    CHECK(update_calls == 2);
+    CHECK(last_updated_field == KSRP_TELEMETRY_MOTOR_STATUS_CURRENT_FIELD_ID);
+    CHECK(instance.motor_status_changed_fields[DEVICE_ID] == (FIELD_BIT(COUNTER) | FIELD_BIT(CURRENT)));
+
+    // Same value is not a change
+    CHECK_OK(update_field(KSRP_TELEMETRY_MOTOR_STATUS_COUNTER_FIELD_ID, &counter, sizeof(counter)));
+    CHECK(update_calls == 2);
+
+    // Send clears the changed fields, first frame is a keyframe and the next one a delta of the changed field
+    CHECK_OK(KSRP_Telemetry_Instance_SetSendFrameCallback(&instance, record_frame));
+    counter++;
+    CHECK_OK(update_field(KSRP_TELEMETRY_MOTOR_STATUS_COUNTER_FIELD_ID, &counter, sizeof(counter)));
+    CHECK(sent_count == 1);
+    CHECK(!KSRP_Delta_IsDelta(&sent[0]));
+    CHECK(instance.motor_status_changed_fields[DEVICE_ID] == 0);
+
+    uint8_t mode = 2;
+    CHECK_OK(update_field(KSRP_TELEMETRY_MOTOR_STATUS_MODE_FIELD_ID, &mode, sizeof(mode)));
+    CHECK(sent_count == 2);
+    CHECK(KSRP_Delta_IsDelta(&sent[1]));
+    KSRP_Telemetry_MotorStatus_Frame patched;
+    KSRP_Telemetry_MotorStatus_Frame original;
+    CHECK_OK(KSRP_Unpack_Telemetry_MotorStatus(&sent[0], &original));
+    patched = original;
+    CHECK_OK(KSRP_ApplyDelta_Telemetry_MotorStatus(&sent[1], &patched));
+    CHECK(patched.mode == 2);
+    original.mode = 2;
+    CHECK(memcmp(&patched, &original, sizeof(patched)) == 0);
+}
+
+static void test_health_update(void) {
+    init_instance();
+    float temperature = 90.0f;
+
+    CHECK_OK(update_field(KSRP_TELEMETRY_MOTOR_STATUS_TEMPERATURE_FIELD_ID, &temperature, sizeof(temperature)));
+    CHECK(KSRP_Telemetry_Instance_GetHealth(&instance, DEVICE_ID, KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID,
+                                            KSRP_TELEMETRY_MOTOR_STATUS_TEMPERATURE_FIELD_ID) ==
+          KSRP_RESULT_WARNING);
+    CHECK(health_calls == 1);
+
+    // Other fields and other devices don't re-evaluate the result
+    uint32_t counter = 1;
+    CHECK_OK(update_field(KSRP_TELEMETRY_MOTOR_STATUS_COUNTER_FIELD_ID, &counter, sizeof(counter)));
+    CHECK(health_calls == 1);
+    CHECK(KSRP_Telemetry_Instance_GetHealth(&instance, DEVICE_ID + 1, KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID,
+                                            KSRP_TELEMETRY_MOTOR_STATUS_TEMPERATURE_FIELD_ID) == KSRP_RESULT_OK);
+
+    temperature = 30.0f;
+    CHECK_OK(update_field(KSRP_TELEMETRY_MOTOR_STATUS_TEMPERATURE_FIELD_ID, &temperature, sizeof(temperature)));
+    CHECK(KSRP_Telemetry_Instance_GetHealth(&instance, DEVICE_ID, KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID,
+                                            KSRP_TELEMETRY_MOTOR_STATUS_TEMPERATURE_FIELD_ID) == KSRP_RESULT_OK);
+    CHECK(health_calls == 2);
+}
+
+static void test_invalid_updates(void) {
+    init_instance();
+    const KSRP_Telemetry_MotorStatus_Frame before = instance.motor_status_instance[DEVICE_ID];
+    uint32_t counter = 5;
+    uint64_t wide = 5;
+
+    CHECK(update_field(KSRP_TELEMETRY_MOTOR_STATUS_FIELDS_COUNT, &counter, sizeof(counter)) ==
+          KSRP_STATUS_INVALID_FIELD_TYPE);
+    CHECK(update_field(KSRP_ILLEGAL_FIELD_ID, &counter, sizeof(counter)) == KSRP_STATUS_INVALID_FIELD_TYPE);
+    CHECK(update_field(KSRP_TELEMETRY_MOTOR_STATUS_COUNTER_FIELD_ID, &wide, sizeof(wide)) ==
+          KSRP_STATUS_INVALID_DATA_SIZE);
+    CHECK(update_field(KSRP_TELEMETRY_MOTOR_STATUS_COUNTER_FIELD_ID, &counter, sizeof(counter) - 1) ==
+          KSRP_STATUS_INVALID_DATA_SIZE);
+    CHECK(KSRP_UpdateFrameField_Telemetry_Instance(&instance, KSRP_TELEMETRY_MAX_DEVICES,
+                                                   KSRP_TELEMETRY_MOTOR_STATUS_FRAME_ID,
+                                                   KSRP_TELEMETRY_MOTOR_STATUS_COUNTER_FIELD_ID, &counter,
+                                                   sizeof(counter)) == KSRP_STATUS_INVALID_DEVICE_ID);
+    CHECK(KSRP_UpdateFrameField_Telemetry_Instance(&instance, DEVICE_ID, (KSRP_Telemetry_FrameID)0,
+                                                   KSRP_TELEMETRY_MOTOR_STATUS_COUNTER_FIELD_ID, &counter,
+                                                   sizeof(counter)) == KSRP_STATUS_INVALID_FRAME_TYPE);
+
+    CHECK(memcmp(&instance.motor_status_instance[DEVICE_ID], &before, sizeof(before)) == 0);
+    CHECK(instance.motor_status_changed_fields[DEVICE_ID] == 0);
+    CHECK(update_calls == 0);
+}
+
+int main(void) {
+    RUN_TEST(test_change_detection_and_delta_bits);
+    RUN_TEST(test_health_update);
+    RUN_TEST(test_invalid_updates);
+    return EXIT_SUCCESS;
+}
@@ -1,3 +1,5 @@
+import math
+import struct
 import yaml
 from unidecode import unidecode
 
@@ -16,20 +18,65 @@ ALLOWED_TYPES = {
     'bool': 1,
 }
 
+INTEGER_RANGES = {
+    'uint8_t': (0, 0xFF),
+    'uint16_t': (0, 0xFFFF),
+    'uint32_t': (0, 0xFFFFFFFF),
+    'uint64_t': (0, 0xFFFFFFFFFFFFFFFF),
+    'int8_t': (-0x80, 0x7F),
+    'int16_t': (-0x8000, 0x7FFF),
+    'int32_t': (-0x80000000, 0x7FFFFFFF),
+    'int64_t': (-0x8000000000000000, 0x7FFFFFFFFFFFFFFF),
+}
+FLOAT_MAX = struct.unpack('<f', struct.pack('<I', 0x7F7FFFFF))[0]
+
+DEFAULT_MAX_DEVICES = 8
+MAX_DEVICES = 255  # device_id is uint8_t, its range checks against 256 devices would be always false
+DEFAULT_KEYFRAME_INTERVAL = 16
+MAX_DEADLINES = 0xFFFF  # KSRP_DEADLINE_NONE
+MAX_SCALED_BITS = 32  # Scaled values are quantized in double precision
+RESERVED_SUBSYSTEM_ID = 0xFF  # KSRP_BATCH_SUBSYSTEM_ID, KSRP_DELTA_SUBSYSTEM_ID, KSRP_SEGMENT_SUBSYSTEM_ID
+MAX_FRAME_SIZE = 62  # KSRP_MAX_FRAME_SIZE
+SEGMENT_PAYLOAD_BYTES = 56  # KSRP_SEGMENT_PAYLOAD_BYTES
+SEGMENT_WINDOW_MARGIN = 8  # KSRP_SEGMENT_WINDOW_MARGIN, size of the largest field
+MAX_SEGMENTED_SIZE = 255 * SEGMENT_PAYLOAD_BYTES  # Number of segments is encoded in a byte
+MAX_MASK_FIELDS = 64  # Changed fields of deltas and failing health checks are uint64_t bitmasks indexed by field ID
+
 
 class Protocol:
     def __init__(self):
         self.multiple_devices = False
+        self.max_devices = 1
+        self.deferred_transmit = False
+        self.delta_encoding = False
+        self.keyframe_interval = 0
+        self.rx_queue_capacity = 0
         self.subsystem = None
         self.subsystem_id = None
         self.frames = []
 
+        # Protocol definition as loaded from yaml, used to compute hash of all definitions
+        self.definition = None
+
 
 class Frame:
     def __init__(self):
         self.name = None
         self.id = None
         self.fields = []
+        self.size = 0
+        self.min_transmit_interval_ms = 0
+        self.has_health_checks = False
+        self.timeout_ms = 0
+
+        # Frames with bit-packed fields are serialized field by field with bit granularity
+        self.is_bit_packed = False
+        self.wire_size = 0
+
+        # Frames larger than single raw data frame are sent in segments, every segment is serialized separately
+        # from fields overlapping it as (bit offset of its serialization window, fields)
+        self.is_segmented = False
+        self.segments = []
 
 
 class Field:
@@ -44,10 +91,30 @@ class Field:
         self.is_enum = False
         self.is_health_check = False
         self.is_type_cast = False
+        self.is_device_id = False
 
         self.offset = 0
         self.actual_size = None
 
+        # Position and width of the field in serialized frame, value of scaled field is encoded as
+        # round((value - scale_offset) / scale)
+        self.is_bit_packed = False
+        self.is_scaled = False
+        self.bit_offset = 0
+        self.bits = None
+        self.scale = None
+        self.scale_offset = 0
+
+        # Health checks compiled into lookup tables, outcome index 0 means no check matched
+        # and index n refers to n-th health check
+        self.health_check_lut = None
+        self.health_check_points = []
+        self.health_check_bounds = []
+        self.health_check_intervals = []
+
+        # Value margin that has to be crossed before cached health result improves
+        self.hysteresis = None
+
         self.default = None
 
 
@@ -69,18 +136,56 @@ class Parser:
     def load_from_yaml(self, path: str):
         yaml_file = self.__load_yaml(path)
         protocol = Protocol()
+        protocol.definition = yaml_file['protocol']
         protocol.subsystem = yaml_file['protocol']['subsystem']
         protocol.subsystem_id = yaml_file['protocol']['subsystem_id']
+        if protocol.subsystem_id == RESERVED_SUBSYSTEM_ID:
+            raise ValueError(f"Subsystem id {RESERVED_SUBSYSTEM_ID} of {protocol.subsystem} is reserved for batch and delta frames")
 
         if 'multiple_devices' in yaml_file['protocol']:
             protocol.multiple_devices = bool(yaml_file['protocol']['multiple_devices'])
 
+        if protocol.multiple_devices:
+            protocol.max_devices = yaml_file['protocol'].get('max_devices', DEFAULT_MAX_DEVICES)
+            if not 1 <= protocol.max_devices <= MAX_DEVICES:
+                raise ValueError(f"Invalid max_devices {protocol.max_devices} for subsystem {protocol.subsystem}")
+
+        if 'deferred_transmit' in yaml_file['protocol']:
+            protocol.deferred_transmit = bool(yaml_file['protocol']['deferred_transmit'])
+
+        if 'delta_encoding' in yaml_file['protocol']:
+            protocol.delta_encoding = bool(yaml_file['protocol']['delta_encoding'])
+
+        if protocol.delta_encoding:
+            protocol.keyframe_interval = int(yaml_file['protocol'].get('keyframe_interval', DEFAULT_KEYFRAME_INTERVAL))
+            if not 1 <= protocol.keyframe_interval <= 0xFFFF:
+                raise ValueError(f"Invalid keyframe_interval {protocol.keyframe_interval} for subsystem {protocol.subsystem}")
+        elif 'keyframe_interval' in yaml_file['protocol']:
+            raise ValueError(f"keyframe_interval of subsystem {protocol.subsystem} requires delta_encoding")
+
+        if 'rx_queue_capacity' in yaml_file['protocol']:
+            protocol.rx_queue_capacity = int(yaml_file['protocol']['rx_queue_capacity'])
+            if protocol.rx_queue_capacity < 1 or protocol.rx_queue_capacity & (protocol.rx_queue_capacity - 1):
+                raise ValueError(f"rx_queue_capacity {protocol.rx_queue_capacity} of subsystem {protocol.subsystem} "
+                                 f"must be a power of two")
+
         for frame in yaml_file['protocol']['frames']:
             frame_obj = Frame()
             frame_obj.name = frame['name']
             frame_obj.id = frame['frame_id']
 
+            if 'min_transmit_interval_ms' in frame:
+                if not protocol.deferred_transmit:
+                    raise ValueError(f"min_transmit_interval_ms of frame {frame_obj.name} requires deferred_transmit")
+                frame_obj.min_transmit_interval_ms = int(frame['min_transmit_interval_ms'])
+
+            if 'timeout_ms' in frame:
+                frame_obj.timeout_ms = int(frame['timeout_ms'])
+                if not 1 <= frame_obj.timeout_ms <= 0x7FFFFFFF:
+                    raise ValueError(f"Invalid timeout_ms {frame_obj.timeout_ms} of frame {frame_obj.name}")
+
             current_offset = 0
+            current_bit_offset = 0
 
             if protocol.multiple_devices:
                 device_id_field = Field()
@@ -88,9 +193,12 @@ class Parser:
                 device_id_field.name = 'device_id'
                 device_id_field.offset = current_offset
                 device_id_field.actual_size = ALLOWED_TYPES[device_id_field.type]
+                device_id_field.is_device_id = True
+                device_id_field.bits = 8
 
                 frame_obj.fields.append(device_id_field)
                 current_offset += 1
+                current_bit_offset += 8
 
             for field in frame['fields']:
                 field_obj = Field()
@@ -123,6 +231,11 @@ class Parser:
                     current_offset += ALLOWED_TYPES[field_obj.type]
                     field_obj.actual_size = ALLOWED_TYPES[field_obj.type]
 
+                self.__parse_bit_packing(field_obj, field)
+                field_obj.bit_offset = current_bit_offset
+                current_bit_offset += field_obj.bits
+                frame_obj.is_bit_packed |= field_obj.is_bit_packed
+
                 if 'health_checks' in field:
                     field_obj.is_health_check = True
                     for health_check in field['health_checks']:
@@ -144,10 +257,38 @@ class Parser:
 
                         field_obj.health_checks.append(health_check_obj)
 
+                    self.__compile_health_checks(field_obj)
+                    frame_obj.has_health_checks = True
+
+                if 'hysteresis' in field:
+                    if not field_obj.is_health_check or field_obj.is_enum or field_obj.type == 'bool':
+                        raise ValueError(f"hysteresis of field {field_obj.name} requires numeric field with health_checks")
+                    field_obj.hysteresis = field['hysteresis']
+                    if field_obj.type not in ('float', 'double'):
+                        field_obj.hysteresis = int(field_obj.hysteresis)
+                    if field_obj.hysteresis <= 0:
+                        raise ValueError(f"Invalid hysteresis {field_obj.hysteresis} for field {field_obj.name}")
+
                 frame_obj.fields.append(field_obj)
 
+            frame_obj.size = current_offset
+            frame_obj.wire_size = (current_bit_offset + 7) // 8
+            frame_obj.is_segmented = frame_obj.wire_size > MAX_FRAME_SIZE
+            if protocol.delta_encoding and len(frame_obj.fields) > MAX_MASK_FIELDS:
+                raise ValueError(f"Frame {frame_obj.name} with delta_encoding has more than {MAX_MASK_FIELDS} fields")
+            if any(field.is_health_check for field in frame_obj.fields[MAX_MASK_FIELDS:]):
+                raise ValueError(f"Health checked field of frame {frame_obj.name} has field ID above {MAX_MASK_FIELDS - 1}")
+            if frame_obj.wire_size > MAX_SEGMENTED_SIZE:
+                raise ValueError(f"Frame {frame_obj.name} of {frame_obj.wire_size} bytes exceeds {MAX_SEGMENTED_SIZE} "
+                                 f"bytes that can be sent in segments")
+            if frame_obj.is_segmented:
+                self.__split_segments(frame_obj)
             protocol.frames.append(frame_obj)
 
+        timed_frames_count = len([frame for frame in protocol.frames if frame.timeout_ms])
+        if timed_frames_count * protocol.max_devices >= MAX_DEADLINES:
+            raise ValueError(f"Too many frames with timeout_ms in subsystem {protocol.subsystem}")
+
         self.__protocols[protocol.subsystem] = protocol
 
     def get_protocols(self):
@@ -156,6 +297,140 @@ class Parser:
     # def save_to_file(self, path: str):
     #     dump_yaml(self.yaml_description, path)
 
+    @staticmethod
+    def __parse_bit_packing(field_obj, field):
+        """Parse bit width and fixed-point scaling of the field, fields without them keep their whole bytes"""
+        storage_type = field_obj.cast_type if field_obj.is_type_cast else field_obj.type
+        is_floating = storage_type in ('float', 'double')
+        field_obj.bits = field_obj.actual_size * 8
+
+        if 'scale' in field or 'offset' in field:
+            if not is_floating:
+                raise ValueError(f"scale and offset of field {field_obj.name} require float or double type")
+            if 'bits' not in field:
+                raise ValueError(f"scale and offset of field {field_obj.name} require bits")
+            field_obj.is_scaled = True
+            field_obj.scale = float(field.get('scale', 1))
+            field_obj.scale_offset = float(field.get('offset', 0))
+            if not field_obj.scale > 0:
+                raise ValueError(f"Invalid scale {field_obj.scale} for field {field_obj.name}")
+
+        if 'bits' not in field:
+            return
+
+        if is_floating and not field_obj.is_scaled:
+            raise ValueError(f"bits of floating point field {field_obj.name} require scale")
+
+        field_obj.bits = int(field['bits'])
+        field_obj.is_bit_packed = True
+        max_bits = MAX_SCALED_BITS if field_obj.is_scaled else field_obj.actual_size * 8
+        if not 1 <= field_obj.bits <= max_bits:
+            raise ValueError(f"Invalid bits {field_obj.bits} for field {field_obj.name}, must be in range 1-{max_bits}")
+
+        if field_obj.is_enum:
+            # Enum values continue from the last explicitly numbered value
+            value, max_value = 0, 0
+            for enum_value in field_obj.values:
+                if isinstance(enum_value, dict):
+                    value = int(next(iter(enum_value.values())))
+                if value < 0:
+                    raise ValueError(f"Negative value of bit-packed enum field {field_obj.name}")
+                max_value = max(max_value, value)
+                value += 1
+            if max_value >> field_obj.bits:
+                raise ValueError(f"Values of enum field {field_obj.name} don't fit in {field_obj.bits} bits")
+
+    @staticmethod
+    def __split_segments(frame):
+        """Find fields overlapping every segment, window of the segment starts SEGMENT_WINDOW_MARGIN bytes before it"""
+        for start in range(0, frame.wire_size, SEGMENT_PAYLOAD_BYTES):
+            end = min(start + SEGMENT_PAYLOAD_BYTES, frame.wire_size)
+            fields = [field for field in frame.fields
+                      if field.bit_offset < end * 8 and field.bit_offset + field.bits > start * 8]
+            frame.segments.append(((start - SEGMENT_WINDOW_MARGIN) * 8, fields))
+
+    @staticmethod
+    def __float_ceil(value):
+        """Smallest float not less than the value, so float field is in [min, max) exactly when the check is met"""
+        if value > FLOAT_MAX:
+            return math.inf
+        if value < -FLOAT_MAX:
+            return -FLOAT_MAX
+        rounded = struct.unpack('<f', struct.pack('<f', value))[0]
+        if rounded < value:
+            bits = struct.unpack('<I', struct.pack('<f', rounded))[0]
+            rounded = struct.unpack('<f', struct.pack('<I', bits + 1 if rounded >= 0 else bits - 1))[0]
+        return rounded
+
+    @staticmethod
+    def __compile_health_checks(field):
+        """
+        Compile ordered health checks of the field into lookup tables with the same result as evaluating them one
+        by one. Single byte fields get a table indexed directly by value, other fields get sorted exact values and
+        sorted range bounds for binary search.
+        """
+        storage_type = field.cast_type if field.is_type_cast else field.type
+        is_integer = storage_type not in ('float', 'double')
+        type_min, type_max = INTEGER_RANGES.get(storage_type, (-math.inf, math.inf))
+
+        def matches(health_check, value):
+            if health_check.type == 'exact':
+                return value == health_check.value
+            return health_check.min <= value < health_check.max
+
+        def first_match(value, checks_count):
+            for index, health_check in enumerate(field.health_checks[:checks_count]):
+                if matches(health_check, value):
+                    return index + 1
+            return 0
+
+        if field.actual_size == 1:
+            values = range(-128, 128) if storage_type == 'int8_t' else range(256)
+            field.health_check_lut = [0] * 256
+            for value in values:
+                field.health_check_lut[value & 0xFF] = first_match(value, len(field.health_checks))
+            return
+
+        # Exact check is reachable only if none of the checks before it matches the same value
+        points = {}
+        for index, health_check in enumerate(field.health_checks):
+            if health_check.type != 'exact' or (is_integer and health_check.value != int(health_check.value)):
+                continue
+            if not type_min <= health_check.value <= type_max:
+                continue
+            if storage_type == 'float' and Parser.__float_ceil(health_check.value) != health_check.value:
+                continue
+            if health_check.value not in points and first_match(health_check.value, index) == 0:
+                points[health_check.value] = index + 1
+        field.health_check_points = sorted(points.items())
+
+        # Integer field is in [min, max) range exactly when it is in [ceil(min), ceil(max)) range. Bounds are clamped
+        # to the type, otherwise they would wrap in the table and break its order. Float bounds are rounded up the same
+        # way, rounding to the nearest float would move values next to the bound to the other range
+        def bound(value):
+            if is_integer:
+                return min(max(math.ceil(value), type_min), type_max + 1)
+            return Parser.__float_ceil(value) if storage_type == 'float' else value
+
+        ranges = [(bound(health_check.min), bound(health_check.max), index + 1)
+                  for index, health_check in enumerate(field.health_checks) if health_check.type == 'range']
+        ranges = [(low, high, index) for low, high, index in ranges if low < high]
+        bounds = sorted({value for low, high, _ in ranges for value in (low, high)})
+        intervals = []
+        for low, high in zip(bounds, bounds[1:]):
+            outcome = next((index for range_min, range_max, index in ranges if range_min <= low and high <= range_max), 0)
+            if intervals and intervals[-1][2] == outcome:
+                intervals[-1] = (intervals[-1][0], high, outcome)
+            else:
+                intervals.append((low, high, outcome))
+
+        if intervals:
+            # Range reaching past the largest value of the type is left open, its end isn't representable
+            field.health_check_bounds = [low for low, _, _ in intervals]
+            if intervals[-1][1] <= type_max:
+                field.health_check_bounds.append(intervals[-1][1])
+            field.health_check_intervals = [outcome for _, _, outcome in intervals]
+
     @staticmethod
     def __load_yaml(path: str):
         with open(path, 'r') as file: